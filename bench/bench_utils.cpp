@@ -0,0 +1,124 @@
+#include "bench_utils.hpp"
+
+#include <cmath>
+
+#include "content/Content.hpp"
+#include "content/ContentBuilder.hpp"
+#include "core_defs.hpp"
+#include "items/ItemDef.hpp"
+#include "lighting/Lighting.hpp"
+#include "objects/rigging.hpp"
+#include "voxels/Block.hpp"
+#include "voxels/Chunk.hpp"
+#include "voxels/Chunks.hpp"
+
+static uint32_t hash(int x, int y, int z) {
+    uint32_t h = x * 374761393u + y * 668265263u + z * 2147483647u;
+    h = (h ^ (h >> 13)) * 1274126177u;
+    return h ^ (h >> 16);
+}
+
+std::unique_ptr<Content> bench::create_content() {
+    ContentBuilder builder;
+    {
+        Block& block = builder.blocks.create(CORE_AIR);
+        block.replaceable = true;
+        block.drawGroup = 1;
+        block.lightPassing = true;
+        block.skyLightPassing = true;
+        block.obstacle = false;
+        block.selectable = false;
+        block.model = BlockModel::none;
+        block.pickingItem = CORE_EMPTY;
+    }
+    builder.items.create(CORE_EMPTY);
+    for (const auto& name : {"bench:stone", "bench:dirt"}) {
+        Block& block = builder.blocks.create(name);
+        block.textureFaces.fill(name);
+        block.pickingItem = CORE_EMPTY;
+    }
+    {
+        Block& block = builder.blocks.create("bench:lamp");
+        block.textureFaces.fill("bench:lamp");
+        block.pickingItem = CORE_EMPTY;
+        block.emission[0] = 15;
+        block.emission[1] = 14;
+        block.emission[2] = 10;
+    }
+    {
+        Block& block = builder.blocks.create("bench:glass");
+        block.textureFaces.fill("bench:glass");
+        block.pickingItem = CORE_EMPTY;
+        block.drawGroup = 2;
+        block.lightPassing = true;
+        block.skyLightPassing = true;
+        block.translucent = true;
+    }
+    return builder.build();
+}
+
+void bench::fill_terrain(Chunk& chunk, const Content& content) {
+    const auto& blocks = content.blocks;
+    blockid_t stone = blocks.require("bench:stone").rt.id;
+    blockid_t dirt = blocks.require("bench:dirt").rt.id;
+    blockid_t glass = blocks.require("bench:glass").rt.id;
+    blockid_t lamp = blocks.require("bench:lamp").rt.id;
+
+    for (int z = 0; z < CHUNK_D; z++) {
+        for (int x = 0; x < CHUNK_W; x++) {
+            int gx = chunk.x * CHUNK_W + x;
+            int gz = chunk.z * CHUNK_D + z;
+            int height = 64 + std::sin(gx * 0.07f) * 12.0f +
+                         std::cos(gz * 0.05f) * 10.0f;
+            for (int y = 0; y < height; y++) {
+                voxel& vox = chunk.voxels[vox_index(x, y, z)];
+                uint32_t value = hash(gx, y, gz);
+                if (y > 8 && y < height - 6 && value % 7 == 0) {
+                    vox.id = BLOCK_AIR;
+                } else if (value % 997 == 0) {
+                    vox.id = lamp;
+                } else if (y < height - 3) {
+                    vox.id = value % 61 == 0 ? glass : stone;
+                } else {
+                    vox.id = dirt;
+                }
+                vox.state.rotation = value % 6;
+            }
+        }
+    }
+    chunk.updateHeights();
+}
+
+std::unique_ptr<Chunks> bench::create_chunks(
+    const Content& content, int size
+) {
+    const auto& indices = *content.getIndices();
+    int offset = -size / 2;
+
+    auto chunks =
+        std::make_unique<Chunks>(size, size, 0, 0, nullptr, indices);
+    chunks->setCenter(0, 0);
+    for (int z = 0; z < size; z++) {
+        for (int x = 0; x < size; x++) {
+            auto chunk = std::make_shared<Chunk>(offset + x, offset + z);
+            fill_terrain(*chunk, content);
+            Lighting::prebuildSkyLight(*chunk, indices);
+            chunk->flags.loaded = true;
+            chunk->flags.ready = true;
+            chunks->putChunk(chunk);
+        }
+    }
+    Lighting lighting(content, *chunks);
+    for (int z = 0; z < size; z++) {
+        for (int x = 0; x < size; x++) {
+            lighting.buildSkyLight(offset + x, offset + z);
+            lighting.onChunkLoaded(offset + x, offset + z, true);
+        }
+    }
+    for (const auto& chunk : chunks->getChunks()) {
+        if (chunk) {
+            chunk->flags.lighted = true;
+        }
+    }
+    return chunks;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <memory>
+
+class Chunk;
+class Chunks;
+class Content;
+
+namespace bench {
+    /// @brief Size of the chunks matrix created by create_chunks
+    inline constexpr int CHUNKS_SIZE = 6;
+
+    /// @brief Create minimal content: core:air, core:empty and blocks
+    /// bench:stone, bench:dirt, bench:glass (translucent) and
+    /// bench:lamp (light source)
+    std::unique_ptr<Content> create_content();
+
+    /// @brief Fill chunk voxels with deterministic hilly terrain
+    /// with caves, glass and lamps
+    void fill_terrain(Chunk& chunk, const Content& content);
+
+    /// @brief Create size x size matrix of terrain chunks centered at 0, 0
+    /// with sky light and lamps light calculated
+    std::unique_ptr<Chunks> create_chunks(
+        const Content& content, int size = CHUNKS_SIZE
+    );
+}
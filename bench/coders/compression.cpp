@@ -0,0 +1,100 @@
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "bench_utils.hpp"
+#include "coders/gzip.hpp"
+#include "coders/rle.hpp"
+#include "content/Content.hpp"
+#include "voxels/Chunk.hpp"
+
+/// @brief Encoded terrain chunk voxels as stored in world regions
+static const std::vector<ubyte>& chunk_data() {
+    static std::vector<ubyte> data = []() {
+        auto content = bench::create_content();
+        Chunk chunk(0, 0);
+        bench::fill_terrain(chunk, *content);
+        auto bytes = chunk.encode();
+        return std::vector<ubyte>(bytes.get(), bytes.get() + CHUNK_DATA_LEN);
+    }();
+    return data;
+}
+
+static void BM_extrle_encode(benchmark::State& state) {
+    const auto& src = chunk_data();
+    std::vector<ubyte> dst(src.size() * 2);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+            extrle::encode(src.data(), src.size(), dst.data())
+        );
+    }
+    state.SetBytesProcessed(state.iterations() * src.size());
+}
+BENCHMARK(BM_extrle_encode);
+
+static void BM_extrle_decode(benchmark::State& state) {
+    const auto& src = chunk_data();
+    std::vector<ubyte> encoded(src.size() * 2);
+    size_t length = extrle::encode(src.data(), src.size(), encoded.data());
+    std::vector<ubyte> dst(src.size());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+            extrle::decode(encoded.data(), length, dst.data())
+        );
+    }
+    state.SetBytesProcessed(state.iterations() * src.size());
+}
+BENCHMARK(BM_extrle_decode);
+
+static void BM_extrle_encode16(benchmark::State& state) {
+    const auto& src = chunk_data();
+    std::vector<ubyte> dst(src.size() * 2);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+            extrle::encode16(src.data(), src.size(), dst.data())
+        );
+    }
+    state.SetBytesProcessed(state.iterations() * src.size());
+}
+BENCHMARK(BM_extrle_encode16);
+
+static void BM_extrle_decode16(benchmark::State& state) {
+    const auto& src = chunk_data();
+    std::vector<ubyte> encoded(src.size() * 2);
+    size_t length = extrle::encode16(src.data(), src.size(), encoded.data());
+    std::vector<ubyte> dst(src.size());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+            extrle::decode16(encoded.data(), length, dst.data())
+        );
+    }
+    state.SetBytesProcessed(state.iterations() * src.size());
+}
+BENCHMARK(BM_extrle_decode16);
+
+static void BM_gzip_compress(benchmark::State& state) {
+    const auto& src = chunk_data();
+    std::vector<ubyte> encoded(src.size() * 2);
+    encoded.resize(extrle::encode16(src.data(), src.size(), encoded.data()));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+            gzip::compress(encoded.data(), encoded.size())
+        );
+    }
+    state.SetBytesProcessed(state.iterations() * encoded.size());
+}
+BENCHMARK(BM_gzip_compress);
+
+static void BM_gzip_decompress(benchmark::State& state) {
+    const auto& src = chunk_data();
+    std::vector<ubyte> encoded(src.size() * 2);
+    encoded.resize(extrle::encode16(src.data(), src.size(), encoded.data()));
+    auto compressed = gzip::compress(encoded.data(), encoded.size());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+            gzip::decompress(compressed.data(), compressed.size())
+        );
+    }
+    state.SetBytesProcessed(state.iterations() * encoded.size());
+}
+BENCHMARK(BM_gzip_decompress);
@@ -0,0 +1,251 @@
+#include <benchmark/benchmark.h>
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "coders/json.hpp"
+#include "coders/scanning.hpp"
+#include "data/dv_document.hpp"
+
+/// @brief World-data-like object: entities with components, transforms
+/// and per-entity properties
+static const dv::value& sample_object() {
+    static dv::value root = []() {
+        auto root = dv::object();
+        root["version"] = 3;
+        root["name"] = "benchmark world";
+        auto& entities = root.list("entities");
+        for (int i = 0; i < 500; i++) {
+            auto entity = dv::object();
+            entity["uid"] = i * 7919;
+            entity["def"] = "base:drop";
+            entity["visible"] = i % 3 != 0;
+            auto& position = entity.list("position");
+            position.add(i * 1.25);
+            position.add(64.5 + (i % 16));
+            position.add(-i * 0.75);
+            auto& components = entity.list("components");
+            components.add("base:drop");
+            components.add("base:physics");
+            auto& props = entity.object("props");
+            props["count"] = i % 64;
+            props["item"] = "base:stone.item";
+            props["timer"] = i * 0.05;
+            entities.add(std::move(entity));
+        }
+        return root;
+    }();
+    return root;
+}
+
+static void BM_json_stringify(benchmark::State& state) {
+    const auto& object = sample_object();
+    size_t bytes = 0;
+    for (auto _ : state) {
+        auto text = json::stringify(object, false);
+        bytes = text.size();
+        benchmark::DoNotOptimize(text);
+    }
+    state.SetBytesProcessed(state.iterations() * bytes);
+}
+BENCHMARK(BM_json_stringify);
+
+/// @brief Indented json parsing with scalar or vectorized scanning kernels
+static void BM_json_parse(benchmark::State& state) {
+    auto text = json::stringify(sample_object(), true);
+    bool enabled = scanning::is_enabled();
+    scanning::set_enabled(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(json::parse("<bench>", text));
+    }
+    scanning::set_enabled(enabled);
+    state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_json_parse)->ArgName("vectorized")->Arg(0)->Arg(1);
+
+static void BM_json_parse_document(benchmark::State& state) {
+    auto text = json::stringify(sample_object(), true);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(json::parse_document("<bench>", text));
+    }
+    state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_json_parse_document);
+
+/// @brief Contents of all json files of the res folder (empty if the folder
+/// is not found)
+static const std::vector<std::string>& res_corpus() {
+    namespace fs = std::filesystem;
+    static std::vector<std::string> texts = []() {
+        std::vector<std::string> texts;
+        for (auto path : {"res", "../res", "../../res"}) {
+            if (!fs::is_directory(fs::u8path(path) / "content")) {
+                continue;
+            }
+            for (const auto& entry :
+                 fs::recursive_directory_iterator(fs::u8path(path))) {
+                if (entry.path().extension() != ".json") {
+                    continue;
+                }
+                std::ifstream file(entry.path(), std::ios::binary);
+                std::stringstream ss;
+                ss << file.rdbuf();
+                texts.push_back(ss.str());
+            }
+            break;
+        }
+        return texts;
+    }();
+    return texts;
+}
+
+/// @brief Parsing bundled res json files (small, mostly flat documents)
+/// into dv::value or dv::document
+static void BM_json_parse_res(benchmark::State& state) {
+    const auto& texts = res_corpus();
+    if (texts.empty()) {
+        state.SkipWithError("res folder not found");
+        return;
+    }
+    bool enabled = scanning::is_enabled();
+    scanning::set_enabled(state.range(0));
+    bool document = state.range(1);
+    size_t bytes = 0;
+    for (const auto& text : texts) {
+        bytes += text.size();
+    }
+    for (auto _ : state) {
+        for (const auto& text : texts) {
+            if (document) {
+                benchmark::DoNotOptimize(json::parse_document("<res>", text));
+            } else {
+                benchmark::DoNotOptimize(json::parse("<res>", text));
+            }
+        }
+    }
+    scanning::set_enabled(enabled);
+    state.SetBytesProcessed(state.iterations() * bytes);
+    state.counters["files"] = texts.size();
+}
+BENCHMARK(BM_json_parse_res)
+    ->ArgNames({"vectorized", "document"})
+    ->ArgsProduct({{0, 1}, {0, 1}});
+
+static void BM_bjson_serialize(benchmark::State& state) {
+    const auto& object = sample_object();
+    bool compress = state.range(0);
+    size_t bytes = 0;
+    for (auto _ : state) {
+        auto data = json::to_binary(object, compress);
+        bytes = data.size();
+        benchmark::DoNotOptimize(data);
+    }
+    state.SetBytesProcessed(state.iterations() * bytes);
+}
+BENCHMARK(BM_bjson_serialize)->ArgName("compress")->Arg(0)->Arg(1);
+
+static void BM_bjson_parse(benchmark::State& state) {
+    auto data = json::to_binary(sample_object(), state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(json::from_binary(data.data(), data.size()));
+    }
+    state.SetBytesProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_bjson_parse)->ArgName("compress")->Arg(0)->Arg(1);
+
+/// @brief Visit every value with the cursor without building a tree
+static size_t walk(json::BinaryCursor& cursor) {
+    size_t count = 1;
+    switch (cursor.peekType()) {
+        case dv::value_type::object:
+            cursor.enterObject();
+            while (cursor.hasNext()) {
+                cursor.readKey();
+                count += walk(cursor);
+            }
+            break;
+        case dv::value_type::list:
+            cursor.enterList();
+            while (cursor.hasNext()) {
+                count += walk(cursor);
+            }
+            break;
+        default:
+            cursor.skip();
+            break;
+    }
+    return count;
+}
+
+static void BM_bjson_cursor(benchmark::State& state) {
+    auto data = json::to_binary(sample_object(), false);
+    for (auto _ : state) {
+        json::BinaryCursor cursor(data.data(), data.size());
+        benchmark::DoNotOptimize(walk(cursor));
+    }
+    state.SetBytesProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_bjson_cursor);
+
+/// @brief Entities region layer similar to Entities::serialize output
+static const std::vector<ubyte>& entities_layer() {
+    static std::vector<ubyte> data = []() {
+        auto root = dv::object();
+        auto& list = root.list("data");
+        for (int i = 0; i < 2000; i++) {
+            auto& entity = list.object();
+            entity["def"] = i % 3 ? "base:drop" : "base:falling_block";
+            entity["uid"] = 1000 + i;
+            auto& transform = entity.object("transform");
+            transform["pos"] = dv::list({i * 0.5, 64.0 + i % 7, -i * 0.25});
+            if (i % 2) {
+                transform["size"] = dv::list({0.25, 0.25, 0.25});
+            }
+            auto& rigidbody = entity.object("rigidbody");
+            rigidbody["vel"] = dv::list({0.0, -9.8 * (i % 5), 0.0});
+            rigidbody["damping"] = 1.5;
+            auto& comps = entity.object("comps");
+            auto& drop = comps.object("base:drop");
+            drop["item"] = i % 3 ? "base:stone.item" : "base:dirt.item";
+            drop["count"] = i % 64 + 1;
+            drop["timer"] = i * 0.01;
+        }
+        return json::to_binary(root);
+    }();
+    return data;
+}
+
+static void BM_entities_from_binary(benchmark::State& state) {
+    const auto& data = entities_layer();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(json::from_binary(data.data(), data.size()));
+    }
+    state.SetBytesProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_entities_from_binary);
+
+static void BM_entities_from_binary_document(benchmark::State& state) {
+    const auto& data = entities_layer();
+    size_t arenaSize = 0;
+    for (auto _ : state) {
+        auto doc = json::from_binary_document(data.data(), data.size());
+        arenaSize = doc.getArena().getAllocated();
+        benchmark::DoNotOptimize(doc);
+    }
+    state.SetBytesProcessed(state.iterations() * data.size());
+    state.counters["arena_kb"] = arenaSize / 1024.0;
+}
+BENCHMARK(BM_entities_from_binary_document);
+
+static void BM_entities_cursor(benchmark::State& state) {
+    const auto& data = entities_layer();
+    for (auto _ : state) {
+        json::BinaryCursor cursor(data.data(), data.size());
+        benchmark::DoNotOptimize(walk(cursor));
+    }
+    state.SetBytesProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_entities_cursor);
@@ -0,0 +1,60 @@
+#include <benchmark/benchmark.h>
+
+#include "bench_utils.hpp"
+#include "assets/Assets.hpp"
+#include "content/Content.hpp"
+#include "frontend/ContentGfxCache.hpp"
+#include "graphics/core/Atlas.hpp"
+#include "graphics/core/ImageData.hpp"
+#include "graphics/core/Mesh.hpp"
+#include "graphics/render/BlocksRenderer.hpp"
+#include "settings.hpp"
+#include "voxels/Block.hpp"
+#include "voxels/Chunk.hpp"
+#include "voxels/Chunks.hpp"
+
+/// @brief Store blocks atlas without a texture, so no GL context required
+static void create_atlas(Assets& assets, const Content& content) {
+    std::unordered_map<std::string, UVRegion> regions;
+    const auto& defs = content.getIndices()->blocks.getIterable();
+    for (size_t i = 0; i < defs.size(); i++) {
+        float u = i / static_cast<float>(defs.size());
+        for (const auto& name : defs[i]->textureFaces) {
+            regions[name] = UVRegion(u, 0.0f, u + 1.0f / defs.size(), 1.0f);
+        }
+    }
+    assets.store(
+        std::make_unique<Atlas>(
+            std::make_unique<ImageData>(ImageFormat::rgba8888, 16, 16),
+            std::move(regions),
+            false
+        ),
+        "blocks"
+    );
+}
+
+static void BM_BlocksRenderer_build(benchmark::State& state) {
+    auto content = bench::create_content();
+    auto chunks = bench::create_chunks(*content);
+    EngineSettings settings;
+    settings.graphics.denseRender.set(state.range(0));
+
+    Assets assets;
+    create_atlas(assets, *content);
+    ContentGfxCache cache(*content, assets, settings.graphics);
+    BlocksRenderer renderer(
+        settings.graphics.chunkMaxVerticesDense.get(), *content, cache, settings
+    );
+
+    const Chunk* chunk = chunks->getChunk(0, 0);
+    for (auto _ : state) {
+        renderer.build(chunk, chunks.get());
+        benchmark::DoNotOptimize(renderer.createMesh());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_BlocksRenderer_build)
+    ->ArgName("dense")
+    ->Arg(0)
+    ->Arg(1)
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,65 @@
+#include <benchmark/benchmark.h>
+
+#include "bench_utils.hpp"
+#include "content/Content.hpp"
+#include "lighting/LightSolver.hpp"
+#include "lighting/Lighting.hpp"
+#include "voxels/Chunk.hpp"
+#include "voxels/Chunks.hpp"
+
+/// @brief Point light flood fill in open air and its removal
+static void BM_LightSolver_add_remove(benchmark::State& state) {
+    auto content = bench::create_content();
+    auto chunks = bench::create_chunks(*content);
+    LightSolver solver(*content->getIndices(), *chunks, 0);
+
+    int emission = state.range(0);
+    for (auto _ : state) {
+        solver.add(0, 120, 0, emission);
+        solver.solve();
+        solver.remove(0, 120, 0);
+        solver.solve();
+    }
+}
+BENCHMARK(BM_LightSolver_add_remove)->ArgName("emission")->Arg(8)->Arg(15);
+
+/// @brief Point light flood fill inside the terrain caves
+static void BM_LightSolver_add_remove_caves(benchmark::State& state) {
+    auto content = bench::create_content();
+    auto chunks = bench::create_chunks(*content);
+    LightSolver solver(*content->getIndices(), *chunks, 0);
+
+    for (auto _ : state) {
+        solver.add(0, 40, 0, 15);
+        solver.solve();
+        solver.remove(0, 40, 0);
+        solver.solve();
+    }
+}
+BENCHMARK(BM_LightSolver_add_remove_caves);
+
+/// @brief Full chunks lighting: sky light build and emitters flood fill
+/// as done on chunks loading
+static void BM_Lighting_chunks_loaded(benchmark::State& state) {
+    auto content = bench::create_content();
+    const auto& indices = *content->getIndices();
+    int size = 3;
+    auto chunks = bench::create_chunks(*content, size);
+    int offset = -size / 2;
+
+    Lighting lighting(*content, *chunks);
+    for (auto _ : state) {
+        lighting.clear();
+        for (const auto& chunk : chunks->getChunks()) {
+            Lighting::prebuildSkyLight(*chunk, indices);
+        }
+        for (int z = 0; z < size; z++) {
+            for (int x = 0; x < size; x++) {
+                lighting.buildSkyLight(offset + x, offset + z);
+                lighting.onChunkLoaded(offset + x, offset + z, true);
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * size * size);
+}
+BENCHMARK(BM_Lighting_chunks_loaded)->Unit(benchmark::kMillisecond);
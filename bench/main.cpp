@@ -0,0 +1,16 @@
+#include <benchmark/benchmark.h>
+
+#include "debug/Logger.hpp"
+
+int main(int argc, char** argv) {
+    // keep console output readable, engine modules log on initialization
+    debug::Logger::setLevel(debug::LogLevel::warning);
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,41 @@
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "maths/simd.hpp"
+
+/// @brief Heightmap rows of 256 points, as heightmap:noise calculates them
+static constexpr size_t ROW_SIZE = 256;
+static constexpr size_t ROWS = 64;
+
+/// @brief Arguments: noise type, SIMD kernels enabled
+static void BM_noise2d(benchmark::State& state) {
+    bool enabled = simd::is_enabled();
+    simd::set_enabled(state.range(1) != 0);
+
+    fnl_state noise = fnlCreateState();
+    noise.noise_type = static_cast<fnl_noise_type>(state.range(0));
+    noise.seed = 42;
+    noise.frequency = 0.05f;
+
+    std::vector<float> xs(ROW_SIZE);
+    std::vector<float> ys(ROW_SIZE);
+    std::vector<float> values(ROW_SIZE);
+    for (auto _ : state) {
+        for (size_t y = 0; y < ROWS; y++) {
+            for (size_t x = 0; x < ROW_SIZE; x++) {
+                xs[x] = x * 1.37f;
+                ys[x] = y * 0.91f;
+            }
+            simd::noise2d(
+                noise, xs.data(), ys.data(), values.data(), ROW_SIZE
+            );
+            benchmark::DoNotOptimize(values.data());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * ROWS * ROW_SIZE);
+    simd::set_enabled(enabled);
+}
+BENCHMARK(BM_noise2d)
+    ->ArgNames({"type", "simd"})
+    ->ArgsProduct({{FNL_NOISE_OPENSIMPLEX2, FNL_NOISE_CELLULAR}, {0, 1}});
@@ -0,0 +1,63 @@
+#include <benchmark/benchmark.h>
+
+#include "bench_utils.hpp"
+#include "content/Content.hpp"
+#include "lighting/Lighting.hpp"
+#include "voxels/Block.hpp"
+#include "voxels/Chunks.hpp"
+#include "voxels/blocks_agent.hpp"
+
+static constexpr int FILL_SIZE = 64;
+static constexpr int FILL_Y = 64;
+
+static const glm::ivec3 FILL_MIN {-FILL_SIZE / 2, FILL_Y, -FILL_SIZE / 2};
+static const glm::ivec3 FILL_MAX = FILL_MIN + glm::ivec3(FILL_SIZE - 1);
+
+/// @brief Fill 64^3 area with stone and clear it back setting blocks one
+/// by one with light update per block (as block.set does)
+static void BM_fill_per_block(benchmark::State& state) {
+    auto content = bench::create_content();
+    auto chunks = bench::create_chunks(*content);
+    Lighting lighting(*content, *chunks);
+    blockid_t stone = content->blocks.require("bench:stone").rt.id;
+
+    for (auto _ : state) {
+        for (blockid_t id : {stone, BLOCK_AIR}) {
+            for (int y = FILL_MIN.y; y <= FILL_MAX.y; y++) {
+                for (int z = FILL_MIN.z; z <= FILL_MAX.z; z++) {
+                    for (int x = FILL_MIN.x; x <= FILL_MAX.x; x++) {
+                        blocks_agent::set(*chunks, x, y, z, id, {});
+                        lighting.onBlockSet(x, y, z, id);
+                    }
+                }
+            }
+        }
+    }
+    state.SetItemsProcessed(
+        state.iterations() * 2 * FILL_SIZE * FILL_SIZE * FILL_SIZE
+    );
+}
+BENCHMARK(BM_fill_per_block)->Unit(benchmark::kMillisecond);
+
+/// @brief Same area filled and cleared with blocks_agent::fill and single
+/// light solve per fill (as block.fill does)
+static void BM_fill_area(benchmark::State& state) {
+    auto content = bench::create_content();
+    auto chunks = bench::create_chunks(*content);
+    Lighting lighting(*content, *chunks);
+    blockid_t stone = content->blocks.require("bench:stone").rt.id;
+
+    for (auto _ : state) {
+        for (blockid_t id : {stone, BLOCK_AIR}) {
+            blocks_agent::fill(*chunks, FILL_MIN, FILL_MAX, id, {});
+            lighting.onAreaSet(
+                FILL_MIN.x, FILL_MIN.y, FILL_MIN.z,
+                FILL_MAX.x, FILL_MAX.y, FILL_MAX.z
+            );
+        }
+    }
+    state.SetItemsProcessed(
+        state.iterations() * 2 * FILL_SIZE * FILL_SIZE * FILL_SIZE
+    );
+}
+BENCHMARK(BM_fill_area)->Unit(benchmark::kMillisecond);
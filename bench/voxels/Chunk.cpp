@@ -0,0 +1,54 @@
+#include <benchmark/benchmark.h>
+
+#include "bench_utils.hpp"
+#include "content/Content.hpp"
+#include "lighting/Lightmap.hpp"
+#include "voxels/Chunk.hpp"
+#include "voxels/Chunks.hpp"
+
+static void BM_Chunk_encode(benchmark::State& state) {
+    auto content = bench::create_content();
+    Chunk chunk(0, 0);
+    bench::fill_terrain(chunk, *content);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(chunk.encode());
+    }
+    state.SetBytesProcessed(state.iterations() * CHUNK_DATA_LEN);
+}
+BENCHMARK(BM_Chunk_encode);
+
+static void BM_Chunk_decode(benchmark::State& state) {
+    auto content = bench::create_content();
+    Chunk source(0, 0);
+    bench::fill_terrain(source, *content);
+    auto data = source.encode();
+
+    Chunk chunk(0, 0);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(chunk.decode(data.get()));
+    }
+    state.SetBytesProcessed(state.iterations() * CHUNK_DATA_LEN);
+}
+BENCHMARK(BM_Chunk_decode);
+
+static void BM_Lightmap_encode(benchmark::State& state) {
+    auto content = bench::create_content();
+    auto chunks = bench::create_chunks(*content, 3);
+    const auto& lightmap = chunks->getChunk(0, 0)->lightmap;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(lightmap.encode());
+    }
+    state.SetBytesProcessed(state.iterations() * CHUNK_VOL * sizeof(light_t));
+}
+BENCHMARK(BM_Lightmap_encode);
+
+static void BM_Lightmap_decode(benchmark::State& state) {
+    auto content = bench::create_content();
+    auto chunks = bench::create_chunks(*content, 3);
+    auto data = chunks->getChunk(0, 0)->lightmap.encode();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Lightmap::decode(data.get()));
+    }
+    state.SetBytesProcessed(state.iterations() * LIGHTMAP_DATA_LEN);
+}
+BENCHMARK(BM_Lightmap_decode);
@@ -0,0 +1,71 @@
+#include <benchmark/benchmark.h>
+
+#include "bench_utils.hpp"
+#include "content/Content.hpp"
+#include "voxels/Chunk.hpp"
+#include "voxels/Chunks.hpp"
+#include "voxels/VoxelsVolume.hpp"
+#include "voxels/blocks_agent.hpp"
+
+/// @brief Volume of a chunk with 1 block padding as used by meshing
+static void BM_Chunks_getVoxels(benchmark::State& state) {
+    auto content = bench::create_content();
+    auto chunks = bench::create_chunks(*content);
+    bool backlight = state.range(0);
+
+    VoxelsVolume volume(CHUNK_W + 2, CHUNK_H, CHUNK_D + 2);
+    volume.setPosition(-1, 0, -1);
+    for (auto _ : state) {
+        chunks->getVoxels(volume, backlight);
+        benchmark::DoNotOptimize(volume.getVoxels());
+    }
+    state.SetItemsProcessed(
+        state.iterations() * volume.getW() * volume.getH() * volume.getD()
+    );
+}
+BENCHMARK(BM_Chunks_getVoxels)->ArgName("backlight")->Arg(0)->Arg(1);
+
+/// @brief Random-ish access pattern crossing chunk borders
+static void BM_blocks_agent_get(benchmark::State& state) {
+    auto content = bench::create_content();
+    auto chunks = bench::create_chunks(*content);
+
+    int extent = bench::CHUNKS_SIZE / 2 * CHUNK_W;
+    uint32_t seed = 1;
+    for (auto _ : state) {
+        uint32_t sum = 0;
+        for (int i = 0; i < 4096; i++) {
+            seed = seed * 1664525u + 1013904223u;
+            int x = static_cast<int>(seed % (extent * 2)) - extent;
+            int y = (seed >> 8) % CHUNK_H;
+            int z = static_cast<int>((seed >> 16) % (extent * 2)) - extent;
+            if (auto vox = blocks_agent::get(*chunks, x, y, z)) {
+                sum += vox->id;
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * 4096);
+}
+BENCHMARK(BM_blocks_agent_get);
+
+/// @brief Sequential access along X axis as in area scans
+static void BM_blocks_agent_get_sequential(benchmark::State& state) {
+    auto content = bench::create_content();
+    auto chunks = bench::create_chunks(*content);
+
+    int extent = bench::CHUNKS_SIZE / 2 * CHUNK_W;
+    for (auto _ : state) {
+        uint32_t sum = 0;
+        for (int z = -16; z < 16; z++) {
+            for (int x = -extent; x < extent; x++) {
+                if (auto vox = blocks_agent::get(*chunks, x, 60, z)) {
+                    sum += vox->id;
+                }
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * 32 * extent * 2);
+}
+BENCHMARK(BM_blocks_agent_get_sequential);
@@ -0,0 +1,187 @@
+#include <benchmark/benchmark.h>
+
+#include "bench_utils.hpp"
+#include "content/Content.hpp"
+#include "logic/WorldPregenerator.hpp"
+#include "maths/FastNoiseLite.h"
+#include "maths/simd.hpp"
+#include "voxels/Chunk.hpp"
+#include "world/generator/GeneratorDef.hpp"
+#include "world/generator/VoxelFragment.hpp"
+#include "world/generator/WorldGenerator.hpp"
+
+namespace {
+    /// @brief Native analog of a simple generator script: noise heightmap,
+    /// two biome parameters and no structures
+    class SampleScript : public GeneratorScript {
+        fnl_state noise = fnlCreateState();
+
+        /// @brief Noise rows are calculated with batch kernels
+        /// as heightmap:noise does
+        std::shared_ptr<Heightmap> noiseMap(
+            const glm::ivec2& offset,
+            const glm::ivec2& size,
+            uint bpd,
+            float frequency,
+            float base,
+            float scale
+        ) {
+            auto map = std::make_shared<Heightmap>(size.x, size.y);
+            float* values = map->getValues();
+            std::vector<float> xs(size.x);
+            std::vector<float> ys(size.x);
+            for (int z = 0; z < size.y; z++) {
+                for (int x = 0; x < size.x; x++) {
+                    xs[x] = (offset.x + x) * bpd * frequency;
+                    ys[x] = (offset.y + z) * bpd * frequency;
+                }
+                float* row = values + z * size.x;
+                simd::noise2d(noise, xs.data(), ys.data(), row, size.x);
+                simd::binop(simd::BinaryOp::MUL, row, scale, size.x);
+                simd::binop(simd::BinaryOp::ADD, row, base, size.x);
+            }
+            return map;
+        }
+    public:
+        void initialize(uint64_t seed) override {
+            noise.seed = static_cast<int>(seed);
+        }
+
+        std::unique_ptr<GeneratorScript> clone() const override {
+            return std::make_unique<SampleScript>();
+        }
+
+        std::shared_ptr<Heightmap> generateHeightmap(
+            const glm::ivec2& offset,
+            const glm::ivec2& size,
+            uint bpd,
+            const std::vector<std::shared_ptr<Heightmap>>&
+        ) override {
+            return noiseMap(offset, size, bpd, 0.5f, 0.25f, 0.1f);
+        }
+
+        std::vector<std::shared_ptr<Heightmap>> generateParameterMaps(
+            const glm::ivec2& offset, const glm::ivec2& size, uint bpd
+        ) override {
+            return {
+                noiseMap(offset, size, bpd, 0.1f, 0.5f, 0.5f),
+                noiseMap(offset + 1000, size, bpd, 0.2f, 0.5f, 0.5f)};
+        }
+
+        std::vector<Placement> placeStructuresWide(
+            const glm::ivec2&, const glm::ivec2&, uint
+        ) override {
+            return {};
+        }
+
+        std::vector<Placement> placeStructures(
+            const glm::ivec2&,
+            const glm::ivec2&,
+            const std::shared_ptr<Heightmap>&,
+            uint
+        ) override {
+            return {};
+        }
+    };
+}
+
+static Biome create_biome(
+    std::string name,
+    float temperature,
+    std::vector<BlocksLayer> groundLayers,
+    BiomeElementList plants
+) {
+    Biome biome {};
+    biome.name = std::move(name);
+    biome.parameters = {{temperature, 0.5f}, {0.5f, 1.0f}};
+    biome.plants = std::move(plants);
+    // resizeable layer is the last one
+    biome.groundLayers = {std::move(groundLayers), 0};
+    biome.seaLayers = {{{"bench:glass", -1, true, {}}}, 0};
+    return biome;
+}
+
+static std::unique_ptr<GeneratorDef> create_generator(const Content& content) {
+    auto def = std::make_unique<GeneratorDef>("bench:sample");
+    def->script = std::make_unique<SampleScript>();
+    def->seaLevel = 32;
+    def->biomeParameters = 2;
+    def->biomes.push_back(create_biome(
+        "hills",
+        0.3f,
+        {{"bench:dirt", 3, false, {}}, {"bench:stone", -1, true, {}}},
+        BiomeElementList({{"bench:lamp", 1.0f, {}}}, 0.01f)
+    ));
+    def->biomes.push_back(create_biome(
+        "rocks",
+        0.7f,
+        {{"bench:stone", -1, true, {}}},
+        BiomeElementList({}, 0.0f)
+    ));
+    def->prepare(&content);
+    return def;
+}
+
+/// @brief Enables SIMD kernels if the benchmark argument is non-zero
+/// (restored on destruction)
+class SimdScope {
+    bool enabled;
+public:
+    SimdScope(const benchmark::State& state) : enabled(simd::is_enabled()) {
+        simd::set_enabled(state.range(0) != 0);
+    }
+
+    ~SimdScope() {
+        simd::set_enabled(enabled);
+    }
+};
+
+/// @brief Chunks streaming along X axis, so every generated chunk
+/// requires new prototypes as when a player moves through the world.
+/// Argument: SIMD kernels enabled
+static void BM_WorldGenerator_generate(benchmark::State& state) {
+    SimdScope simdScope(state);
+    auto content = bench::create_content();
+    auto def = create_generator(*content);
+    WorldGenerator generator(*def, *content, 42);
+
+    Chunk chunk(0, 0);
+    int x = 0;
+    for (auto _ : state) {
+        generator.update(x, 0, 4);
+        generator.generate(chunk.voxels, x, 0);
+        benchmark::DoNotOptimize(chunk.voxels);
+        x++;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_WorldGenerator_generate)
+    ->ArgName("simd")
+    ->Arg(0)
+    ->Arg(1)
+    ->Unit(benchmark::kMillisecond);
+
+/// @brief Pregeneration worker job: tiles generated and lighted along
+/// X axis. Items processed are saved chunks, so items per second is
+/// pregeneration throughput of a single worker.
+/// Argument: SIMD kernels enabled
+static void BM_WorldPregenerator_tile(benchmark::State& state) {
+    constexpr int TILE_SIZE = WorldPregenerator::TILE_SIZE;
+    SimdScope simdScope(state);
+    auto content = bench::create_content();
+    auto def = create_generator(*content);
+    WorldGenerator generator(*def, *content, 42);
+
+    PregenJob job {{0, 0}, ~uint64_t(0)};
+    for (auto _ : state) {
+        auto tile = WorldPregenerator::generateTile(generator, *content, job);
+        benchmark::DoNotOptimize(tile.chunks.data());
+        job.pos.x += TILE_SIZE;
+    }
+    state.SetItemsProcessed(state.iterations() * TILE_SIZE * TILE_SIZE);
+}
+BENCHMARK(BM_WorldPregenerator_tile)
+    ->ArgName("simd")
+    ->Arg(0)
+    ->Arg(1)
+    ->Unit(benchmark::kMillisecond);
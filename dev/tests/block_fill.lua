@@ -0,0 +1,42 @@
+-- Fills a 64x64x64 area through block.set and clears it with block.fill
+-- (timings are measured by BM_fill_* benchmarks of VoxelEngineBench)
+local util = require "core:tests_util"
+util.create_demo_world()
+
+app.set_setting("chunks.load-distance", 5)
+app.set_setting("chunks.load-speed", 15)
+
+local pid = player.create("Xerxes")
+player.set_pos(pid, 32, 100, 32)
+for i=1,10 do
+    app.tick()
+end
+
+local SIZE = 64
+local Y = 64
+local stone = block.index("base:stone")
+
+local function check(id)
+    for y=Y,Y+SIZE-1,7 do
+        for z=0,SIZE-1,7 do
+            for x=0,SIZE-1,7 do
+                assert(block.get(x, y, z) == id)
+            end
+        end
+    end
+end
+
+for y=Y,Y+SIZE-1 do
+    for z=0,SIZE-1 do
+        for x=0,SIZE-1 do
+            block.set(x, y, z, stone)
+        end
+    end
+end
+check(stone)
+
+block.fill({0, Y, 0}, {SIZE-1, Y+SIZE-1, SIZE-1}, 0)
+check(0)
+
+app.close_world(false)
+app.delete_world("demo")
@@ -87,6 +87,8 @@ local Entity = {__index={
 }}
 
 local entities = {}
+-- components time is accounted to component names only
+local account_call = profiler.__account_call
 
 return {
     new_Entity = function(eid)
@@ -108,15 +110,23 @@ return {
             entities[eid] = nil;
         end
     end,
-    update = function(tps, parts, part)
+    update = function(tps, parts, part, suspended)
+        local accounting = profiler.is_accounting()
         for uid, entity in pairs(entities) do
-            if uid % parts ~= part then
+            if uid % parts ~= part or (suspended and suspended[uid]) then
                 goto continue
             end
-            for _, component in pairs(entity.components) do
+            for name, component in pairs(entity.components) do
                 local callback = component.on_update
                 if not component.__disabled and callback then
-                    local result, err = pcall(callback, tps)
+                    local result, err
+                    if accounting then
+                        result, err = pcall(
+                            account_call, name..".on_update", callback, tps
+                        )
+                    else
+                        result, err = pcall(callback, tps)
+                    end
                     if err then
                         debug.error(err)
                     end
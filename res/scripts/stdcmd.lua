@@ -291,6 +291,126 @@ console.add_command(
     end
 )
 
+console.add_command(
+    "world.pregen x1:int z1:int x2:int z2:int workers:int=0",
+    "Generate, light and save chunks area (chunk coordinates) in background",
+    function (args, kwargs)
+        local x1, z1, x2, z2, workers = unpack(args)
+        world.pregenerate(x1, z1, x2, z2, workers)
+        local w = math.abs(x2 - x1) + 1
+        local d = math.abs(z2 - z1) + 1
+        return "pregeneration of " .. tostring(w * d) .. " chunks started"
+    end
+)
+
+console.add_command(
+    "world.pregen.status",
+    "Show world pregeneration progress",
+    function (args, kwargs)
+        local progress = world.get_pregen_progress()
+        if progress == nil then
+            return "no active pregeneration"
+        end
+        return string.format(
+            "%s/%s chunks, %.1f chunks/s",
+            progress.done, progress.total, progress.speed
+        )
+    end
+)
+
+console.add_command(
+    "world.snapshot name:str",
+    "Save the world and write its copy to export:name (.zip - archive) in background",
+    function (args, kwargs)
+        local target = "export:" .. args[1]
+        world.snapshot(target)
+        return "writing snapshot to " .. target
+    end
+)
+
+console.add_command(
+    "profiler operation:[start|stop|save] name:str='trace'",
+    "Control tick profiler. save writes capture to export:name.json "..
+    "(Chrome trace format)",
+    function (args, kwargs)
+        local operation, name = unpack(args)
+        if operation == "start" then
+            profiler.start()
+            return "profiler capture started"
+        elseif operation == "stop" then
+            profiler.stop()
+            return string.format("profiler capture stopped: %s zones", profiler.count())
+        end
+        local target = "export:" .. name .. ".json"
+        profiler.save(target)
+        return "profiler capture written to " .. target
+    end
+)
+
+console.add_command(
+    "scripts.stats operation:[report|start|stop|reset] limit:int=10",
+    "Per-pack scripts time accounting",
+    function (args, kwargs)
+        local operation, limit = unpack(args)
+        if operation == "start" then
+            profiler.set_accounting(true)
+            return "scripts accounting started"
+        elseif operation == "stop" then
+            profiler.set_accounting(false)
+            return "scripts accounting stopped"
+        elseif operation == "reset" then
+            profiler.reset_accounting()
+            return "scripts accounting reset"
+        end
+        return profiler.accounting_report(limit)
+    end
+)
+
+console.add_command(
+    "metrics operation:[report|reset] prefix:str=''",
+    "Engine and scripts metrics (counters, gauges and histograms) "..
+    "with names starting with prefix. Reset affects scripts metrics only",
+    function (args, kwargs)
+        local operation, prefix = unpack(args)
+        if operation == "reset" then
+            metrics.reset()
+            return "scripts metrics reset"
+        end
+        return metrics.report(prefix)
+    end
+)
+
+console.add_command(
+    "world.record operation:[start|stop] name:str='session'",
+    "Record player inputs and interactions to export:name.vcrec with the "..
+    "world snapshot in export:name (replayed with --replay)",
+    function (args, kwargs)
+        local operation, name = unpack(args)
+        if operation == "stop" then
+            return string.format(
+                "recording finished: %s ticks", world.stop_recording()
+            )
+        end
+        local file = "export:" .. name .. ".vcrec"
+        world.start_recording(file, "export:" .. name)
+        return "recording session to " .. file
+    end
+)
+
+console.add_command(
+    "world.snapshot.status",
+    "Show world snapshot progress",
+    function (args, kwargs)
+        local progress = world.get_snapshot_progress()
+        if progress == nil then
+            return "no active snapshot"
+        end
+        return string.format(
+            "%s: %s/%s", progress.target, progress.done, progress.total
+        )
+    end
+)
+
 console.cheats = {
     "blocks.fill",
     "tp",
@@ -300,4 +420,5 @@ console.cheats = {
     "entity.despawn",
     "player.respawn",
     "weather.set",
+    "world.pregen",
 }
@@ -37,6 +37,8 @@ local function complete_app_lib(app)
     app.tick = coroutine.yield
     app.get_version = core.get_version
     app.get_setting_info = core.get_setting_info
+    app.get_tick_metrics = core.get_tick_metrics
+    app.export_tick_metrics = core.export_tick_metrics
     app.load_content = function()
         core.load_content()
         app.tick()
@@ -256,6 +258,7 @@ function session.reset_entry(name)
 end
 
 stdcomp = require "core:internal/stdcomp"
+profiler.__account_call = nil
 entities.get = stdcomp.get_Entity
 entities.get_all = function(uids)
     if uids == nil then
@@ -12,7 +12,10 @@
 #include "coders/obj.hpp"
 #include "coders/vec3.hpp"
 #include "constants.hpp"
+#include "content/ContentCache.hpp"
+#include "content/ContentControl.hpp"
 #include "debug/Logger.hpp"
+#include "engine/Engine.hpp"
 #include "io/engine_paths.hpp"
 #include "io/io.hpp"
 #include "frontend/UiDocument.hpp"
@@ -168,13 +171,27 @@ assetload::postfunc assetload::atlas(
         }
         return [](auto){};
     }
-    AtlasBuilder builder;
-    for (const auto& file : paths.listdir(directory)) {
-        if (!imageio::is_read_supported(file.extension())) continue;
-        if (!append_atlas(builder, file)) continue;
+    auto cache = loader->getEngine().getContentControl().getCache();
+    std::unique_ptr<Atlas> built;
+    if (cache) {
+        built = cache->getAtlas(directory);
     }
-    std::set<std::string> names = builder.getNames();
-    Atlas* atlas = builder.build(2, false).release();
+    if (built == nullptr) {
+        AtlasBuilder builder;
+        for (const auto& file : paths.listdir(directory)) {
+            if (!imageio::is_read_supported(file.extension())) continue;
+            if (!append_atlas(builder, file)) continue;
+        }
+        built = builder.build(2, false);
+        if (cache) {
+            cache->putAtlas(directory, *built);
+        }
+    }
+    std::set<std::string> names;
+    for (const auto& [regionName, _] : built->getRegions()) {
+        names.insert(regionName);
+    }
+    Atlas* atlas = built.release();
     return [=](auto assets) {
         atlas->prepare();
         assets->store(std::unique_ptr<Atlas>(atlas), name);
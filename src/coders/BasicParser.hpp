@@ -36,6 +36,11 @@ protected:
     dv::value parseNumber(int sign);
     dv::value parseNumber();
     StringT parseString(CharT chr, bool closeRequired = true);
+    /// @brief Parse closed string literal (see parseString). Literals
+    /// without escape sequences are returned as views of the source, others
+    /// are parsed to the buffer
+    /// @param buffer parsed literal storage reused between calls
+    StringViewT parseStringView(CharT chr, StringT& buffer);
 
     parsing_error error(const std::string& message);
 
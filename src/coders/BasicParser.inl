@@ -2,8 +2,10 @@
 
 #include <cmath>
 #include <sstream>
+#include <type_traits>
 
 #include "util/stringutil.hpp"
+#include "scanning.hpp"
 
 namespace {
     inline int is_box(int c) {
@@ -32,6 +34,16 @@ namespace {
 
 template<typename CharT>
 void BasicParser<CharT>::skipWhitespaceBasic(bool newline) {
+    if constexpr (std::is_same<CharT, char>()) {
+        // most calls are made with no whitespace to skip (see peek)
+        if (hasNext() && !is_whitespace(source[pos])) {
+            return;
+        }
+        pos = scanning::skip_whitespace(
+            source.data(), pos, source.length(), newline, line, linestart
+        );
+        return;
+    }
     while (hasNext()) {
         CharT next = source[pos];
         if (next == '\n') {
@@ -357,6 +369,16 @@ int64_t BasicParser<CharT>::parseSimpleInt(int base) {
     }
     int64_t value = index;
     pos++;
+    if constexpr (std::is_same<CharT, char>()) {
+        if (base == 10) {
+            size_t count =
+                scanning::count_digits(source.data(), pos, source.length());
+            for (size_t i = 0; i < count; i++) {
+                value = value * 10 + (source[pos + i] - '0');
+            }
+            pos += count;
+        }
+    }
     while (hasNext()) {
         c = source[pos];
         while (c == '_') {
@@ -458,19 +480,30 @@ template <typename CharT>
 std::basic_string<CharT> BasicParser<CharT>::parseString(
     CharT quote, bool closeRequired
 ) {
-    std::basic_stringstream<CharT> ss;
+    std::basic_string<CharT> str;
     while (hasNext()) {
+        if constexpr (std::is_same<CharT, char>()) {
+            // copy regular characters at once
+            size_t end = scanning::find_string_special(
+                source.data(), pos, source.length(), quote
+            );
+            str.append(source.data() + pos, end - pos);
+            pos = end;
+            if (!hasNext()) {
+                break;
+            }
+        }
         CharT c = source[pos];
         if (c == quote) {
             pos++;
-            return ss.str();
+            return str;
         }
         if (c == '\\') {
             pos++;
             c = nextChar();
             if (c >= '0' && c <= '7') {
                 pos--;
-                ss << (char)parseSimpleInt(8);
+                str += static_cast<CharT>(static_cast<char>(parseSimpleInt(8)));
                 continue;
             }
             if (c == 'u' || c == 'x') {
@@ -481,20 +514,20 @@ std::basic_string<CharT> BasicParser<CharT>::parseString(
                 for (int i = 0; i < 4; i++) {
                     chars[i] = bytes[i];
                 }
-                ss.write(chars, size);
+                str.append(chars, size);
                 continue;
             }
             switch (c) {
-                case 'n': ss << '\n'; break;
-                case 'r': ss << '\r'; break;
-                case 'b': ss << '\b'; break;
-                case 't': ss << '\t'; break;
-                case 'f': ss << '\f'; break;
-                case 'v': ss << '\v'; break;
-                case '\'': ss << '\''; break;
-                case '"': ss << '"'; break;
-                case '\\': ss << '\\'; break;
-                case '/': ss << '/'; break;
+                case 'n': str += '\n'; break;
+                case 'r': str += '\r'; break;
+                case 'b': str += '\b'; break;
+                case 't': str += '\t'; break;
+                case 'f': str += '\f'; break;
+                case 'v': str += '\v'; break;
+                case '\'': str += '\''; break;
+                case '"': str += '"'; break;
+                case '\\': str += '\\'; break;
+                case '/': str += '/'; break;
                 case '\n': continue;
                 default:
                     throw error(
@@ -508,13 +541,37 @@ std::basic_string<CharT> BasicParser<CharT>::parseString(
         if (c == '\n' && closeRequired) {
             throw error("non-closed string literal");
         }
-        ss << c;
+        str += c;
         pos++;
     }
     if (closeRequired) {
         throw error("unexpected end");
     }
-    return ss.str();
+    return str;
+}
+
+template <typename CharT>
+std::basic_string_view<CharT> BasicParser<CharT>::parseStringView(
+    CharT quote, std::basic_string<CharT>& buffer
+) {
+    size_t end = pos;
+    if constexpr (std::is_same<CharT, char>()) {
+        end = scanning::find_string_special(
+            source.data(), pos, source.length(), quote
+        );
+    } else {
+        while (end < source.length() && source[end] != quote &&
+               source[end] != '\\' && source[end] != '\n') {
+            end++;
+        }
+    }
+    if (end < source.length() && source[end] == quote) {
+        auto view = source.substr(pos, end - pos);
+        pos = end + 1;
+        return view;
+    }
+    buffer = parseString(quote);
+    return buffer;
 }
 
 template <>
@@ -12,7 +12,8 @@ using namespace json;
 static void to_binary(ByteBuilder& builder, const dv::value& value) {
     switch (value.getType()) {
         case dv::value_type::none:
-            throw std::runtime_error("none value is not implemented");
+            builder.put(BJSON_TYPE_NULL);
+            break;
         case dv::value_type::object: {
             const auto bytes = json::to_binary(value);
             builder.put(bytes.data(), bytes.size());
@@ -167,3 +168,309 @@ dv::value json::from_binary(const ubyte* src, size_t size) {
         return value_from_binary(reader);
     }
 }
+
+static void document_value_from_binary(
+    ByteReader& reader, dv::document_builder& builder
+) {
+    ubyte typecode = reader.get();
+    switch (typecode) {
+        case BJSON_TYPE_DOCUMENT: {
+            reader.getInt32();
+            size_t mark = builder.begin();
+            while (reader.peek() != BJSON_END) {
+                builder.key(reader.getCString());
+                document_value_from_binary(reader, builder);
+            }
+            reader.get();
+            builder.endObject(mark);
+            return;
+        }
+        case BJSON_TYPE_LIST: {
+            size_t mark = builder.begin();
+            while (reader.peek() != BJSON_END) {
+                document_value_from_binary(reader, builder);
+            }
+            reader.get();
+            builder.endList(mark);
+            return;
+        }
+        case BJSON_TYPE_BYTE:
+            builder.addInteger(reader.get());
+            return;
+        case BJSON_TYPE_INT16:
+            builder.addInteger(reader.getInt16());
+            return;
+        case BJSON_TYPE_INT32:
+            builder.addInteger(reader.getInt32());
+            return;
+        case BJSON_TYPE_INT64:
+            builder.addInteger(reader.getInt64());
+            return;
+        case BJSON_TYPE_NUMBER:
+            builder.addNumber(reader.getFloat64());
+            return;
+        case BJSON_TYPE_FALSE:
+        case BJSON_TYPE_TRUE:
+            builder.addBoolean((typecode - BJSON_TYPE_FALSE) != 0);
+            return;
+        case BJSON_TYPE_STRING: {
+            uint32_t length = static_cast<uint32_t>(reader.getInt32());
+            if (length > reader.remaining()) {
+                throw std::runtime_error("buffer underflow");
+            }
+            builder.addString(std::string_view(
+                reinterpret_cast<const char*>(reader.pointer()), length
+            ));
+            reader.skip(length);
+            return;
+        }
+        case BJSON_TYPE_NULL:
+            builder.addNone();
+            return;
+        case BJSON_TYPE_BYTES: {
+            int32_t size = reader.getInt32();
+            if (size < 0) {
+                throw std::runtime_error(
+                    "invalid byte-buffer size "+std::to_string(size));
+            }
+            if (static_cast<size_t>(size) > reader.remaining()) {
+                throw std::runtime_error(
+                    "buffer_size > remaining_size "+std::to_string(size));
+            }
+            builder.addBytes(reader.pointer(), size);
+            reader.skip(size);
+            return;
+        }
+    }
+    throw std::runtime_error(
+        "type support not implemented for <"+std::to_string(typecode)+">");
+}
+
+dv::document json::from_binary_document(const ubyte* src, size_t size) {
+    if (size < 2) {
+        throw std::runtime_error("bytes length is less than 2");
+    }
+    if (src[0] == gzip::MAGIC[0] && src[1] == gzip::MAGIC[1]) {
+        auto data = gzip::decompress(src, size);
+        return from_binary_document(data.data(), data.size());
+    }
+    ByteReader reader(src, size);
+    dv::document_builder builder;
+    document_value_from_binary(reader, builder);
+    return builder.build();
+}
+
+static std::vector<ubyte> decompress_if_needed(const ubyte* src, size_t size) {
+    if (size >= 2 && src[0] == gzip::MAGIC[0] && src[1] == gzip::MAGIC[1]) {
+        return gzip::decompress(src, size);
+    }
+    return {};
+}
+
+BinaryCursor::BinaryCursor(const ubyte* src, size_t size)
+    : decompressed(decompress_if_needed(src, size)),
+      reader(
+          decompressed.empty() ? src : decompressed.data(),
+          decompressed.empty() ? size : decompressed.size()
+      ) {
+}
+
+void BinaryCursor::throwTypeError(int expected) {
+    throw std::runtime_error(
+        "unexpected bjson type <" + std::to_string(reader.peek()) +
+        ">, expected <" + std::to_string(expected) + ">"
+    );
+}
+
+dv::value_type BinaryCursor::peekType() {
+    switch (reader.peek()) {
+        case BJSON_TYPE_DOCUMENT:
+            return dv::value_type::object;
+        case BJSON_TYPE_LIST:
+            return dv::value_type::list;
+        case BJSON_TYPE_BYTE:
+        case BJSON_TYPE_INT16:
+        case BJSON_TYPE_INT32:
+        case BJSON_TYPE_INT64:
+            return dv::value_type::integer;
+        case BJSON_TYPE_NUMBER:
+            return dv::value_type::number;
+        case BJSON_TYPE_FALSE:
+        case BJSON_TYPE_TRUE:
+            return dv::value_type::boolean;
+        case BJSON_TYPE_STRING:
+            return dv::value_type::string;
+        case BJSON_TYPE_BYTES:
+            return dv::value_type::bytes;
+        case BJSON_TYPE_NULL:
+            return dv::value_type::none;
+    }
+    throw std::runtime_error(
+        "type support not implemented for <" +
+        std::to_string(reader.peek()) + ">"
+    );
+}
+
+void BinaryCursor::enterObject() {
+    if (reader.peek() != BJSON_TYPE_DOCUMENT) {
+        throwTypeError(BJSON_TYPE_DOCUMENT);
+    }
+    reader.get();
+    reader.getInt32();
+}
+
+void BinaryCursor::enterList() {
+    if (reader.peek() != BJSON_TYPE_LIST) {
+        throwTypeError(BJSON_TYPE_LIST);
+    }
+    reader.get();
+}
+
+bool BinaryCursor::hasNext() {
+    if (reader.peek() == BJSON_END) {
+        reader.get();
+        return false;
+    }
+    return true;
+}
+
+std::string_view BinaryCursor::readKey() {
+    return reader.getCString();
+}
+
+dv::integer_t BinaryCursor::readInteger() {
+    switch (reader.peek()) {
+        case BJSON_TYPE_BYTE:
+            reader.get();
+            return reader.get();
+        case BJSON_TYPE_INT16:
+            reader.get();
+            return reader.getInt16();
+        case BJSON_TYPE_INT32:
+            reader.get();
+            return reader.getInt32();
+        case BJSON_TYPE_INT64:
+            reader.get();
+            return reader.getInt64();
+        case BJSON_TYPE_NUMBER:
+            reader.get();
+            return static_cast<dv::integer_t>(reader.getFloat64());
+    }
+    throwTypeError(BJSON_TYPE_INT64);
+}
+
+dv::number_t BinaryCursor::readNumber() {
+    if (reader.peek() == BJSON_TYPE_NUMBER) {
+        reader.get();
+        return reader.getFloat64();
+    }
+    return static_cast<dv::number_t>(readInteger());
+}
+
+dv::boolean_t BinaryCursor::readBoolean() {
+    ubyte typecode = reader.peek();
+    if (typecode != BJSON_TYPE_FALSE && typecode != BJSON_TYPE_TRUE) {
+        throwTypeError(BJSON_TYPE_TRUE);
+    }
+    reader.get();
+    return typecode == BJSON_TYPE_TRUE;
+}
+
+std::string_view BinaryCursor::readString() {
+    if (reader.peek() != BJSON_TYPE_STRING) {
+        throwTypeError(BJSON_TYPE_STRING);
+    }
+    reader.get();
+    uint32_t length = static_cast<uint32_t>(reader.getInt32());
+    if (length > reader.remaining()) {
+        throw std::runtime_error("buffer underflow");
+    }
+    std::string_view string(
+        reinterpret_cast<const char*>(reader.pointer()), length
+    );
+    reader.skip(length);
+    return string;
+}
+
+const ubyte* BinaryCursor::readBytes(size_t& size) {
+    if (reader.peek() != BJSON_TYPE_BYTES) {
+        throwTypeError(BJSON_TYPE_BYTES);
+    }
+    reader.get();
+    int32_t length = reader.getInt32();
+    if (length < 0 || static_cast<size_t>(length) > reader.remaining()) {
+        throw std::runtime_error(
+            "invalid byte-buffer size " + std::to_string(length)
+        );
+    }
+    const ubyte* bytes = reader.pointer();
+    reader.skip(length);
+    size = length;
+    return bytes;
+}
+
+static void skip_bytes(ByteReader& reader, size_t n) {
+    if (n > reader.remaining()) {
+        throw std::runtime_error("buffer underflow");
+    }
+    reader.skip(n);
+}
+
+void BinaryCursor::skip() {
+    ubyte typecode = reader.get();
+    switch (typecode) {
+        case BJSON_TYPE_DOCUMENT: {
+            const ubyte* start = reader.pointer() - 1;
+            int32_t size = reader.getInt32();
+            // size includes type byte and size field
+            size_t rest = size - 5;
+            if (size > 5 && rest <= reader.remaining() &&
+                start[size - 1] == BJSON_END) {
+                reader.skip(rest);
+                return;
+            }
+            while (hasNext()) {
+                readKey();
+                skip();
+            }
+            return;
+        }
+        case BJSON_TYPE_LIST:
+            while (hasNext()) {
+                skip();
+            }
+            return;
+        case BJSON_TYPE_BYTE:
+            skip_bytes(reader, 1);
+            return;
+        case BJSON_TYPE_INT16:
+            skip_bytes(reader, 2);
+            return;
+        case BJSON_TYPE_INT32:
+            skip_bytes(reader, 4);
+            return;
+        case BJSON_TYPE_INT64:
+        case BJSON_TYPE_NUMBER:
+            skip_bytes(reader, 8);
+            return;
+        case BJSON_TYPE_FALSE:
+        case BJSON_TYPE_TRUE:
+        case BJSON_TYPE_NULL:
+            return;
+        case BJSON_TYPE_STRING:
+        case BJSON_TYPE_BYTES: {
+            uint32_t length = static_cast<uint32_t>(reader.getInt32());
+            if (length > reader.remaining()) {
+                throw std::runtime_error("buffer underflow");
+            }
+            reader.skip(length);
+            return;
+        }
+    }
+    throw std::runtime_error(
+        "type support not implemented for <"+std::to_string(typecode)+">");
+}
+
+dv::value BinaryCursor::readValue() {
+    return value_from_binary(reader);
+}
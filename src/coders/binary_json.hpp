@@ -4,7 +4,9 @@
 #include <vector>
 
 #include "data/dv.hpp"
+#include "data/dv_document.hpp"
 
+#include "byte_utils.hpp"
 #include "typedefs.hpp"
 
 namespace json {
@@ -26,4 +28,76 @@ namespace json {
     std::vector<ubyte> to_binary(const dv::value& obj, bool compress = false);
     
     dv::value from_binary(const ubyte* src, size_t size);
+
+    /// @brief Read binary json directly into arena-backed document
+    dv::document from_binary_document(const ubyte* src, size_t size);
+
+    /// @brief Pull reader walking binary json in place without building
+    /// a tree. Strings and bytes are returned as views into the source
+    /// buffer (or decompressed copy of it), so they are valid while the
+    /// cursor and the source buffer are alive.
+    ///
+    /// Usage:
+    /// @code
+    /// cursor.enterObject();
+    /// while (cursor.hasNext()) {
+    ///     auto key = cursor.readKey();
+    ///     if (key == "name") {
+    ///         name = cursor.readString();
+    ///     } else {
+    ///         cursor.skip();
+    ///     }
+    /// }
+    /// @endcode
+    class BinaryCursor {
+        std::vector<ubyte> decompressed;
+        ByteReader reader;
+
+        [[noreturn]] void throwTypeError(int expected);
+    public:
+        /// @param src binary json (gzip-compressed input is decompressed)
+        BinaryCursor(const ubyte* src, size_t size);
+
+        /// @return type of the next value
+        dv::value_type peekType();
+
+        /// @brief Enter the next value which must be an object
+        void enterObject();
+        /// @brief Enter the next value which must be a list
+        void enterList();
+        /// @brief Check if current object or list has more entries.
+        /// Leaves the object or list (consumes terminator) if not
+        bool hasNext();
+
+        /// @brief Read the next object entry key
+        std::string_view readKey();
+
+        dv::integer_t readInteger();
+        /// @brief Read the next number (integer is converted)
+        dv::number_t readNumber();
+        dv::boolean_t readBoolean();
+        std::string_view readString();
+        /// @brief Read the next byte-buffer
+        /// @param size output buffer size
+        /// @return pointer to the buffer inside of the source
+        const ubyte* readBytes(size_t& size);
+
+        /// @brief Skip the next value. Objects are skipped using their
+        /// size field, lists are walked through
+        void skip();
+
+        /// @return position of the next value
+        size_t tell() const {
+            return reader.tell();
+        }
+
+        /// @brief Return to the position returned by tell(), e.g. to skip
+        /// a value which reading failed
+        void seek(size_t position) {
+            reader.seek(position);
+        }
+
+        /// @brief Read the next value as dv::value tree
+        dv::value readValue();
+    };
 }
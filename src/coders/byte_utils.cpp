@@ -219,3 +219,14 @@ const ubyte* ByteReader::pointer() const {
 void ByteReader::skip(size_t n) {
     pos += n;
 }
+
+size_t ByteReader::tell() const {
+    return pos;
+}
+
+void ByteReader::seek(size_t position) {
+    if (position > size) {
+        throw std::runtime_error("seek out of buffer");
+    }
+    pos = position;
+}
@@ -83,4 +83,8 @@ public:
 
     const ubyte* pointer() const;
     void skip(size_t n);
+    /// @return Number of bytes read
+    size_t tell() const;
+    /// @brief Move to the position returned by tell()
+    void seek(size_t position);
 };
@@ -22,6 +22,21 @@ namespace {
         dv::value parseObject();
         dv::value parseValue();
     };
+
+    class DocumentParser : BasicParser<char> {
+        dv::document_builder builder;
+        /// @brief Escaped strings storage, others are passed to the builder
+        /// as source views (keys are interned by the builder)
+        std::string buffer;
+    public:
+        DocumentParser(std::string_view filename, std::string_view source);
+
+        dv::document parse();
+    private:
+        void parseList();
+        void parseObject();
+        void parseValue();
+    };
 }
 
 inline void newline(
@@ -280,3 +295,120 @@ dv::value json::parse(
 dv::value json::parse(std::string_view source) {
     return parse("[string]", source);
 }
+
+DocumentParser::DocumentParser(
+    std::string_view filename, std::string_view source
+)
+    : BasicParser(filename, source) {
+}
+
+dv::document DocumentParser::parse() {
+    char next = peek();
+    if (next == '{') {
+        parseObject();
+    } else if (next == '[') {
+        parseList();
+    } else {
+        throw error("'{' or '[' expected");
+    }
+    return builder.build();
+}
+
+void DocumentParser::parseObject() {
+    expect('{');
+    size_t mark = builder.begin();
+    while (peek() != '}') {
+        if (peek() == '#') {
+            skipLine();
+            continue;
+        }
+        expect('"');
+        builder.key(parseStringView('"', buffer));
+        char next = peek();
+        if (next != ':') {
+            throw error("':' expected");
+        }
+        pos++;
+        parseValue();
+        next = peek();
+        if (next == ',') {
+            pos++;
+        } else if (next == '}') {
+            break;
+        } else {
+            throw error("',' expected");
+        }
+    }
+    pos++;
+    builder.endObject(mark);
+}
+
+void DocumentParser::parseList() {
+    expect('[');
+    size_t mark = builder.begin();
+    while (peek() != ']') {
+        if (peek() == '#') {
+            skipLine();
+            continue;
+        }
+        parseValue();
+
+        char next = peek();
+        if (next == ',') {
+            pos++;
+        } else if (next == ']') {
+            break;
+        } else {
+            throw error("',' expected");
+        }
+    }
+    pos++;
+    builder.endList(mark);
+}
+
+void DocumentParser::parseValue() {
+    char next = peek();
+    if (next == '-' || next == '+' || is_digit(next)) {
+        auto numeric = parseNumber();
+        if (numeric.isInteger()) {
+            builder.addInteger(numeric.asInteger());
+        } else {
+            builder.addNumber(numeric.asNumber());
+        }
+        return;
+    }
+    if (is_identifier_start(next)) {
+        std::string literal = parseName();
+        if (literal == "true") {
+            builder.addBoolean(true);
+        } else if (literal == "false") {
+            builder.addBoolean(false);
+        } else if (literal == "inf") {
+            builder.addNumber(INFINITY);
+        } else if (literal == "nan") {
+            builder.addNumber(NAN);
+        } else if (literal == "null") {
+            builder.addNone();
+        } else {
+            throw error("invalid keyword " + literal);
+        }
+        return;
+    }
+    if (next == '{') {
+        parseObject();
+    } else if (next == '[') {
+        parseList();
+    } else if (next == '"' || next == '\'') {
+        pos++;
+        builder.addString(parseStringView(next, buffer));
+    } else {
+        throw error("unexpected character '" + std::string({next}) + "'");
+    }
+}
+
+dv::document json::parse_document(
+    std::string_view filename, std::string_view source
+) {
+    DocumentParser parser(filename, source);
+    return parser.parse();
+}
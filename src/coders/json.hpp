@@ -10,6 +10,11 @@ namespace json {
     dv::value parse(std::string_view filename, std::string_view source);
     dv::value parse(std::string_view source);
 
+    /// @brief Parse json directly into arena-backed document
+    dv::document parse_document(
+        std::string_view filename, std::string_view source
+    );
+
     std::string stringify(
         const dv::value& value,
         bool nice,
@@ -0,0 +1,184 @@
+#include "scanning.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define SCANNING_SSE2
+#include <emmintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#endif
+
+#include "commons.hpp"
+
+#ifdef SCANNING_SSE2
+static bool enabled = true;
+
+static inline unsigned first_bit(unsigned mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return index;
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+static inline unsigned last_bit(unsigned mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanReverse(&index, mask);
+    return index;
+#else
+    return 31 - __builtin_clz(mask);
+#endif
+}
+
+static inline unsigned count_bits(unsigned mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    return __popcnt(mask);
+#else
+    return __builtin_popcount(mask);
+#endif
+}
+
+static inline unsigned char_mask(__m128i chars, char c) {
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(chars, _mm_set1_epi8(c)));
+}
+
+static size_t skip_whitespace_sse2(
+    const char* src,
+    size_t pos,
+    size_t end,
+    bool newlines,
+    unsigned& line,
+    unsigned& linestart
+) {
+    for (; pos + 16 <= end; pos += 16) {
+        __m128i chars =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + pos));
+        unsigned lf = char_mask(chars, '\n');
+        unsigned spaces = char_mask(chars, ' ') | char_mask(chars, '\r') |
+                          char_mask(chars, '\t') | char_mask(chars, '\f');
+        if (newlines) {
+            spaces |= lf;
+        }
+        unsigned other = ~spaces & 0xFFFF;
+        unsigned count = other ? first_bit(other) : 16;
+        // newlines before the first non-whitespace character
+        lf &= (1u << count) - 1;
+        if (newlines && lf) {
+            line += count_bits(lf);
+            linestart = pos + last_bit(lf) + 1;
+        }
+        if (other) {
+            return pos + count;
+        }
+    }
+    return pos;
+}
+
+static size_t find_string_special_sse2(
+    const char* src, size_t pos, size_t end, char quote
+) {
+    for (; pos + 16 <= end; pos += 16) {
+        __m128i chars =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + pos));
+        unsigned mask = char_mask(chars, quote) | char_mask(chars, '\\') |
+                        char_mask(chars, '\n');
+        if (mask) {
+            return pos + first_bit(mask);
+        }
+    }
+    return pos;
+}
+
+static size_t count_digits_sse2(const char* src, size_t pos, size_t end) {
+    size_t start = pos;
+    for (; pos + 16 <= end; pos += 16) {
+        __m128i chars =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + pos));
+        __m128i digits = _mm_and_si128(
+            _mm_cmpgt_epi8(chars, _mm_set1_epi8('0' - 1)),
+            _mm_cmplt_epi8(chars, _mm_set1_epi8('9' + 1))
+        );
+        unsigned other = ~_mm_movemask_epi8(digits) & 0xFFFF;
+        if (other) {
+            return pos + first_bit(other) - start;
+        }
+    }
+    return pos - start;
+}
+#else
+static bool enabled = false;
+#endif
+
+bool scanning::is_enabled() {
+    return enabled;
+}
+
+void scanning::set_enabled(bool flag) {
+#ifdef SCANNING_SSE2
+    enabled = flag;
+#endif
+}
+
+size_t scanning::skip_whitespace(
+    const char* src,
+    size_t pos,
+    size_t end,
+    bool newlines,
+    unsigned& line,
+    unsigned& linestart
+) {
+#ifdef SCANNING_SSE2
+    if (enabled) {
+        pos = skip_whitespace_sse2(src, pos, end, newlines, line, linestart);
+    }
+#endif
+    for (; pos < end; pos++) {
+        char c = src[pos];
+        if (c == '\n') {
+            if (!newlines) {
+                break;
+            }
+            line++;
+            linestart = pos + 1;
+        } else if (!is_whitespace(c)) {
+            break;
+        }
+    }
+    return pos;
+}
+
+size_t scanning::find_string_special(
+    const char* src, size_t pos, size_t end, char quote
+) {
+#ifdef SCANNING_SSE2
+    if (enabled) {
+        pos = find_string_special_sse2(src, pos, end, quote);
+    }
+#endif
+    for (; pos < end; pos++) {
+        char c = src[pos];
+        if (c == quote || c == '\\' || c == '\n') {
+            break;
+        }
+    }
+    return pos;
+}
+
+size_t scanning::count_digits(const char* src, size_t pos, size_t end) {
+    size_t count = 0;
+#ifdef SCANNING_SSE2
+    if (enabled) {
+        count = count_digits_sse2(src, pos, end);
+        if (pos + count < end && !is_digit(src[pos + count])) {
+            return count;
+        }
+    }
+#endif
+    while (pos + count < end && is_digit(src[pos + count])) {
+        count++;
+    }
+    return count;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <stddef.h>
+
+/// @brief Text scanning kernels used by parsers. SSE2 is used on x86-64,
+/// scalar implementation otherwise.
+namespace scanning {
+    /// @return true if vectorized kernels are used
+    bool is_enabled();
+
+    /// @brief Enable or disable vectorized kernels (for testing and
+    /// benchmarking). Has no effect if SSE2 is not available.
+    void set_enabled(bool flag);
+
+    /// @brief Skip whitespace characters (see is_whitespace)
+    /// @param src source text
+    /// @param pos start position
+    /// @param end source length
+    /// @param newlines skip line separators too (stop at '\n' otherwise)
+    /// @param line incremented for each skipped '\n'
+    /// @param linestart set to position after the last skipped '\n'
+    /// @return position of the first non-whitespace character or end
+    size_t skip_whitespace(
+        const char* src,
+        size_t pos,
+        size_t end,
+        bool newlines,
+        unsigned& line,
+        unsigned& linestart
+    );
+
+    /// @return position of the first quote, '\\' or '\n' character
+    /// starting from pos, or end if not found
+    size_t find_string_special(
+        const char* src, size_t pos, size_t end, char quote
+    );
+
+    /// @return number of decimal digits starting from pos
+    size_t count_digits(const char* src, size_t pos, size_t end);
+}
@@ -0,0 +1,247 @@
+#include "ContentCache.hpp"
+
+#include <algorithm>
+#include <tuple>
+
+#include "coders/binary_json.hpp"
+#include "constants.hpp"
+#include "ContentPack.hpp"
+#include "debug/Logger.hpp"
+#include "graphics/core/Atlas.hpp"
+#include "graphics/core/ImageData.hpp"
+
+static debug::Logger logger("content-cache");
+
+static constexpr uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325ULL;
+static constexpr uint64_t FNV_PRIME = 0x100000001b3ULL;
+
+static void hash_bytes(uint64_t& hash, const void* data, size_t size) {
+    auto bytes = reinterpret_cast<const ubyte*>(data);
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * FNV_PRIME;
+    }
+}
+
+static void hash_string(uint64_t& hash, const std::string& str) {
+    // include terminator to separate adjacent strings
+    hash_bytes(hash, str.c_str(), str.length() + 1);
+}
+
+template <typename T>
+static void hash_value(uint64_t& hash, T value) {
+    hash_bytes(hash, &value, sizeof(T));
+}
+
+using FileStat = std::tuple<std::string, size_t, int64_t>;
+
+static void collect_files(
+    const io::path& folder,
+    const std::string& prefix,
+    std::vector<FileStat>& files
+) {
+    for (const auto& file : io::directory_iterator(folder)) {
+        auto name = prefix + file.name();
+        if (io::is_directory(file)) {
+            collect_files(file, name + "/", files);
+        } else {
+            files.emplace_back(
+                name,
+                io::file_size(file),
+                io::last_write_time(file).time_since_epoch().count()
+            );
+        }
+    }
+}
+
+uint64_t ContentCache::computeKey(const std::vector<ContentPack>& packs) {
+    uint64_t hash = FNV_OFFSET_BASIS;
+    hash_string(hash, ENGINE_VERSION_STRING);
+    hash_value(hash, FORMAT_VERSION);
+
+    std::vector<FileStat> files;
+    for (const auto& pack : packs) {
+        hash_string(hash, pack.id);
+        hash_string(hash, pack.folder.string());
+        if (!io::is_directory(pack.folder)) {
+            continue;
+        }
+        files.clear();
+        collect_files(pack.folder, "", files);
+        // directory iteration order is unspecified
+        std::sort(files.begin(), files.end());
+        for (const auto& [name, size, mtime] : files) {
+            hash_string(hash, name);
+            hash_value(hash, static_cast<uint64_t>(size));
+            hash_value(hash, mtime);
+        }
+    }
+    return hash;
+}
+
+ContentCache::ContentCache(io::path file, const std::vector<ContentPack>& packs)
+    : file(std::move(file)), key(computeKey(packs)) {
+    if (!io::is_regular_file(this->file)) {
+        logger.info() << "no content cache found";
+        return;
+    }
+    try {
+        readFile();
+    } catch (const std::runtime_error& err) {
+        logger.error() << "could not read content cache: " << err.what();
+        definitions = dv::object();
+        scripts = dv::object();
+        atlases = dv::object();
+    }
+}
+
+ContentCache::~ContentCache() = default;
+
+void ContentCache::readFile() {
+    auto root = io::read_binary_json(file);
+    int format = 0;
+    root.at("format").get(format);
+    integer_t storedKey = 0;
+    root.at("key").get(storedKey);
+    if (format != FORMAT_VERSION ||
+        static_cast<uint64_t>(storedKey) != key) {
+        logger.info() << "content cache is outdated";
+        modified = true;
+        return;
+    }
+    definitions = root["definitions"];
+    scripts = root["scripts"];
+    atlases = root["atlases"];
+    logger.info() << "content cache loaded: " << definitions.size()
+                  << " definitions, " << scripts.size() << " scripts, "
+                  << atlases.size() << " atlases";
+}
+
+template <typename Reader>
+dv::value ContentCache::read(const io::path& file, Reader reader) {
+    auto name = file.string();
+    {
+        std::lock_guard lock(mutex);
+        if (definitions.has(name)) {
+            hits++;
+            const auto& bytes = definitions[name].asBytes();
+            return json::from_binary(bytes.data(), bytes.size());
+        }
+        misses++;
+    }
+    auto value = reader(file);
+    if (!value.isObject()) {
+        return value;
+    }
+    auto bytes = json::to_binary(value);
+    std::lock_guard lock(mutex);
+    definitions[name] = std::make_shared<dv::objects::Bytes>(
+        bytes.data(), bytes.size()
+    );
+    modified = true;
+    return value;
+}
+
+dv::value ContentCache::readJson(const io::path& file) {
+    return read(file, io::read_json);
+}
+
+dv::value ContentCache::readObject(const io::path& file) {
+    return read(file, io::read_object);
+}
+
+std::optional<std::string> ContentCache::getScript(const io::path& file) {
+    auto name = file.string();
+    std::lock_guard lock(mutex);
+    if (!scripts.has(name)) {
+        misses++;
+        return std::nullopt;
+    }
+    hits++;
+    const auto& bytes = scripts[name].asBytes();
+    return std::string(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+}
+
+void ContentCache::putScript(const io::path& file, const std::string& bytecode) {
+    std::lock_guard lock(mutex);
+    scripts[file.string()] = std::make_shared<dv::objects::Bytes>(
+        reinterpret_cast<const ubyte*>(bytecode.data()), bytecode.size()
+    );
+    modified = true;
+}
+
+std::unique_ptr<Atlas> ContentCache::getAtlas(const std::string& name) {
+    std::lock_guard lock(mutex);
+    if (!atlases.has(name)) {
+        misses++;
+        return nullptr;
+    }
+    const auto& map = atlases[name];
+    auto format = static_cast<ImageFormat>(map["format"].asInteger());
+    uint width = map["width"].asInteger();
+    uint height = map["height"].asInteger();
+    const auto& pixels = map["pixels"].asBytes();
+    size_t channels = format == ImageFormat::rgba8888 ? 4 : 3;
+    if (pixels.size() != width * height * channels) {
+        logger.error() << "invalid cached atlas " << name;
+        misses++;
+        return nullptr;
+    }
+    std::unordered_map<std::string, UVRegion> regions;
+    for (const auto& [regionName, uv] : map["regions"].asObject()) {
+        regions[regionName] = UVRegion(
+            uv[0].asNumber(), uv[1].asNumber(), uv[2].asNumber(), uv[3].asNumber()
+        );
+    }
+    hits++;
+    return std::make_unique<Atlas>(
+        std::make_unique<ImageData>(format, width, height, pixels.data()),
+        std::move(regions),
+        false
+    );
+}
+
+void ContentCache::putAtlas(const std::string& name, const Atlas& atlas) {
+    auto image = atlas.getImage();
+    size_t channels = image->getFormat() == ImageFormat::rgba8888 ? 4 : 3;
+    auto map = dv::object();
+    map["format"] = static_cast<integer_t>(image->getFormat());
+    map["width"] = image->getWidth();
+    map["height"] = image->getHeight();
+    map["pixels"] = std::make_shared<dv::objects::Bytes>(
+        image->getData(), image->getWidth() * image->getHeight() * channels
+    );
+    auto& regions = map.object("regions");
+    for (const auto& [regionName, uv] : atlas.getRegions()) {
+        auto& list = regions.list(regionName);
+        list.add(uv.u1);
+        list.add(uv.v1);
+        list.add(uv.u2);
+        list.add(uv.v2);
+    }
+    std::lock_guard lock(mutex);
+    atlases[name] = std::move(map);
+    modified = true;
+}
+
+void ContentCache::save() {
+    std::lock_guard lock(mutex);
+    logger.info() << "content cache: " << hits << " hits, " << misses
+                  << " misses";
+    if (!modified) {
+        return;
+    }
+    auto root = dv::object();
+    root["format"] = FORMAT_VERSION;
+    root["key"] = static_cast<integer_t>(key);
+    root["definitions"] = definitions;
+    root["scripts"] = scripts;
+    root["atlases"] = atlases;
+    try {
+        io::create_directories(file.parent());
+        // uncompressed for faster startup
+        io::write_binary_json(file, root);
+        modified = false;
+    } catch (const std::runtime_error& err) {
+        logger.error() << "could not write content cache: " << err.what();
+    }
+}
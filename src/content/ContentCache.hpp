@@ -0,0 +1,76 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "data/dv.hpp"
+#include "io/io.hpp"
+#include "typedefs.hpp"
+
+struct ContentPack;
+class Atlas;
+
+/// @brief On-disk cache of compiled content used to speed up startup.
+///
+/// Stores parsed definition files (as binary json), content scripts
+/// bytecode and packed atlases (raster and UV regions). The cache is
+/// bound to a key hashed from the engine version and the packs files
+/// (relative paths, sizes and modification times). If the key does not
+/// match the stored one, the cache is discarded and filled again by the
+/// full load. Thread-safe.
+class ContentCache {
+    io::path file;
+    uint64_t key;
+    bool modified = false;
+    size_t hits = 0;
+    size_t misses = 0;
+    std::mutex mutex;
+
+    /// @brief Definition file -> binary json
+    dv::value definitions = dv::object();
+    /// @brief Script file -> bytecode
+    dv::value scripts = dv::object();
+    /// @brief Atlas name -> {width, height, format, pixels, regions}
+    dv::value atlases = dv::object();
+
+    void readFile();
+
+    template <typename Reader>
+    dv::value read(const io::path& file, Reader reader);
+public:
+    /// @brief Increment on cache file structure changes
+    static constexpr int FORMAT_VERSION = 1;
+    static inline const io::path DEFAULT_FILE = "user:cache/content.bjson";
+
+    /// @param file cache file
+    /// @param packs all loaded packs including core
+    ContentCache(io::path file, const std::vector<ContentPack>& packs);
+    ~ContentCache();
+
+    /// @brief Cached io::read_json
+    dv::value readJson(const io::path& file);
+
+    /// @brief Cached io::read_object
+    dv::value readObject(const io::path& file);
+
+    /// @return script bytecode if cached
+    std::optional<std::string> getScript(const io::path& file);
+    void putScript(const io::path& file, const std::string& bytecode);
+
+    /// @return unprepared atlas if cached
+    std::unique_ptr<Atlas> getAtlas(const std::string& name);
+    void putAtlas(const std::string& name, const Atlas& atlas);
+
+    /// @brief Write cache file if modified
+    void save();
+
+    uint64_t getKey() const {
+        return key;
+    }
+
+    /// @brief Hash engine version and packs files metadata
+    static uint64_t computeKey(const std::vector<ContentPack>& packs);
+};
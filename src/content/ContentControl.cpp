@@ -5,6 +5,7 @@
 #include "Content.hpp"
 #include "ContentPack.hpp"
 #include "ContentBuilder.hpp"
+#include "ContentCache.hpp"
 #include "ContentLoader.hpp"
 #include "PacksManager.hpp"
 #include "objects/rigging.hpp"
@@ -104,17 +105,30 @@ void ContentControl::loadContent() {
         resRoots.push_back({pack.id, pack.folder});
     }
     paths.resPaths = ResPaths(resRoots);
-    // Load content
-    for (auto& pack : allPacks) {
-        ContentLoader(&pack, contentBuilder, paths.resPaths).load();
-        load_configs(input, pack.folder);
-    }
-    content = contentBuilder.build();
-    scripting::on_content_load(content.get());
-
-    ContentLoader::loadScripts(*content);
 
-    postContent();
+    cache = std::make_unique<ContentCache>(
+        ContentCache::DEFAULT_FILE, allPacks
+    );
+    try {
+        // Load content
+        for (auto& pack : allPacks) {
+            ContentLoader(&pack, contentBuilder, paths.resPaths, *cache)
+                .load();
+            load_configs(input, pack.folder);
+        }
+        content = contentBuilder.build();
+        scripting::on_content_load(content.get());
+
+        ContentLoader::loadScripts(*content);
+
+        postContent();
+    } catch (...) {
+        cache.reset();
+        throw;
+    }
+    cache->save();
+    // scripts reloaded later must not be taken from the cache
+    cache.reset();
 }
 
 std::vector<ContentPack>& ContentControl::getContentPacks() {
@@ -127,6 +141,10 @@ std::vector<ContentPack> ContentControl::getAllContentPacks() {
     return packs;
 }
 
+ContentCache* ContentControl::getCache() {
+    return cache.get();
+}
+
 PacksManager& ContentControl::scan() {
     manager->scan();
     return *manager;
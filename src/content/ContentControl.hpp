@@ -11,6 +11,7 @@ class Content;
 class PacksManager;
 class EnginePaths;
 class Input;
+class ContentCache;
 
 namespace io {
     class path;
@@ -40,6 +41,10 @@ public:
     std::vector<ContentPack> getAllContentPacks();
 
     PacksManager& scan();
+
+    /// @brief Get compiled content cache
+    /// @return nullptr if content is not being loaded
+    ContentCache* getCache();
 private:
     EnginePaths& paths;
     Input& input;
@@ -48,4 +53,6 @@ private:
     std::vector<std::string> basePacks;
     std::unique_ptr<PacksManager> manager;
     std::vector<ContentPack> contentPacks;
+    /// @brief Exists only while content and its assets are loaded
+    std::unique_ptr<ContentCache> cache;
 };
@@ -7,6 +7,7 @@
 
 #include "loading/ContentUnitLoader.hpp"
 #include "ContentBuilder.hpp"
+#include "ContentCache.hpp"
 #include "ContentPack.hpp"
 #include "debug/Logger.hpp"
 #include "logic/scripting/scripting.hpp"
@@ -18,9 +19,12 @@
 static debug::Logger logger("content-loader");
 
 ContentLoader::ContentLoader(
-    ContentPack* pack, ContentBuilder& builder, const ResPaths& paths
+    ContentPack* pack,
+    ContentBuilder& builder,
+    const ResPaths& paths,
+    ContentCache& cache
 )
-    : pack(pack), builder(builder), paths(paths) {
+    : pack(pack), builder(builder), paths(paths), cache(cache) {
     auto runtime = std::make_unique<ContentPackRuntime>(
         *pack, scripting::create_pack_environment(*pack)
     );
@@ -33,7 +37,8 @@ ContentLoader::ContentLoader(
 static void detect_defs(
     const io::path& folder,
     const std::string& prefix,
-    std::vector<std::string>& detected
+    std::vector<std::string>& detected,
+    ContentCache* cache
 ) {
     if (!io::is_directory(folder)) {
         return;
@@ -44,11 +49,12 @@ static void detect_defs(
             continue;
         }
         if (io::is_regular_file(file) && io::is_data_file(file)) {
-            auto map = io::read_object(file);
+            // parsed to validate the file
+            auto map = cache ? cache->readObject(file) : io::read_object(file);
             std::string id = prefix.empty() ? name : prefix + ":" + name;
             detected.emplace_back(id);
         } else if (io::is_directory(file) && file.extension() != ".files") {
-            detect_defs(file, name, detected);
+            detect_defs(file, name, detected, cache);
         }
     }
 }
@@ -94,10 +100,11 @@ std::vector<std::tuple<std::string, std::string>> ContentLoader::scanContent(
 bool ContentLoader::fixPackIndices(
     const io::path& folder,
     dv::value& indicesRoot,
-    const std::string& contentSection
+    const std::string& contentSection,
+    ContentCache* cache
 ) {
     std::vector<std::string> detected;
-    detect_defs(folder, "", detected);
+    detect_defs(folder, "", detected, cache);
 
     std::vector<std::string> indexed;
     bool modified = false;
@@ -139,9 +146,9 @@ void ContentLoader::fixPackIndices() {
     }
 
     bool modified = false;
-    modified |= fixPackIndices(blocksFolder, root, "blocks");
-    modified |= fixPackIndices(itemsFolder, root, "items");
-    modified |= fixPackIndices(entitiesFolder, root, "entities");
+    modified |= fixPackIndices(blocksFolder, root, "blocks", &cache);
+    modified |= fixPackIndices(itemsFolder, root, "items", &cache);
+    modified |= fixPackIndices(entitiesFolder, root, "entities", &cache);
 
     if (modified) {
         // rewrite modified json
@@ -186,7 +193,7 @@ void ContentUnitLoader<DefT>::loadUnit(
 void ContentLoader::loadBlockMaterial(
     BlockMaterial& def, const io::path& file
 ) {
-    def.deserialize(io::read_json(file));
+    def.deserialize(cache.readJson(file));
     if (def.hitSound.empty()) {
         def.hitSound = def.stepsSound;
     }
@@ -205,7 +212,7 @@ void ContentUnitLoader<DefT>::loadDefs(const dv::value& root) {
         auto configFile = pack.folder / (prefix + "/" + name + ".json");
         std::string parent;
         if (io::exists(configFile)) {
-            auto root = io::read_json(configFile);
+            auto root = cache.readJson(configFile);
             root.at("parent").get(parent);
         }
         return parent;
@@ -278,7 +285,7 @@ void ContentLoader::loadContent(const dv::value& root) {
         builder.entities.defs.size(),
     };
 
-    ContentUnitLoader<Block>(*pack, builder.blocks, "blocks", 
+    ContentUnitLoader<Block>(*pack, builder.blocks, cache, "blocks",
         [this](Block& def) {
         if (!def.hidden) {
             bool created;
@@ -295,8 +302,9 @@ void ContentLoader::loadContent(const dv::value& root) {
         }
     }).loadDefs(root);
 
-    ContentUnitLoader(*pack, builder.items, "items").loadDefs(root);
-    ContentUnitLoader(*pack, builder.entities, "entities").loadDefs(root);
+    ContentUnitLoader(*pack, builder.items, cache, "items").loadDefs(root);
+    ContentUnitLoader(*pack, builder.entities, cache, "entities")
+        .loadDefs(root);
 
     stats->totalBlocks = builder.blocks.defs.size() - prevStats.totalBlocks;
     stats->totalItems = builder.items.defs.size() - prevStats.totalItems;
@@ -357,7 +365,7 @@ void ContentLoader::load() {
     // Load pack resources.json
     io::path resourcesFile = folder / "resources.json";
     if (io::exists(resourcesFile)) {
-        auto resRoot = io::read_json(resourcesFile);
+        auto resRoot = cache.readJson(resourcesFile);
         for (const auto& [key, arr] : resRoot.asObject()) {
             ResourceType type;
             if (ResourceTypeMeta.getItem(key, type)) {
@@ -372,7 +380,7 @@ void ContentLoader::load() {
     // Load pack resources aliases
     io::path aliasesFile = folder / "resource-aliases.json";
     if (io::exists(aliasesFile)) {
-        auto resRoot = io::read_json(aliasesFile);
+        auto resRoot = cache.readJson(aliasesFile);
         for (const auto& [key, arr] : resRoot.asObject()) {
             ResourceType type;
             if (ResourceTypeMeta.getItem(key, type)) {
@@ -17,6 +17,7 @@ struct GeneratorDef;
 class ResPaths;
 class Content;
 class ContentBuilder;
+class ContentCache;
 class ContentPackRuntime;
 struct ContentPackStats;
 
@@ -27,11 +28,12 @@ class ContentLoader {
     ContentBuilder& builder;
     ContentPackStats* stats;
     const ResPaths& paths;
+    ContentCache& cache;
 
     void loadGenerator(
         GeneratorDef& def, const std::string& full, const std::string& name
     );
-    static void loadBlockMaterial(BlockMaterial& def, const io::path& file);
+    void loadBlockMaterial(BlockMaterial& def, const io::path& file);
     void loadResources(ResourceType type, const dv::value& list);
     void loadResourceAliases(ResourceType type, const dv::value& aliases);
 
@@ -40,14 +42,16 @@ public:
     ContentLoader(
         ContentPack* pack,
         ContentBuilder& builder,
-        const ResPaths& paths
+        const ResPaths& paths,
+        ContentCache& cache
     );
 
     // Refresh pack content.json
     static bool fixPackIndices(
         const io::path& folder,
         dv::value& indicesRoot,
-        const std::string& contentSection
+        const std::string& contentSection,
+        ContentCache* cache = nullptr
     );
 
     static std::vector<std::tuple<std::string, std::string>> scanContent(
@@ -1,6 +1,11 @@
 #include "ContentReport.hpp"
 
+#include <zlib.h>
+
+#include <algorithm>
+#include <iomanip>
 #include <memory>
+#include <sstream>
 
 #include "coders/json.hpp"
 #include "constants.hpp"
@@ -143,3 +148,36 @@ std::vector<ContentEntry> ContentReport::getMissingContent() const {
     items.getMissingContent(entries);
     return entries;
 }
+
+template <class T, class U>
+static void write_lut(std::ostream& stream, const ContentUnitLUT<T, U>& lut) {
+    stream << lut.count() << '\n';
+    for (size_t i = 0; i < lut.count(); i++) {
+        stream << lut.getName(i) << ' ' << lut.getId(i) << '\n';
+    }
+}
+
+std::string ContentReport::getFingerprint() const {
+    std::stringstream ss;
+    ss << regionsVersion << '\n';
+    write_lut(ss, blocks);
+    write_lut(ss, items);
+
+    std::vector<std::string> layouts;
+    for (const auto& [name, _] : blocksDataLayouts) {
+        layouts.push_back(name);
+    }
+    std::sort(layouts.begin(), layouts.end());
+    for (const auto& name : layouts) {
+        ss << name << ' '
+           << json::stringify(blocksDataLayouts.at(name).serialize(), false)
+           << '\n';
+    }
+    auto text = ss.str();
+    uLong crc = crc32(
+        0L, reinterpret_cast<const Bytef*>(text.data()), text.length()
+    );
+    std::stringstream hex;
+    hex << std::hex << std::setw(8) << std::setfill('0') << crc;
+    return hex.str();
+}
@@ -165,4 +165,9 @@ public:
 
     const std::vector<ContentIssue>& getIssues() const;
     std::vector<ContentEntry> getMissingContent() const;
+
+    /// @brief Get checksum of the indices mapping, regions version and
+    /// blocks data layouts. Equal reports produce equal fingerprints
+    /// @return hex string
+    std::string getFingerprint() const;
 };
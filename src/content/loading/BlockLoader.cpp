@@ -2,6 +2,7 @@
 #include "ContentUnitLoader.hpp"
 
 #include "../ContentBuilder.hpp"
+#include "../ContentCache.hpp"
 #include "coders/json.hpp"
 #include "core_defs.hpp"
 #include "data/dv.hpp"
@@ -43,7 +44,7 @@ static void perform_user_block_fields(
 template<> void ContentUnitLoader<Block>::loadUnit(
     Block& def, const std::string& name, const io::path& file
 ) {
-    auto root = io::read_json(file);
+    auto root = cache.readJson(file);
     if (def.properties == nullptr) {
         def.properties = dv::object();
         def.properties["name"] = name;
@@ -217,6 +217,7 @@ void ContentLoader::loadGenerator(
 
     map.at("sea-level").get(def.seaLevel);
     map.at("wide-structs-chunks-radius").get(def.wideStructsChunksRadius);
+    map.at("area-chunks").get(def.areaChunks);
     if (map.has("heightmap-inputs")) {
         for (const auto& element : map["heightmap-inputs"]) {
             int index = element.asInteger();
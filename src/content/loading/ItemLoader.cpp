@@ -2,6 +2,7 @@
 #include "ContentUnitLoader.hpp"
 
 #include "../ContentBuilder.hpp"
+#include "../ContentCache.hpp"
 #include "coders/json.hpp"
 #include "core_defs.hpp"
 #include "data/dv.hpp"
@@ -15,7 +16,7 @@ static debug::Logger logger("item-content-loader");
 template<> void ContentUnitLoader<ItemDef>::loadUnit(
     ItemDef& def, const std::string& name, const io::path& file
 ) {
-    auto root = io::read_json(file);
+    auto root = cache.readJson(file);
     def.properties = root;
 
     if (root.has("parent")) {
@@ -0,0 +1,350 @@
+#include "dv_document.hpp"
+
+#include <algorithm>
+
+#include "util/Buffer.hpp"
+
+namespace dv {
+    static const node NONE_NODE {};
+
+    arena::arena(size_t firstBlockSize) : nextBlockSize(firstBlockSize) {
+    }
+
+    void* arena::allocate(size_t size, size_t alignment) {
+        if (size == 0) {
+            return nullptr;
+        }
+        size_t padding = (alignment - reinterpret_cast<uintptr_t>(current) %
+                                          alignment) % alignment;
+        if (current == nullptr || padding + size > remaining) {
+            // oversized allocations get their own block
+            size_t blockSize = std::max(nextBlockSize, size + alignment);
+            blocks.push_back(std::make_unique<byte_t[]>(blockSize));
+            current = blocks.back().get();
+            remaining = blockSize;
+            allocated += blockSize;
+            nextBlockSize = std::min(nextBlockSize * 2, MAX_BLOCK_SIZE);
+            padding = (alignment - reinterpret_cast<uintptr_t>(current) %
+                                       alignment) % alignment;
+        }
+        byte_t* ptr = current + padding;
+        current += padding + size;
+        remaining -= padding + size;
+        return ptr;
+    }
+
+    integer_t view::asInteger() const {
+        if (ptr->type == value_type::integer) {
+            return ptr->val.integer;
+        } else if (ptr->type == value_type::number) {
+            return static_cast<integer_t>(ptr->val.number);
+        }
+        throw_type_error(ptr->type, value_type::integer);
+        return 0; // unreachable
+    }
+
+    number_t view::asNumber() const {
+        if (ptr->type == value_type::number) {
+            return ptr->val.number;
+        } else if (ptr->type == value_type::integer) {
+            return static_cast<number_t>(ptr->val.integer);
+        }
+        throw_type_error(ptr->type, value_type::number);
+        return 0; // unreachable
+    }
+
+    boolean_t view::asBoolean() const {
+        if (ptr->type == value_type::none) {
+            return false;
+        }
+        check_type(ptr->type, value_type::boolean);
+        return ptr->val.boolean;
+    }
+
+    std::string_view view::asString() const {
+        check_type(ptr->type, value_type::string);
+        return ptr->str();
+    }
+
+    const byte_t* view::asBytes() const {
+        check_type(ptr->type, value_type::bytes);
+        return ptr->val.bytes;
+    }
+
+    view view::operator[](size_t index) const {
+        if (index >= ptr->size) {
+            throw std::out_of_range(
+                "index " + std::to_string(index) + " out of range [0, " +
+                std::to_string(ptr->size) + ")"
+            );
+        }
+        if (ptr->type == value_type::object) {
+            return view(doc, &ptr->val.members[index].value);
+        }
+        check_type(ptr->type, value_type::list);
+        return view(doc, &ptr->val.elements[index]);
+    }
+
+    static const member* find_member(const node& node, uint32_t key) {
+        if (node.type != value_type::object || key == document::NO_KEY) {
+            return nullptr;
+        }
+        auto begin = node.val.members;
+        auto end = begin + node.size;
+        auto found = std::lower_bound(
+            begin, end, key, [](const member& m, uint32_t key) {
+                return m.key < key;
+            }
+        );
+        if (found == end || found->key != key) {
+            return nullptr;
+        }
+        return found;
+    }
+
+    view view::operator[](std::string_view key) const {
+        check_type(ptr->type, value_type::object);
+        if (auto found = find_member(*ptr, doc->findKey(key))) {
+            return view(doc, &found->value);
+        }
+        return view(doc, &NONE_NODE);
+    }
+
+    bool view::has(std::string_view key) const {
+        return find_member(*ptr, doc->findKey(key)) != nullptr;
+    }
+
+    std::string_view view::keyAt(size_t index) const {
+        check_type(ptr->type, value_type::object);
+        if (index >= ptr->size) {
+            throw std::out_of_range("member index out of range");
+        }
+        return doc->getKey(ptr->val.members[index].key);
+    }
+
+    value view::toValue() const {
+        switch (ptr->type) {
+            case value_type::none:
+                return nullptr;
+            case value_type::number:
+                return ptr->val.number;
+            case value_type::boolean:
+                return ptr->val.boolean;
+            case value_type::integer:
+                return ptr->val.integer;
+            case value_type::string:
+                return std::string(ptr->str());
+            case value_type::bytes:
+                return std::make_shared<objects::Bytes>(
+                    ptr->val.bytes, ptr->size
+                );
+            case value_type::list: {
+                auto list = dv::list();
+                for (size_t i = 0; i < ptr->size; i++) {
+                    list.add(view(doc, &ptr->val.elements[i]).toValue());
+                }
+                return list;
+            }
+            case value_type::object: {
+                auto object = dv::object();
+                for (size_t i = 0; i < ptr->size; i++) {
+                    const auto& member = ptr->val.members[i];
+                    object[std::string(doc->getKey(member.key))] =
+                        view(doc, &member.value).toValue();
+                }
+                return object;
+            }
+        }
+        return nullptr;
+    }
+
+    document::document() : root(&NONE_NODE) {
+    }
+
+    uint32_t document::findKey(std::string_view key) const {
+        const auto& found = keyIds.find(key);
+        if (found == keyIds.end()) {
+            return NO_KEY;
+        }
+        return found->second;
+    }
+
+    static void build_from_value(document_builder& builder, const value& src) {
+        switch (src.getType()) {
+            case value_type::none:
+                builder.addNone();
+                break;
+            case value_type::number:
+                builder.addNumber(src.asNumber());
+                break;
+            case value_type::boolean:
+                builder.addBoolean(src.asBoolean());
+                break;
+            case value_type::integer:
+                builder.addInteger(src.asInteger());
+                break;
+            case value_type::string:
+                builder.addString(src.asString());
+                break;
+            case value_type::bytes: {
+                const auto& bytes = src.asBytes();
+                builder.addBytes(bytes.data(), bytes.size());
+                break;
+            }
+            case value_type::list: {
+                size_t mark = builder.begin();
+                for (const auto& element : src) {
+                    build_from_value(builder, element);
+                }
+                builder.endList(mark);
+                break;
+            }
+            case value_type::object: {
+                size_t mark = builder.begin();
+                for (const auto& [key, element] : src.asObject()) {
+                    builder.key(key);
+                    build_from_value(builder, element);
+                }
+                builder.endObject(mark);
+                break;
+            }
+        }
+    }
+
+    document document::from(const value& value) {
+        document_builder builder;
+        build_from_value(builder, value);
+        return builder.build();
+    }
+
+    document_builder::document_builder() {
+        stack.reserve(64);
+    }
+
+    uint32_t document_builder::intern(std::string_view key) {
+        const auto& found = doc.keyIds.find(key);
+        if (found != doc.keyIds.end()) {
+            return found->second;
+        }
+        char* chars = doc.memory.allocate_array<char>(key.size());
+        if (!key.empty()) {
+            std::memcpy(chars, key.data(), key.size());
+        }
+        std::string_view stored(chars, key.size());
+        uint32_t id = doc.keys.size();
+        doc.keys.push_back(stored);
+        doc.keyIds[stored] = id;
+        return id;
+    }
+
+    node& document_builder::push() {
+        stack.push_back(member {pendingKey, node {}});
+        pendingKey = document::NO_KEY;
+        return stack.back().value;
+    }
+
+    void document_builder::key(std::string_view key) {
+        pendingKey = intern(key);
+    }
+
+    void document_builder::addNone() {
+        push();
+    }
+
+    void document_builder::addInteger(integer_t value) {
+        auto& node = push();
+        node.type = value_type::integer;
+        node.val.integer = value;
+    }
+
+    void document_builder::addNumber(number_t value) {
+        auto& node = push();
+        node.type = value_type::number;
+        node.val.number = value;
+    }
+
+    void document_builder::addBoolean(boolean_t value) {
+        auto& node = push();
+        node.type = value_type::boolean;
+        node.val.boolean = value;
+    }
+
+    void document_builder::addString(std::string_view value) {
+        auto& node = push();
+        node.type = value_type::string;
+        node.size = value.size();
+        if (value.size() <= node::SHORT_STRING_SIZE) {
+            std::memcpy(node.val.shortString, value.data(), value.size());
+        } else {
+            char* chars = doc.memory.allocate_array<char>(value.size());
+            std::memcpy(chars, value.data(), value.size());
+            node.val.string = chars;
+        }
+    }
+
+    void document_builder::addBytes(const byte_t* bytes, size_t size) {
+        auto& node = push();
+        node.type = value_type::bytes;
+        node.size = size;
+        byte_t* dst = doc.memory.allocate_array<byte_t>(size);
+        if (size) {
+            std::memcpy(dst, bytes, size);
+        }
+        node.val.bytes = dst;
+    }
+
+    size_t document_builder::begin() {
+        containerKeys.push_back(pendingKey);
+        pendingKey = document::NO_KEY;
+        return stack.size();
+    }
+
+    void document_builder::endList(size_t mark) {
+        size_t count = stack.size() - mark;
+        node* elements = doc.memory.allocate_array<node>(count);
+        for (size_t i = 0; i < count; i++) {
+            elements[i] = stack[mark + i].value;
+        }
+        stack.resize(mark);
+        pendingKey = containerKeys.back();
+        containerKeys.pop_back();
+        auto& list = push();
+        list.type = value_type::list;
+        list.size = count;
+        list.val.elements = elements;
+    }
+
+    void document_builder::endObject(size_t mark) {
+        auto begin = stack.begin() + mark;
+        std::stable_sort(begin, stack.end(), [](const auto& a, const auto& b) {
+            return a.key < b.key;
+        });
+        // keep the last member of equal keys
+        auto end = std::unique(
+            std::make_reverse_iterator(stack.end()),
+            std::make_reverse_iterator(begin),
+            [](const auto& a, const auto& b) { return a.key == b.key; }
+        ).base();
+        size_t count = stack.end() - end;
+        member* members = doc.memory.allocate_array<member>(count);
+        std::copy(end, stack.end(), members);
+        stack.resize(mark);
+        pendingKey = containerKeys.back();
+        containerKeys.pop_back();
+        auto& object = push();
+        object.type = value_type::object;
+        object.size = count;
+        object.val.members = members;
+    }
+
+    document document_builder::build() {
+        if (stack.size() != 1) {
+            throw std::runtime_error("document must have exactly one root");
+        }
+        node* root = doc.memory.allocate_array<node>(1);
+        *root = stack[0].value;
+        doc.root = root;
+        stack.clear();
+        return std::move(doc);
+    }
+}
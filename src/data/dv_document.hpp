@@ -0,0 +1,206 @@
+#pragma once
+
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "dv.hpp"
+
+namespace dv {
+    /// @brief Monotonic allocator. Memory is released only with the arena
+    class arena {
+        std::vector<std::unique_ptr<byte_t[]>> blocks;
+        byte_t* current = nullptr;
+        size_t remaining = 0;
+        size_t nextBlockSize;
+        size_t allocated = 0;
+    public:
+        static constexpr size_t MAX_BLOCK_SIZE = 1024 * 1024;
+
+        explicit arena(size_t firstBlockSize = 4096);
+        arena(arena&&) = default;
+        arena& operator=(arena&&) = default;
+
+        void* allocate(size_t size, size_t alignment);
+
+        template <class T>
+        T* allocate_array(size_t count) {
+            return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+        }
+
+        /// @brief Total size of allocated blocks in bytes
+        size_t getAllocated() const {
+            return allocated;
+        }
+
+        size_t getBlocksCount() const {
+            return blocks.size();
+        }
+    };
+
+    struct member;
+
+    /// @brief Compact document node (16 bytes)
+    struct node {
+        /// @brief Strings of this size or less are stored inside the node
+        static constexpr size_t SHORT_STRING_SIZE = 8;
+
+        value_type type = value_type::none;
+        /// @brief Number of elements, members, bytes or string length
+        uint32_t size = 0;
+        union {
+            integer_t integer;
+            number_t number;
+            boolean_t boolean;
+            const char* string;
+            char shortString[SHORT_STRING_SIZE];
+            const byte_t* bytes;
+            const node* elements;
+            const member* members;
+        } val {};
+
+        std::string_view str() const {
+            return std::string_view(
+                size <= SHORT_STRING_SIZE ? val.shortString : val.string, size
+            );
+        }
+    };
+
+    /// @brief Object member. Object members are sorted by key id
+    struct member {
+        uint32_t key;
+        node value;
+    };
+
+    class document;
+
+    /// @brief Read-only reference to a document node.
+    /// Valid while the document is alive and not moved
+    class view {
+        const document* doc;
+        const node* ptr;
+    public:
+        view(const document* doc, const node* ptr) : doc(doc), ptr(ptr) {}
+
+        value_type getType() const {
+            return ptr->type;
+        }
+
+        bool isNone() const {
+            return ptr->type == value_type::none;
+        }
+        bool isObject() const {
+            return ptr->type == value_type::object;
+        }
+        bool isList() const {
+            return ptr->type == value_type::list;
+        }
+        bool isString() const {
+            return ptr->type == value_type::string;
+        }
+        bool isNumber() const {
+            return ptr->type == value_type::number ||
+                   ptr->type == value_type::integer;
+        }
+
+        integer_t asInteger() const;
+        number_t asNumber() const;
+        boolean_t asBoolean() const;
+        std::string_view asString() const;
+        const byte_t* asBytes() const;
+
+        /// @return number of list elements, object members, string or bytes
+        /// length
+        size_t size() const noexcept {
+            return ptr->size;
+        }
+
+        /// @brief Get list element or object member value by index
+        view operator[](size_t index) const;
+
+        /// @brief Get object member value
+        /// @return none-view if object has no such member
+        view operator[](std::string_view key) const;
+
+        bool has(std::string_view key) const;
+
+        /// @brief Get object member key by index
+        std::string_view keyAt(size_t index) const;
+
+        /// @brief Create a deep copy as dv::value
+        value toValue() const;
+    };
+
+    /// @brief Arena-backed immutable dv tree. Object keys are interned,
+    /// short strings are stored inside nodes and objects are flat arrays
+    /// sorted by key id. All nodes are released with the document.
+    class document {
+        friend class document_builder;
+
+        arena memory;
+        std::vector<std::string_view> keys;
+        std::unordered_map<std::string_view, uint32_t> keyIds;
+        const node* root;
+    public:
+        static constexpr uint32_t NO_KEY = UINT32_MAX;
+
+        document();
+        document(document&&) = default;
+        document& operator=(document&&) = default;
+
+        view getRoot() const {
+            return view(this, root);
+        }
+
+        /// @return key id or NO_KEY if key is not interned
+        uint32_t findKey(std::string_view key) const;
+
+        std::string_view getKey(uint32_t id) const {
+            return keys.at(id);
+        }
+
+        const arena& getArena() const {
+            return memory;
+        }
+
+        /// @brief Create document from dv::value
+        static document from(const value& value);
+    };
+
+    /// @brief Builds a document in depth-first order.
+    /// Values are added to a scratch stack, so complete lists and objects
+    /// are copied to the arena once with exact size.
+    class document_builder {
+        document doc;
+        std::vector<member> stack;
+        /// @brief Keys of unfinished lists and objects
+        std::vector<uint32_t> containerKeys;
+        uint32_t pendingKey = document::NO_KEY;
+
+        uint32_t intern(std::string_view key);
+        node& push();
+    public:
+        document_builder();
+
+        /// @brief Set key for the next added object member
+        void key(std::string_view key);
+
+        void addNone();
+        void addInteger(integer_t value);
+        void addNumber(number_t value);
+        void addBoolean(boolean_t value);
+        void addString(std::string_view value);
+        void addBytes(const byte_t* bytes, size_t size);
+
+        /// @brief Start list or object
+        /// @return mark passed to endList or endObject
+        size_t begin();
+        void endList(size_t mark);
+        /// @brief Finish object. Last member wins on duplicate keys
+        void endObject(size_t mark);
+
+        /// @brief Finish document with the only value added at top level
+        document build();
+    };
+}
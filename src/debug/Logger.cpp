@@ -1,42 +1,50 @@
 #include "Logger.hpp"
 
+#include <algorithm>
 #include <chrono>
+#include <condition_variable>
 #include <ctime>
 #include <iomanip>
 #include <iostream>
+#include <thread>
+#include <unordered_map>
 #include <utility>
+#include <vector>
+
+#include "util/MPSCQueue.hpp"
 
 using namespace debug;
+using namespace std::chrono;
 
-std::ofstream Logger::file;
-std::mutex Logger::mutex;
-std::string Logger::utcOffset = "";
-unsigned Logger::moduleLen = 20;
+/// @brief Max number of queued messages, new messages are dropped when full
+static constexpr size_t QUEUE_CAPACITY = 8192;
+/// @brief Max time messages wait in the queue
+static constexpr auto DRAIN_INTERVAL = milliseconds(10);
 
-LogMessage::~LogMessage() {
-    logger->log(level, ss.str());
+namespace {
+    struct Record {
+        LogLevel level = LogLevel::info;
+        system_clock::time_point time;
+        std::string name;
+        std::string message;
+    };
 }
 
-Logger::Logger(std::string name) : name(std::move(name)) {
-}
+/// @brief Output state, guarded by outputMutex
+static std::mutex outputMutex;
+static std::ofstream file;
+static std::string utcOffset = "";
+static constexpr unsigned MODULE_LEN = 20;
 
-void Logger::log(
-    LogLevel level, const std::string& name, const std::string& message
-) {
-    if (level == LogLevel::print) {
-        std::cout << "[" << name << "]    " << message << std::endl;
+static void write_record(const Record& record) {
+    if (record.level == LogLevel::print) {
+        std::cout << "[" << record.name << "]    " << record.message << '\n';
         return;
     }
-
-    using namespace std::chrono;
-
     std::stringstream ss;
-    switch (level) {
+    switch (record.level) {
         case LogLevel::print:
         case LogLevel::debug:
-#ifdef NDEBUG
-            return;
-#endif
             ss << "[D]";
             break;
         case LogLevel::info:
@@ -49,40 +57,284 @@ void Logger::log(
             ss << "[E]";
             break;
     }
-    time_t tm = std::time(nullptr);
+    time_t tm = system_clock::to_time_t(record.time);
     auto ms =
-        duration_cast<milliseconds>(system_clock::now().time_since_epoch()) %
-        1000;
+        duration_cast<milliseconds>(record.time.time_since_epoch()) % 1000;
     ss << " " << std::put_time(std::localtime(&tm), "%Y/%m/%d %T");
     ss << '.' << std::setfill('0') << std::setw(3) << ms.count();
-    ss << utcOffset << " [" << std::setfill(' ') << std::setw(moduleLen) << name
-       << "] ";
-    ss << message;
-    {
-        std::lock_guard<std::mutex> lock(mutex);
-        auto string = ss.str();
-        if (file.good()) {
-            file << string << '\n';
-            file.flush();
+    ss << utcOffset << " [" << std::setfill(' ') << std::setw(MODULE_LEN)
+       << record.name << "] ";
+    ss << record.message;
+
+    auto string = ss.str();
+    if (file.good()) {
+        file << string << '\n';
+    }
+    std::cout << string << '\n';
+}
+
+static void flush_output() {
+    if (file.good()) {
+        file.flush();
+    }
+    std::cout.flush();
+}
+
+namespace {
+    /// @brief Background thread writing queued records in batches
+    class AsyncWriter {
+        util::MPSCQueue<Record> queue {QUEUE_CAPACITY};
+        std::atomic<uint64_t> pushed {0};
+        std::atomic<uint64_t> written {0};
+        std::atomic<uint64_t> dropped {0};
+        std::atomic<uint64_t> droppedTotal {0};
+        std::atomic<bool> stopRequested {false};
+        std::mutex waitMutex;
+        std::condition_variable cv;
+        std::mutex flushMutex;
+        /// @brief Notified when a batch is written
+        std::condition_variable flushed;
+        std::thread thread;
+
+        void drain(std::vector<Record>& batch) {
+            Record record;
+            while (batch.size() < queue.capacity() && queue.tryPop(record)) {
+                batch.push_back(std::move(record));
+            }
+            uint64_t droppedNow = dropped.exchange(0);
+            if (batch.empty() && droppedNow == 0) {
+                return;
+            }
+            {
+                std::lock_guard<std::mutex> lock(outputMutex);
+                for (const auto& record : batch) {
+                    write_record(record);
+                }
+                if (droppedNow) {
+                    write_record(Record {
+                        LogLevel::warning,
+                        system_clock::now(),
+                        "logger",
+                        std::to_string(droppedNow) +
+                            " messages dropped (queue is full)"});
+                }
+                flush_output();
+            }
+            {
+                std::lock_guard<std::mutex> lock(flushMutex);
+                written += batch.size();
+            }
+            flushed.notify_all();
+            batch.clear();
+        }
+
+        void run() {
+            std::vector<Record> batch;
+            batch.reserve(queue.capacity());
+            while (!stopRequested.load()) {
+                drain(batch);
+                std::unique_lock<std::mutex> lock(waitMutex);
+                cv.wait_for(lock, DRAIN_INTERVAL);
+            }
+            drain(batch);
+        }
+    public:
+        AsyncWriter() : thread([this]() { run(); }) {
+        }
+
+        ~AsyncWriter() {
+            stopRequested = true;
+            cv.notify_one();
+            thread.join();
+        }
+
+        void push(Record&& record) {
+            bool urgent = record.level >= LogLevel::warning;
+            if (!queue.tryPush(std::move(record))) {
+                dropped++;
+                droppedTotal++;
+                return;
+            }
+            pushed++;
+            if (urgent) {
+                cv.notify_one();
+            }
+        }
+
+        void flush() {
+            uint64_t target = pushed.load();
+            cv.notify_one();
+            std::unique_lock<std::mutex> lock(flushMutex);
+            flushed.wait(lock, [this, target]() {
+                return written.load() >= target;
+            });
+        }
+
+        uint64_t getDroppedCount() const {
+            return droppedTotal.load();
+        }
+    };
+}
+
+/// @brief Set after init(...) until the writer is destroyed at exit
+static std::atomic<AsyncWriter*> asyncWriter {nullptr};
+
+namespace debug {
+    /// @brief Loggers levels configuration
+    class LoggersRegistry {
+        std::mutex mutex;
+        std::vector<Logger*> loggers;
+        std::unordered_map<std::string, LogLevel> moduleLevels;
+#ifdef NDEBUG
+        LogLevel defaultLevel = LogLevel::info;
+#else
+        LogLevel defaultLevel = LogLevel::debug;
+#endif
+        LogLevel getLevel(const std::string& name) const {
+            const auto& found = moduleLevels.find(name);
+            if (found != moduleLevels.end()) {
+                return found->second;
+            }
+            return defaultLevel;
+        }
+
+        void apply(Logger& logger) {
+            logger.level.store(
+                static_cast<int>(getLevel(logger.name)),
+                std::memory_order_relaxed
+            );
+        }
+    public:
+        /// @brief Registry is never destroyed as loggers may outlive
+        /// any other static object
+        static LoggersRegistry& get() {
+            static auto registry = new LoggersRegistry();
+            return *registry;
+        }
+
+        void add(Logger& logger) {
+            std::lock_guard<std::mutex> lock(mutex);
+            apply(logger);
+            loggers.push_back(&logger);
         }
-        std::cout << string << std::endl;
+
+        void remove(Logger& logger) {
+            std::lock_guard<std::mutex> lock(mutex);
+            loggers.erase(std::remove(loggers.begin(), loggers.end(), &logger));
+        }
+
+        void setDefaultLevel(LogLevel level) {
+            std::lock_guard<std::mutex> lock(mutex);
+            defaultLevel = level;
+            for (auto logger : loggers) {
+                apply(*logger);
+            }
+        }
+
+        void setModuleLevel(const std::string& name, LogLevel level) {
+            std::lock_guard<std::mutex> lock(mutex);
+            moduleLevels[name] = level;
+            for (auto logger : loggers) {
+                if (logger->name == name) {
+                    apply(*logger);
+                }
+            }
+        }
+    };
+}
+
+LogMessage::LogMessage(Logger* logger, LogLevel level)
+    : logger(logger), level(level) {
+    if (logger->isEnabled(level)) {
+        ss.emplace();
+    }
+}
+
+LogMessage::~LogMessage() {
+    if (ss) {
+        logger->log(level, ss->str());
+    }
+}
+
+Logger::Logger(std::string name) : name(std::move(name)), level(0) {
+    LoggersRegistry::get().add(*this);
+}
+
+Logger::~Logger() {
+    LoggersRegistry::get().remove(*this);
+}
+
+void Logger::log(LogLevel level, std::string message) {
+    if (!isEnabled(level)) {
+        return;
+    }
+    Record record {level, system_clock::now(), name, std::move(message)};
+    if (auto writer = asyncWriter.load()) {
+        writer->push(std::move(record));
+        // the last error before a crash must reach the log file
+        if (level == LogLevel::error) {
+            writer->flush();
+        }
+        return;
     }
+    // before init(...) and at exit
+    std::lock_guard<std::mutex> lock(outputMutex);
+    write_record(record);
+    flush_output();
 }
 
 void Logger::init(const std::string& filename) {
-    file.open(filename);
+    {
+        std::lock_guard<std::mutex> lock(outputMutex);
+        file.open(filename);
 
-    time_t tm = std::time(nullptr);
-    std::stringstream ss;
-    ss << std::put_time(std::localtime(&tm), "%z");
-    utcOffset = ss.str();
+        time_t tm = std::time(nullptr);
+        std::stringstream ss;
+        ss << std::put_time(std::localtime(&tm), "%z");
+        utcOffset = ss.str();
+    }
+    // destroyed at exit, writing the rest of the queue
+    static AsyncWriter writer;
+    asyncWriter = &writer;
+    static struct WriterGuard {
+        ~WriterGuard() {
+            asyncWriter = nullptr;
+        }
+    } guard;
 }
 
 void Logger::flush() {
-    std::lock_guard<std::mutex> lock(mutex);
-    file.flush();
+    if (auto writer = asyncWriter.load()) {
+        writer->flush();
+    }
+    std::lock_guard<std::mutex> lock(outputMutex);
+    flush_output();
 }
 
-void Logger::log(LogLevel level, std::string message) {
-    log(level, name, std::move(message));
+void Logger::setLevel(LogLevel level) {
+    LoggersRegistry::get().setDefaultLevel(level);
+}
+
+void Logger::setModuleLevel(const std::string& name, LogLevel level) {
+    LoggersRegistry::get().setModuleLevel(name, level);
+}
+
+std::optional<LogLevel> Logger::parseLevel(std::string_view name) {
+    if (name == "debug") {
+        return LogLevel::debug;
+    } else if (name == "info") {
+        return LogLevel::info;
+    } else if (name == "warning") {
+        return LogLevel::warning;
+    } else if (name == "error") {
+        return LogLevel::error;
+    }
+    return std::nullopt;
+}
+
+uint64_t Logger::getDroppedCount() {
+    if (auto writer = asyncWriter.load()) {
+        return writer->getDroppedCount();
+    }
+    return 0;
 }
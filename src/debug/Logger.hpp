@@ -1,47 +1,74 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <fstream>
 #include <mutex>
+#include <optional>
 #include <sstream>
+#include <string>
+#include <string_view>
 
 namespace debug {
     enum class LogLevel { print, debug, info, warning, error };
 
     class Logger;
 
+    /// @brief Message builder. Formatting is skipped if the level
+    /// is filtered out for the logger module
     class LogMessage {
         Logger* logger;
         LogLevel level;
-        std::stringstream ss;
+        std::optional<std::stringstream> ss;
     public:
-        LogMessage(Logger* logger, LogLevel level)
-            : logger(logger), level(level) {
-        }
+        LogMessage(Logger* logger, LogLevel level);
         ~LogMessage();
 
         template <class T>
         LogMessage& operator<<(const T& x) {
-            ss << x;
+            if (ss) {
+                *ss << x;
+            }
             return *this;
         }
     };
 
+    /// @brief Module logger. Messages are passed to a background writer
+    /// thread after init(...), so logging does not block on output.
+    /// Errors are written and flushed before log returns.
+    /// When the writer queue is full, messages are dropped and counted
     class Logger {
-        static std::mutex mutex;
-        static std::string utcOffset;
-        static std::ofstream file;
-        static unsigned moduleLen;
-
         std::string name;
+        /// @brief Min level of messages written
+        std::atomic<int> level;
 
-        static void log(
-            LogLevel level, const std::string& name, const std::string& message
-        );
+        friend class LoggersRegistry;
     public:
+        /// @brief Open log file and start background writer
         static void init(const std::string& filename);
+        /// @brief Wait until all logged messages are written
         static void flush();
 
+        /// @brief Set min level of modules having no own level
+        static void setLevel(LogLevel level);
+        /// @brief Set min level of module
+        static void setModuleLevel(const std::string& name, LogLevel level);
+        /// @brief Parse level name (debug, info, warning, error)
+        static std::optional<LogLevel> parseLevel(std::string_view name);
+        /// @return number of messages dropped due to full queue
+        static uint64_t getDroppedCount();
+
         Logger(std::string name);
+        ~Logger();
+
+        Logger(const Logger&) = delete;
+        Logger& operator=(const Logger&) = delete;
+
+        bool isEnabled(LogLevel level) const {
+            return level == LogLevel::print ||
+                   static_cast<int>(level) >=
+                       this->level.load(std::memory_order_relaxed);
+        }
 
         void log(LogLevel level, std::string message);
 
@@ -0,0 +1,300 @@
+#include "Metrics.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+
+using namespace debug::metrics;
+
+size_t debug::metrics::stripe() {
+    static std::atomic<size_t> nextStripe {0};
+    thread_local size_t index =
+        nextStripe.fetch_add(1, std::memory_order_relaxed) % STRIPES;
+    return index;
+}
+
+static void atomic_add(std::atomic<double>& value, double delta) {
+    double current = value.load(std::memory_order_relaxed);
+    while (!value.compare_exchange_weak(
+        current, current + delta, std::memory_order_relaxed
+    )) {
+    }
+}
+
+uint64_t Counter::get() const {
+    uint64_t sum = 0;
+    for (const auto& stripe : stripes) {
+        sum += stripe.value.load(std::memory_order_relaxed);
+    }
+    return sum;
+}
+
+void Counter::reset() {
+    for (auto& stripe : stripes) {
+        stripe.value.store(0, std::memory_order_relaxed);
+    }
+}
+
+void Gauge::add(double delta) {
+    atomic_add(value, delta);
+}
+
+double HistogramSnapshot::quantile(double q) const {
+    if (count == 0) {
+        return 0.0;
+    }
+    double rank = std::clamp(q, 0.0, 1.0) * count;
+    uint64_t accumulated = 0;
+    for (size_t i = 0; i < counts.size(); i++) {
+        if (counts[i] == 0 || accumulated + counts[i] < rank) {
+            accumulated += counts[i];
+            continue;
+        }
+        // the last bucket has no upper bound
+        if (i == bounds.size()) {
+            return bounds.empty() ? 0.0 : bounds.back();
+        }
+        double lower = i == 0 ? 0.0 : bounds[i - 1];
+        double upper = bounds[i];
+        double t = (rank - accumulated) / counts[i];
+        return lower + (upper - lower) * t;
+    }
+    return bounds.empty() ? 0.0 : bounds.back();
+}
+
+Histogram::Histogram(std::vector<double> bounds) : bounds(std::move(bounds)) {
+    if (!std::is_sorted(this->bounds.begin(), this->bounds.end())) {
+        throw std::runtime_error("histogram bounds must be ascending");
+    }
+    for (auto& stripe : stripes) {
+        stripe.counts =
+            std::make_unique<std::atomic<uint64_t>[]>(this->bounds.size() + 1);
+    }
+}
+
+void Histogram::observe(double value) {
+    size_t index =
+        std::lower_bound(bounds.begin(), bounds.end(), value) - bounds.begin();
+    auto& stripe = stripes[debug::metrics::stripe()];
+    stripe.counts[index].fetch_add(1, std::memory_order_relaxed);
+    atomic_add(stripe.sum, value);
+}
+
+HistogramSnapshot Histogram::snapshot() const {
+    HistogramSnapshot snapshot {bounds, std::vector<uint64_t>(bounds.size() + 1)};
+    for (const auto& stripe : stripes) {
+        for (size_t i = 0; i <= bounds.size(); i++) {
+            uint64_t count = stripe.counts[i].load(std::memory_order_relaxed);
+            snapshot.counts[i] += count;
+            snapshot.count += count;
+        }
+        snapshot.sum += stripe.sum.load(std::memory_order_relaxed);
+    }
+    return snapshot;
+}
+
+void Histogram::reset() {
+    for (auto& stripe : stripes) {
+        for (size_t i = 0; i <= bounds.size(); i++) {
+            stripe.counts[i].store(0, std::memory_order_relaxed);
+        }
+        stripe.sum.store(0.0, std::memory_order_relaxed);
+    }
+}
+
+const std::vector<double>& debug::metrics::default_bounds() {
+    static const std::vector<double> bounds {
+        0.1, 0.25, 0.5, 1, 2.5, 5, 10, 25, 50, 100, 250, 500, 1000, 2500,
+        5000, 10000};
+    return bounds;
+}
+
+namespace {
+    struct Metric {
+        MetricType type;
+        std::unique_ptr<Counter> counter;
+        std::unique_ptr<Gauge> gauge;
+        std::unique_ptr<Histogram> histogram;
+    };
+
+    /// @brief Metrics are never removed, references stay valid
+    class Registry {
+        std::mutex mutex;
+        std::map<std::string, Metric, std::less<>> metrics;
+
+        Metric& require(const std::string& name, MetricType type) {
+            auto found = metrics.find(name);
+            if (found != metrics.end()) {
+                if (found->second.type != type) {
+                    throw std::runtime_error(
+                        "metric '" + name + "' has another type"
+                    );
+                }
+                return found->second;
+            }
+            auto& metric = metrics[name];
+            metric.type = type;
+            return metric;
+        }
+
+        static MetricValue get_value(
+            const std::string& name, const Metric& metric
+        ) {
+            MetricValue value {name, metric.type, 0.0, {}};
+            switch (metric.type) {
+                case MetricType::counter:
+                    value.value = metric.counter->get();
+                    break;
+                case MetricType::gauge:
+                    value.value = metric.gauge->get();
+                    break;
+                case MetricType::histogram:
+                    value.histogram = metric.histogram->snapshot();
+                    value.value = value.histogram.count;
+                    break;
+            }
+            return value;
+        }
+    public:
+        /// @brief Registry is never destroyed as metrics may be updated
+        /// by static objects destructors
+        static Registry& get() {
+            static auto registry = new Registry();
+            return *registry;
+        }
+
+        Counter& counter(const std::string& name) {
+            std::lock_guard lock(mutex);
+            auto& metric = require(name, MetricType::counter);
+            if (metric.counter == nullptr) {
+                metric.counter = std::make_unique<Counter>();
+            }
+            return *metric.counter;
+        }
+
+        Gauge& gauge(const std::string& name) {
+            std::lock_guard lock(mutex);
+            auto& metric = require(name, MetricType::gauge);
+            if (metric.gauge == nullptr) {
+                metric.gauge = std::make_unique<Gauge>();
+            }
+            return *metric.gauge;
+        }
+
+        Histogram& histogram(
+            const std::string& name, const std::vector<double>& bounds
+        ) {
+            std::lock_guard lock(mutex);
+            auto& metric = require(name, MetricType::histogram);
+            if (metric.histogram == nullptr) {
+                metric.histogram = std::make_unique<Histogram>(bounds);
+            }
+            return *metric.histogram;
+        }
+
+        std::vector<MetricValue> collect(std::string_view prefix) {
+            std::lock_guard lock(mutex);
+            std::vector<MetricValue> values;
+            for (auto it = metrics.lower_bound(prefix); it != metrics.end();
+                 ++it) {
+                if (it->first.compare(0, prefix.length(), prefix) != 0) {
+                    break;
+                }
+                values.push_back(get_value(it->first, it->second));
+            }
+            return values;
+        }
+
+        bool get(const std::string& name, MetricValue& dst) {
+            std::lock_guard lock(mutex);
+            const auto& found = metrics.find(name);
+            if (found == metrics.end()) {
+                return false;
+            }
+            dst = get_value(name, found->second);
+            return true;
+        }
+
+        void reset(std::string_view prefix) {
+            std::lock_guard lock(mutex);
+            for (auto it = metrics.lower_bound(prefix); it != metrics.end();
+                 ++it) {
+                if (it->first.compare(0, prefix.length(), prefix) != 0) {
+                    break;
+                }
+                auto& metric = it->second;
+                if (metric.counter) {
+                    metric.counter->reset();
+                }
+                if (metric.histogram) {
+                    metric.histogram->reset();
+                }
+            }
+        }
+    };
+}
+
+Counter& debug::metrics::counter(const std::string& name) {
+    return Registry::get().counter(name);
+}
+
+Gauge& debug::metrics::gauge(const std::string& name) {
+    return Registry::get().gauge(name);
+}
+
+Histogram& debug::metrics::histogram(
+    const std::string& name, const std::vector<double>& bounds
+) {
+    return Registry::get().histogram(name, bounds);
+}
+
+std::vector<MetricValue> debug::metrics::collect(std::string_view prefix) {
+    return Registry::get().collect(prefix);
+}
+
+bool debug::metrics::get(const std::string& name, MetricValue& dst) {
+    return Registry::get().get(name, dst);
+}
+
+std::string debug::metrics::report(std::string_view prefix) {
+    auto values = collect(prefix);
+    if (values.empty()) {
+        return "no metrics";
+    }
+    size_t nameWidth = 0;
+    for (const auto& value : values) {
+        nameWidth = std::max(nameWidth, value.name.length());
+    }
+    std::stringstream ss;
+    ss << std::fixed;
+    for (const auto& value : values) {
+        ss << std::left << std::setw(nameWidth + 2) << value.name;
+        switch (value.type) {
+            case MetricType::counter:
+                ss << static_cast<uint64_t>(value.value);
+                break;
+            case MetricType::gauge:
+                ss << std::defaultfloat << value.value << std::fixed;
+                break;
+            case MetricType::histogram: {
+                const auto& h = value.histogram;
+                ss << std::setprecision(2) << "count=" << h.count
+                   << " mean=" << h.mean() << " p50=" << h.quantile(0.5)
+                   << " p95=" << h.quantile(0.95)
+                   << " p99=" << h.quantile(0.99);
+                break;
+            }
+        }
+        ss << '\n';
+    }
+    auto text = ss.str();
+    text.pop_back();
+    return text;
+}
+
+void debug::metrics::reset(std::string_view prefix) {
+    Registry::get().reset(prefix);
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/// @brief Registry of named engine metrics: counters, gauges and histograms.
+///
+/// Metrics are created on first access and live until exit, so subsystems
+/// keep references in static variables. Counters and histograms are
+/// striped per thread, so updating them from workers does not contend.
+namespace debug::metrics {
+    /// @brief Number of stripes of counters and histograms
+    inline constexpr size_t STRIPES = 16;
+
+    /// @return stripe index of the current thread
+    size_t stripe();
+
+    enum class MetricType { counter, gauge, histogram };
+
+    /// @brief Monotonic counter
+    class Counter {
+        struct alignas(64) Stripe {
+            std::atomic<uint64_t> value {0};
+        };
+        std::array<Stripe, STRIPES> stripes;
+    public:
+        void add(uint64_t n = 1) {
+            stripes[stripe()].value.fetch_add(n, std::memory_order_relaxed);
+        }
+
+        uint64_t get() const;
+
+        void reset();
+    };
+
+    /// @brief Last set value (sizes, queue depths, totals owned by
+    /// subsystems)
+    class Gauge {
+        std::atomic<double> value {0.0};
+    public:
+        void set(double v) {
+            value.store(v, std::memory_order_relaxed);
+        }
+
+        void add(double delta);
+
+        double get() const {
+            return value.load(std::memory_order_relaxed);
+        }
+    };
+
+    struct HistogramSnapshot {
+        /// @brief Buckets upper bounds, the last bucket has no bound
+        std::vector<double> bounds;
+        /// @brief Number of values in each bucket (bounds.size() + 1)
+        std::vector<uint64_t> counts;
+        uint64_t count = 0;
+        double sum = 0.0;
+
+        /// @brief Estimate quantile interpolating inside of the bucket
+        /// @param q quantile in range [0, 1]
+        double quantile(double q) const;
+
+        double mean() const {
+            return count ? sum / count : 0.0;
+        }
+    };
+
+    /// @brief Distribution of values over fixed buckets
+    class Histogram {
+        struct alignas(64) Stripe {
+            std::unique_ptr<std::atomic<uint64_t>[]> counts;
+            std::atomic<double> sum {0.0};
+        };
+        std::vector<double> bounds;
+        std::array<Stripe, STRIPES> stripes;
+    public:
+        /// @param bounds ascending buckets upper bounds
+        explicit Histogram(std::vector<double> bounds);
+
+        void observe(double value);
+
+        HistogramSnapshot snapshot() const;
+
+        void reset();
+    };
+
+    /// @brief Default histogram bounds suitable for milliseconds and sizes
+    const std::vector<double>& default_bounds();
+
+    /// @throws std::runtime_error if the name is taken by other metric type
+    Counter& counter(const std::string& name);
+
+    /// @throws std::runtime_error if the name is taken by other metric type
+    Gauge& gauge(const std::string& name);
+
+    /// @param bounds used if the histogram does not exist yet
+    /// @throws std::runtime_error if the name is taken by other metric type
+    Histogram& histogram(
+        const std::string& name,
+        const std::vector<double>& bounds = default_bounds()
+    );
+
+    struct MetricValue {
+        std::string name;
+        MetricType type;
+        /// @brief Counter or gauge value, histogram values count
+        double value;
+        /// @brief Histogram snapshot (empty for counters and gauges)
+        HistogramSnapshot histogram;
+    };
+
+    /// @return values of metrics with names starting with prefix,
+    /// sorted by name
+    std::vector<MetricValue> collect(std::string_view prefix = "");
+
+    /// @return value of the metric or false if not found
+    bool get(const std::string& name, MetricValue& dst);
+
+    /// @brief Text report of metrics with names starting with prefix
+    std::string report(std::string_view prefix = "");
+
+    /// @brief Reset counters and histograms with names starting with
+    /// prefix (gauges are owned by subsystems and keep values)
+    void reset(std::string_view prefix = "");
+}
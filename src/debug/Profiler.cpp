@@ -0,0 +1,150 @@
+#include "Profiler.hpp"
+
+#include <atomic>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "util/stringutil.hpp"
+
+using namespace debug;
+using namespace std::chrono;
+
+/// @brief Zones limit per thread to keep forgotten capture from eating
+/// all memory (24 MiB per thread)
+static constexpr size_t MAX_THREAD_ZONES = 1 << 20;
+
+namespace {
+    struct ZoneRecord {
+        const char* name;
+        profiler::clock::time_point begin;
+        profiler::clock::duration duration;
+    };
+
+    struct ThreadBuffer {
+        uint32_t tid;
+        std::mutex mutex;
+        std::vector<ZoneRecord> zones;
+        /// @brief Zones began with profiler::begin
+        std::vector<std::pair<const char*, profiler::clock::time_point>> stack;
+    };
+}
+
+static std::atomic<bool> capturing = false;
+static std::mutex registryMutex;
+/// @brief Buffers stay alive after their threads are finished
+static std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+static std::unordered_set<std::string> names;
+static profiler::clock::time_point captureStart;
+
+static ThreadBuffer& get_buffer() {
+    static thread_local std::shared_ptr<ThreadBuffer> buffer;
+    if (buffer == nullptr) {
+        buffer = std::make_shared<ThreadBuffer>();
+        std::lock_guard lock(registryMutex);
+        buffer->tid = buffers.size() + 1;
+        buffers.push_back(buffer);
+    }
+    return *buffer;
+}
+
+void profiler::start() {
+    std::lock_guard lock(registryMutex);
+    for (const auto& buffer : buffers) {
+        std::lock_guard bufferLock(buffer->mutex);
+        buffer->zones.clear();
+    }
+    captureStart = clock::now();
+    capturing = true;
+}
+
+void profiler::stop() {
+    capturing = false;
+}
+
+bool profiler::is_active() {
+    return capturing.load(std::memory_order_relaxed);
+}
+
+size_t profiler::count() {
+    std::lock_guard lock(registryMutex);
+    size_t count = 0;
+    for (const auto& buffer : buffers) {
+        std::lock_guard bufferLock(buffer->mutex);
+        count += buffer->zones.size();
+    }
+    return count;
+}
+
+const char* profiler::intern(std::string_view name) {
+    std::lock_guard lock(registryMutex);
+    // unordered_set nodes are not relocated
+    return names.emplace(name).first->c_str();
+}
+
+void profiler::record(
+    const char* name, clock::time_point begin, clock::time_point end
+) {
+    if (!is_active()) {
+        return;
+    }
+    auto& buffer = get_buffer();
+    std::lock_guard lock(buffer.mutex);
+    if (buffer.zones.size() < MAX_THREAD_ZONES) {
+        buffer.zones.push_back(ZoneRecord {name, begin, end - begin});
+    }
+}
+
+void profiler::begin(const char* name) {
+    get_buffer().stack.emplace_back(name, clock::now());
+}
+
+bool profiler::end() {
+    auto& stack = get_buffer().stack;
+    if (stack.empty()) {
+        return false;
+    }
+    auto [name, begin] = stack.back();
+    stack.pop_back();
+    record(name, begin, clock::now());
+    return true;
+}
+
+std::string profiler::to_chrome_trace() {
+    std::lock_guard lock(registryMutex);
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(3);
+    ss << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    for (const auto& buffer : buffers) {
+        std::lock_guard bufferLock(buffer->mutex);
+        if (buffer->zones.empty()) {
+            continue;
+        }
+        if (!first) {
+            ss << ",";
+        }
+        first = false;
+        ss << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+           << buffer->tid << ",\"args\":{\"name\":\"thread " << buffer->tid
+           << "\"}}";
+        for (const auto& zone : buffer->zones) {
+            if (zone.begin < captureStart) {
+                // began before the capture
+                continue;
+            }
+            auto ts = duration<double, std::micro>(zone.begin - captureStart);
+            auto dur = duration<double, std::micro>(zone.duration);
+            ss << ",\n{\"name\":" << util::escape(zone.name)
+               << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->tid
+               << ",\"ts\":" << ts.count() << ",\"dur\":" << dur.count()
+               << "}";
+        }
+    }
+    ss << "\n]}\n";
+    return ss.str();
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/// @brief Scoped-zone profiler recording nested timings per thread.
+///
+/// Zones are recorded only while capture is active, otherwise a zone
+/// costs a single atomic flag check. Captured zones are exported in
+/// Chrome trace format (chrome://tracing, Perfetto).
+namespace debug::profiler {
+    using clock = std::chrono::steady_clock;
+
+    /// @brief Start a new capture discarding the previous one
+    void start();
+
+    /// @brief Stop capture keeping recorded zones
+    void stop();
+
+    bool is_active();
+
+    /// @return number of recorded zones
+    size_t count();
+
+    /// @brief Get persistent name pointer for runtime-generated zone name
+    const char* intern(std::string_view name);
+
+    /// @brief Record finished zone
+    /// @param name static or interned zone name
+    void record(const char* name, clock::time_point begin, clock::time_point end);
+
+    /// @brief Begin zone on the current thread (for scripting)
+    void begin(const char* name);
+
+    /// @brief End the last zone began on the current thread
+    /// @return false if there is no zone to end
+    bool end();
+
+    /// @brief Export recorded zones as Chrome trace json
+    std::string to_chrome_trace();
+
+    /// @brief RAII zone
+    class Zone {
+        const char* name;
+        clock::time_point begin;
+        bool active;
+    public:
+        explicit Zone(const char* name) : name(name), active(is_active()) {
+            if (active) {
+                begin = clock::now();
+            }
+        }
+
+        ~Zone() {
+            if (active) {
+                record(name, begin, clock::now());
+            }
+        }
+
+        Zone(const Zone&) = delete;
+        Zone& operator=(const Zone&) = delete;
+    };
+}
+
+#define PROFILER_CONCAT_IMPL(a, b) a##b
+#define PROFILER_CONCAT(a, b) PROFILER_CONCAT_IMPL(a, b)
+
+/// @brief Profile the rest of the current scope as named zone
+#define PROFILE_ZONE(name) \
+    debug::profiler::Zone PROFILER_CONCAT(profilerZone_, __LINE__)(name)
@@ -5,6 +5,7 @@
 #endif
 
 #include "debug/Logger.hpp"
+#include "debug/Profiler.hpp"
 #include "assets/AssetsLoader.hpp"
 #include "audio/audio.hpp"
 #include "coders/GLSLExtension.hpp"
@@ -38,6 +39,7 @@
 #include "Mainloop.hpp"
 #include "ServerMainloop.hpp"
 
+#include <fstream>
 #include <iostream>
 #include <assert.h>
 #include <glm/glm.hpp>
@@ -82,6 +84,10 @@ void Engine::initialize(CoreParameters coreParameters) {
     if (params.headless) {
         logger.info() << "headless mode is enabled";
     }
+    if (!params.profileFile.empty()) {
+        logger.info() << "profiler capture is enabled";
+        debug::profiler::start();
+    }
     paths.setResourcesFolder(params.resFolder);
     paths.setUserFilesFolder(params.userFolder);
     paths.prepare();
@@ -280,6 +286,13 @@ void Engine::close() {
         window.reset();
         logger.info() << "window closed";
     }
+    if (!params.profileFile.empty()) {
+        debug::profiler::stop();
+        std::ofstream file(params.profileFile, std::ios::binary);
+        file << debug::profiler::to_chrome_trace();
+        logger.info() << "profiler capture written to "
+                      << params.profileFile.string();
+    }
     logger.info() << "engine finished";
 }
 
@@ -381,6 +394,10 @@ Time& Engine::getTime() {
     return time;
 }
 
+TickMetrics& Engine::getTickMetrics() {
+    return tickMetrics;
+}
+
 const CoreParameters& Engine::getCoreParameters() const {
     return params;
 }
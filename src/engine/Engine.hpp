@@ -9,6 +9,7 @@
 #include "util/ObjectsKeeper.hpp"
 #include "PostRunnables.hpp"
 #include "Time.hpp"
+#include "TickMetrics.hpp"
 
 #include <memory>
 #include <string>
@@ -48,6 +49,18 @@ struct CoreParameters {
     std::filesystem::path resFolder = "res";
     std::filesystem::path userFolder = ".";
     std::filesystem::path scriptFile;
+    /// @brief Chrome trace file written on shutdown if not empty
+    std::filesystem::path profileFile;
+    /// @brief World opened by dedicated server if no script specified
+    std::string worldName;
+    /// @brief Dedicated server ticks per second
+    int tickRate = 20;
+    /// @brief Run missed ticks back-to-back instead of skipping them
+    bool tickCatchUp = false;
+    /// @brief Tick metrics file periodically written by dedicated server
+    std::filesystem::path metricsFile;
+    /// @brief Session recording to replay in headless mode
+    std::filesystem::path replayFile;
 };
 
 using OnWorldOpen = std::function<void(std::unique_ptr<Level>, int64_t)>;
@@ -70,6 +83,7 @@ class Engine : public util::ObjectsKeeper {
     std::unique_ptr<devtools::Editor> editor;
     PostRunnables postRunnables;
     Time time;
+    TickMetrics tickMetrics;
     OnWorldOpen levelConsumer;
     bool quitSignal = false;
     
@@ -141,6 +155,8 @@ public:
 
     Time& getTime();
 
+    TickMetrics& getTickMetrics();
+
     const CoreParameters& getCoreParameters() const;
 
     bool isHeadless() const;
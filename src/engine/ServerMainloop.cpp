@@ -2,20 +2,51 @@
 
 #include "Engine.hpp"
 #include "logic/scripting/scripting.hpp"
+#include "logic/EngineController.hpp"
 #include "logic/LevelController.hpp"
+#include "logic/SessionReplayer.hpp"
 #include "interfaces/Process.hpp"
 #include "debug/Logger.hpp"
 #include "world/Level.hpp"
 #include "world/World.hpp"
 #include "util/platform.hpp"
 
-#include <chrono>
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <thread>
+#include <vector>
 
 using namespace std::chrono;
 
 static debug::Logger logger("mainloop");
 
-inline constexpr int TPS = 20;
+/// @brief Max ticks behind schedule to run back-to-back in catch-up mode
+inline constexpr int MAX_CATCH_UP_TICKS = 10;
+/// @brief Time before the tick spent spinning instead of sleeping,
+/// covers the system timer granularity
+inline constexpr auto SPIN_THRESHOLD = milliseconds(2);
+inline constexpr auto METRICS_INTERVAL = seconds(5);
+inline constexpr auto OVERLOAD_WARNING_INTERVAL = seconds(15);
+/// @brief Number of the slowest replayed ticks listed in log
+inline constexpr size_t REPLAY_SLOWEST_TICKS = 10;
+
+/// @brief Wait until time point sleeping in milliseconds and spinning
+/// for the rest
+static void wait_until(steady_clock::time_point target) {
+    while (true) {
+        auto remaining = target - steady_clock::now();
+        if (remaining <= steady_clock::duration::zero()) {
+            return;
+        }
+        auto millis = duration_cast<milliseconds>(remaining - SPIN_THRESHOLD);
+        if (millis.count() > 0) {
+            platform::sleep(millis.count());
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
 
 ServerMainloop::ServerMainloop(Engine& engine) : engine(engine) {
 }
@@ -25,57 +56,240 @@ ServerMainloop::~ServerMainloop() = default;
 void ServerMainloop::run() {
     const auto& coreParams = engine.getCoreParameters();
     auto& time = engine.getTime();
+    auto& metrics = engine.getTickMetrics();
 
-    if (coreParams.scriptFile.empty()) {
+    if (coreParams.scriptFile.empty() && coreParams.worldName.empty() &&
+        coreParams.replayFile.empty()) {
         logger.info() << "nothing to do";
         return;
     }
     engine.setLevelConsumer([this](auto level, auto) {
         setLevel(std::move(level));
     });
+    if (!coreParams.replayFile.empty()) {
+        runReplay();
+        return;
+    }
 
-    logger.info() << "starting test " << coreParams.scriptFile.string();
-    auto process = scripting::start_coroutine(
-        "script:" + coreParams.scriptFile.filename().u8string()
-    );
+    std::unique_ptr<Process> process;
+    if (!coreParams.scriptFile.empty()) {
+        logger.info() << "starting test " << coreParams.scriptFile.string();
+        process = scripting::start_coroutine(
+            "script:" + coreParams.scriptFile.filename().u8string()
+        );
+    } else if (!openWorld(coreParams.worldName)) {
+        return;
+    }
 
-    double targetDelta = 1.0 / static_cast<double>(TPS);
-    double delta = targetDelta;
-    auto begin = system_clock::now();
-    auto startupTime = begin;
+    int tickRate = coreParams.tickRate;
+    metrics.reset();
+    metrics.setTargetRate(tickRate);
+    logger.info() << "running at " << tickRate << " TPS ("
+                  << (coreParams.tickCatchUp ? "catch-up" : "skip")
+                  << " on overload)";
 
-    while (process->isActive()) {
+    double delta = 1.0 / static_cast<double>(tickRate);
+    auto step = duration_cast<steady_clock::duration>(duration<double>(delta));
+    auto startupTime = steady_clock::now();
+    auto nextTick = startupTime;
+    auto lastMetricsWrite = startupTime;
+    auto lastOverloadWarning = startupTime - OVERLOAD_WARNING_INTERVAL;
+
+    while (process == nullptr || process->isActive()) {
         if (engine.isQuitSignal()) {
-            process->terminate();
-            logger.info() << "script has been terminated due to quit signal";
+            if (process) {
+                process->terminate();
+                logger.info() << "script has been terminated due to quit signal";
+            }
             break;
         }
-        if (coreParams.testMode) {
-            time.step(delta);
-        } else {
-            auto now = system_clock::now();
-            time.update(
-                duration_cast<microseconds>(now - startupTime).count() / 1e6);
-            delta = time.getDelta();
+        auto tickStart = steady_clock::now();
+        // fixed step: missed ticks slow down the world instead of
+        // making steps longer
+        time.step(delta);
+        if (process) {
+            process->update();
         }
-        process->update();
         if (controller) {
             controller->getLevel()->getWorld()->updateTimers(delta);
-            controller->update(glm::min(delta, 0.2), false);
+            controller->update(delta, false);
         }
         engine.postUpdate();
 
-        if (!coreParams.testMode) {
-            auto end = system_clock::now();
-            int64_t millis = targetDelta * 1000 - 
-                duration_cast<microseconds>(end - begin).count() / 1000;
-            if (millis > 0) {
-                platform::sleep(millis);
+        auto tickEnd = steady_clock::now();
+        metrics.record(
+            duration<double>(tickStart - startupTime).count(),
+            duration<double>(tickEnd - tickStart).count()
+        );
+        if (coreParams.testMode) {
+            continue;
+        }
+        if (!coreParams.metricsFile.empty() &&
+            tickEnd - lastMetricsWrite >= METRICS_INTERVAL) {
+            lastMetricsWrite = tickEnd;
+            writeMetrics();
+        }
+
+        nextTick += step;
+        auto behind = (tickEnd - nextTick) / step;
+        if (behind > 0 &&
+            (!coreParams.tickCatchUp || behind > MAX_CATCH_UP_TICKS)) {
+            metrics.addSkipped(behind);
+            metrics.addOverload();
+            nextTick += step * behind;
+            if (tickEnd - lastOverloadWarning >= OVERLOAD_WARNING_INTERVAL) {
+                lastOverloadWarning = tickEnd;
+                logger.warning() << "can't keep up, skipped " << behind
+                                 << " ticks (" << metrics.getSkipped()
+                                 << " total)";
             }
-            begin = system_clock::now();
         }
+        wait_until(nextTick);
+    }
+    if (!coreParams.metricsFile.empty()) {
+        writeMetrics();
+    }
+    if (process == nullptr && controller) {
+        controller->saveWorld();
+        controller->onWorldQuit();
+        controller = nullptr;
+    }
+    logger.info() << (process ? "script finished" : "server stopped");
+}
+
+bool ServerMainloop::openWorld(const std::string& name) {
+    logger.info() << "opening world " << name;
+    try {
+        engine.getController()->openWorld(name, false);
+    } catch (const std::exception& err) {
+        logger.error() << "could not open world: " << err.what();
+        return false;
+    }
+    if (controller == nullptr) {
+        logger.error() << "could not open world " << name;
+        return false;
+    }
+    return true;
+}
+
+void ServerMainloop::runReplay() {
+    const auto& coreParams = engine.getCoreParameters();
+    auto& time = engine.getTime();
+    const auto& file = coreParams.replayFile;
+
+    std::unique_ptr<SessionReplayer> replayer;
+    try {
+        std::ifstream stream(file, std::ios::binary);
+        if (!stream) {
+            throw std::runtime_error("could not open file");
+        }
+        std::vector<ubyte> data(
+            (std::istreambuf_iterator<char>(stream)),
+            std::istreambuf_iterator<char>()
+        );
+        replayer = std::make_unique<SessionReplayer>(std::move(data));
+    } catch (const std::exception& err) {
+        logger.error() << "could not read recording " << file.u8string()
+                       << ": " << err.what();
+        return;
+    }
+    // the recorded world is already modified by the session, so replay
+    // must run on the snapshot written on the recording start
+    if (coreParams.worldName.empty()) {
+        logger.error() << "recording is made on snapshot "
+                       << replayer->getSnapshot()
+                       << ": copy it to the worlds folder and pass its "
+                          "name with --world";
+        return;
+    }
+    if (!openWorld(coreParams.worldName)) {
+        return;
+    }
+    logger.info() << "replaying " << file.u8string();
+
+    std::vector<std::pair<float, double>> timings;
+    auto startTime = steady_clock::now();
+    float delta;
+    while (!engine.isQuitSignal() && controller &&
+           replayer->beginTick(*controller, delta)) {
+        auto tickStart = steady_clock::now();
+        time.step(delta);
+        controller->getLevel()->getWorld()->updateTimers(delta);
+        controller->update(delta, false);
+        replayer->endTick(*controller);
+        engine.postUpdate();
+        timings.emplace_back(
+            delta, duration<double>(steady_clock::now() - tickStart).count()
+        );
+    }
+    double elapsed = duration<double>(steady_clock::now() - startTime).count();
+
+    TickMetrics metrics(timings.size());
+    double recorded = 0.0;
+    for (const auto& [tickDelta, duration] : timings) {
+        metrics.record(recorded, duration);
+        recorded += tickDelta;
+    }
+    auto stats = metrics.getStats();
+    logger.info() << "replayed " << timings.size() << " ticks ("
+                  << recorded << " s recorded) in " << elapsed
+                  << " s: mspt mean " << stats.msptMean << ", p50 "
+                  << stats.msptP50 << ", p95 " << stats.msptP95 << ", p99 "
+                  << stats.msptP99 << ", max " << stats.msptMax;
+
+    std::vector<size_t> slowest(timings.size());
+    for (size_t i = 0; i < slowest.size(); i++) {
+        slowest[i] = i;
+    }
+    size_t reported = std::min<size_t>(REPLAY_SLOWEST_TICKS, slowest.size());
+    std::partial_sort(
+        slowest.begin(),
+        slowest.begin() + reported,
+        slowest.end(),
+        [&timings](size_t a, size_t b) {
+            return timings[a].second > timings[b].second;
+        }
+    );
+    for (size_t i = 0; i < reported; i++) {
+        logger.info() << "slow tick " << slowest[i] + 1 << ": "
+                      << timings[slowest[i]].second * 1000.0 << " ms";
+    }
+
+    auto timingsFile = file;
+    timingsFile += ".timings.csv";
+    std::ofstream csv(timingsFile);
+    csv << "tick,delta,ms\n";
+    for (size_t i = 0; i < timings.size(); i++) {
+        csv << i + 1 << ',' << timings[i].first << ','
+            << timings[i].second * 1000.0 << '\n';
+    }
+    logger.info() << "tick timings written to " << timingsFile.u8string();
+
+    if (controller) {
+        controller->onWorldQuit();
+        controller = nullptr;
+    }
+}
+
+void ServerMainloop::writeMetrics() {
+    const auto& file = engine.getCoreParameters().metricsFile;
+    // written to a temporary file first so readers never see a partial one
+    auto tmpFile = file;
+    tmpFile += ".tmp";
+    {
+        std::ofstream stream(tmpFile, std::ios::binary);
+        stream << engine.getTickMetrics().toText();
+        if (!stream) {
+            logger.error() << "could not write metrics to " << tmpFile.u8string();
+            return;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmpFile, file, ec);
+    if (ec) {
+        logger.error() << "could not write metrics to " << file.u8string()
+                       << ": " << ec.message();
     }
-    logger.info() << "script finished";
 }
 
 void ServerMainloop::setLevel(std::unique_ptr<Level> level) {
@@ -1,14 +1,27 @@
 #pragma once
 
+#include <chrono>
 #include <memory>
+#include <string>
 
 class Level;
 class LevelController;
 class Engine;
 
+/// @brief Headless main loop running ticks at fixed rate.
+///
+/// Runs a `--script` coroutine, serves a `--world` until quit signal or
+/// replays a `--replay` session recording as fast as possible.
+/// Ticks are paced with sleep followed by a short spin. When overloaded,
+/// missed ticks are either skipped or run back-to-back (`--catch-up`)
+/// up to a limit.
 class ServerMainloop {
     Engine& engine;
     std::unique_ptr<LevelController> controller;
+
+    void writeMetrics();
+    bool openWorld(const std::string& name);
+    void runReplay();
 public:
     ServerMainloop(Engine& engine);
     ~ServerMainloop();
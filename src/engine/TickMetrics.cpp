@@ -0,0 +1,123 @@
+#include "TickMetrics.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+TickMetrics::TickMetrics(size_t capacity) : samples(std::max<size_t>(capacity, 2)) {
+}
+
+void TickMetrics::record(double start, double duration) {
+    samples[next] = Sample {start, duration};
+    next = (next + 1) % samples.size();
+    count = std::min(count + 1, samples.size());
+    ticks++;
+}
+
+void TickMetrics::addSkipped(uint64_t count) {
+    skipped += count;
+}
+
+void TickMetrics::addOverload() {
+    overloads++;
+}
+
+void TickMetrics::setTargetRate(double rate) {
+    targetRate = rate;
+}
+
+/// @brief Nearest-rank percentile of sorted values
+static double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * sorted.size()));
+    return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+}
+
+TickStats TickMetrics::getStats() const {
+    TickStats stats {};
+    stats.samples = count;
+    if (count == 0) {
+        return stats;
+    }
+    size_t first = (next + samples.size() - count) % samples.size();
+
+    std::vector<double> durations;
+    std::vector<double> intervals;
+    durations.reserve(count);
+    intervals.reserve(count);
+    double sum = 0.0;
+    for (size_t i = 0; i < count; i++) {
+        const auto& sample = samples[(first + i) % samples.size()];
+        durations.push_back(sample.duration * 1000.0);
+        sum += sample.duration * 1000.0;
+        if (i > 0) {
+            const auto& prev = samples[(first + i - 1) % samples.size()];
+            intervals.push_back(sample.start - prev.start);
+        }
+    }
+    std::sort(durations.begin(), durations.end());
+    stats.msptMean = sum / count;
+    stats.msptP50 = percentile(durations, 50);
+    stats.msptP95 = percentile(durations, 95);
+    stats.msptP99 = percentile(durations, 99);
+    stats.msptMax = durations.back();
+
+    if (intervals.empty()) {
+        return stats;
+    }
+    double span = samples[(next + samples.size() - 1) % samples.size()].start -
+                  samples[first].start;
+    if (span > 0.0) {
+        stats.tps = intervals.size() / span;
+    }
+    std::sort(intervals.begin(), intervals.end());
+    auto rate = [](double interval) {
+        return interval > 0.0 ? 1.0 / interval : 0.0;
+    };
+    stats.tpsP50 = rate(percentile(intervals, 50));
+    stats.tpsP5 = rate(percentile(intervals, 95));
+    stats.tpsP1 = rate(percentile(intervals, 99));
+    return stats;
+}
+
+std::string TickMetrics::toText() const {
+    auto stats = getStats();
+    std::stringstream ss;
+    ss << "# HELP voxelcore_tps Ticks per second in the window\n";
+    ss << "# TYPE voxelcore_tps gauge\n";
+    ss << "voxelcore_tps " << stats.tps << "\n";
+    ss << "voxelcore_tps{quantile=\"0.5\"} " << stats.tpsP50 << "\n";
+    ss << "voxelcore_tps{quantile=\"0.05\"} " << stats.tpsP5 << "\n";
+    ss << "voxelcore_tps{quantile=\"0.01\"} " << stats.tpsP1 << "\n";
+    ss << "# HELP voxelcore_tps_target Target ticks per second\n";
+    ss << "# TYPE voxelcore_tps_target gauge\n";
+    ss << "voxelcore_tps_target " << targetRate << "\n";
+    ss << "# HELP voxelcore_mspt Milliseconds per tick in the window\n";
+    ss << "# TYPE voxelcore_mspt summary\n";
+    ss << "voxelcore_mspt{quantile=\"0.5\"} " << stats.msptP50 << "\n";
+    ss << "voxelcore_mspt{quantile=\"0.95\"} " << stats.msptP95 << "\n";
+    ss << "voxelcore_mspt{quantile=\"0.99\"} " << stats.msptP99 << "\n";
+    ss << "voxelcore_mspt{quantile=\"1\"} " << stats.msptMax << "\n";
+    ss << "voxelcore_mspt_sum " << stats.msptMean * stats.samples << "\n";
+    ss << "voxelcore_mspt_count " << stats.samples << "\n";
+    ss << "# HELP voxelcore_ticks_total Ticks performed\n";
+    ss << "# TYPE voxelcore_ticks_total counter\n";
+    ss << "voxelcore_ticks_total " << ticks << "\n";
+    ss << "# HELP voxelcore_ticks_skipped_total Ticks dropped due to overload\n";
+    ss << "# TYPE voxelcore_ticks_skipped_total counter\n";
+    ss << "voxelcore_ticks_skipped_total " << skipped << "\n";
+    ss << "# HELP voxelcore_overloads_total Times the loop fell behind\n";
+    ss << "# TYPE voxelcore_overloads_total counter\n";
+    ss << "voxelcore_overloads_total " << overloads << "\n";
+    return ss.str();
+}
+
+void TickMetrics::reset() {
+    next = 0;
+    count = 0;
+    ticks = 0;
+    skipped = 0;
+    overloads = 0;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct TickStats {
+    /// @brief Number of ticks in the window
+    size_t samples = 0;
+    /// @brief Mean ticks per second in the window
+    double tps = 0.0;
+    /// @brief Median ticks per second
+    double tpsP50 = 0.0;
+    /// @brief Ticks per second of the slowest 5% intervals
+    double tpsP5 = 0.0;
+    /// @brief Ticks per second of the slowest 1% intervals
+    double tpsP1 = 0.0;
+    /// @brief Milliseconds per tick
+    double msptMean = 0.0;
+    double msptP50 = 0.0;
+    double msptP95 = 0.0;
+    double msptP99 = 0.0;
+    double msptMax = 0.0;
+};
+
+/// @brief Rolling tick duration statistics of the server main loop
+class TickMetrics {
+    struct Sample {
+        /// @brief Tick start time in seconds
+        double start;
+        /// @brief Tick duration in seconds
+        double duration;
+    };
+    std::vector<Sample> samples;
+    size_t next = 0;
+    size_t count = 0;
+    double targetRate = 20.0;
+    uint64_t ticks = 0;
+    uint64_t skipped = 0;
+    uint64_t overloads = 0;
+public:
+    /// @param capacity window size (in ticks)
+    explicit TickMetrics(size_t capacity = 1200);
+
+    /// @brief Record finished tick
+    /// @param start tick start time in seconds
+    /// @param duration tick duration in seconds
+    void record(double start, double duration);
+
+    /// @brief Count ticks dropped due to overload
+    void addSkipped(uint64_t count);
+
+    /// @brief Count moments when the loop fell too far behind
+    void addOverload();
+
+    void setTargetRate(double rate);
+
+    double getTargetRate() const {
+        return targetRate;
+    }
+
+    uint64_t getTicks() const {
+        return ticks;
+    }
+
+    uint64_t getSkipped() const {
+        return skipped;
+    }
+
+    uint64_t getOverloads() const {
+        return overloads;
+    }
+
+    /// @brief Calculate window statistics
+    TickStats getStats() const;
+
+    /// @brief Export metrics in Prometheus text exposition format
+    std::string toText() const;
+
+    void reset();
+};
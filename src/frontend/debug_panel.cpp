@@ -24,6 +24,9 @@
 #include "voxels/Chunk.hpp"
 #include "voxels/Chunks.hpp"
 #include "voxels/GlobalChunks.hpp"
+#include "world/files/RegionsSaver.hpp"
+#include "world/files/WorldFiles.hpp"
+#include "world/files/WorldRegions.hpp"
 #include "world/Level.hpp"
 #include "world/World.hpp"
 
@@ -123,6 +126,27 @@ std::shared_ptr<UINode> create_debug_panel(
         return L"chunks: "+std::to_wstring(level.chunks->size())+
                L" visible: "+std::to_wstring(ChunksRenderer::visibleChunks);
     }));
+    panel->add(create_label(gui, [&]() -> std::wstring {
+        auto saver = level.getWorld()->wfile->getRegions().getSaver();
+        if (saver == nullptr) {
+            return L"saving: sync";
+        }
+        return L"saving queue: " + std::to_wstring(saver->getQueueDepth()) +
+               L" written: " +
+               std::to_wstring(saver->getBytesWritten() / 1024) + L" KiB";
+    }));
+    panel->add(create_label(gui, [&]() {
+        auto stats = level.getWorld()->wfile->getRegions().getCacheStats();
+        return L"regions: " + std::to_wstring(stats.regions) + L" " +
+               std::to_wstring(stats.memoryUsage >> 20) + L"/" +
+               std::to_wstring(stats.memoryBudget >> 20) + L" MiB";
+    }));
+    panel->add(create_label(gui, [&]() {
+        auto stats = level.getWorld()->wfile->getRegions().getCacheStats();
+        return L"hits: " + std::to_wstring(stats.hits) + L" misses: " +
+               std::to_wstring(stats.misses) + L" evicted: " +
+               std::to_wstring(stats.evictions);
+    }));
     panel->add(create_label(gui, [&]() {
         return L"entities: "+std::to_wstring(level.entities->size())+L" next: "+
                std::to_wstring(level.entities->peekNextID());
@@ -60,7 +60,7 @@ LevelScreen::LevelScreen(
     controller =
         std::make_unique<LevelController>(&engine, std::move(levelPtr), player);
     playerController = std::make_unique<PlayerController>(
-        settings, *level, *player, *controller->getBlocksController()
+        settings, *level, *player, *controller
     );
 
     frontend = std::make_unique<LevelFrontend>(
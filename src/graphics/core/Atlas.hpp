@@ -36,6 +36,10 @@ public:
 
     Texture* getTexture() const;
     ImageData* getImage() const;
+
+    const std::unordered_map<std::string, UVRegion>& getRegions() const {
+        return regions;
+    }
 };
 
 struct atlasentry {
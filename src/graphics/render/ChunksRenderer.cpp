@@ -1,6 +1,8 @@
 #include "ChunksRenderer.hpp"
 #include "BlocksRenderer.hpp"
 #include "debug/Logger.hpp"
+#include "debug/Metrics.hpp"
+#include "debug/Profiler.hpp"
 #include "assets/Assets.hpp"
 #include "graphics/core/Mesh.hpp"
 #include "graphics/core/Shader.hpp"
@@ -40,12 +42,22 @@ public:
     }
 
     RendererResult operator()(const std::shared_ptr<Chunk>& chunk) override {
+        static auto& meshingTime =
+            debug::metrics::histogram("chunks.meshing.time");
+        static auto& meshed = debug::metrics::counter("chunks.meshed");
+
+        PROFILE_ZONE("chunk meshing");
+        auto begin = std::chrono::steady_clock::now();
         renderer.build(chunk.get(), &chunks);
         if (renderer.isCancelled()) {
             return RendererResult {
                 glm::ivec2(chunk->x, chunk->z), true, ChunkMeshData {}};
         }
         auto meshData = renderer.createMesh();
+        meshingTime.observe(std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - begin
+        ).count());
+        meshed.add();
         return RendererResult {
             glm::ivec2(chunk->x, chunk->z), false, std::move(meshData)};
     }
@@ -139,7 +151,10 @@ const Mesh* ChunksRenderer::getOrRender(
 }
 
 void ChunksRenderer::update() {
+    static auto& meshingQueue = debug::metrics::gauge("chunks.meshing.queue");
+
     threadPool.update();
+    meshingQueue.set(inwork.size());
 }
 
 const Mesh* ChunksRenderer::retrieveChunk(
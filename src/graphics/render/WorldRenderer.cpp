@@ -155,8 +155,11 @@ void WorldRenderer::renderLevel(
     texts->render(ctx, camera, settings, hudVisible, false);
 
     bool culling = engine.getSettings().graphics.frustumCulling.get();
-    float fogFactor =
-        15.0f / static_cast<float>(settings.chunks.loadDistance.get() - 2);
+    // load distance may be lowered by adaptive distance controller
+    int loadDistance = std::max(
+        3, player.chunks->getWidth() / 2 - settings.chunks.padding.get()
+    );
+    float fogFactor = 15.0f / static_cast<float>(loadDistance - 2);
 
     auto& entityShader = assets.require<Shader>("entity");
     setupWorldShader(entityShader, camera, settings, fogFactor);
@@ -63,6 +63,17 @@ SettingsHandler::SettingsHandler(EngineSettings& settings) {
     builder.add("load-distance", &settings.chunks.loadDistance);
     builder.add("load-speed", &settings.chunks.loadSpeed);
     builder.add("padding", &settings.chunks.padding);
+    builder.add("prototypes-cache", &settings.chunks.prototypesCache);
+    builder.add("prototypes-spill", &settings.chunks.prototypesSpill);
+    builder.add("save-workers", &settings.chunks.saveWorkers);
+    builder.add("regions-memory", &settings.chunks.regionsMemory);
+    builder.add("save-journal", &settings.chunks.saveJournal);
+    builder.add("save-deltas", &settings.chunks.saveDeltas);
+    builder.add("adaptive-distance", &settings.chunks.adaptiveDistance);
+    builder.add("min-load-distance", &settings.chunks.minLoadDistance);
+    builder.add("simulation-distance", &settings.chunks.simulationDistance);
+    builder.add("target-tick-time", &settings.chunks.targetTickTime);
+    builder.add("max-backlog", &settings.chunks.maxBacklog);
 
     builder.section("graphics");
     builder.add("fog-curve", &settings.graphics.fogCurve);
@@ -82,6 +93,8 @@ SettingsHandler::SettingsHandler(EngineSettings& settings) {
     builder.section("debug");
     builder.add("generator-test-mode", &settings.debug.generatorTestMode);
     builder.add("do-write-lights", &settings.debug.doWriteLights);
+    builder.add("scripts-budget", &settings.debug.scriptsBudget);
+    builder.add("scripts-throttle", &settings.debug.scriptsThrottle);
 }
 
 dv::value SettingsHandler::getValue(const std::string& name) const {
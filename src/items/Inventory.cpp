@@ -1,5 +1,6 @@
 #include "Inventory.hpp"
 
+#include "coders/binary_json.hpp"
 #include "content/ContentReport.hpp"
 
 Inventory::Inventory(int64_t id, size_t size) : id(id), slots(size) {
@@ -81,6 +82,48 @@ void Inventory::deserialize(const dv::value& src) {
     }
 }
 
+static ItemStack read_item(json::BinaryCursor& cursor) {
+    itemid_t id = 0;
+    itemcount_t count = 0;
+    dv::value fields = nullptr;
+    cursor.enterObject();
+    while (cursor.hasNext()) {
+        auto key = cursor.readKey();
+        if (key == "id") {
+            id = cursor.readInteger();
+        } else if (key == "count") {
+            count = cursor.readInteger();
+        } else if (key == "fields") {
+            fields = cursor.readValue();
+        } else {
+            cursor.skip();
+        }
+    }
+    return ItemStack(id, count, fields);
+}
+
+void Inventory::deserialize(json::BinaryCursor& cursor) {
+    id = 1;
+    size_t slotscount = 0;
+    cursor.enterObject();
+    while (cursor.hasNext()) {
+        auto key = cursor.readKey();
+        if (key == "id") {
+            id = cursor.readInteger();
+        } else if (key == "slots") {
+            cursor.enterList();
+            for (; cursor.hasNext(); slotscount++) {
+                if (slots.size() <= slotscount) {
+                    slots.emplace_back();
+                }
+                slots[slotscount].set(read_item(cursor));
+            }
+        } else {
+            cursor.skip();
+        }
+    }
+}
+
 dv::value Inventory::serialize() const {
     auto map = dv::object();
     map["id"] = id;
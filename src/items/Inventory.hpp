@@ -10,6 +10,10 @@
 class ContentReport;
 class ContentIndices;
 
+namespace json {
+    class BinaryCursor;
+}
+
 class Inventory : public Serializable {
     int64_t id;
     std::vector<ItemStack> slots;
@@ -37,6 +41,9 @@ public:
 
     void deserialize(const dv::value& src) override;
 
+    /// @brief Read inventory from binary json without decoding whole tree
+    void deserialize(json::BinaryCursor& cursor);
+
     dv::value serialize() const override;
 
     void convert(const ContentReport* report);
@@ -4,6 +4,7 @@
 #include "LightSolver.hpp"
 #include "Lightmap.hpp"
 #include "content/Content.hpp"
+#include "debug/Metrics.hpp"
 #include "voxels/Chunks.hpp"
 #include "voxels/Chunk.hpp"
 #include "voxels/voxel.hpp"
@@ -48,6 +49,16 @@ void LightSolver::remove(int x, int y, int z) {
 }
 
 void LightSolver::solve(){
+    static auto& queueSizes = debug::metrics::histogram("lighting.queue");
+    static auto& entriesSolved = debug::metrics::counter("lighting.entries");
+
+    size_t queued = remqueue.size() + addqueue.size();
+    if (queued == 0) {
+        return;
+    }
+    queueSizes.observe(queued);
+    uint64_t solved = 0;
+
     const int coords[] = {
             0, 0, 1,
             0, 0,-1,
@@ -60,6 +71,7 @@ void LightSolver::solve(){
     while (!remqueue.empty()){
         const lightentry entry = remqueue.front();
         remqueue.pop();
+        solved++;
 
         for (int i = 0; i < 6; i++) {
             int imul3 = i*3;
@@ -97,6 +109,7 @@ void LightSolver::solve(){
     while (!addqueue.empty()){
         const lightentry entry = addqueue.front();
         addqueue.pop();
+        solved++;
 
         for (int i = 0; i < 6; i++) {
             int imul3 = i*3;
@@ -123,4 +136,5 @@ void LightSolver::solve(){
             }
         }
     }
+    entriesSolved.add(solved);
 }
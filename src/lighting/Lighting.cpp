@@ -9,7 +9,9 @@
 #include "constants.hpp"
 #include "util/timeutil.hpp"
 #include "debug/Logger.hpp"
+#include "debug/Profiler.hpp"
 
+#include <algorithm>
 #include <memory>
 
 static debug::Logger logger("lighting");
@@ -63,6 +65,7 @@ void Lighting::prebuildSkyLight(Chunk& chunk, const ContentIndices& indices){
 }
 
 void Lighting::buildSkyLight(int cx, int cz){
+    PROFILE_ZONE("Lighting::buildSkyLight");
     const auto blockDefs = content.getIndices()->blocks.getDefs();
 
     Chunk* chunk = chunks.getChunk(cx, cz);
@@ -95,6 +98,7 @@ void Lighting::buildSkyLight(int cx, int cz){
 
 
 void Lighting::onChunkLoaded(int cx, int cz, bool expand) {
+    PROFILE_ZONE("Lighting::onChunkLoaded");
     auto& solverR = *this->solverR;
     auto& solverG = *this->solverG;
     auto& solverB = *this->solverB;
@@ -161,6 +165,7 @@ void Lighting::onChunkLoaded(int cx, int cz, bool expand) {
 }
 
 void Lighting::onBlockSet(int x, int y, int z, blockid_t id){
+    PROFILE_ZONE("Lighting::onBlockSet");
     const auto& block = content.getIndices()->blocks.require(id);
     solverR->remove(x,y,z);
     solverG->remove(x,y,z);
@@ -213,3 +218,103 @@ void Lighting::onBlockSet(int x, int y, int z, blockid_t id){
         }
     }
 }
+
+void Lighting::onAreaSet(int x1, int y1, int z1, int x2, int y2, int z2) {
+    y1 = std::max(y1, 0);
+    y2 = std::min(y2, CHUNK_H - 1);
+    if (y1 > y2) {
+        return;
+    }
+    auto& solverR = *this->solverR;
+    auto& solverG = *this->solverG;
+    auto& solverB = *this->solverB;
+    auto& solverS = *this->solverS;
+    auto blockDefs = content.getIndices()->blocks.getDefs();
+
+    // remove all lights inside the area
+    for (int y = y1; y <= y2; y++) {
+        for (int z = z1; z <= z2; z++) {
+            for (int x = x1; x <= x2; x++) {
+                solverR.remove(x, y, z);
+                solverG.remove(x, y, z);
+                solverB.remove(x, y, z);
+                solverS.remove(x, y, z);
+            }
+        }
+    }
+    // remove direct sky light passing through the area
+    for (int z = z1; z <= z2; z++) {
+        for (int x = x1; x <= x2; x++) {
+            for (int y = y1 - 1; y >= 0; y--) {
+                if (chunks.getLight(x, y, z, 3) != 0xF) {
+                    break;
+                }
+                solverS.remove(x, y, z);
+            }
+        }
+    }
+    solverR.solve();
+    solverG.solve();
+    solverB.solve();
+    solverS.solve();
+
+    // emitters inside the area
+    for (int y = y1; y <= y2; y++) {
+        for (int z = z1; z <= z2; z++) {
+            for (int x = x1; x <= x2; x++) {
+                const voxel* vox = chunks.get(x, y, z);
+                if (vox == nullptr) {
+                    continue;
+                }
+                const Block* block = blockDefs[vox->id];
+                if (block->rt.emissive) {
+                    solverR.add(x, y, z, block->emission[0]);
+                    solverG.add(x, y, z, block->emission[1]);
+                    solverB.add(x, y, z, block->emission[2]);
+                }
+            }
+        }
+    }
+    // direct sky light through and under the area
+    for (int z = z1; z <= z2; z++) {
+        for (int x = x1; x <= x2; x++) {
+            if (y2 + 1 < CHUNK_H && chunks.getLight(x, y2 + 1, z, 3) != 0xF) {
+                continue;
+            }
+            for (int y = y2; y >= 0; y--) {
+                const voxel* vox = chunks.get(x, y, z);
+                if (vox == nullptr || !blockDefs[vox->id]->skyLightPassing) {
+                    break;
+                }
+                solverS.add(x, y, z, 0xF);
+            }
+        }
+    }
+    // lights coming from the area neighbours
+    auto addBorder = [&](int x, int y, int z) {
+        solverR.add(x, y, z);
+        solverG.add(x, y, z);
+        solverB.add(x, y, z);
+        solverS.add(x, y, z);
+    };
+    for (int y = y1; y <= y2; y++) {
+        for (int z = z1; z <= z2; z++) {
+            addBorder(x1 - 1, y, z);
+            addBorder(x2 + 1, y, z);
+        }
+        for (int x = x1; x <= x2; x++) {
+            addBorder(x, y, z1 - 1);
+            addBorder(x, y, z2 + 1);
+        }
+    }
+    for (int z = z1; z <= z2; z++) {
+        for (int x = x1; x <= x2; x++) {
+            addBorder(x, y1 - 1, z);
+            addBorder(x, y2 + 1, z);
+        }
+    }
+    solverR.solve();
+    solverG.solve();
+    solverB.solve();
+    solverS.solve();
+}
@@ -24,5 +24,15 @@ public:
     void onChunkLoaded(int cx, int cz, bool expand);
     void onBlockSet(int x, int y, int z, blockid_t id);
 
+    /// @brief Recalculate lights after multiple blocks changed in the area
+    /// using single solve instead of onBlockSet call per block
+    /// @param x1 area minimum X (inclusive)
+    /// @param y1 area minimum Y (inclusive)
+    /// @param z1 area minimum Z (inclusive)
+    /// @param x2 area maximum X (inclusive)
+    /// @param y2 area maximum Y (inclusive)
+    /// @param z2 area maximum Z (inclusive)
+    void onAreaSet(int x1, int y1, int z1, int x2, int y2, int z2);
+
     static void prebuildSkyLight(Chunk& chunk, const ContentIndices& indices);
 };
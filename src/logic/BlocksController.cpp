@@ -1,8 +1,7 @@
 #include "BlocksController.hpp"
 
-#include <set>
-
 #include "content/Content.hpp"
+#include "debug/Profiler.hpp"
 #include "items/Inventories.hpp"
 #include "items/Inventory.hpp"
 #include "lighting/Lighting.hpp"
@@ -12,6 +11,7 @@
 #include "voxels/Block.hpp"
 #include "voxels/Chunk.hpp"
 #include "voxels/Chunks.hpp"
+#include "voxels/GlobalChunks.hpp"
 #include "voxels/voxel.hpp"
 #include "voxels/blocks_agent.hpp"
 #include "world/Level.hpp"
@@ -60,6 +60,24 @@ void BlocksController::updateSides(int x, int y, int z, int w, int h, int d) {
     }
 }
 
+void BlocksController::updateAreaSides(
+    const glm::ivec3& min, const glm::ivec3& max
+) {
+    for (int y = min.y - 1; y <= max.y + 1; y++) {
+        bool yside = y < min.y || y > max.y;
+        for (int z = min.z - 1; z <= max.z + 1; z++) {
+            if (yside || z < min.z || z > max.z) {
+                for (int x = min.x - 1; x <= max.x + 1; x++) {
+                    updateBlock(x, y, z);
+                }
+            } else {
+                updateBlock(min.x - 1, y, z);
+                updateBlock(max.x + 1, y, z);
+            }
+        }
+    }
+}
+
 void BlocksController::breakBlock(
     Player* player, const Block& def, int x, int y, int z
 ) {
@@ -119,9 +137,10 @@ void BlocksController::updateBlock(int x, int y, int z) {
     }
 }
 
-void BlocksController::update(float delta, uint padding) {
+void BlocksController::update(float delta) {
+    PROFILE_ZONE("BlocksController::update");
     if (randTickClock.update(delta)) {
-        randomTick(randTickClock.getPart(), randTickClock.getParts(), padding);
+        randomTick(randTickClock.getPart(), randTickClock.getParts());
     }
     if (blocksTickClock.update(delta)) {
         onBlocksTick(blocksTickClock.getPart(), blocksTickClock.getParts());
@@ -132,6 +151,7 @@ void BlocksController::update(float delta, uint padding) {
 }
 
 void BlocksController::onBlocksTick(int tickid, int parts) {
+    PROFILE_ZONE("BlocksController::onBlocksTick");
     const auto& indices = level.content.getIndices()->blocks;
     int tickRate = blocksTickClock.getTickRate();
     for (size_t id = 0; id < indices.count(); id++) {
@@ -168,42 +188,19 @@ void BlocksController::randomTick(
     }
 }
 
-void BlocksController::randomTick(int tickid, int parts, uint padding) {
+void BlocksController::randomTick(int tickid, int parts) {
+    PROFILE_ZONE("BlocksController::randomTick");
     auto indices = level.content.getIndices();
+    int segments = 4;
 
-    std::set<uint64_t> chunksIterated;
-
-    for (const auto& [pid, player] : *level.players) {
-        const auto& chunks = *player->chunks;
-        int offsetX = chunks.getOffsetX();
-        int offsetY = chunks.getOffsetY();
-        int width = chunks.getWidth();
-        int height = chunks.getHeight();
-        int segments = 4;
-
-        for (uint z = padding; z < height - padding; z++) {
-            for (uint x = padding; x < width - padding; x++) {
-                int index = z * width + x;
-                if ((index + tickid) % parts != 0) {
-                    continue;
-                }
-                auto& chunk = chunks.getChunks()[index];
-                if (chunk == nullptr || !chunk->flags.lighted) {
-                    continue;
-                }
-                union {
-                    int32_t pos[2];
-                    uint64_t key;
-                } posU;
-                posU.pos[0] = x + offsetX;
-                posU.pos[1] = z + offsetY;
-                if (chunksIterated.find(posU.key) != chunksIterated.end()) {
-                    continue;
-                }
-                chunksIterated.insert(posU.key);
-                randomTick(*chunk, segments, indices);
-            }
+    for (const Chunk* chunk : chunks.getActiveChunks()) {
+        // stable chunk part independent of the active chunks order
+        uint32_t hash = static_cast<uint32_t>(chunk->x) * 73856093U ^
+                        static_cast<uint32_t>(chunk->z) * 19349663U;
+        if ((hash + tickid) % parts != 0 || !chunk->flags.lighted) {
+            continue;
         }
+        randomTick(*chunk, segments, indices);
     }
 }
 
@@ -40,16 +40,22 @@ public:
     void updateSides(int x, int y, int z, int w, int h, int d);
     void updateBlock(int x, int y, int z);
 
+    /// @brief Update blocks surrounding the area once
+    /// @param min area minimum corner (inclusive)
+    /// @param max area maximum corner (inclusive)
+    void updateAreaSides(const glm::ivec3& min, const glm::ivec3& max);
+
     void breakBlock(Player* player, const Block& def, int x, int y, int z);
     void placeBlock(
         Player* player, const Block& def, blockstate state, int x, int y, int z
     );
 
-    void update(float delta, uint padding);
+    void update(float delta);
     void randomTick(
         const Chunk& chunk, int segments, const ContentIndices* indices
     );
-    void randomTick(int tickid, int parts, uint padding);
+    /// @brief Random tick active chunks part
+    void randomTick(int tickid, int parts);
     void onBlocksTick(int tickid, int parts);
     int64_t createBlockInventory(int x, int y, int z);
     void bindInventory(int64_t invid, int x, int y, int z);
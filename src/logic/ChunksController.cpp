@@ -4,12 +4,14 @@
 #include <memory>
 
 #include "content/Content.hpp"
+#include "debug/Profiler.hpp"
 #include "world/files/WorldFiles.hpp"
 #include "graphics/core/Mesh.hpp"
 #include "lighting/Lighting.hpp"
 #include "maths/voxmaths.hpp"
 #include "util/timeutil.hpp"
 #include "objects/Player.hpp"
+#include "objects/Players.hpp"
 #include "voxels/Block.hpp"
 #include "voxels/Chunk.hpp"
 #include "voxels/Chunks.hpp"
@@ -17,23 +19,55 @@
 #include "world/Level.hpp"
 #include "world/World.hpp"
 #include "world/generator/WorldGenerator.hpp"
+#include "world/generator/PrototypeCache.hpp"
+#include "settings.hpp"
 
 const uint MAX_WORK_PER_FRAME = 128;
 const uint MIN_SURROUNDING = 9;
 
-ChunksController::ChunksController(Level& level)
+ChunksController::ChunksController(
+    Level& level, const ChunksSettings& settings
+)
     : level(level),
       generator(std::make_unique<WorldGenerator>(
           level.content.generators.require(level.getWorld()->getGenerator()),
           level.content,
           level.getWorld()->getSeed()
-      )) {}
+      )) {
+    if (int capacity = settings.prototypesCache.get()) {
+        const auto& world = *level.getWorld();
+        io::path spillFolder;
+        if (settings.prototypesSpill.get()) {
+            spillFolder = world.wfile->getFolder() / "prototypes";
+        }
+        generator->setPrototypeCache(std::make_unique<PrototypeCache>(
+            level.content.generators.require(world.getGenerator()),
+            level.content,
+            world.getSeed(),
+            capacity,
+            spillFolder
+        ));
+    }
+    const auto& world = *level.getWorld();
+    const auto& def = level.content.generators.require(world.getGenerator());
+    const auto& content = level.content;
+    uint64_t seed = world.getSeed();
+    world.wfile->getRegions().setBaselineGenerator(
+        [this](int x, int z, voxel* dst) { generator->generate(dst, x, z); },
+        [&def, &content, seed]() {
+            return WorldGenerator::createStandalone(def, content, seed);
+        }
+    );
+}
 
-ChunksController::~ChunksController() = default;
+ChunksController::~ChunksController() {
+    level.getWorld()->wfile->getRegions().setBaselineGenerator(nullptr);
+}
 
 void ChunksController::update(
     int64_t maxDuration, int loadDistance, uint padding, Player& player
-) const {
+) {
+    PROFILE_ZONE("ChunksController::update");
     const auto& position = player.getPosition();
     int centerX = floordiv<CHUNK_W>(glm::floor(position.x));
     int centerY = floordiv<CHUNK_D>(glm::floor(position.z));
@@ -45,11 +79,12 @@ void ChunksController::update(
         return;
     }
 
+    auto& scheduler = getScheduler(player, padding);
     int64_t mcstotal = 0;
 
     for (uint i = 0; i < MAX_WORK_PER_FRAME; i++) {
         timeutil::Timer timer;
-        if (loadVisible(player, padding)) {
+        if (loadVisible(player, scheduler)) {
             int64_t mcs = timer.stop();
             if (mcstotal + mcs < maxDuration * 1000) {
                 mcstotal += mcs;
@@ -60,87 +95,122 @@ void ChunksController::update(
     }
 }
 
-bool ChunksController::loadVisible(const Player& player, uint padding) const {
+size_t ChunksController::getBacklog(const Player& player) const {
+    const auto& found = schedulers.find(player.getId());
+    if (found == schedulers.end()) {
+        return 0;
+    }
+    return found->second.getPendingCount();
+}
+
+void ChunksController::requestLights(int x, int z) {
+    for (auto& [_, scheduler] : schedulers) {
+        if (scheduler.isInside(x, z)) {
+            scheduler.requestLights(x, z);
+        }
+    }
+}
+
+void ChunksController::removePlayer(u64id_t playerId) {
+    schedulers.erase(playerId);
+}
+
+ChunksScheduler& ChunksController::getScheduler(
+    const Player& player, uint padding
+) {
     const auto& chunks = *player.chunks;
-    int sizeX = chunks.getWidth();
-    int sizeY = chunks.getHeight();
-
-    int nearX = 0;
-    int nearZ = 0;
-    bool assigned = false;
-    int minDistance = ((sizeX - padding * 2) / 2) * ((sizeY - padding * 2) / 2);
-    for (uint z = padding; z < sizeY - padding; z++) {
-        for (uint x = padding; x < sizeX - padding; x++) {
-            int index = z * sizeX + x;
-            auto& chunk = chunks.getChunks()[index];
-            if (chunk != nullptr) {
-                if (chunk->flags.loaded && !chunk->flags.lighted) {
-                    if (buildLights(player, chunk)) {
-                        return true;
-                    }
-                }
-                continue;
-            }
-            int lx = x - sizeX / 2;
-            int lz = z - sizeY / 2;
-            int distance = (lx * lx + lz * lz);
-            if (distance < minDistance) {
-                minDistance = distance;
-                nearX = x;
-                nearZ = z;
-                assigned = true;
+    auto& scheduler = schedulers[player.getId()];
+    int radius = chunks.getWidth() / 2 - static_cast<int>(padding);
+    int centerX = chunks.getOffsetX() + chunks.getWidth() / 2;
+    int centerZ = chunks.getOffsetY() + chunks.getHeight() / 2;
+    bool reset = scheduler.setArea(centerX, centerZ, radius);
+    // loaded cells can't outnumber matrix chunks unless it was cleared
+    if (!reset && chunks.getChunksCount() < scheduler.getLoadedCount()) {
+        scheduler.reset();
+        reset = true;
+    }
+    if (reset) {
+        for (const auto& chunk : chunks.getChunks()) {
+            if (chunk && chunk->flags.loaded && !chunk->flags.lighted) {
+                scheduler.onChunkLoaded(chunk->x, chunk->z);
             }
         }
     }
+    return scheduler;
+}
 
-    const auto& chunk = chunks.getChunks()[nearZ * sizeX + nearX];
-    if (chunk != nullptr || !assigned || !player.isLoadingChunks()) {
+bool ChunksController::loadVisible(
+    const Player& player, ChunksScheduler& scheduler
+) {
+    const auto& chunks = *player.chunks;
+    int x, z;
+    while (scheduler.nextLightsCandidate(x, z)) {
+        auto chunk = chunks.getChunk(x, z);
+        if (chunk == nullptr || !chunk->flags.loaded || chunk->flags.lighted) {
+            continue;
+        }
+        if (buildLights(player, *chunk)) {
+            return true;
+        }
+    }
+    if (!player.isLoadingChunks()) {
+        return false;
+    }
+    auto isLoaded = [&chunks](int x, int z) {
+        return chunks.getChunk(x, z) != nullptr;
+    };
+    if (!scheduler.nextMissing(isLoaded, x, z)) {
         return false;
     }
-    int offsetX = chunks.getOffsetX();
-    int offsetY = chunks.getOffsetY();
-    createChunk(player, nearX + offsetX, nearZ + offsetY);
+    createChunk(player, x, z);
     return true;
 }
 
 bool ChunksController::buildLights(
-    const Player& player, const std::shared_ptr<Chunk>& chunk
+    const Player& player, Chunk& chunk
 ) const {
     int surrounding = 0;
     for (int oz = -1; oz <= 1; oz++) {
         for (int ox = -1; ox <= 1; ox++) {
-            if (player.chunks->getChunk(chunk->x + ox, chunk->z + oz))
+            if (player.chunks->getChunk(chunk.x + ox, chunk.z + oz))
                 surrounding++;
         }
     }
     if (surrounding == MIN_SURROUNDING) {
         if (lighting) {
-            bool lightsCache = chunk->flags.loadedLights;
+            bool lightsCache = chunk.flags.loadedLights;
             if (!lightsCache) {
-                lighting->buildSkyLight(chunk->x, chunk->z);
+                lighting->buildSkyLight(chunk.x, chunk.z);
             }
-            lighting->onChunkLoaded(chunk->x, chunk->z, !lightsCache);
+            lighting->onChunkLoaded(chunk.x, chunk.z, !lightsCache);
         }
-        chunk->flags.lighted = true;
+        chunk.flags.lighted = true;
         return true;
     }
     return false;
 }
 
-void ChunksController::createChunk(const Player& player, int x, int z) const {
+void ChunksController::createChunk(const Player& player, int x, int z) {
     if (!player.isLoadingChunks()) {
         if (auto chunk = level.chunks->fetch(x, z)) {
             player.chunks->putChunk(chunk);
+            schedulers[player.getId()].onChunkLoaded(x, z);
         }
         return;
     }
     auto chunk = level.chunks->create(x, z);
     player.chunks->putChunk(chunk);
+    schedulers[player.getId()].onChunkLoaded(x, z);
     auto& chunkFlags = chunk->flags;
+    if (chunkFlags.ready) {
+        // already loaded by another player
+        return;
+    }
 
     if (!chunkFlags.loaded) {
         generator->generate(chunk->voxels, x, z);
         chunkFlags.unsaved = true;
+        chunkFlags.generated = true;
     }
     chunk->updateHeights();
 
@@ -149,4 +219,20 @@ void ChunksController::createChunk(const Player& player, int x, int z) const {
     }
     chunkFlags.loaded = true;
     chunkFlags.ready = true;
+    shareChunk(player, chunk);
+}
+
+void ChunksController::shareChunk(
+    const Player& player, const std::shared_ptr<Chunk>& chunk
+) {
+    for (const auto& [id, other] : *level.players) {
+        if (other.get() == &player || other->isSuspended()) {
+            continue;
+        }
+        auto& chunks = *other->chunks;
+        if (chunks.getChunk(chunk->x, chunk->z) == nullptr &&
+            chunks.putChunk(chunk)) {
+            schedulers[id].onChunkLoaded(chunk->x, chunk->z);
+        }
+    }
 }
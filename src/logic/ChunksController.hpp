@@ -1,7 +1,9 @@
 #pragma once
 
 #include <memory>
+#include <unordered_map>
 
+#include "ChunksScheduler.hpp"
 #include "typedefs.hpp"
 
 class Level;
@@ -10,27 +12,48 @@ class Chunks;
 class Player;
 class Lighting;
 class WorldGenerator;
+struct ChunksSettings;
 
 /// @brief ChunksController manages chunks dynamic loading/unloading
 class ChunksController {
 private:
     Level& level;
     std::unique_ptr<WorldGenerator> generator;
+    /// @brief Loading schedulers by player id
+    std::unordered_map<u64id_t, ChunksScheduler> schedulers;
+
+    /// @brief Update player scheduler area
+    ChunksScheduler& getScheduler(const Player& player, uint padding);
 
     /// @brief Process one chunk: load it or calculate lights for it
-    bool loadVisible(const Player& player, uint padding) const;
-    bool buildLights(const Player& player, const std::shared_ptr<Chunk>& chunk) const;
-    void createChunk(const Player& player, int x, int y) const;
+    bool loadVisible(const Player& player, ChunksScheduler& scheduler);
+    bool buildLights(const Player& player, Chunk& chunk) const;
+    void createChunk(const Player& player, int x, int y);
+
+    /// @brief Put created chunk to matrices of other players which
+    /// areas contain the chunk, so it is not handled again
+    void shareChunk(const Player& player, const std::shared_ptr<Chunk>& chunk);
 public:
     std::unique_ptr<Lighting> lighting;
 
-    ChunksController(Level& level);
+    ChunksController(Level& level, const ChunksSettings& settings);
     ~ChunksController();
 
     /// @param maxDuration milliseconds reserved for chunks loading
     void update(
         int64_t maxDuration, int loadDistance, uint padding, Player& player
-    ) const;
+    );
+
+    /// @return number of chunks waiting for loading or lights building
+    /// in the player area
+    size_t getBacklog(const Player& player) const;
+
+    /// @brief Queue chunk for lights building in areas of all players
+    /// containing it. Must be called when chunk lighted flag is cleared
+    void requestLights(int x, int z);
+
+    /// @brief Forget loading scheduler of removed player
+    void removePlayer(u64id_t playerId);
 
     const WorldGenerator* getGenerator() const {
         return generator.get();
@@ -0,0 +1,111 @@
+#include "ChunksScheduler.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+bool ChunksScheduler::setArea(int centerX, int centerZ, int radius) {
+    if (radius != this->radius) {
+        this->radius = radius;
+        this->centerX = centerX;
+        this->centerZ = centerZ;
+        cells.clear();
+        for (int z = -radius; z < radius; z++) {
+            for (int x = -radius; x < radius; x++) {
+                int distance = x * x + z * z;
+                if (distance < radius * radius) {
+                    cells.push_back(Cell {x, z, distance});
+                }
+            }
+        }
+        // stable sort keeps row order of equidistant cells
+        std::stable_sort(
+            cells.begin(), cells.end(), [](const auto& a, const auto& b) {
+                return a.distance < b.distance;
+            }
+        );
+        reset();
+        return true;
+    }
+    int dx = centerX - this->centerX;
+    int dz = centerZ - this->centerZ;
+    if (dx == 0 && dz == 0) {
+        return false;
+    }
+    this->centerX = centerX;
+    this->centerZ = centerZ;
+    if (cursor == 0) {
+        return false;
+    }
+    // cells closer than `loaded` to the previous center are loaded,
+    // so cells closer than `loaded - shift` to the new center are too
+    double loaded = cursor < cells.size()
+                        ? std::sqrt(cells[cursor].distance)
+                        : radius;
+    int keep = std::floor(loaded - std::sqrt(dx * dx + dz * dz));
+    if (keep <= 0) {
+        cursor = 0;
+        return false;
+    }
+    int keepDistance = keep * keep;
+    cursor = std::lower_bound(
+                 cells.begin(),
+                 cells.begin() + cursor,
+                 keepDistance,
+                 [](const auto& cell, int distance) {
+                     return cell.distance < distance;
+                 }
+             ) -
+             cells.begin();
+    return false;
+}
+
+void ChunksScheduler::reset() {
+    cursor = 0;
+    lightsQueue.clear();
+}
+
+bool ChunksScheduler::nextMissing(
+    const std::function<bool(int, int)>& isLoaded, int& x, int& z
+) {
+    while (cursor < cells.size()) {
+        const auto& cell = cells[cursor];
+        if (!isLoaded(centerX + cell.x, centerZ + cell.z)) {
+            x = centerX + cell.x;
+            z = centerZ + cell.z;
+            return true;
+        }
+        cursor++;
+    }
+    return false;
+}
+
+void ChunksScheduler::onChunkLoaded(int x, int z) {
+    for (int oz = -1; oz <= 1; oz++) {
+        for (int ox = -1; ox <= 1; ox++) {
+            lightsQueue.emplace_back(x + ox, z + oz);
+        }
+    }
+}
+
+void ChunksScheduler::requestLights(int x, int z) {
+    lightsQueue.emplace_back(x, z);
+}
+
+bool ChunksScheduler::nextLightsCandidate(int& x, int& z) {
+    while (!lightsQueue.empty()) {
+        auto pos = lightsQueue.back();
+        lightsQueue.pop_back();
+        if (isInside(pos.x, pos.y)) {
+            x = pos.x;
+            z = pos.y;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ChunksScheduler::isInside(int x, int z) const {
+    int lx = x - centerX;
+    int lz = z - centerZ;
+    return lx >= -radius && lx < radius && lz >= -radius && lz < radius;
+}
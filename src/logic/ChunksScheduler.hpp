@@ -0,0 +1,75 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "delegates.hpp"
+#include "typedefs.hpp"
+
+/// @brief Incremental chunks loading queue of a player chunks matrix.
+///
+/// Replaces full matrix scan for the nearest missing chunk. Area cells are
+/// visited in order of distance from the center, skipping the prefix known
+/// to be loaded. When the center shifts, the prefix is shrunk by the shift
+/// distance instead of restarting. Loaded chunks are queued for lights
+/// building when they or their neighbours arrive.
+class ChunksScheduler {
+    struct Cell {
+        int x, z;
+        int distance;
+    };
+    int centerX = 0;
+    int centerZ = 0;
+    int radius = -1;
+    /// @brief Cells of the loading circle sorted by distance from center
+    std::vector<Cell> cells;
+    /// @brief All cells before the cursor are loaded
+    size_t cursor = 0;
+    /// @brief Chunks to check for lights building
+    std::vector<glm::ivec2> lightsQueue;
+public:
+    /// @brief Set loading circle
+    /// @param centerX center chunk X
+    /// @param centerZ center chunk Z
+    /// @param radius loading distance (in chunks)
+    /// @return true if scheduler is reset and must be refilled
+    /// with loaded chunks
+    bool setArea(int centerX, int centerZ, int radius);
+
+    /// @brief Forget loaded chunks (chunks matrix is cleared)
+    void reset();
+
+    /// @brief Find the nearest chunk not present in the matrix
+    /// @param isLoaded chunk presence check by chunk coords
+    /// @param x nearest missing chunk X destination
+    /// @param z nearest missing chunk Z destination
+    /// @return false if all chunks of the loading circle are loaded
+    bool nextMissing(
+        const std::function<bool(int, int)>& isLoaded, int& x, int& z
+    );
+
+    /// @brief Queue chunk and its neighbours for lights building check
+    void onChunkLoaded(int x, int z);
+
+    /// @brief Queue chunk for lights building check again
+    /// (its lighted flag is cleared)
+    void requestLights(int x, int z);
+
+    /// @brief Get next chunk to check for lights building
+    /// @return false if queue is empty
+    bool nextLightsCandidate(int& x, int& z);
+
+    /// @brief Check if chunk is inside of the loading square
+    bool isInside(int x, int z) const;
+
+    /// @return number of cells known to be loaded
+    size_t getLoadedCount() const {
+        return cursor;
+    }
+
+    /// @return number of cells not known to be loaded and chunks waiting
+    /// for lights building check
+    size_t getPendingCount() const {
+        return cells.size() - cursor + lightsQueue.size();
+    }
+};
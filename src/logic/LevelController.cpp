@@ -3,20 +3,30 @@
 #include <algorithm>
 
 #include "debug/Logger.hpp"
+#include "debug/Metrics.hpp"
+#include "debug/Profiler.hpp"
 #include "engine/Engine.hpp"
+#include "io/io.hpp"
 #include "world/files/WorldFiles.hpp"
+#include "world/files/WorldRegions.hpp"
+#include "world/files/WorldSnapshot.hpp"
 #include "maths/voxmaths.hpp"
 #include "objects/Entities.hpp"
 #include "objects/Players.hpp"
 #include "objects/Player.hpp"
 #include "physics/Hitbox.hpp"
 #include "voxels/Chunks.hpp"
+#include "voxels/GlobalChunks.hpp"
 #include "scripting/scripting.hpp"
+#include "scripting/scripting_stats.hpp"
 #include "lighting/Lighting.hpp"
 #include "settings.hpp"
+#include "util/timeutil.hpp"
 #include "world/LevelEvents.hpp"
 #include "world/Level.hpp"
 #include "world/World.hpp"
+#include "SessionRecorder.hpp"
+#include "WorldPregenerator.hpp"
 
 static debug::Logger logger("level-control");
 
@@ -25,7 +35,7 @@ LevelController::LevelController(
 )
     : settings(engine->getSettings()),
       level(std::move(levelPtr)),
-      chunks(std::make_unique<ChunksController>(*level)),
+      chunks(std::make_unique<ChunksController>(*level, settings.chunks)),
       playerTickClock(20, 3) {
     
     level->events->listen(LevelEventType::CHUNK_PRESENT, [](auto, Chunk* chunk) {
@@ -35,6 +45,25 @@ LevelController::LevelController(
         scripting::on_chunk_remove(*chunk);
     });
 
+    if (!level->getWorld()->isNameless()) {
+        auto& regions = level->getWorld()->wfile->getRegions();
+        int saveWorkers = settings.chunks.saveWorkers.get();
+        if (saveWorkers > 0) {
+            regions.startAsyncSaving(saveWorkers);
+        }
+        if (settings.chunks.saveJournal.get()) {
+            regions.enableJournal();
+        }
+        regions.setDeltaStorage(settings.chunks.saveDeltas.get());
+        // unsaved regions of nameless world can not be written back
+        regionsMemoryObserver = settings.chunks.regionsMemory.observe(
+            [&regions](integer_t megabytes) {
+                regions.setMemoryBudget(static_cast<size_t>(megabytes) << 20);
+            },
+            true
+        );
+    }
+
     if (clientPlayer) {
         chunks->lighting = std::make_unique<Lighting>(
             level->content, *clientPlayer->chunks
@@ -68,31 +97,48 @@ LevelController::LevelController(
     } while (confirmed < level->players->size());
 }
 
+LevelController::~LevelController() = default;
+
 void LevelController::update(float delta, bool pause) {
-    for (const auto& [_, player] : *level->players) {
-        if (player->isSuspended()) {
-            continue;
+    PROFILE_ZONE("LevelController::update");
+    timeutil::Timer timer;
+    if (recorder && !pause) {
+        recorder->beginTick(delta, *level->players);
+    }
+    if (pregenerator) {
+        try {
+            pregenerator->update();
+            if (!pregenerator->isActive()) {
+                pregenerator = nullptr;
+                saveWorld();
+            }
+        } catch (const std::exception& err) {
+            logger.error() << "pregeneration failed: " << err.what();
+            pregenerator = nullptr;
         }
-        player->rotationInterpolation.updateTimer(delta);
-        player->updateEntity();
-        glm::vec3 position = player->getPosition();
-        player->chunks->configure(
-            glm::floor(position.x),
-            glm::floor(position.z),
-            settings.chunks.loadDistance.get() + settings.chunks.padding.get()
-        );
-        chunks->update(
-            settings.chunks.loadSpeed.get(),
-            settings.chunks.loadDistance.get(),
-            settings.chunks.padding.get(),
-            *player
-        );
     }
+    {
+        PROFILE_ZONE("WorldRegions::update");
+        level->getWorld()->wfile->getRegions().update();
+    }
+    if (snapshot) {
+        try {
+            snapshot->update();
+        } catch (const std::exception& err) {
+            logger.error() << err.what();
+        }
+        if (!snapshot->isActive()) {
+            snapshot = nullptr;
+        }
+    }
+    bool simulationLimited = updatePlayersChunks(delta);
     if (!pause) {
         // update all objects that needed
-        blocks->update(delta, settings.chunks.padding.get());
+        blocks->update(delta);
+        level->entities->setSimulationLimited(simulationLimited);
         level->entities->updatePhysics(delta);
         level->entities->update(delta);
+        PROFILE_ZONE("players tick");
         for (const auto& [_, player] : *level->players) {
             if (player->isSuspended()) {
                 continue;
@@ -114,8 +160,124 @@ void LevelController::update(float delta, bool pause) {
                 }
             }
         }
+        scripting::stats::on_tick(
+            settings.debug.scriptsBudget.get(),
+            settings.debug.scriptsThrottle.get()
+        );
     }
     level->entities->clean();
+    updateMetrics();
+
+    static auto& updateTime = debug::metrics::histogram("level.update.time");
+    float elapsed = timer.stop() / 1000.0f;
+    updateTime.observe(elapsed);
+    if (settings.chunks.adaptiveDistance.get()) {
+        // chunks loading takes up to loadSpeed per player by design
+        loadDistances.addTickTime(std::max(0.0f, elapsed - chunksLoadTime));
+    }
+}
+
+bool LevelController::updatePlayersChunks(float delta) {
+    static auto& backlogGauge = debug::metrics::gauge("chunks.backlog");
+
+    const auto& chunksSettings = settings.chunks;
+    bool adaptive = chunksSettings.adaptiveDistance.get();
+    if (!adaptive) {
+        loadDistances.reset();
+    }
+    LoadDistanceLimits limits {
+        chunksSettings.minLoadDistance.get(),
+        chunksSettings.loadDistance.get(),
+        static_cast<float>(chunksSettings.targetTickTime.get()),
+        chunksSettings.maxBacklog.get()};
+    int padding = chunksSettings.padding.get();
+
+    bool simulationLimited = false;
+    size_t totalBacklog = 0;
+    chunksLoadTime = 0.0f;
+    for (const auto& [_, player] : *level->players) {
+        PROFILE_ZONE("players chunks");
+        if (player->isSuspended()) {
+            continue;
+        }
+        player->rotationInterpolation.updateTimer(delta);
+        player->updateEntity();
+
+        size_t backlog = chunks->getBacklog(*player);
+        totalBacklog += backlog;
+        int loadDistance = limits.maxDistance;
+        if (adaptive) {
+            loadDistance = loadDistances.update(
+                player->getId(), delta, static_cast<int>(backlog), limits
+            );
+        }
+        int simulationDistance = getSimulationDistance(player->getId());
+        simulationLimited |= simulationDistance < loadDistance;
+
+        glm::vec3 position = player->getPosition();
+        player->chunks->configure(
+            glm::floor(position.x),
+            glm::floor(position.z),
+            loadDistance + padding
+        );
+        const auto& playerChunks = *player->chunks;
+        // active (ticked) chunks are collected from viewers areas
+        level->chunks->setViewer(
+            player->getId(),
+            ChunksViewer {
+                playerChunks.getOffsetX() + playerChunks.getWidth() / 2,
+                playerChunks.getOffsetY() + playerChunks.getHeight() / 2,
+                simulationDistance
+            }
+        );
+        timeutil::Timer loadTimer;
+        chunks->update(
+            chunksSettings.loadSpeed.get(), loadDistance, padding, *player
+        );
+        chunksLoadTime += loadTimer.stop() / 1000.0f;
+    }
+    backlogGauge.set(totalBacklog);
+    return simulationLimited;
+}
+
+void LevelController::onPlayerRemoved(u64id_t playerId) {
+    loadDistances.removePlayer(playerId);
+    chunks->removePlayer(playerId);
+}
+
+int LevelController::getLoadDistance(u64id_t playerId) const {
+    int loadDistance = settings.chunks.loadDistance.get();
+    if (!settings.chunks.adaptiveDistance.get()) {
+        return loadDistance;
+    }
+    int distance = loadDistances.getDistance(playerId);
+    return distance > 0 ? std::min(distance, loadDistance) : loadDistance;
+}
+
+int LevelController::getSimulationDistance(u64id_t playerId) const {
+    int loadDistance = getLoadDistance(playerId);
+    int simulationDistance = settings.chunks.simulationDistance.get();
+    if (simulationDistance == 0) {
+        return loadDistance;
+    }
+    return std::min(simulationDistance, loadDistance);
+}
+
+void LevelController::updateMetrics() {
+    using namespace debug;
+    static auto& loadedChunks = metrics::gauge("chunks.loaded");
+    static auto& entitiesCount = metrics::gauge("entities.count");
+    static auto& playersCount = metrics::gauge("players.count");
+    static auto& regionsCount = metrics::gauge("regions.count");
+    static auto& regionsMemory = metrics::gauge("regions.memory");
+
+    loadedChunks.set(level->chunks->size());
+    entitiesCount.set(level->entities->size());
+    playersCount.set(level->players->size());
+
+    auto stats = level->getWorld()->wfile->getRegions().getCacheStats();
+    regionsCount.set(stats.regions);
+    regionsMemory.set(stats.memoryUsage);
 }
 
 void LevelController::saveWorld() {
@@ -125,14 +287,90 @@ void LevelController::saveWorld() {
         return;
     }
     logger.info() << "writing world '" << world->getName() << "'";
+    if (snapshot) {
+        // files must not be rewritten while being copied
+        snapshot->waitForCopies();
+    }
     world->wfile->createDirectories();
     scripting::on_world_save();
     level->onSave();
     level->getWorld()->write(level.get());
 }
 
+void LevelController::pregenerate(
+    glm::ivec2 minPos, glm::ivec2 maxPos, int workers
+) {
+    pregenerator = nullptr;
+    pregenerator = std::make_unique<WorldPregenerator>(
+        *level, minPos, maxPos, workers
+    );
+}
+
+WorldPregenerator* LevelController::getPregenerator() {
+    return pregenerator.get();
+}
+
+void LevelController::createSnapshot(const io::path& target) {
+    if (snapshot) {
+        throw std::runtime_error("snapshot is already being written");
+    }
+    auto world = level->getWorld();
+    if (world->isNameless()) {
+        throw std::runtime_error("nameless world can not be saved");
+    }
+    saveWorld();
+    snapshot = std::make_unique<WorldSnapshot>(*world->wfile, target);
+}
+
+WorldSnapshot* LevelController::getSnapshot() {
+    return snapshot.get();
+}
+
+void LevelController::startRecording(
+    const io::path& file, const io::path& snapshotTarget
+) {
+    if (recorder) {
+        throw std::runtime_error("session is already being recorded");
+    }
+    createSnapshot(snapshotTarget);
+    recorder = std::make_unique<SessionRecorder>(
+        io::write(file), snapshotTarget.string()
+    );
+    logger.info() << "recording session to " << file.string();
+}
+
+uint64_t LevelController::stopRecording() {
+    if (recorder == nullptr) {
+        return 0;
+    }
+    uint64_t ticks = recorder->getTicks();
+    recorder = nullptr;
+    logger.info() << "session recording finished (" << ticks << " ticks)";
+    return ticks;
+}
+
+SessionRecorder* LevelController::getRecorder() {
+    return recorder.get();
+}
+
 void LevelController::onWorldQuit() {
+    pregenerator = nullptr;
+    stopRecording();
+    if (snapshot) {
+        try {
+            snapshot->waitForEnd();
+        } catch (const std::exception& err) {
+            logger.error() << err.what();
+        }
+        snapshot = nullptr;
+    }
     scripting::on_world_quit();
+    // wait for chunks and regions being saved in background
+    try {
+        level->getWorld()->wfile->getRegions().flush();
+    } catch (const std::exception& err) {
+        logger.error() << err.what();
+    }
 }
 
 Level* LevelController::getLevel() {
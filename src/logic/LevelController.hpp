@@ -2,13 +2,21 @@
 
 #include <memory>
 
+#include <glm/glm.hpp>
+
 #include "BlocksController.hpp"
 #include "ChunksController.hpp"
+#include "LoadDistanceController.hpp"
+#include "io/path.hpp"
 #include "util/Clock.hpp"
+#include "util/observer_handler.hpp"
 
 class Engine;
 class Level;
 class Player;
+class WorldPregenerator;
+class WorldSnapshot;
+class SessionRecorder;
 struct EngineSettings;
 
 /// @brief LevelController manages other controllers
@@ -18,10 +26,28 @@ class LevelController {
     // Sub-controllers
     std::unique_ptr<BlocksController> blocks;
     std::unique_ptr<ChunksController> chunks;
+    std::unique_ptr<WorldPregenerator> pregenerator;
+    std::unique_ptr<WorldSnapshot> snapshot;
+    std::unique_ptr<SessionRecorder> recorder;
+    /// @brief Applies chunks.regions-memory setting changes
+    ObserverHandler regionsMemoryObserver;
 
     util::Clock playerTickClock;
+    LoadDistanceController loadDistances;
+    /// @brief Time spent on chunks loading during the last update
+    /// (milliseconds), excluded from adaptive distance tick time
+    float chunksLoadTime = 0.0f;
+
+    /// @brief Update players chunks areas and load chunks
+    /// @return true if simulation distance of any player is lower than
+    /// its load distance
+    bool updatePlayersChunks(float delta);
+
+    /// @brief Update level gauges of the metrics registry
+    void updateMetrics();
 public:
     LevelController(Engine* engine, std::unique_ptr<Level> level, Player* clientPlayer);
+    ~LevelController();
 
     /// @param delta time elapsed since the last update
     /// @param pause is world and player simulation paused
@@ -29,6 +55,50 @@ public:
 
     void saveWorld();
 
+    /// @brief Forget per-player controllers state of removed player
+    void onPlayerRemoved(u64id_t playerId);
+
+    /// @return effective load distance of the player (in chunks),
+    /// may be lowered by adaptive distance controller
+    int getLoadDistance(u64id_t playerId) const;
+
+    /// @return effective simulation distance of the player (in chunks):
+    /// random ticks, entities physics and updates radius
+    int getSimulationDistance(u64id_t playerId) const;
+
+    /// @brief Start pregeneration of the chunks area (replaces current one).
+    /// The world is saved when pregeneration is finished.
+    /// @param minPos area minimum chunk position (inclusive)
+    /// @param maxPos area maximum chunk position (inclusive)
+    /// @param workers max number of worker threads (0 - auto)
+    void pregenerate(glm::ivec2 minPos, glm::ivec2 maxPos, int workers);
+
+    /// @return active pregeneration task or nullptr
+    WorldPregenerator* getPregenerator();
+
+    /// @brief Save the world and start writing its snapshot to the target
+    /// directory or .zip archive in background
+    /// @throws std::runtime_error if another snapshot is being written
+    void createSnapshot(const io::path& target);
+
+    /// @return active snapshot task or nullptr
+    WorldSnapshot* getSnapshot();
+
+    /// @brief Write world snapshot and start recording the session
+    /// (replaced with --replay in headless mode)
+    /// @param file recording file
+    /// @param snapshotTarget snapshot target directory or .zip archive
+    /// @throws std::runtime_error if already recording or snapshot
+    /// can not be created
+    void startRecording(const io::path& file, const io::path& snapshotTarget);
+
+    /// @brief Finish recording
+    /// @return number of ticks recorded
+    uint64_t stopRecording();
+
+    /// @return active session recorder or nullptr
+    SessionRecorder* getRecorder();
+
     void onWorldQuit();
 
     Level* getLevel();
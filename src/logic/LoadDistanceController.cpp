@@ -0,0 +1,68 @@
+#include "LoadDistanceController.hpp"
+
+#include <algorithm>
+
+void LoadDistanceController::addTickTime(float milliseconds) {
+    tickTime += (milliseconds - tickTime) * SMOOTHING;
+}
+
+int LoadDistanceController::update(
+    u64id_t player, float delta, int backlog, const LoadDistanceLimits& limits
+) {
+    int minDistance = std::min(limits.minDistance, limits.maxDistance);
+    auto& state =
+        players.try_emplace(player, PlayerState {limits.maxDistance})
+            .first->second;
+    // bounds may be changed in settings
+    state.distance =
+        std::clamp(state.distance, minDistance, limits.maxDistance);
+
+    bool overloaded = tickTime > limits.targetTickTime;
+    int trend = 0;
+    if (overloaded || backlog > limits.maxBacklog) {
+        trend = -1;
+    } else if (tickTime < limits.targetTickTime * RAISE_THRESHOLD &&
+               backlog <= limits.maxBacklog * RAISE_THRESHOLD) {
+        // moving player always has some chunks to load at the area edge
+        trend = 1;
+    }
+    if (trend != state.trend) {
+        state.trend = trend;
+        state.timer = 0.0f;
+        state.backlog = backlog;
+    }
+    state.timer += delta;
+
+    if (trend < 0 && state.timer >= LOWER_INTERVAL) {
+        // backlog being drained is not a reason to lower distance
+        if ((overloaded || backlog >= state.backlog) &&
+            state.distance > minDistance) {
+            state.distance--;
+        }
+        state.timer = 0.0f;
+        state.backlog = backlog;
+    } else if (trend > 0 && state.timer >= RAISE_INTERVAL) {
+        if (state.distance < limits.maxDistance) {
+            state.distance++;
+        }
+        state.timer = 0.0f;
+    }
+    return state.distance;
+}
+
+void LoadDistanceController::removePlayer(u64id_t player) {
+    players.erase(player);
+}
+
+int LoadDistanceController::getDistance(u64id_t player) const {
+    const auto& found = players.find(player);
+    if (found == players.end()) {
+        return 0;
+    }
+    return found->second.distance;
+}
+
+void LoadDistanceController::reset() {
+    players.clear();
+    tickTime = 0.0f;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <unordered_map>
+
+#include "typedefs.hpp"
+
+/// @brief Adaptive load distance bounds and thresholds
+struct LoadDistanceLimits {
+    /// @brief Distance is never lowered below (in chunks)
+    int minDistance;
+    /// @brief Distance is never raised above (in chunks)
+    int maxDistance;
+    /// @brief Level update time target (in milliseconds)
+    float targetTickTime;
+    /// @brief Number of chunks waiting for loading or lights building
+    /// considered as loading backlog
+    int maxBacklog;
+};
+
+/// @brief Adapts players load distance to the level update time
+/// and chunks loading backlog.
+///
+/// Distance of a player is lowered by one chunk per LOWER_INTERVAL while
+/// smoothed update time exceeds the target or the player backlog is over
+/// the limit and does not decrease. It is raised back by one chunk per
+/// RAISE_INTERVAL while update time stays below RAISE_THRESHOLD of the
+/// target and the player backlog stays below RAISE_THRESHOLD of the limit.
+///
+/// Update time samples should not include time reserved for chunks
+/// loading, otherwise loading itself lowers the distance.
+class LoadDistanceController {
+    struct PlayerState {
+        int distance;
+        /// @brief -1 - lowering, 1 - raising, 0 - steady
+        int trend = 0;
+        /// @brief Time since the trend started or distance changed
+        float timer = 0.0f;
+        /// @brief Backlog at the moment the timer was reset
+        int backlog = 0;
+    };
+    std::unordered_map<u64id_t, PlayerState> players;
+    /// @brief Exponentially smoothed level update time (milliseconds)
+    float tickTime = 0.0f;
+public:
+    static constexpr float LOWER_INTERVAL = 1.0f;
+    static constexpr float RAISE_INTERVAL = 5.0f;
+    static constexpr float RAISE_THRESHOLD = 0.6f;
+    static constexpr float SMOOTHING = 0.1f;
+
+    /// @brief Add level update time sample
+    /// @param milliseconds measured update duration
+    void addTickTime(float milliseconds);
+
+    /// @brief Update player load distance
+    /// @param player player id
+    /// @param delta time elapsed since the last update (seconds)
+    /// @param backlog number of chunks waiting for loading or lights
+    /// building in the player area
+    /// @param limits distance bounds and thresholds
+    /// @return effective load distance of the player
+    int update(
+        u64id_t player, float delta, int backlog, const LoadDistanceLimits& limits
+    );
+
+    /// @brief Forget removed player
+    void removePlayer(u64id_t player);
+
+    /// @return effective load distance of the player or 0 if the player
+    /// is not controlled
+    int getDistance(u64id_t player) const;
+
+    /// @brief Forget all players (distances start from maximum again)
+    void reset();
+
+    /// @return smoothed level update time (milliseconds)
+    float getTickTime() const {
+        return tickTime;
+    }
+};
@@ -5,6 +5,8 @@
 #include <cmath>
 
 #include "BlocksController.hpp"
+#include "LevelController.hpp"
+#include "SessionRecorder.hpp"
 #include "content/Content.hpp"
 #include "core_defs.hpp"
 #include "engine/Engine.hpp"
@@ -215,12 +217,13 @@ PlayerController::PlayerController(
     const EngineSettings& settings,
     Level& level,
     Player& player,
-    BlocksController& blocksController
+    LevelController& controller
 )
     : level(level),
       player(player),
       camControl(player, settings.camera),
-      blocksController(blocksController) {
+      controller(controller),
+      blocksController(*controller.getBlocksController()) {
 }
 
 void PlayerController::onFootstep(const Hitbox& hitbox) {
@@ -424,6 +427,11 @@ void PlayerController::processRightClick(
     state.rotation = determine_rotation(&def, selection.normal, camera->dir);
 
     if (!input.shift && target.rt.funcsset.oninteract) {
+        if (auto recorder = controller.getRecorder()) {
+            recorder->onBlockInteract(
+                &player, target, selection.actualPosition
+            );
+        }
         if (scripting::on_block_interact(
                 &player, target, selection.actualPosition
             )) {
@@ -467,6 +475,9 @@ void PlayerController::processRightClick(
             auto& slot = player.getInventory()->getSlot(player.getChosenSlot());
             slot.setCount(slot.getCount() - 1);
         }
+        if (auto recorder = controller.getRecorder()) {
+            recorder->onBlockPlaced(&player, def, state, coord);
+        }
         blocksController.placeBlock(
             &player, def, state, coord.x, coord.y, coord.z
         );
@@ -481,10 +492,17 @@ void PlayerController::updateEntityInteraction(
         return;
     }
     auto entity = *entityOpt;
+    auto recorder = controller.getRecorder();
     if (lclick) {
+        if (recorder) {
+            recorder->onEntityAttacked(&player, eid);
+        }
         scripting::on_attacked(entity, &player, player.getEntity());
     }
     if (rclick) {
+        if (recorder) {
+            recorder->onEntityUsed(&player, eid);
+        }
         scripting::on_entity_used(entity, &player);
     }
 }
@@ -513,9 +531,13 @@ void PlayerController::updateInteraction(const Input& inputEvents, float delta)
     const ItemStack& stack = inventory->getSlot(player.getChosenSlot());
     auto& item = indices->items.require(stack.getItemId());
 
+    auto recorder = controller.getRecorder();
     auto vox = updateSelection(maxDistance);
     if (vox == nullptr) {
         if (rclick && item.rt.funcsset.on_use) {
+            if (recorder) {
+                recorder->onItemUse(&player, item);
+            }
             scripting::on_item_use(&player, item);
         }
         if (selection.entity) {
@@ -526,6 +548,9 @@ void PlayerController::updateInteraction(const Input& inputEvents, float delta)
 
     auto iend = selection.position;
     if (lclick && !input.shift && item.rt.funcsset.on_block_break_by) {
+        if (recorder) {
+            recorder->onItemBreakBlock(&player, item, iend);
+        }
         if (scripting::on_item_break_block(
                 &player, item, iend.x, iend.y, iend.z
             )) {
@@ -534,8 +559,14 @@ void PlayerController::updateInteraction(const Input& inputEvents, float delta)
     }
     auto& target = indices->blocks.require(vox->id);
     if (lclick) {
+        if (recorder) {
+            recorder->onBlockBreaking(&player, target, iend);
+        }
         scripting::on_block_breaking(&player, target, iend);
         if (player.isInstantDestruction() && target.breakable) {
+            if (recorder) {
+                recorder->onBlockBroken(&player, target, iend);
+            }
             blocksController.breakBlock(
                 &player, target, iend.x, iend.y, iend.z
             );
@@ -544,10 +575,18 @@ void PlayerController::updateInteraction(const Input& inputEvents, float delta)
     if (rclick && !input.shift) {
         bool preventDefault = false;
         if (item.rt.funcsset.on_use_on_block) {
+            if (recorder) {
+                recorder->onItemUseOnBlock(
+                    &player, item, iend, selection.normal
+                );
+            }
             preventDefault = scripting::on_item_use_on_block(
                 &player, item, iend, selection.normal
             );
         } else if (item.rt.funcsset.on_use) {
+            if (recorder) {
+                recorder->onItemUse(&player, item);
+            }
             preventDefault = scripting::on_item_use(&player, item);
         }
         if (preventDefault) {
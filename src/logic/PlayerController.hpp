@@ -14,6 +14,7 @@ class Level;
 class Block;
 class Chunks;
 class BlocksController;
+class LevelController;
 struct Hitbox;
 struct CameraSettings;
 struct EngineSettings;
@@ -52,6 +53,7 @@ class PlayerController {
     Player& player;
     PlayerInput input {};
     CameraControl camControl;
+    LevelController& controller;
     BlocksController& blocksController;
     float interactionTimer = 0.0f;
     
@@ -72,7 +74,7 @@ public:
         const EngineSettings& settings,
         Level& level,
         Player& player,
-        BlocksController& blocksController
+        LevelController& controller
     );
 
     /// @brief Called after blocks update if not paused
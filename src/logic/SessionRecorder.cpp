@@ -0,0 +1,169 @@
+#include "SessionRecorder.hpp"
+
+#include "items/ItemDef.hpp"
+#include "objects/Player.hpp"
+#include "objects/Players.hpp"
+#include "voxels/Block.hpp"
+
+using namespace session;
+
+/// @brief Buffered records size written to the output at once
+static constexpr size_t FLUSH_THRESHOLD = 64 * 1024;
+
+SessionRecorder::SessionRecorder(
+    std::unique_ptr<std::ostream> output, const std::string& snapshot
+)
+    : output(std::move(output)) {
+    buffer.put(reinterpret_cast<const ubyte*>(MAGIC), MAGIC_SIZE);
+    buffer.putInt32(VERSION);
+    buffer.put(snapshot);
+}
+
+SessionRecorder::~SessionRecorder() {
+    buffer.put(static_cast<ubyte>(RecordType::end));
+    flush();
+}
+
+void SessionRecorder::beginTick(float delta, const Players& players) {
+    beginTick(delta);
+    for (const auto& [id, player] : players) {
+        onPlayerState(
+            id,
+            PlayerState {
+                player->getPosition(),
+                player->getRotation(),
+                player->getChosenSlot(),
+                static_cast<ubyte>(
+                    (player->isFlight() ? PLAYER_FLIGHT : 0) |
+                    (player->isNoclip() ? PLAYER_NOCLIP : 0)
+                )}
+        );
+    }
+}
+
+void SessionRecorder::beginTick(float delta) {
+    flushIfFull();
+    buffer.put(static_cast<ubyte>(RecordType::tick));
+    buffer.putFloat32(delta);
+    ticks++;
+}
+
+void SessionRecorder::onPlayerState(u64id_t id, const PlayerState& state) {
+    const auto& found = states.find(id);
+    if (found != states.end() && found->second == state) {
+        return;
+    }
+    states[id] = state;
+    buffer.put(static_cast<ubyte>(RecordType::player));
+    buffer.putInt64(id);
+    for (int i = 0; i < 3; i++) {
+        buffer.putFloat32(state.position[i]);
+    }
+    for (int i = 0; i < 3; i++) {
+        buffer.putFloat32(state.rotation[i]);
+    }
+    buffer.putInt32(state.slot);
+    buffer.put(state.flags);
+}
+
+void SessionRecorder::putPlayer(const Player* player) {
+    buffer.putInt64(player ? static_cast<int64_t>(player->getId()) : -1);
+}
+
+void SessionRecorder::putPos(const glm::ivec3& pos) {
+    buffer.putInt32(pos.x);
+    buffer.putInt32(pos.y);
+    buffer.putInt32(pos.z);
+}
+
+void SessionRecorder::onBlockPlaced(
+    const Player* player,
+    const Block& def,
+    blockstate state,
+    const glm::ivec3& pos
+) {
+    buffer.put(static_cast<ubyte>(RecordType::blockPlace));
+    putPlayer(player);
+    putPos(pos);
+    buffer.put(def.name);
+    buffer.putInt16(blockstate2int(state));
+}
+
+void SessionRecorder::onBlockBroken(
+    const Player* player, const Block& def, const glm::ivec3& pos
+) {
+    buffer.put(static_cast<ubyte>(RecordType::blockBreak));
+    putPlayer(player);
+    putPos(pos);
+    buffer.put(def.name);
+}
+
+void SessionRecorder::onBlockInteract(
+    const Player* player, const Block& def, const glm::ivec3& pos
+) {
+    buffer.put(static_cast<ubyte>(RecordType::blockInteract));
+    putPlayer(player);
+    putPos(pos);
+    buffer.put(def.name);
+}
+
+void SessionRecorder::onBlockBreaking(
+    const Player* player, const Block& def, const glm::ivec3& pos
+) {
+    buffer.put(static_cast<ubyte>(RecordType::blockBreaking));
+    putPlayer(player);
+    putPos(pos);
+    buffer.put(def.name);
+}
+
+void SessionRecorder::onItemUse(const Player* player, const ItemDef& def) {
+    buffer.put(static_cast<ubyte>(RecordType::itemUse));
+    putPlayer(player);
+    buffer.put(def.name);
+}
+
+void SessionRecorder::onItemUseOnBlock(
+    const Player* player,
+    const ItemDef& def,
+    const glm::ivec3& pos,
+    const glm::ivec3& normal
+) {
+    buffer.put(static_cast<ubyte>(RecordType::itemUseOnBlock));
+    putPlayer(player);
+    putPos(pos);
+    putPos(normal);
+    buffer.put(def.name);
+}
+
+void SessionRecorder::onItemBreakBlock(
+    const Player* player, const ItemDef& def, const glm::ivec3& pos
+) {
+    buffer.put(static_cast<ubyte>(RecordType::itemBreakBlock));
+    putPlayer(player);
+    putPos(pos);
+    buffer.put(def.name);
+}
+
+void SessionRecorder::onEntityAttacked(const Player* player, entityid_t eid) {
+    buffer.put(static_cast<ubyte>(RecordType::entityAttacked));
+    putPlayer(player);
+    buffer.putInt64(eid);
+}
+
+void SessionRecorder::onEntityUsed(const Player* player, entityid_t eid) {
+    buffer.put(static_cast<ubyte>(RecordType::entityUsed));
+    putPlayer(player);
+    buffer.putInt64(eid);
+}
+
+void SessionRecorder::flushIfFull() {
+    if (buffer.size() >= FLUSH_THRESHOLD) {
+        flush();
+    }
+}
+
+void SessionRecorder::flush() {
+    output->write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+    output->flush();
+    buffer = ByteBuilder();
+}
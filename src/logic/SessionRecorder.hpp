@@ -0,0 +1,143 @@
+#pragma once
+
+#include <memory>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+
+#include <glm/glm.hpp>
+
+#include "coders/byte_utils.hpp"
+#include "typedefs.hpp"
+#include "voxels/voxel.hpp"
+
+class Block;
+class Player;
+class Players;
+struct ItemDef;
+
+namespace session {
+    inline constexpr const char* MAGIC = "VCREC";
+    inline constexpr size_t MAGIC_SIZE = 6;
+    inline constexpr int32_t VERSION = 1;
+
+    /// @brief Recording records. Records of a tick are the tick header,
+    /// players states changed before the level update and player
+    /// interactions performed after it
+    enum class RecordType : ubyte {
+        tick = 1,
+        player,
+        blockPlace,
+        blockBreak,
+        blockInteract,
+        blockBreaking,
+        itemUse,
+        itemUseOnBlock,
+        itemBreakBlock,
+        entityAttacked,
+        entityUsed,
+        end
+    };
+
+    enum PlayerFlags : ubyte {
+        PLAYER_FLIGHT = 1,
+        PLAYER_NOCLIP = 2,
+    };
+
+    /// @brief Player state, written when changed since the previous tick
+    struct PlayerState {
+        glm::vec3 position;
+        glm::vec3 rotation;
+        int slot;
+        /// @brief PlayerFlags
+        ubyte flags;
+
+        bool operator==(const PlayerState& o) const {
+            return position == o.position && rotation == o.rotation &&
+                   slot == o.slot && flags == o.flags;
+        }
+    };
+
+    /// @brief Player interaction record
+    struct Interaction {
+        RecordType type;
+        /// @brief Player id or -1
+        int64_t player;
+        glm::ivec3 pos {};
+        glm::ivec3 normal {};
+        /// @brief Block or item name
+        std::string name;
+        blockstate state {};
+        entityid_t entity = 0;
+    };
+}
+
+/// @brief Writes player inputs, block interactions and script-visible
+/// player events of the level with tick numbers.
+///
+/// Replayed by SessionReplayer on the world snapshot taken at the
+/// recording start.
+class SessionRecorder {
+    std::unique_ptr<std::ostream> output;
+    ByteBuilder buffer;
+    uint64_t ticks = 0;
+    std::unordered_map<u64id_t, session::PlayerState> states;
+
+    void putPlayer(const Player* player);
+    void putPos(const glm::ivec3& pos);
+    void flushIfFull();
+public:
+    /// @param output recording output stream
+    /// @param snapshot target of the world snapshot taken at the recording
+    /// start (the recording must be replayed on it)
+    SessionRecorder(
+        std::unique_ptr<std::ostream> output, const std::string& snapshot
+    );
+    /// @brief Finishes recording
+    ~SessionRecorder();
+
+    /// @brief Start tick record writing changed players states
+    void beginTick(float delta, const Players& players);
+
+    /// @brief Start tick record
+    void beginTick(float delta);
+
+    /// @brief Write player state if changed since the previous tick.
+    /// Must be called after beginTick before interactions
+    void onPlayerState(u64id_t id, const session::PlayerState& state);
+
+    void onBlockPlaced(
+        const Player* player,
+        const Block& def,
+        blockstate state,
+        const glm::ivec3& pos
+    );
+    void onBlockBroken(
+        const Player* player, const Block& def, const glm::ivec3& pos
+    );
+    void onBlockInteract(
+        const Player* player, const Block& def, const glm::ivec3& pos
+    );
+    void onBlockBreaking(
+        const Player* player, const Block& def, const glm::ivec3& pos
+    );
+    void onItemUse(const Player* player, const ItemDef& def);
+    void onItemUseOnBlock(
+        const Player* player,
+        const ItemDef& def,
+        const glm::ivec3& pos,
+        const glm::ivec3& normal
+    );
+    void onItemBreakBlock(
+        const Player* player, const ItemDef& def, const glm::ivec3& pos
+    );
+    void onEntityAttacked(const Player* player, entityid_t eid);
+    void onEntityUsed(const Player* player, entityid_t eid);
+
+    /// @brief Write buffered records
+    void flush();
+
+    uint64_t getTicks() const {
+        return ticks;
+    }
+};
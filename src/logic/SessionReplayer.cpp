@@ -0,0 +1,232 @@
+#include "SessionReplayer.hpp"
+
+#include <stdexcept>
+
+#include "SessionRecorder.hpp"
+#include "LevelController.hpp"
+#include "content/Content.hpp"
+#include "debug/Logger.hpp"
+#include "items/ItemDef.hpp"
+#include "objects/Entities.hpp"
+#include "objects/Player.hpp"
+#include "objects/Players.hpp"
+#include "scripting/scripting.hpp"
+#include "voxels/Block.hpp"
+#include "world/Level.hpp"
+
+static debug::Logger logger("replay");
+
+using namespace session;
+
+SessionReplayer::SessionReplayer(std::vector<ubyte> data)
+    : data(std::move(data)), reader(this->data) {
+    reader.checkMagic(MAGIC, MAGIC_SIZE);
+    int version = reader.getInt32();
+    if (version != VERSION) {
+        throw std::runtime_error(
+            "unsupported recording version " + std::to_string(version)
+        );
+    }
+    snapshot = reader.getString();
+}
+
+Player* SessionReplayer::getPlayer(LevelController& controller, int64_t id) {
+    if (id < 0) {
+        return nullptr;
+    }
+    auto& players = *controller.getLevel()->players;
+    if (auto player = players.get(id)) {
+        return player;
+    }
+    logger.warning() << "player " << id << " is missing, creating";
+    return players.create(id);
+}
+
+static glm::ivec3 get_pos(ByteReader& reader) {
+    glm::ivec3 pos;
+    pos.x = reader.getInt32();
+    pos.y = reader.getInt32();
+    pos.z = reader.getInt32();
+    return pos;
+}
+
+bool SessionReplayer::nextTick(float& delta) {
+    if (finished || !reader.hasNext() ||
+        reader.peek() != static_cast<ubyte>(RecordType::tick)) {
+        finished = true;
+        return false;
+    }
+    reader.get();
+    delta = reader.getFloat32();
+    tick++;
+    return true;
+}
+
+bool SessionReplayer::nextPlayerState(int64_t& id, PlayerState& state) {
+    if (!reader.hasNext() ||
+        reader.peek() != static_cast<ubyte>(RecordType::player)) {
+        return false;
+    }
+    reader.get();
+    id = reader.getInt64();
+    for (int i = 0; i < 3; i++) {
+        state.position[i] = reader.getFloat32();
+    }
+    for (int i = 0; i < 3; i++) {
+        state.rotation[i] = reader.getFloat32();
+    }
+    state.slot = reader.getInt32();
+    state.flags = reader.get();
+    return true;
+}
+
+bool SessionReplayer::nextInteraction(Interaction& record) {
+    if (finished || !reader.hasNext()) {
+        return false;
+    }
+    auto type = static_cast<RecordType>(reader.peek());
+    if (type == RecordType::tick) {
+        return false;
+    }
+    reader.get();
+    if (type == RecordType::end) {
+        finished = true;
+        return false;
+    }
+    record = Interaction {type, reader.getInt64()};
+    switch (type) {
+        case RecordType::blockPlace:
+            record.pos = get_pos(reader);
+            record.name = reader.getString();
+            record.state = int2blockstate(reader.getInt16());
+            break;
+        case RecordType::blockBreak:
+        case RecordType::blockInteract:
+        case RecordType::blockBreaking:
+        case RecordType::itemBreakBlock:
+            record.pos = get_pos(reader);
+            record.name = reader.getString();
+            break;
+        case RecordType::itemUse:
+            record.name = reader.getString();
+            break;
+        case RecordType::itemUseOnBlock:
+            record.pos = get_pos(reader);
+            record.normal = get_pos(reader);
+            record.name = reader.getString();
+            break;
+        case RecordType::entityAttacked:
+        case RecordType::entityUsed:
+            record.entity = reader.getInt64();
+            break;
+        default:
+            throw std::runtime_error(
+                "invalid record type " +
+                std::to_string(static_cast<int>(type)) + " at tick " +
+                std::to_string(tick)
+            );
+    }
+    return true;
+}
+
+bool SessionReplayer::beginTick(LevelController& controller, float& delta) {
+    if (!nextTick(delta)) {
+        return false;
+    }
+    int64_t id;
+    PlayerState state;
+    while (nextPlayerState(id, state)) {
+        auto player = getPlayer(controller, id);
+        if (player == nullptr) {
+            continue;
+        }
+        player->teleport(state.position);
+        player->setRotation(state.rotation);
+        player->setChosenSlot(state.slot);
+        player->setFlight(state.flags & PLAYER_FLIGHT);
+        player->setNoclip(state.flags & PLAYER_NOCLIP);
+    }
+    return true;
+}
+
+void SessionReplayer::endTick(LevelController& controller) {
+    auto level = controller.getLevel();
+    const auto& content = level->content;
+    auto& blocks = *controller.getBlocksController();
+
+    Interaction record;
+    while (nextInteraction(record)) {
+        auto player = getPlayer(controller, record.player);
+        const auto& pos = record.pos;
+        switch (record.type) {
+            case RecordType::blockPlace:
+                blocks.placeBlock(
+                    player,
+                    content.blocks.require(record.name),
+                    record.state,
+                    pos.x,
+                    pos.y,
+                    pos.z
+                );
+                break;
+            case RecordType::blockBreak:
+                blocks.breakBlock(
+                    player,
+                    content.blocks.require(record.name),
+                    pos.x,
+                    pos.y,
+                    pos.z
+                );
+                break;
+            case RecordType::blockInteract:
+                scripting::on_block_interact(
+                    player, content.blocks.require(record.name), pos
+                );
+                break;
+            case RecordType::blockBreaking:
+                scripting::on_block_breaking(
+                    player, content.blocks.require(record.name), pos
+                );
+                break;
+            case RecordType::itemUse:
+                scripting::on_item_use(
+                    player, content.items.require(record.name)
+                );
+                break;
+            case RecordType::itemUseOnBlock:
+                scripting::on_item_use_on_block(
+                    player,
+                    content.items.require(record.name),
+                    pos,
+                    record.normal
+                );
+                break;
+            case RecordType::itemBreakBlock:
+                scripting::on_item_break_block(
+                    player,
+                    content.items.require(record.name),
+                    pos.x,
+                    pos.y,
+                    pos.z
+                );
+                break;
+            case RecordType::entityAttacked:
+            case RecordType::entityUsed: {
+                auto entity = level->entities->get(record.entity);
+                if (!entity) {
+                    break;
+                }
+                if (record.type == RecordType::entityAttacked) {
+                    scripting::on_attacked(
+                        *entity, player, player ? player->getEntity() : 0
+                    );
+                } else {
+                    scripting::on_entity_used(*entity, player);
+                }
+                break;
+            }
+            default:
+                break;
+        }
+    }
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "SessionRecorder.hpp"
+#include "coders/byte_utils.hpp"
+#include "typedefs.hpp"
+
+class Player;
+class LevelController;
+
+/// @brief Plays SessionRecorder recording back on a level.
+///
+/// Players states are applied before the level update and recorded
+/// interactions after it, in the same order as they were performed.
+/// Outcomes of interactions (placed and broken blocks) are replayed
+/// as recorded, so scripts decisions are not required to repeat.
+class SessionReplayer {
+    std::vector<ubyte> data;
+    ByteReader reader;
+    std::string snapshot;
+    uint64_t tick = 0;
+    bool finished = false;
+
+    Player* getPlayer(LevelController& controller, int64_t id);
+public:
+    /// @throws std::runtime_error if data is not a valid recording
+    SessionReplayer(std::vector<ubyte> data);
+
+    /// @return target of the world snapshot the session was recorded from
+    const std::string& getSnapshot() const {
+        return snapshot;
+    }
+
+    /// @brief Read next tick header
+    /// @param delta recorded tick delta destination
+    /// @return false if recording is over
+    bool nextTick(float& delta);
+
+    /// @brief Read next player state record of the current tick
+    /// @return false if there are no more players states in the tick
+    bool nextPlayerState(int64_t& id, session::PlayerState& state);
+
+    /// @brief Read next interaction record of the current tick
+    /// @return false if the tick is over
+    /// @throws std::runtime_error on invalid record type
+    bool nextInteraction(session::Interaction& record);
+
+    /// @brief Read next tick header and apply players states
+    /// @param delta recorded tick delta destination
+    /// @return false if recording is over
+    bool beginTick(LevelController& controller, float& delta);
+
+    /// @brief Apply interactions performed after the level update
+    void endTick(LevelController& controller);
+
+    /// @return number of ticks began
+    uint64_t getTick() const {
+        return tick;
+    }
+};
@@ -0,0 +1,263 @@
+#include "WorldPregenerator.hpp"
+
+#include "content/Content.hpp"
+#include "debug/Logger.hpp"
+#include "lighting/Lighting.hpp"
+#include "maths/voxmaths.hpp"
+#include "util/ThreadPool.hpp"
+#include "voxels/Chunk.hpp"
+#include "voxels/Chunks.hpp"
+#include "voxels/GlobalChunks.hpp"
+#include "world/files/WorldFiles.hpp"
+#include "world/files/WorldRegions.hpp"
+#include "world/generator/GeneratorDef.hpp"
+#include "world/generator/WorldGenerator.hpp"
+#include "world/Level.hpp"
+#include "world/World.hpp"
+
+static debug::Logger logger("pregenerator");
+
+/// @brief Progress report interval in microseconds
+inline constexpr int64_t REPORT_INTERVAL = 5'000'000;
+
+static_assert(
+    REGION_SIZE % WorldPregenerator::TILE_SIZE == 0,
+    "region size must be divisible by pregeneration tile size"
+);
+static_assert(
+    WorldPregenerator::TILE_SIZE * WorldPregenerator::TILE_SIZE <= 64,
+    "tile chunks must fit PregenJob::mask"
+);
+
+class PregenWorker : public util::Worker<PregenJob, PregenTile> {
+    const Content& content;
+    WorldGenerator generator;
+public:
+    PregenWorker(const Content& content, const GeneratorDef& def, uint64_t seed)
+        : content(content), generator(def, content, seed, def.script->clone()) {
+    }
+
+    PregenTile operator()(const PregenJob& job) override {
+        return WorldPregenerator::generateTile(generator, content, job);
+    }
+};
+
+WorldPregenerator::WorldPregenerator(
+    Level& level, glm::ivec2 minPos, glm::ivec2 maxPos, int workers
+)
+    : level(level),
+      regions(level.getWorld()->wfile->getRegions()),
+      minPos(glm::min(minPos, maxPos)),
+      maxPos(glm::max(minPos, maxPos)) {
+    const auto& content = level.content;
+    const auto& def = content.generators.require(level.getWorld()->getGenerator());
+    uint64_t seed = level.getWorld()->getSeed();
+
+    int regionX1 = floordiv<REGION_SIZE>(this->minPos.x);
+    int regionZ1 = floordiv<REGION_SIZE>(this->minPos.y);
+    int regionX2 = floordiv<REGION_SIZE>(this->maxPos.x);
+    int regionZ2 = floordiv<REGION_SIZE>(this->maxPos.y);
+
+    constexpr int regionSize = REGION_SIZE;
+    // region-by-region order allows to write and unload regions early
+    for (int rz = regionZ1; rz <= regionZ2; rz++) {
+        for (int rx = regionX1; rx <= regionX2; rx++) {
+            for (int tz = 0; tz < regionSize; tz += TILE_SIZE) {
+                for (int tx = 0; tx < regionSize; tx += TILE_SIZE) {
+                    PregenJob job {
+                        {rx * regionSize + tx, rz * regionSize + tz}, 0};
+                    for (int z = 0; z < TILE_SIZE; z++) {
+                        for (int x = 0; x < TILE_SIZE; x++) {
+                            int cx = job.pos.x + x;
+                            int cz = job.pos.y + z;
+                            if (cx < this->minPos.x || cz < this->minPos.y ||
+                                cx > this->maxPos.x || cz > this->maxPos.y) {
+                                continue;
+                            }
+                            if (regions.hasChunk(cx, cz) ||
+                                level.chunks->getChunk(cx, cz)) {
+                                chunksSkipped++;
+                                continue;
+                            }
+                            job.mask |= 1ULL << (z * TILE_SIZE + x);
+                            regionsRemaining[{rx, rz}]++;
+                            chunksTotal++;
+                        }
+                    }
+                    if (job.mask) {
+                        tiles.push(job);
+                    }
+                }
+            }
+        }
+    }
+    logger.info() << "pregenerating chunks from " << this->minPos.x << ", "
+                  << this->minPos.y << " to " << this->maxPos.x << ", "
+                  << this->maxPos.y << ": " << chunksTotal << " to generate, "
+                  << chunksSkipped << " already present";
+    if (tiles.empty()) {
+        active = false;
+        return;
+    }
+    level.getWorld()->wfile->createDirectories();
+
+    pool = std::make_unique<util::ThreadPool<PregenJob, PregenTile>>(
+        "pregenerator-pool",
+        [&content, &def, seed]() {
+            return std::make_shared<PregenWorker>(content, def, seed);
+        },
+        [this](PregenTile& tile) { processResult(tile); },
+        workers
+    );
+    logger.info() << "using " << pool->getWorkersCount() << " workers";
+    enqueueTiles();
+}
+
+PregenTile WorldPregenerator::generateTile(
+    WorldGenerator& generator, const Content& content, const PregenJob& job
+) {
+    // tile chunks with 1 chunk margin required for lights
+    constexpr int size = TILE_SIZE + 2;
+    const auto& indices = *content.getIndices();
+    int offsetX = job.pos.x - 1;
+    int offsetZ = job.pos.y - 1;
+
+    generator.update(
+        job.pos.x + TILE_SIZE / 2, job.pos.y + TILE_SIZE / 2, size / 2 + 1
+    );
+
+    Chunks chunks(size, size, 0, 0, nullptr, indices);
+    chunks.setCenter(
+        (offsetX + size / 2) * CHUNK_W, (offsetZ + size / 2) * CHUNK_D
+    );
+    for (int z = 0; z < size; z++) {
+        for (int x = 0; x < size; x++) {
+            auto chunk = std::make_shared<Chunk>(offsetX + x, offsetZ + z);
+            generator.generate(chunk->voxels, chunk->x, chunk->z);
+            chunk->updateHeights();
+            Lighting::prebuildSkyLight(*chunk, indices);
+            chunk->flags.loaded = true;
+            chunk->flags.ready = true;
+            chunk->flags.unsaved = true;
+            chunk->flags.generated = true;
+            chunks.putChunk(chunk);
+        }
+    }
+    Lighting lighting(content, chunks);
+    for (int z = 0; z < size; z++) {
+        for (int x = 0; x < size; x++) {
+            lighting.buildSkyLight(offsetX + x, offsetZ + z);
+            lighting.onChunkLoaded(offsetX + x, offsetZ + z, true);
+        }
+    }
+
+    PregenTile tile {job.pos, {}};
+    const auto& matrix = chunks.getChunks();
+    for (int z = 0; z < TILE_SIZE; z++) {
+        for (int x = 0; x < TILE_SIZE; x++) {
+            if (!((job.mask >> (z * TILE_SIZE + x)) & 1)) {
+                continue;
+            }
+            const auto& chunk = matrix[(z + 1) * size + x + 1];
+            chunk->flags.lighted = true;
+            tile.chunks.push_back(chunk);
+        }
+    }
+    return tile;
+}
+
+WorldPregenerator::~WorldPregenerator() {
+    terminate();
+}
+
+void WorldPregenerator::enqueueTiles() {
+    // limit number of generated but not processed chunks
+    uint maxInWork = pool->getWorkersCount() * 2;
+    while (!tiles.empty() && tilesInWork < maxInWork) {
+        pool->enqueueJob(tiles.front());
+        tiles.pop();
+        tilesInWork++;
+    }
+}
+
+void WorldPregenerator::processResult(PregenTile& tile) {
+    tilesInWork--;
+    for (const auto& chunk : tile.chunks) {
+        // chunk loaded in the level meanwhile will be saved by the level
+        if (level.chunks->getChunk(chunk->x, chunk->z) == nullptr) {
+            regions.put(chunk.get(), {});
+        }
+        chunksDone++;
+
+        glm::ivec2 regionPos(
+            floordiv<REGION_SIZE>(chunk->x), floordiv<REGION_SIZE>(chunk->z)
+        );
+        auto found = regionsRemaining.find(regionPos);
+        if (found != regionsRemaining.end() && --found->second == 0) {
+            regionsRemaining.erase(found);
+            regions.flushRegion(regionPos.x, regionPos.y);
+        }
+    }
+}
+
+void WorldPregenerator::report() {
+    lastReportTime = elapsed;
+    logger.info() << "pregenerated " << chunksDone << "/" << chunksTotal
+                  << " chunks ("
+                  << (chunksTotal ? chunksDone * 100 / chunksTotal : 100)
+                  << "%), " << static_cast<int>(getChunksPerSecond())
+                  << " chunks/s";
+}
+
+bool WorldPregenerator::isActive() const {
+    return active;
+}
+
+uint WorldPregenerator::getWorkTotal() const {
+    return chunksTotal;
+}
+
+uint WorldPregenerator::getWorkDone() const {
+    return chunksDone;
+}
+
+void WorldPregenerator::update() {
+    if (!active) {
+        return;
+    }
+    elapsed = timer.stop();
+    pool->update();
+    enqueueTiles();
+
+    if (tiles.empty() && tilesInWork == 0) {
+        report();
+        logger.info() << "pregeneration finished in " << elapsed / 1'000'000
+                      << " s";
+        terminate();
+    } else if (elapsed - lastReportTime >= REPORT_INTERVAL) {
+        report();
+    }
+}
+
+void WorldPregenerator::waitForEnd() {
+    while (active) {
+        if (tilesInWork > 0) {
+            pool->waitForResults();
+        }
+        update();
+    }
+}
+
+void WorldPregenerator::terminate() {
+    if (pool) {
+        pool->terminate();
+    }
+    active = false;
+}
+
+double WorldPregenerator::getChunksPerSecond() const {
+    if (elapsed <= 0) {
+        return 0.0;
+    }
+    return chunksDone / (elapsed / 1e6);
+}
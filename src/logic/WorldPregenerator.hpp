@@ -0,0 +1,103 @@
+#pragma once
+
+#include <queue>
+#include <memory>
+#include <vector>
+#include <unordered_map>
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/glm.hpp>
+#include <glm/gtx/hash.hpp>
+
+#include "interfaces/Task.hpp"
+#include "typedefs.hpp"
+#include "util/timeutil.hpp"
+
+class Level;
+class Chunk;
+class Content;
+class WorldRegions;
+class WorldGenerator;
+
+namespace util {
+    template <class T, class R>
+    class ThreadPool;
+}
+
+/// @brief Tile of TILE_SIZE*TILE_SIZE chunks to generate
+struct PregenJob {
+    /// @brief Tile position (first chunk)
+    glm::ivec2 pos;
+    /// @brief Bit mask of the tile chunks to save (z * TILE_SIZE + x)
+    uint64_t mask;
+};
+
+/// @brief Generated, lighted and ready to save chunks of a tile
+struct PregenTile {
+    glm::ivec2 pos;
+    std::vector<std::shared_ptr<Chunk>> chunks;
+};
+
+/// @brief Generates, lights and saves a rectangle of chunks using worker
+/// threads, not depending on players chunks matrices.
+/// Already saved chunks are skipped, so interrupted pregeneration continues
+/// from where it stopped.
+class WorldPregenerator : public Task {
+    Level& level;
+    WorldRegions& regions;
+    /// @brief Area minimum chunk position (inclusive)
+    glm::ivec2 minPos;
+    /// @brief Area maximum chunk position (inclusive)
+    glm::ivec2 maxPos;
+    std::unique_ptr<util::ThreadPool<PregenJob, PregenTile>> pool;
+    /// @brief Tiles waiting to be enqueued
+    std::queue<PregenJob> tiles;
+    /// @brief Number of chunks remaining to save per region
+    std::unordered_map<glm::ivec2, uint> regionsRemaining;
+    uint tilesInWork = 0;
+    uint chunksTotal = 0;
+    uint chunksDone = 0;
+    uint chunksSkipped = 0;
+    bool active = true;
+
+    timeutil::Timer timer;
+    /// @brief Microseconds elapsed since start (updated in update())
+    int64_t elapsed = 0;
+    int64_t lastReportTime = 0;
+
+    void enqueueTiles();
+    void processResult(PregenTile& tile);
+    void report();
+public:
+    /// @brief Tile size in chunks. Region size must be divisible by it.
+    static inline constexpr int TILE_SIZE = 8;
+
+    /// @param level target level
+    /// @param minPos area minimum chunk position (inclusive)
+    /// @param maxPos area maximum chunk position (inclusive)
+    /// @param workers max number of worker threads (0 - auto)
+    WorldPregenerator(
+        Level& level, glm::ivec2 minPos, glm::ivec2 maxPos, int workers = 0
+    );
+    ~WorldPregenerator();
+
+    /// @brief Generate and light chunks of the tile (called by workers)
+    /// @param generator worker own generator
+    /// @param content world content
+    /// @param job tile to generate
+    /// @return chunks selected by the job mask
+    static PregenTile generateTile(
+        WorldGenerator& generator, const Content& content, const PregenJob& job
+    );
+
+    bool isActive() const override;
+    uint getWorkTotal() const override;
+    uint getWorkDone() const override;
+    void update() override;
+    void waitForEnd() override;
+    void terminate() override;
+
+    /// @brief Get average generation speed since start
+    /// @return number of chunks saved per second
+    double getChunksPerSecond() const;
+};
@@ -122,6 +122,39 @@ static int l_set(lua::State* L) {
     return 0;
 }
 
+static int l_fill(lua::State* L) {
+    glm::ivec3 a = lua::tovec3(L, 1);
+    glm::ivec3 b = lua::tovec3(L, 2);
+    auto id = lua::tointeger(L, 3);
+    auto state = lua::tointeger(L, 4);
+    bool noupdate = lua::toboolean(L, 5);
+    if (static_cast<size_t>(id) >= indices->blocks.count()) {
+        return 0;
+    }
+    auto min = glm::min(a, b);
+    auto max = glm::max(a, b);
+    min.y = std::max(min.y, 0);
+    max.y = std::min(max.y, CHUNK_H - 1);
+    if (min.y > max.y) {
+        return 0;
+    }
+    blocks_agent::fill(*level->chunks, min, max, id, int2blockstate(state));
+
+    auto chunksController = controller->getChunksController();
+    if (chunksController == nullptr) {
+        return 0;
+    }
+    if (chunksController->lighting) {
+        chunksController->lighting->onAreaSet(
+            min.x, min.y, min.z, max.x, max.y, max.z
+        );
+    }
+    if (!noupdate) {
+        blocks->updateAreaSides(min, max);
+    }
+    return 0;
+}
+
 static int l_get(lua::State* L) {
     auto x = lua::tointeger(L, 1);
     auto y = lua::tointeger(L, 2);
@@ -642,6 +675,7 @@ const luaL_Reg blocklib[] = {
     {"is_solid_at", lua::wrap<l_is_solid_at>},
     {"is_replaceable_at", lua::wrap<l_is_replaceable_at>},
     {"set", lua::wrap<l_set>},
+    {"fill", lua::wrap<l_fill>},
     {"get", lua::wrap<l_get>},
     {"get_X", lua::wrap<l_get_x>},
     {"get_Y", lua::wrap<l_get_y>},
@@ -302,6 +302,45 @@ static int l_capture_output(lua::State* L) {
     return 1;
 }
 
+/// @brief Get dedicated server tick metrics
+static int l_get_tick_metrics(lua::State* L) {
+    const auto& metrics = engine->getTickMetrics();
+    auto stats = metrics.getStats();
+    lua::createtable(L, 0, 13);
+    lua::pushnumber(L, metrics.getTargetRate());
+    lua::setfield(L, "target_tps");
+    lua::pushnumber(L, stats.tps);
+    lua::setfield(L, "tps");
+    lua::pushnumber(L, stats.tpsP50);
+    lua::setfield(L, "tps_p50");
+    lua::pushnumber(L, stats.tpsP5);
+    lua::setfield(L, "tps_p5");
+    lua::pushnumber(L, stats.tpsP1);
+    lua::setfield(L, "tps_p1");
+    lua::pushnumber(L, stats.msptMean);
+    lua::setfield(L, "mspt");
+    lua::pushnumber(L, stats.msptP50);
+    lua::setfield(L, "mspt_p50");
+    lua::pushnumber(L, stats.msptP95);
+    lua::setfield(L, "mspt_p95");
+    lua::pushnumber(L, stats.msptP99);
+    lua::setfield(L, "mspt_p99");
+    lua::pushnumber(L, stats.msptMax);
+    lua::setfield(L, "mspt_max");
+    lua::pushinteger(L, metrics.getTicks());
+    lua::setfield(L, "ticks");
+    lua::pushinteger(L, metrics.getSkipped());
+    lua::setfield(L, "skipped");
+    lua::pushinteger(L, metrics.getOverloads());
+    lua::setfield(L, "overloads");
+    return 1;
+}
+
+/// @brief Get dedicated server tick metrics in Prometheus text format
+static int l_export_tick_metrics(lua::State* L) {
+    return lua::pushstring(L, engine->getTickMetrics().toText());
+}
+
 const luaL_Reg corelib[] = {
     {"blank", lua::wrap<l_blank>},
     {"get_version", lua::wrap<l_get_version>},
@@ -322,6 +361,8 @@ const luaL_Reg corelib[] = {
     {"open_folder", lua::wrap<l_open_folder>},
     {"quit", lua::wrap<l_quit>},
     {"capture_output", lua::wrap<l_capture_output>},
+    {"get_tick_metrics", lua::wrap<l_get_tick_metrics>},
+    {"export_tick_metrics", lua::wrap<l_export_tick_metrics>},
     {"__load_texture", lua::wrap<l_load_texture>},
     {NULL, NULL}
 };
@@ -0,0 +1,120 @@
+#include "api_lua.hpp"
+#include "debug/Metrics.hpp"
+
+using namespace debug;
+
+static int push_value(lua::State* L, const metrics::MetricValue& value) {
+    if (value.type != metrics::MetricType::histogram) {
+        return lua::pushnumber(L, value.value);
+    }
+    const auto& histogram = value.histogram;
+    lua::createtable(L, 0, 6);
+    lua::pushinteger(L, histogram.count);
+    lua::setfield(L, "count");
+    lua::pushnumber(L, histogram.sum);
+    lua::setfield(L, "sum");
+    lua::pushnumber(L, histogram.mean());
+    lua::setfield(L, "mean");
+    lua::pushnumber(L, histogram.quantile(0.5));
+    lua::setfield(L, "p50");
+    lua::pushnumber(L, histogram.quantile(0.95));
+    lua::setfield(L, "p95");
+    lua::pushnumber(L, histogram.quantile(0.99));
+    lua::setfield(L, "p99");
+    return 1;
+}
+
+static std::string_view opt_prefix(lua::State* L, int idx) {
+    if (lua::isnoneornil(L, idx)) {
+        return "";
+    }
+    return lua::require_lstring(L, idx);
+}
+
+/// @brief Scripts may update only metrics in pack namespace (packid:name),
+/// so engine metrics can not be overwritten
+static std::string require_script_metric(lua::State* L, int idx) {
+    std::string name = lua::require_string(L, idx);
+    size_t sep = name.find(':');
+    if (sep == std::string::npos || sep == 0 || sep + 1 == name.length()) {
+        throw std::runtime_error(
+            "metric name must be prefixed with pack id (packid:name), got '" +
+            name + "'"
+        );
+    }
+    return name;
+}
+
+static int l_get(lua::State* L) {
+    metrics::MetricValue value;
+    if (!metrics::get(lua::require_string(L, 1), value)) {
+        return 0;
+    }
+    return push_value(L, value);
+}
+
+static int l_list(lua::State* L) {
+    auto values = metrics::collect(opt_prefix(L, 1));
+    lua::createtable(L, 0, values.size());
+    for (const auto& value : values) {
+        push_value(L, value);
+        lua::setfield(L, value.name);
+    }
+    return 1;
+}
+
+static int l_add(lua::State* L) {
+    lua::Integer n = 1;
+    if (!lua::isnoneornil(L, 2)) {
+        n = lua::tointeger(L, 2);
+    }
+    if (n < 0) {
+        throw std::runtime_error("counter can not be decreased");
+    }
+    metrics::counter(require_script_metric(L, 1)).add(n);
+    return 0;
+}
+
+static int l_set(lua::State* L) {
+    metrics::gauge(require_script_metric(L, 1)).set(lua::tonumber(L, 2));
+    return 0;
+}
+
+static int l_observe(lua::State* L) {
+    metrics::histogram(require_script_metric(L, 1))
+        .observe(lua::tonumber(L, 2));
+    return 0;
+}
+
+static int l_report(lua::State* L) {
+    return lua::pushstring(L, metrics::report(opt_prefix(L, 1)));
+}
+
+static int l_reset(lua::State* L) {
+    if (!lua::isnoneornil(L, 1)) {
+        std::string packid = lua::require_string(L, 1);
+        if (packid.empty() || packid.find(':') != std::string::npos) {
+            throw std::runtime_error("invalid pack id '" + packid + "'");
+        }
+        metrics::reset(packid + ":");
+        return 0;
+    }
+    // engine metrics names have no pack prefix
+    for (const auto& value : metrics::collect()) {
+        if (value.name.find(':') != std::string::npos) {
+            metrics::reset(value.name);
+        }
+    }
+    return 0;
+}
+
+const luaL_Reg metricslib[] = {
+    {"get", lua::wrap<l_get>},
+    {"list", lua::wrap<l_list>},
+    {"add", lua::wrap<l_add>},
+    {"set", lua::wrap<l_set>},
+    {"observe", lua::wrap<l_observe>},
+    {"report", lua::wrap<l_report>},
+    {"reset", lua::wrap<l_reset>},
+    {NULL, NULL}
+};
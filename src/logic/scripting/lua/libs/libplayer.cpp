@@ -2,6 +2,7 @@
 #include <glm/glm.hpp>
 
 #include "items/Inventory.hpp"
+#include "logic/LevelController.hpp"
 #include "objects/Entities.hpp"
 #include "objects/Player.hpp"
 #include "objects/Players.hpp"
@@ -289,6 +290,9 @@ static int l_delete(lua::State* L) {
     auto id = lua::tointeger(L, 1);
     level->players->suspend(id);
     level->players->remove(id);
+    if (controller) {
+        controller->onPlayerRemoved(id);
+    }
     return 0;
 }
 
@@ -306,6 +310,16 @@ static int l_set_suspended(lua::State* L) {
     return 0;
 }
 
+static int l_get_load_distance(lua::State* L) {
+    auto player = get_player(L, 1);
+    if (player == nullptr || controller == nullptr) {
+        return 0;
+    }
+    lua::pushinteger(L, controller->getLoadDistance(player->getId()));
+    lua::pushinteger(L, controller->getSimulationDistance(player->getId()));
+    return 2;
+}
+
 const luaL_Reg playerlib[] = {
     {"get_pos", lua::wrap<l_get_pos>},
     {"set_pos", lua::wrap<l_set_pos>},
@@ -317,6 +331,7 @@ const luaL_Reg playerlib[] = {
     {"get_inventory", lua::wrap<l_get_inv>},
     {"is_suspended", lua::wrap<l_is_suspended>},
     {"set_suspended", lua::wrap<l_set_suspended>},
+    {"get_load_distance", lua::wrap<l_get_load_distance>},
     {"is_flight", lua::wrap<l_is_flight>},
     {"set_flight", lua::wrap<l_set_flight>},
     {"is_noclip", lua::wrap<l_is_noclip>},
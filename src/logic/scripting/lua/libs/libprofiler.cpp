@@ -0,0 +1,105 @@
+#include "api_lua.hpp"
+#include "debug/Profiler.hpp"
+#include "io/io.hpp"
+#include "logic/scripting/scripting_stats.hpp"
+
+using namespace debug;
+
+static int l_start(lua::State*) {
+    profiler::start();
+    return 0;
+}
+
+static int l_stop(lua::State*) {
+    profiler::stop();
+    return 0;
+}
+
+static int l_is_active(lua::State* L) {
+    return lua::pushboolean(L, profiler::is_active());
+}
+
+static int l_count(lua::State* L) {
+    return lua::pushinteger(L, profiler::count());
+}
+
+static int l_push(lua::State* L) {
+    profiler::begin(profiler::intern(lua::require_string(L, 1)));
+    return 0;
+}
+
+static int l_pop(lua::State* L) {
+    if (!profiler::end()) {
+        throw std::runtime_error("no profiler zone to pop");
+    }
+    return 0;
+}
+
+static int l_save(lua::State* L) {
+    io::path target = lua::require_string(L, 1);
+    if (target.entryPoint() != "export") {
+        throw std::runtime_error("profiler capture target must be in export:");
+    }
+    io::write_string(target, profiler::to_chrome_trace());
+    return 0;
+}
+
+static int l_time(lua::State* L) {
+    return lua::pushnumber(
+        L,
+        std::chrono::duration<double>(
+            profiler::clock::now().time_since_epoch()
+        ).count()
+    );
+}
+
+/// @brief Call function in accounting scope of the event, so events
+/// emitted by the function are subtracted from its time.
+/// Internal: removed from the library by stdlib after stdcomp loading
+static int l_account_call(lua::State* L) {
+    std::string name = lua::require_string(L, 1);
+    if (!lua::isfunction(L, 2)) {
+        throw std::runtime_error("function expected at 2");
+    }
+    scripting::stats::Scope scope(name);
+    return lua::call(L, lua::gettop(L) - 2);
+}
+
+static int l_set_accounting(lua::State* L) {
+    scripting::stats::set_enabled(lua::toboolean(L, 1));
+    return 0;
+}
+
+static int l_is_accounting(lua::State* L) {
+    return lua::pushboolean(L, scripting::stats::is_enabled());
+}
+
+static int l_accounting_report(lua::State* L) {
+    size_t limit = 10;
+    if (!lua::isnoneornil(L, 1)) {
+        limit = lua::touinteger(L, 1);
+    }
+    return lua::pushstring(L, scripting::stats::report(limit));
+}
+
+static int l_reset_accounting(lua::State*) {
+    scripting::stats::reset();
+    return 0;
+}
+
+const luaL_Reg profilerlib[] = {
+    {"start", lua::wrap<l_start>},
+    {"stop", lua::wrap<l_stop>},
+    {"is_active", lua::wrap<l_is_active>},
+    {"count", lua::wrap<l_count>},
+    {"push", lua::wrap<l_push>},
+    {"pop", lua::wrap<l_pop>},
+    {"save", lua::wrap<l_save>},
+    {"time", lua::wrap<l_time>},
+    {"__account_call", lua::wrap<l_account_call>},
+    {"set_accounting", lua::wrap<l_set_accounting>},
+    {"is_accounting", lua::wrap<l_is_accounting>},
+    {"accounting_report", lua::wrap<l_accounting_report>},
+    {"reset_accounting", lua::wrap<l_reset_accounting>},
+    {NULL, NULL}
+};
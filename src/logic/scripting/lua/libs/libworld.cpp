@@ -21,6 +21,8 @@
 #include "world/World.hpp"
 #include "logic/LevelController.hpp"
 #include "logic/ChunksController.hpp"
+#include "logic/WorldPregenerator.hpp"
+#include "world/files/WorldSnapshot.hpp"
 
 using namespace scripting;
 namespace fs = std::filesystem;
@@ -191,6 +193,7 @@ static int l_set_chunk_data(lua::State* L) {
         return lua::pushboolean(L, true);
     }
     integrate_chunk_client(*chunk);
+    controller->getChunksController()->requestLights(x, z);
     return lua::pushboolean(L, true);
 }
 
@@ -222,6 +225,123 @@ static int l_count_chunks(lua::State* L) {
     return lua::pushinteger(L, level->chunks->size());
 }
 
+static int l_pregenerate(lua::State* L) {
+    if (controller == nullptr) {
+        throw std::runtime_error("no open world");
+    }
+    int x1 = static_cast<int>(lua::tointeger(L, 1));
+    int z1 = static_cast<int>(lua::tointeger(L, 2));
+    int x2 = static_cast<int>(lua::tointeger(L, 3));
+    int z2 = static_cast<int>(lua::tointeger(L, 4));
+    int workers = 0;
+    if (lua::gettop(L) >= 5) {
+        workers = static_cast<int>(lua::tointeger(L, 5));
+        if (workers < 0) {
+            throw std::runtime_error("invalid number of workers");
+        }
+    }
+    controller->pregenerate({x1, z1}, {x2, z2}, workers);
+    return 0;
+}
+
+static int l_get_pregen_progress(lua::State* L) {
+    if (controller == nullptr) {
+        return 0;
+    }
+    auto pregenerator = controller->getPregenerator();
+    if (pregenerator == nullptr || !pregenerator->isActive()) {
+        return 0;
+    }
+    lua::createtable(L, 0, 3);
+    lua::pushinteger(L, pregenerator->getWorkDone());
+    lua::setfield(L, "done");
+    lua::pushinteger(L, pregenerator->getWorkTotal());
+    lua::setfield(L, "total");
+    lua::pushnumber(L, pregenerator->getChunksPerSecond());
+    lua::setfield(L, "speed");
+    return 1;
+}
+
+static int l_get_regions_stats(lua::State* L) {
+    if (level == nullptr) {
+        return 0;
+    }
+    auto stats = level->getWorld()->wfile->getRegions().getCacheStats();
+    lua::createtable(L, 0, 7);
+    lua::pushinteger(L, stats.memoryUsage);
+    lua::setfield(L, "memory");
+    lua::pushinteger(L, stats.memoryBudget);
+    lua::setfield(L, "budget");
+    lua::pushinteger(L, stats.regions);
+    lua::setfield(L, "regions");
+    lua::pushinteger(L, stats.hits);
+    lua::setfield(L, "hits");
+    lua::pushinteger(L, stats.misses);
+    lua::setfield(L, "misses");
+    lua::pushinteger(L, stats.evictions);
+    lua::setfield(L, "evictions");
+    lua::pushinteger(L, stats.writeBacks);
+    lua::setfield(L, "write_backs");
+    return 1;
+}
+
+static int l_snapshot(lua::State* L) {
+    if (controller == nullptr) {
+        throw std::runtime_error("no open world");
+    }
+    io::path target = lua::require_string(L, 1);
+    if (target.entryPoint() != "export") {
+        throw std::runtime_error("snapshot target must be in export:");
+    }
+    controller->createSnapshot(target);
+    return 0;
+}
+
+static int l_get_snapshot_progress(lua::State* L) {
+    if (controller == nullptr) {
+        return 0;
+    }
+    auto snapshot = controller->getSnapshot();
+    if (snapshot == nullptr || !snapshot->isActive()) {
+        return 0;
+    }
+    lua::createtable(L, 0, 3);
+    lua::pushinteger(L, snapshot->getWorkDone());
+    lua::setfield(L, "done");
+    lua::pushinteger(L, snapshot->getWorkTotal());
+    lua::setfield(L, "total");
+    lua::pushstring(L, snapshot->getTarget().string());
+    lua::setfield(L, "target");
+    return 1;
+}
+
+static int l_start_recording(lua::State* L) {
+    if (controller == nullptr) {
+        throw std::runtime_error("no open world");
+    }
+    io::path file = lua::require_string(L, 1);
+    io::path snapshotTarget = lua::require_string(L, 2);
+    if (file.entryPoint() != "export" ||
+        snapshotTarget.entryPoint() != "export") {
+        throw std::runtime_error("recording target must be in export:");
+    }
+    controller->startRecording(file, snapshotTarget);
+    return 0;
+}
+
+static int l_stop_recording(lua::State* L) {
+    if (controller == nullptr) {
+        return lua::pushinteger(L, 0);
+    }
+    return lua::pushinteger(L, controller->stopRecording());
+}
+
+static int l_is_recording(lua::State* L) {
+    return lua::pushboolean(
+        L, controller != nullptr && controller->getRecorder() != nullptr
+    );
+}
+
 static int l_reload_script(lua::State* L) {
     auto packid = lua::require_string(L, 1);
     if (content == nullptr) {
@@ -250,6 +370,14 @@ const luaL_Reg worldlib[] = {
     {"set_chunk_data", lua::wrap<l_set_chunk_data>},
     {"save_chunk_data", lua::wrap<l_save_chunk_data>},
     {"count_chunks", lua::wrap<l_count_chunks>},
+    {"pregenerate", lua::wrap<l_pregenerate>},
+    {"get_pregen_progress", lua::wrap<l_get_pregen_progress>},
+    {"get_regions_stats", lua::wrap<l_get_regions_stats>},
+    {"snapshot", lua::wrap<l_snapshot>},
+    {"get_snapshot_progress", lua::wrap<l_get_snapshot_progress>},
+    {"start_recording", lua::wrap<l_start_recording>},
+    {"stop_recording", lua::wrap<l_stop_recording>},
+    {"is_recording", lua::wrap<l_is_recording>},
     {"reload_script", lua::wrap<l_reload_script>},
     {NULL, NULL}
 };
@@ -2,6 +2,7 @@
 
 #include <iomanip>
 #include <iostream>
+#include <optional>
 
 #include "io/io.hpp"
 #include "io/engine_paths.hpp"
@@ -10,6 +11,7 @@
 #include "libs/api_lua.hpp"
 #include "lua_custom_types.hpp"
 #include "engine/Engine.hpp"
+#include "logic/scripting/scripting_stats.hpp"
 
 static debug::Logger logger("lua-state");
 static lua::State* main_thread = nullptr;
@@ -49,7 +51,9 @@ static void create_libs(State* L, StateType stateType) {
     openlib(L, "item", itemlib);
     openlib(L, "json", jsonlib);
     openlib(L, "mat4", mat4lib);
+    openlib(L, "metrics", metricslib);
     openlib(L, "pack", packlib);
+    openlib(L, "profiler", profilerlib);
     openlib(L, "quat", quatlib);
     openlib(L, "toml", tomllib);
     openlib(L, "utf8", utf8lib);
@@ -140,6 +144,10 @@ void lua::finalize() {
 bool lua::emit_event(
     State* L, const std::string& name, std::function<int(State*)> args
 ) {
+    std::optional<scripting::stats::Scope> statsScope;
+    if (L == main_thread && scripting::stats::is_enabled()) {
+        statsScope.emplace(name);
+    }
     getglobal(L, "events");
     getfield(L, "emit");
     pushstring(L, name);
@@ -535,6 +535,22 @@ namespace lua {
         }
     }
 
+    /// @brief Dump function at the top of the stack to bytecode
+    inline std::string dump(lua::State* L) {
+        std::string bytecode;
+        lua_dump(
+            L,
+            [](lua::State*, const void* data, size_t size, void* dst) -> int {
+                static_cast<std::string*>(dst)->append(
+                    static_cast<const char*>(data), size
+                );
+                return 0;
+            },
+            &bytecode
+        );
+        return bytecode;
+    }
+
     inline void store_in(
         lua::State* L, const std::string& tableName, const std::string& name
     ) {
@@ -6,8 +6,8 @@
 #include <filesystem>
 
 #include "util/functional_util.hpp"
-#define FNL_IMPL
 #include "maths/FastNoiseLite.h"
+#include "maths/simd.hpp"
 #include "coders/imageio.hpp"
 #include "io/util.hpp"
 #include "graphics/core/ImageData.hpp"
@@ -109,24 +109,39 @@ static int l_noise(lua::State* L) {
             shiftMapY = touserdata<LuaHeightmap>(L, 7);
         }
         noise->noise_type = noise_type;
-        for (uint y = 0; y < h; y++) {
-            for (uint x = 0; x < w; x++) {
-                uint i = y * w + x;
-                for (uint c = 0; c < octaves; c++) {
-                    float m = s * (1 << c);
-                    float value = heights[i];
-                    float u = (x + offset.x) * m;
-                    float v = (y + offset.y) * m;
-                    if (shiftMapX) {
-                        u += shiftMapX->getValues()[i];
-                    }
-                    if (shiftMapY) {
-                        v += shiftMapY->getValues()[i];
-                    }
-
-                    value += fnlGetNoise2D(noise, u, v) /
-                            static_cast<float>(1 << c) * multiplier;
-                    heights[i] = value;
+
+        std::vector<float> buffer(w * 3);
+        float* us = buffer.data();
+        float* vs = us + w;
+        float* values = vs + w;
+        for (uint c = 0; c < octaves; c++) {
+            float m = s * (1 << c);
+            float div = static_cast<float>(1 << c);
+            for (uint y = 0; y < h; y++) {
+                uint row = y * w;
+                for (uint x = 0; x < w; x++) {
+                    us[x] = (x + offset.x) * m;
+                    vs[x] = (y + offset.y) * m;
+                }
+                if (shiftMapX) {
+                    simd::binop(
+                        simd::BinaryOp::ADD,
+                        us,
+                        shiftMapX->getValues() + row,
+                        w
+                    );
+                }
+                if (shiftMapY) {
+                    simd::binop(
+                        simd::BinaryOp::ADD,
+                        vs,
+                        shiftMapY->getValues() + row,
+                        w
+                    );
+                }
+                simd::noise2d(*noise, us, vs, values, w);
+                for (uint x = 0; x < w; x++) {
+                    heights[row + x] += values[x] / div * multiplier;
                 }
             }
         }
@@ -134,6 +149,22 @@ static int l_noise(lua::State* L) {
     return 0;
 }
 
+template<simd::BinaryOp op>
+static int l_simd_binop(lua::State* L) {
+    if (auto heightmap = touserdata<LuaHeightmap>(L, 1)) {
+        uint size = heightmap->getWidth() * heightmap->getHeight();
+        auto heights = heightmap->getValues();
+
+        if (isnumber(L, 2)) {
+            simd::binop(op, heights, static_cast<float>(tonumber(L, 2)), size);
+        } else {
+            auto map = touserdata<LuaHeightmap>(L, 2);
+            simd::binop(op, heights, map->getValues(), size);
+        }
+    }
+    return 0;
+}
+
 template<template<class> class Op>
 static int l_binop_func(lua::State* L) {
     Op<float> op;
@@ -165,59 +196,32 @@ static int l_binop_func(lua::State* L) {
 
 static int l_mixin(lua::State* L) {
     if (auto heightmap = touserdata<LuaHeightmap>(L, 1)) {
-        uint w = heightmap->getWidth();
-        uint h = heightmap->getHeight();
+        uint size = heightmap->getWidth() * heightmap->getHeight();
         auto heights = heightmap->getValues();
 
+        const float* src = nullptr;
+        float srcScalar = 0.0f;
         if (isnumber(L, 2)) {
-            float scalar = tonumber(L, 2);
-            if (isnumber(L, 3)) {
-                float t = tonumber(L, 3);
-                for (uint i = 0; i < w * h; i++) {
-                    heights[i] = heights[i] * (1.0f - t) + scalar * t;
-                }
-            } else {
-                auto tmap = touserdata<LuaHeightmap>(L, 3);
-                auto tmapvalues = tmap->getValues();
-                for (uint i = 0; i < w * h; i++) {
-                    float t = tmapvalues[i];
-                    heights[i] = heights[i] * (1.0f - t) + scalar * t;
-                }
-            }
+            srcScalar = tonumber(L, 2);
         } else {
-            auto map = touserdata<LuaHeightmap>(L, 2);
-            auto mapvalues = map->getValues();
-            if (isnumber(L, 3)) {
-                float t = tonumber(L, 3);
-                for (uint i = 0; i < w * h; i++) {
-                    heights[i] = heights[i] * (1.0f - t) + mapvalues[i] * t;
-                }
-            } else {
-                auto tmap = touserdata<LuaHeightmap>(L, 3);
-                auto tmapvalues = tmap->getValues();
-                for (uint i = 0; i < w * h; i++) {
-                    float t = tmapvalues[i];
-                    heights[i] = heights[i] * (1.0f - t) + mapvalues[i] * t;
-                }
-            }
+            src = touserdata<LuaHeightmap>(L, 2)->getValues();
+        }
+        const float* t = nullptr;
+        float tScalar = 0.0f;
+        if (isnumber(L, 3)) {
+            tScalar = tonumber(L, 3);
+        } else {
+            t = touserdata<LuaHeightmap>(L, 3)->getValues();
         }
+        simd::mix(heights, src, srcScalar, t, tScalar, size);
     }
     return 0;
 }
 
-template<template<class> class Op>
-static int l_unaryop_func(lua::State* L) {
-    Op<float> op;
+static int l_abs(lua::State* L) {
     if (auto heightmap = touserdata<LuaHeightmap>(L, 1)) {
-        uint w = heightmap->getWidth();
-        uint h = heightmap->getHeight();
-        auto heights = heightmap->getValues();
-        for (uint y = 0; y < h; y++) {
-            for (uint x = 0; x < w; x++) {
-                uint i = y * w + x;
-                heights[i] = op(heights[i]);
-            }
-        }
+        uint size = heightmap->getWidth() * heightmap->getHeight();
+        simd::abs(heightmap->getValues(), size);
     }
     return 0;
 }
@@ -256,12 +260,12 @@ static std::unordered_map<std::string, lua_CFunction> methods {
     {"noise", lua::wrap<l_noise<FNL_NOISE_OPENSIMPLEX2>>},
     {"cellnoise", lua::wrap<l_noise<FNL_NOISE_CELLULAR>>},
     {"pow", lua::wrap<l_binop_func<util::pow>>},
-    {"add", lua::wrap<l_binop_func<std::plus>>},
-    {"sub", lua::wrap<l_binop_func<std::minus>>},
-    {"mul", lua::wrap<l_binop_func<std::multiplies>>},
-    {"min", lua::wrap<l_binop_func<util::min>>},
-    {"max", lua::wrap<l_binop_func<util::max>>},
-    {"abs", lua::wrap<l_unaryop_func<util::abs>>},
+    {"add", lua::wrap<l_simd_binop<simd::BinaryOp::ADD>>},
+    {"sub", lua::wrap<l_simd_binop<simd::BinaryOp::SUB>>},
+    {"mul", lua::wrap<l_simd_binop<simd::BinaryOp::MUL>>},
+    {"min", lua::wrap<l_simd_binop<simd::BinaryOp::MIN>>},
+    {"max", lua::wrap<l_simd_binop<simd::BinaryOp::MAX>>},
+    {"abs", lua::wrap<l_abs>},
     {"resize", lua::wrap<l_resize>},
     {"crop", lua::wrap<l_crop>},
     {"at", lua::wrap<l_at>},
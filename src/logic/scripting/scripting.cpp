@@ -4,7 +4,10 @@
 #include <stdexcept>
 
 #include "scripting_commons.hpp"
+#include "scripting_stats.hpp"
 #include "content/Content.hpp"
+#include "content/ContentCache.hpp"
+#include "debug/Profiler.hpp"
 #include "content/ContentPack.hpp"
 #include "content/ContentControl.hpp"
 #include "debug/Logger.hpp"
@@ -57,15 +60,40 @@ void scripting::load_script(const io::path& name, bool throwable) {
     }
 }
 
+/// @brief Load content script chunk to the top of the stack, using
+/// cached bytecode while content is being loaded
+static void load_chunk(
+    lua::State* L, int env, const io::path& file, const std::string& fileName
+) {
+    auto cache = content_control ? content_control->getCache() : nullptr;
+    if (cache) {
+        if (auto bytecode = cache->getScript(file)) {
+            try {
+                lua::loadbuffer(L, env, *bytecode, fileName);
+                return;
+            } catch (const lua::luaerror& err) {
+                // bytecode of other LuaJIT build
+                logger.warning() << "cached bytecode rejected: " << err.what();
+            }
+        }
+    }
+    std::string src = io::read_string(file);
+    lua::loadbuffer(L, env, src, fileName);
+    if (cache) {
+        cache->putScript(file, lua::dump(L));
+    }
+}
+
 int scripting::load_script(
     int env,
     const std::string& type,
     const io::path& file,
     const std::string& fileName
 ) {
-    std::string src = io::read_string(file);
     logger.info() << "script (" << type << ") " << file.string();
-    return lua::execute(lua::get_main_state(), env, src, fileName);
+    auto L = lua::get_main_state();
+    load_chunk(L, env, file, fileName);
+    return lua::call_nothrow(L, 0);
 }
 
 void scripting::initialize(Engine* engine) {
@@ -277,8 +305,12 @@ void scripting::on_world_load(LevelController* controller) {
 }
 
 void scripting::on_world_tick() {
+    PROFILE_ZONE("scripting::on_world_tick");
     auto L = lua::get_main_state();
     for (auto& pack : content_control->getAllContentPacks()) {
+        if (stats::is_throttled(pack.id)) {
+            continue;
+        }
         lua::emit_event(L, pack.id + ":.worldtick");
     }
 }
@@ -324,6 +356,12 @@ void scripting::cleanup() {
 }
 
 void scripting::on_blocks_tick(const Block& block, int tps) {
+    PROFILE_ZONE("scripting::on_blocks_tick");
+    std::string_view packid = block.name;
+    packid = packid.substr(0, packid.find(':'));
+    if (stats::is_throttled(packid)) {
+        return;
+    }
     std::string name = block.name + ".blockstick";
     lua::emit_event(lua::get_main_state(), name, [tps](auto L) {
         return lua::pushinteger(L, tps);
@@ -420,6 +458,7 @@ bool scripting::on_block_interact(
 }
 
 void scripting::on_chunk_present(const Chunk& chunk, bool loaded) {
+    PROFILE_ZONE("scripting::on_chunk_present");
     auto args = [&chunk, loaded](lua::State* L) {
         lua::pushvec_stack<2>(L, {chunk.x, chunk.z});
         lua::pushboolean(L, loaded);
@@ -479,6 +518,7 @@ void scripting::on_inventory_closed(const Player* player, const Inventory& inven
 }
 
 void scripting::on_player_tick(Player* player, int tps) {
+    PROFILE_ZONE("scripting::on_player_tick");
     auto args = [=](lua::State* L) {
         lua::pushinteger(L, player ? player->getId() : -1);
         lua::pushinteger(L, tps);
@@ -753,13 +793,26 @@ void scripting::on_entity_used(const Entity& entity, Player* player) {
     );
 }
 
-void scripting::on_entities_update(int tps, int parts, int part) {
+void scripting::on_entities_update(
+    int tps, int parts, int part, const std::vector<entityid_t>& suspended
+) {
+    PROFILE_ZONE("scripting::on_entities_update");
     auto L = lua::get_main_state();
     lua::get_from(L, STDCOMP, "update", true);
     lua::pushinteger(L, tps);
     lua::pushinteger(L, parts);
     lua::pushinteger(L, part);
-    lua::call_nothrow(L, 3, 0);
+    if (suspended.empty()) {
+        lua::pushnil(L);
+    } else {
+        lua::createtable(L, 0, suspended.size());
+        for (entityid_t uid : suspended) {
+            lua::pushinteger(L, uid);
+            lua::pushboolean(L, true);
+            lua::rawset(L);
+        }
+    }
+    lua::call_nothrow(L, 4, 0);
     lua::pop(L);
 }
 
@@ -881,9 +934,8 @@ void scripting::load_entity_component(
     const std::string& name, const io::path& file, const std::string& fileName
 ) {
     auto L = lua::get_main_state();
-    std::string src = io::read_string(file);
     logger.info() << "script (component) " << file.string();
-    lua::loadbuffer(L, 0, src, fileName);
+    load_chunk(L, 0, file, fileName);
     lua::store_in(L, lua::CHUNKS_TABLE, name);
 }
 
@@ -127,7 +127,10 @@ namespace scripting {
     void on_entity_grounded(const Entity& entity, float force);
     void on_entity_fall(const Entity& entity);
     void on_entity_save(const Entity& entity);
-    void on_entities_update(int tps, int parts, int part);
+    /// @param suspended ids of entities out of simulation distance
+    void on_entities_update(
+        int tps, int parts, int part, const std::vector<entityid_t>& suspended
+    );
     void on_entities_render(float delta);
     void on_sensor_enter(const Entity& entity, size_t index, entityid_t oid);
     void on_sensor_exit(const Entity& entity, size_t index, entityid_t oid);
@@ -0,0 +1,145 @@
+#include "scripting_stats.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+
+#include "debug/Logger.hpp"
+
+static debug::Logger logger("scripts-stats");
+
+using namespace scripting;
+
+/// @brief Min interval between budget warnings of a pack
+static constexpr auto WARNING_INTERVAL = std::chrono::seconds(5);
+
+namespace {
+    struct EventStats {
+        double time = 0.0;
+        double peak = 0.0;
+        uint64_t calls = 0;
+    };
+
+    struct PackStats {
+        double time = 0.0;
+        double tickTime = 0.0;
+        double peakTick = 0.0;
+        uint64_t calls = 0;
+        uint64_t overruns = 0;
+        bool throttled = false;
+        stats::clock::time_point lastWarning {};
+        std::unordered_map<std::string, EventStats> events;
+    };
+}
+
+static bool explicitlyEnabled = false;
+static bool budgetEnabled = false;
+static uint64_t ticks = 0;
+static std::unordered_map<std::string, PackStats> packs;
+
+void stats::set_enabled(bool flag) {
+    explicitlyEnabled = flag;
+}
+
+bool stats::is_enabled() {
+    return explicitlyEnabled || budgetEnabled;
+}
+
+void stats::add(std::string_view name, double seconds) {
+    size_t colon = name.find(':');
+    std::string_view packName = "core";
+    std::string_view event = name;
+    if (colon != std::string_view::npos) {
+        packName = name.substr(0, colon);
+        event = name.substr(colon + 1);
+    }
+    size_t dot = event.rfind('.');
+    if (dot != std::string_view::npos) {
+        event = event.substr(dot + 1);
+    }
+    auto& pack = packs[std::string(packName)];
+    pack.time += seconds;
+    pack.tickTime += seconds;
+    pack.calls++;
+
+    auto& eventStats = pack.events[std::string(event)];
+    eventStats.time += seconds;
+    eventStats.peak = std::max(eventStats.peak, seconds);
+    eventStats.calls++;
+}
+
+bool stats::is_throttled(std::string_view pack) {
+    if (!budgetEnabled) {
+        return false;
+    }
+    const auto& found = packs.find(std::string(pack));
+    return found != packs.end() && found->second.throttled;
+}
+
+void stats::on_tick(double budget, bool throttle) {
+    budgetEnabled = budget > 0.0;
+    if (!is_enabled()) {
+        return;
+    }
+    ticks++;
+    auto now = clock::now();
+    for (auto& [name, pack] : packs) {
+        double tickTime = pack.tickTime * 1000.0;
+        pack.peakTick = std::max(pack.peakTick, pack.tickTime);
+        pack.tickTime = 0.0;
+        if (!budgetEnabled || tickTime <= budget) {
+            pack.throttled = false;
+            continue;
+        }
+        pack.overruns++;
+        pack.throttled = throttle;
+        if (now - pack.lastWarning >= WARNING_INTERVAL) {
+            pack.lastWarning = now;
+            logger.warning() << "pack '" << name << "' scripts took "
+                             << tickTime << " ms in tick (budget " << budget
+                             << " ms)" << (throttle ? ", throttling" : "");
+        }
+    }
+}
+
+void stats::reset() {
+    packs.clear();
+    ticks = 0;
+}
+
+std::string stats::report(size_t limit) {
+    std::vector<std::pair<std::string, const PackStats*>> sorted;
+    for (const auto& [name, pack] : packs) {
+        sorted.emplace_back(name, &pack);
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) {
+        return a.second->time > b.second->time;
+    });
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(2);
+    ss << "scripts time in " << ticks << " ticks:";
+    for (size_t i = 0; i < sorted.size() && i < limit; i++) {
+        const auto& [name, pack] = sorted[i];
+        ss << "\n  " << name << ": " << pack->time * 1000.0 << " ms, "
+           << (ticks ? pack->time * 1000.0 / ticks : 0.0) << " ms/tick, peak "
+           << pack->peakTick * 1000.0 << " ms/tick, " << pack->calls
+           << " calls";
+        if (pack->overruns) {
+            ss << ", " << pack->overruns << " overruns";
+        }
+        std::vector<std::pair<std::string, EventStats>> events(
+            pack->events.begin(), pack->events.end()
+        );
+        std::sort(events.begin(), events.end(), [](const auto& a, const auto& b) {
+            return a.second.time > b.second.time;
+        });
+        for (const auto& [event, eventStats] : events) {
+            ss << "\n    " << event << ": " << eventStats.time * 1000.0
+               << " ms, " << eventStats.calls << " calls, peak "
+               << eventStats.peak * 1000.0 << " ms";
+        }
+    }
+    return ss.str();
+}
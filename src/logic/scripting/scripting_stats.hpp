@@ -0,0 +1,80 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/// @brief Per-pack and per-event CPU time accounting of main state scripts.
+///
+/// Event name `pack:name.event` is attributed to `pack` and `event`
+/// (e.g. `base:stone.blockstick` -> base, blockstick). Accounting is
+/// active while enabled explicitly or while script budget is set.
+namespace scripting::stats {
+    using clock = std::chrono::steady_clock;
+
+    void set_enabled(bool flag);
+    bool is_enabled();
+
+    /// @brief Add time spent in event handlers
+    /// @param name full event name
+    /// @param seconds time spent
+    void add(std::string_view name, double seconds);
+
+    /// @brief Check if pack periodic events must be skipped in this tick
+    bool is_throttled(std::string_view pack);
+
+    /// @brief Finish tick: check budgets and reset per-tick counters
+    /// @param budget per-pack script time allowance in milliseconds
+    /// (0 - no budget)
+    /// @param throttle skip periodic events of pack in the next tick
+    /// after it exceeds the budget
+    void on_tick(double budget, bool throttle);
+
+    void reset();
+
+    /// @brief Create human-readable report
+    /// @param limit max number of packs in report
+    std::string report(size_t limit);
+
+    /// @brief Accounting scope for an event. Events emitted by handlers
+    /// are nested scopes: their time is subtracted from the enclosing
+    /// scope, so each event accounts only its own (exclusive) time
+    class Scope {
+        /// @brief Innermost active scope of the thread
+        static inline thread_local Scope* current = nullptr;
+
+        std::string_view name;
+        clock::time_point begin;
+        bool active;
+        Scope* parent = nullptr;
+        /// @brief Time spent in nested scopes (seconds)
+        double childrenTime = 0.0;
+    public:
+        explicit Scope(std::string_view name)
+            : name(name), active(is_enabled()) {
+            if (active) {
+                parent = current;
+                current = this;
+                begin = clock::now();
+            }
+        }
+
+        ~Scope() {
+            if (!active) {
+                return;
+            }
+            double elapsed =
+                std::chrono::duration<double>(clock::now() - begin).count();
+            add(name, std::max(0.0, elapsed - childrenTime));
+            if (parent) {
+                parent->childrenTime += elapsed;
+            }
+            current = parent;
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+}
@@ -0,0 +1,533 @@
+#define FNL_IMPL
+#include "simd.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || \
+    defined(_M_IX86)
+#define SIMD_X86
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define SIMD_AVX2
+#else
+#define SIMD_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+#ifdef SIMD_X86
+static bool is_avx2_supported() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx) {
+        return false;
+    }
+    // check if OS saves YMM registers
+    if ((_xgetbv(0) & 0x6) != 0x6) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+static const bool avx2_supported = is_avx2_supported();
+#else
+static const bool avx2_supported = false;
+#endif
+
+static bool enabled = avx2_supported;
+
+bool simd::is_enabled() {
+    return enabled;
+}
+
+void simd::set_enabled(bool flag) {
+    enabled = flag && avx2_supported;
+}
+
+static inline bool is_vectorized(const fnl_state& state) {
+    switch (state.fractal_type) {
+        case FNL_FRACTAL_FBM:
+        case FNL_FRACTAL_RIDGED:
+        case FNL_FRACTAL_PINGPONG:
+            return false;
+        default:
+            break;
+    }
+    return state.noise_type == FNL_NOISE_OPENSIMPLEX2 ||
+           state.noise_type == FNL_NOISE_CELLULAR;
+}
+
+#ifdef SIMD_X86
+
+// Constants are calculated the same way as in FastNoiseLite.h
+static const float SQRT3 = 1.7320508075688772935274463415059f;
+static const float F2 = 0.5f * (SQRT3 - 1);
+static const float G2 = (3 - SQRT3) / 6;
+
+/// @brief Same as _fnlFastFloor: (int)f - 1 for negative values
+SIMD_AVX2 static inline __m256i fast_floor(__m256 f) {
+    __m256i i = _mm256_cvttps_epi32(f);
+    __m256 negative = _mm256_cmp_ps(f, _mm256_setzero_ps(), _CMP_LT_OQ);
+    // mask is -1 for negative values
+    return _mm256_add_epi32(i, _mm256_castps_si256(negative));
+}
+
+/// @brief Same as _fnlFastRound
+SIMD_AVX2 static inline __m256i fast_round(__m256 f) {
+    __m256 negative = _mm256_cmp_ps(f, _mm256_setzero_ps(), _CMP_LT_OQ);
+    __m256 half = _mm256_blendv_ps(
+        _mm256_set1_ps(0.5f), _mm256_set1_ps(-0.5f), negative
+    );
+    return _mm256_cvttps_epi32(_mm256_add_ps(f, half));
+}
+
+/// @brief Same as _fnlFastSqrt
+SIMD_AVX2 static inline __m256 fast_sqrt(__m256 a) {
+    __m256 xhalf = _mm256_mul_ps(_mm256_set1_ps(0.5f), a);
+    __m256i bits = _mm256_sub_epi32(
+        _mm256_set1_epi32(0x5f3759df),
+        _mm256_srai_epi32(_mm256_castps_si256(a), 1)
+    );
+    __m256 inv = _mm256_castsi256_ps(bits);
+    inv = _mm256_mul_ps(
+        inv,
+        _mm256_sub_ps(
+            _mm256_set1_ps(1.5f),
+            _mm256_mul_ps(_mm256_mul_ps(xhalf, inv), inv)
+        )
+    );
+    return _mm256_mul_ps(a, inv);
+}
+
+SIMD_AVX2 static inline __m256i hash2d(
+    __m256i seed, __m256i xPrimed, __m256i yPrimed
+) {
+    __m256i hash = _mm256_xor_si256(_mm256_xor_si256(seed, xPrimed), yPrimed);
+    return _mm256_mullo_epi32(hash, _mm256_set1_epi32(0x27d4eb2d));
+}
+
+SIMD_AVX2 static inline __m256 grad_coord2d(
+    __m256i seed, __m256i xPrimed, __m256i yPrimed, __m256 xd, __m256 yd
+) {
+    __m256i hash = hash2d(seed, xPrimed, yPrimed);
+    hash = _mm256_xor_si256(hash, _mm256_srai_epi32(hash, 15));
+    hash = _mm256_and_si256(hash, _mm256_set1_epi32(127 << 1));
+    __m256 gx = _mm256_i32gather_ps(GRADIENTS_2D, hash, 4);
+    __m256 gy = _mm256_i32gather_ps(
+        GRADIENTS_2D, _mm256_or_si256(hash, _mm256_set1_epi32(1)), 4
+    );
+    return _mm256_add_ps(_mm256_mul_ps(xd, gx), _mm256_mul_ps(yd, gy));
+}
+
+/// @brief (v * v) * (v * v) * grad if v > 0 else 0
+SIMD_AVX2 static inline __m256 falloff(__m256 v, __m256 grad) {
+    __m256 v2 = _mm256_mul_ps(v, v);
+    __m256 n = _mm256_mul_ps(_mm256_mul_ps(v2, v2), grad);
+    __m256 positive = _mm256_cmp_ps(v, _mm256_setzero_ps(), _CMP_GT_OQ);
+    return _mm256_and_ps(n, positive);
+}
+
+/// @brief 8 points of _fnlSingleSimplex2D including coordinates transform
+SIMD_AVX2 static inline __m256 simplex2d(
+    const fnl_state& state, __m256 x, __m256 y
+) {
+    const __m256i seed = _mm256_set1_epi32(state.seed);
+    const __m256i primeX = _mm256_set1_epi32(PRIME_X);
+    const __m256i primeY = _mm256_set1_epi32(PRIME_Y);
+    const __m256 g2 = _mm256_set1_ps(G2);
+    const __m256 g2m1 = _mm256_set1_ps(G2 - 1);
+    const __m256 half = _mm256_set1_ps(0.5f);
+
+    __m256 frequency = _mm256_set1_ps(state.frequency);
+    x = _mm256_mul_ps(x, frequency);
+    y = _mm256_mul_ps(y, frequency);
+    __m256 s = _mm256_mul_ps(_mm256_add_ps(x, y), _mm256_set1_ps(F2));
+    x = _mm256_add_ps(x, s);
+    y = _mm256_add_ps(y, s);
+
+    __m256i i = fast_floor(x);
+    __m256i j = fast_floor(y);
+    __m256 xi = _mm256_sub_ps(x, _mm256_cvtepi32_ps(i));
+    __m256 yi = _mm256_sub_ps(y, _mm256_cvtepi32_ps(j));
+
+    __m256 t = _mm256_mul_ps(_mm256_add_ps(xi, yi), g2);
+    __m256 x0 = _mm256_sub_ps(xi, t);
+    __m256 y0 = _mm256_sub_ps(yi, t);
+
+    i = _mm256_mullo_epi32(i, primeX);
+    j = _mm256_mullo_epi32(j, primeY);
+
+    __m256 a = _mm256_sub_ps(
+        _mm256_sub_ps(half, _mm256_mul_ps(x0, x0)), _mm256_mul_ps(y0, y0)
+    );
+    __m256 n0 = falloff(a, grad_coord2d(seed, i, j, x0, y0));
+
+    __m256 c = _mm256_add_ps(
+        _mm256_mul_ps(
+            _mm256_set1_ps((float)(2 * (1 - 2 * G2) * (1 / G2 - 2))), t
+        ),
+        _mm256_add_ps(
+            _mm256_set1_ps((float)(-2 * (1 - 2 * G2) * (1 - 2 * G2))), a
+        )
+    );
+    __m256 g2x2m1 = _mm256_set1_ps(2 * (float)G2 - 1);
+    __m256 n2 = falloff(
+        c,
+        grad_coord2d(
+            seed,
+            _mm256_add_epi32(i, primeX),
+            _mm256_add_epi32(j, primeY),
+            _mm256_add_ps(x0, g2x2m1),
+            _mm256_add_ps(y0, g2x2m1)
+        )
+    );
+
+    __m256 upper = _mm256_cmp_ps(y0, x0, _CMP_GT_OQ);
+    __m256 x1 = _mm256_add_ps(x0, _mm256_blendv_ps(g2m1, g2, upper));
+    __m256 y1 = _mm256_add_ps(y0, _mm256_blendv_ps(g2, g2m1, upper));
+    __m256i upperi = _mm256_castps_si256(upper);
+    __m256i i1 = _mm256_blendv_epi8(_mm256_add_epi32(i, primeX), i, upperi);
+    __m256i j1 = _mm256_blendv_epi8(j, _mm256_add_epi32(j, primeY), upperi);
+    __m256 b = _mm256_sub_ps(
+        _mm256_sub_ps(half, _mm256_mul_ps(x1, x1)), _mm256_mul_ps(y1, y1)
+    );
+    __m256 n1 = falloff(b, grad_coord2d(seed, i1, j1, x1, y1));
+
+    return _mm256_mul_ps(
+        _mm256_add_ps(_mm256_add_ps(n0, n1), n2),
+        _mm256_set1_ps(99.83685446303647f)
+    );
+}
+
+/// @brief 8 points of _fnlSingleCellular2D including coordinates transform
+SIMD_AVX2 static inline __m256 cellular2d(
+    const fnl_state& state, __m256 x, __m256 y
+) {
+    const __m256i seed = _mm256_set1_epi32(state.seed);
+    const __m256i primeX = _mm256_set1_epi32(PRIME_X);
+    const __m256i primeY = _mm256_set1_epi32(PRIME_Y);
+    const __m256 jitter = _mm256_set1_ps(0.5f * state.cellular_jitter_mod);
+    const __m256 signMask = _mm256_set1_ps(-0.0f);
+    const auto distanceFunc = state.cellular_distance_func;
+
+    __m256 frequency = _mm256_set1_ps(state.frequency);
+    x = _mm256_mul_ps(x, frequency);
+    y = _mm256_mul_ps(y, frequency);
+
+    __m256i xr = fast_round(x);
+    __m256i yr = fast_round(y);
+
+    __m256 distance0 = _mm256_set1_ps(FLT_MAX);
+    __m256 distance1 = _mm256_set1_ps(FLT_MAX);
+    __m256i closestHash = _mm256_setzero_si256();
+
+    __m256i one = _mm256_set1_epi32(1);
+    __m256i xPrimed = _mm256_mullo_epi32(_mm256_sub_epi32(xr, one), primeX);
+    __m256i yPrimedBase = _mm256_mullo_epi32(_mm256_sub_epi32(yr, one), primeY);
+
+    for (int ox = -1; ox <= 1; ox++) {
+        __m256 xi = _mm256_cvtepi32_ps(
+            _mm256_add_epi32(xr, _mm256_set1_epi32(ox))
+        );
+        __m256i yPrimed = yPrimedBase;
+        for (int oy = -1; oy <= 1; oy++) {
+            __m256 yi = _mm256_cvtepi32_ps(
+                _mm256_add_epi32(yr, _mm256_set1_epi32(oy))
+            );
+            __m256i hash = hash2d(seed, xPrimed, yPrimed);
+            __m256i idx = _mm256_and_si256(hash, _mm256_set1_epi32(255 << 1));
+
+            __m256 vecX = _mm256_add_ps(
+                _mm256_sub_ps(xi, x),
+                _mm256_mul_ps(_mm256_i32gather_ps(RAND_VECS_2D, idx, 4), jitter)
+            );
+            __m256 vecY = _mm256_add_ps(
+                _mm256_sub_ps(yi, y),
+                _mm256_mul_ps(
+                    _mm256_i32gather_ps(
+                        RAND_VECS_2D, _mm256_or_si256(idx, one), 4
+                    ),
+                    jitter
+                )
+            );
+            __m256 newDistance;
+            switch (distanceFunc) {
+                case FNL_CELLULAR_DISTANCE_MANHATTAN:
+                    newDistance = _mm256_add_ps(
+                        _mm256_andnot_ps(signMask, vecX),
+                        _mm256_andnot_ps(signMask, vecY)
+                    );
+                    break;
+                case FNL_CELLULAR_DISTANCE_HYBRID:
+                    newDistance = _mm256_add_ps(
+                        _mm256_add_ps(
+                            _mm256_andnot_ps(signMask, vecX),
+                            _mm256_andnot_ps(signMask, vecY)
+                        ),
+                        _mm256_add_ps(
+                            _mm256_mul_ps(vecX, vecX), _mm256_mul_ps(vecY, vecY)
+                        )
+                    );
+                    break;
+                default:
+                    newDistance = _mm256_add_ps(
+                        _mm256_mul_ps(vecX, vecX), _mm256_mul_ps(vecY, vecY)
+                    );
+                    break;
+            }
+            // _fnlFastMin/_fnlFastMax are (x < y ? x : y) / (x > y ? x : y)
+            __m256 lesser = _mm256_blendv_ps(
+                newDistance,
+                distance1,
+                _mm256_cmp_ps(distance1, newDistance, _CMP_LT_OQ)
+            );
+            distance1 = _mm256_blendv_ps(
+                distance0,
+                lesser,
+                _mm256_cmp_ps(lesser, distance0, _CMP_GT_OQ)
+            );
+            __m256 closer = _mm256_cmp_ps(newDistance, distance0, _CMP_LT_OQ);
+            distance0 = _mm256_blendv_ps(distance0, newDistance, closer);
+            closestHash = _mm256_blendv_epi8(
+                closestHash, hash, _mm256_castps_si256(closer)
+            );
+            yPrimed = _mm256_add_epi32(yPrimed, primeY);
+        }
+        xPrimed = _mm256_add_epi32(xPrimed, primeX);
+    }
+
+    const auto returnType = state.cellular_return_type;
+    if (distanceFunc == FNL_CELLULAR_DISTANCE_EUCLIDEAN &&
+        returnType >= FNL_CELLULAR_RETURN_VALUE_DISTANCE) {
+        distance0 = fast_sqrt(distance0);
+        if (returnType >= FNL_CELLULAR_RETURN_VALUE_DISTANCE2) {
+            distance1 = fast_sqrt(distance1);
+        }
+    }
+    const __m256 one_f = _mm256_set1_ps(1.0f);
+    const __m256 half = _mm256_set1_ps(0.5f);
+    switch (returnType) {
+        case FNL_CELLULAR_RETURN_VALUE_CELLVALUE:
+            return _mm256_mul_ps(
+                _mm256_cvtepi32_ps(closestHash),
+                _mm256_set1_ps(1 / 2147483648.0f)
+            );
+        case FNL_CELLULAR_RETURN_VALUE_DISTANCE:
+            return _mm256_sub_ps(distance0, one_f);
+        case FNL_CELLULAR_RETURN_VALUE_DISTANCE2:
+            return _mm256_sub_ps(distance1, one_f);
+        case FNL_CELLULAR_RETURN_VALUE_DISTANCE2ADD:
+            return _mm256_sub_ps(
+                _mm256_mul_ps(_mm256_add_ps(distance1, distance0), half), one_f
+            );
+        case FNL_CELLULAR_RETURN_VALUE_DISTANCE2SUB:
+            return _mm256_sub_ps(_mm256_sub_ps(distance1, distance0), one_f);
+        case FNL_CELLULAR_RETURN_VALUE_DISTANCE2MUL:
+            return _mm256_sub_ps(
+                _mm256_mul_ps(_mm256_mul_ps(distance1, distance0), half), one_f
+            );
+        case FNL_CELLULAR_RETURN_VALUE_DISTANCE2DIV:
+            return _mm256_sub_ps(_mm256_div_ps(distance0, distance1), one_f);
+        default:
+            return _mm256_setzero_ps();
+    }
+}
+
+SIMD_AVX2 static size_t noise2d_avx2(
+    const fnl_state& state,
+    const float* xs,
+    const float* ys,
+    float* dst,
+    size_t count
+) {
+    size_t i = 0;
+    if (state.noise_type == FNL_NOISE_CELLULAR) {
+        for (; i + 8 <= count; i += 8) {
+            __m256 x = _mm256_loadu_ps(xs + i);
+            __m256 y = _mm256_loadu_ps(ys + i);
+            _mm256_storeu_ps(dst + i, cellular2d(state, x, y));
+        }
+    } else {
+        for (; i + 8 <= count; i += 8) {
+            __m256 x = _mm256_loadu_ps(xs + i);
+            __m256 y = _mm256_loadu_ps(ys + i);
+            _mm256_storeu_ps(dst + i, simplex2d(state, x, y));
+        }
+    }
+    return i;
+}
+
+SIMD_AVX2 static inline __m256 binop_avx2(
+    simd::BinaryOp op, __m256 a, __m256 b
+) {
+    switch (op) {
+        case simd::BinaryOp::ADD: return _mm256_add_ps(a, b);
+        case simd::BinaryOp::SUB: return _mm256_sub_ps(a, b);
+        case simd::BinaryOp::MUL: return _mm256_mul_ps(a, b);
+        case simd::BinaryOp::MIN: return _mm256_min_ps(a, b);
+        case simd::BinaryOp::MAX: return _mm256_max_ps(a, b);
+    }
+    return a;
+}
+
+SIMD_AVX2 static size_t binop_avx2(
+    simd::BinaryOp op, float* dst, const float* src, size_t count
+) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 a = _mm256_loadu_ps(dst + i);
+        __m256 b = _mm256_loadu_ps(src + i);
+        _mm256_storeu_ps(dst + i, binop_avx2(op, a, b));
+    }
+    return i;
+}
+
+SIMD_AVX2 static size_t binop_avx2(
+    simd::BinaryOp op, float* dst, float scalar, size_t count
+) {
+    size_t i = 0;
+    __m256 b = _mm256_set1_ps(scalar);
+    for (; i + 8 <= count; i += 8) {
+        __m256 a = _mm256_loadu_ps(dst + i);
+        _mm256_storeu_ps(dst + i, binop_avx2(op, a, b));
+    }
+    return i;
+}
+
+SIMD_AVX2 static size_t abs_avx2(float* dst, size_t count) {
+    size_t i = 0;
+    __m256 signMask = _mm256_set1_ps(-0.0f);
+    for (; i + 8 <= count; i += 8) {
+        __m256 a = _mm256_loadu_ps(dst + i);
+        _mm256_storeu_ps(dst + i, _mm256_andnot_ps(signMask, a));
+    }
+    return i;
+}
+
+SIMD_AVX2 static size_t mix_avx2(
+    float* dst,
+    const float* src,
+    float srcScalar,
+    const float* t,
+    float tScalar,
+    size_t count
+) {
+    size_t i = 0;
+    __m256 one = _mm256_set1_ps(1.0f);
+    __m256 srcv = _mm256_set1_ps(srcScalar);
+    __m256 tv = _mm256_set1_ps(tScalar);
+    for (; i + 8 <= count; i += 8) {
+        __m256 a = _mm256_loadu_ps(dst + i);
+        __m256 b = src ? _mm256_loadu_ps(src + i) : srcv;
+        __m256 f = t ? _mm256_loadu_ps(t + i) : tv;
+        _mm256_storeu_ps(
+            dst + i,
+            _mm256_add_ps(
+                _mm256_mul_ps(a, _mm256_sub_ps(one, f)), _mm256_mul_ps(b, f)
+            )
+        );
+    }
+    return i;
+}
+
+#endif // SIMD_X86
+
+void simd::noise2d(
+    fnl_state& state,
+    const float* xs,
+    const float* ys,
+    float* dst,
+    size_t count
+) {
+    size_t i = 0;
+#ifdef SIMD_X86
+    if (enabled && is_vectorized(state)) {
+        i = noise2d_avx2(state, xs, ys, dst, count);
+    }
+#endif
+    for (; i < count; i++) {
+        dst[i] = fnlGetNoise2D(&state, xs[i], ys[i]);
+    }
+}
+
+static inline float binop_scalar(simd::BinaryOp op, float a, float b) {
+    switch (op) {
+        case simd::BinaryOp::ADD: return a + b;
+        case simd::BinaryOp::SUB: return a - b;
+        case simd::BinaryOp::MUL: return a * b;
+        case simd::BinaryOp::MIN: return std::min(a, b);
+        case simd::BinaryOp::MAX: return std::max(a, b);
+    }
+    return a;
+}
+
+void simd::binop(BinaryOp op, float* dst, const float* src, size_t count) {
+    size_t i = 0;
+#ifdef SIMD_X86
+    if (enabled) {
+        i = binop_avx2(op, dst, src, count);
+    }
+#endif
+    for (; i < count; i++) {
+        dst[i] = binop_scalar(op, dst[i], src[i]);
+    }
+}
+
+void simd::binop(BinaryOp op, float* dst, float scalar, size_t count) {
+    size_t i = 0;
+#ifdef SIMD_X86
+    if (enabled) {
+        i = binop_avx2(op, dst, scalar, count);
+    }
+#endif
+    for (; i < count; i++) {
+        dst[i] = binop_scalar(op, dst[i], scalar);
+    }
+}
+
+void simd::abs(float* dst, size_t count) {
+    size_t i = 0;
+#ifdef SIMD_X86
+    if (enabled) {
+        i = abs_avx2(dst, count);
+    }
+#endif
+    for (; i < count; i++) {
+        dst[i] = std::abs(dst[i]);
+    }
+}
+
+void simd::mix(
+    float* dst,
+    const float* src,
+    float srcScalar,
+    const float* t,
+    float tScalar,
+    size_t count
+) {
+    size_t i = 0;
+#ifdef SIMD_X86
+    if (enabled) {
+        i = mix_avx2(dst, src, srcScalar, t, tScalar, count);
+    }
+#endif
+    for (; i < count; i++) {
+        float b = src ? src[i] : srcScalar;
+        float f = t ? t[i] : tScalar;
+        dst[i] = dst[i] * (1.0f - f) + b * f;
+    }
+}
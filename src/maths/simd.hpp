@@ -0,0 +1,57 @@
+#pragma once
+
+#include <stddef.h>
+
+#include "maths/FastNoiseLite.h"
+
+/// @brief Batch kernels for heightmaps. AVX2 is used if supported by CPU
+/// (detected at runtime), scalar implementation otherwise.
+namespace simd {
+    enum class BinaryOp {
+        ADD, SUB, MUL, MIN, MAX
+    };
+
+    /// @return true if AVX2 kernels are used
+    bool is_enabled();
+
+    /// @brief Enable or disable SIMD kernels (for testing and benchmarking).
+    /// Has no effect if AVX2 is not supported.
+    void set_enabled(bool flag);
+
+    /// @brief Calculate 2D noise values for the points.
+    /// Equivalent to fnlGetNoise2D call per point. Vectorized for
+    /// OpenSimplex2 and Cellular noise types without fractal.
+    /// @param state noise state
+    /// @param xs points X coordinates
+    /// @param ys points Y coordinates
+    /// @param dst destination values buffer
+    /// @param count number of points
+    void noise2d(
+        fnl_state& state,
+        const float* xs,
+        const float* ys,
+        float* dst,
+        size_t count
+    );
+
+    /// @brief dst[i] = op(dst[i], src[i])
+    void binop(BinaryOp op, float* dst, const float* src, size_t count);
+
+    /// @brief dst[i] = op(dst[i], scalar)
+    void binop(BinaryOp op, float* dst, float scalar, size_t count);
+
+    /// @brief dst[i] = abs(dst[i])
+    void abs(float* dst, size_t count);
+
+    /// @brief dst[i] = dst[i] * (1 - t) + src[i] * t
+    /// @param src source values or nullptr to use srcScalar
+    /// @param t interpolation values or nullptr to use tScalar
+    void mix(
+        float* dst,
+        const float* src,
+        float srcScalar,
+        const float* t,
+        float tScalar,
+        size_t count
+    );
+}
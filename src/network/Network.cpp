@@ -26,6 +26,7 @@ using SOCKET = int;
 #endif // _WIN32
 
 #include "debug/Logger.hpp"
+#include "debug/Metrics.hpp"
 #include "util/stringutil.hpp"
 
 using namespace network;
@@ -666,6 +667,10 @@ size_t Network::getTotalDownload() const {
 }
 
 void Network::update() {
+    static auto& uploadTotal = debug::metrics::gauge("network.upload");
+    static auto& downloadTotal = debug::metrics::gauge("network.download");
+    static auto& connectionsCount = debug::metrics::gauge("network.connections");
+
     requests->update();
 
     {
@@ -691,7 +696,10 @@ void Network::update() {
             }
             ++serveriter;
         }
+        connectionsCount.set(connections.size());
     }
+    uploadTotal.set(getTotalUpload());
+    downloadTotal.set(getTotalDownload());
 }
 
 std::unique_ptr<Network> Network::create(const NetworkSettings& settings) {
@@ -6,8 +6,10 @@
 
 #include "assets/Assets.hpp"
 #include "content/Content.hpp"
+#include "coders/binary_json.hpp"
 #include "data/dv_util.hpp"
 #include "debug/Logger.hpp"
+#include "debug/Profiler.hpp"
 #include "engine/Engine.hpp"
 #include "graphics/core/DrawContext.hpp"
 #include "graphics/core/LineBatch.hpp"
@@ -16,10 +18,13 @@
 #include "logic/scripting/scripting.hpp"
 #include "maths/FrustumCulling.hpp"
 #include "maths/rays.hpp"
+#include "maths/voxmaths.hpp"
 #include "EntityDef.hpp"
 #include "rigging.hpp"
 #include "physics/Hitbox.hpp"
 #include "physics/PhysicsSolver.hpp"
+#include "voxels/Chunk.hpp"
+#include "voxels/GlobalChunks.hpp"
 #include "world/Level.hpp"
 
 static debug::Logger logger("entities");
@@ -123,12 +128,8 @@ static void initialize_body(
     }
 }
 
-entityid_t Entities::spawn(
-    const EntityDef& def,
-    glm::vec3 position,
-    dv::value args,
-    dv::value saved,
-    entityid_t uid
+Entity Entities::create(
+    const EntityDef& def, glm::vec3 position, entityid_t uid
 ) {
     auto skeleton = level.content.getSkeleton(def.skeletonName);
     if (skeleton == nullptr) {
@@ -154,7 +155,7 @@ entityid_t Entities::spawn(
     uids[entity] = id;
 
     registry.emplace<EntityId>(entity, static_cast<entityid_t>(id), def);
-    const auto& tsf = registry.emplace<Transform>(
+    registry.emplace<Transform>(
         entity,
         position,
         glm::vec3(1.0f),
@@ -179,15 +180,37 @@ entityid_t Entities::spawn(
         );
         scripting.components.emplace_back(std::move(component));
     }
+    return get(id).value();
+}
+
+void Entities::finishSpawn(
+    const Entity& entity, const dv::value& args, const dv::value& saved
+) {
+    entity.getRigidbody().hitbox.position = entity.getTransform().pos;
+    scripting::on_entity_spawn(
+        entity.getDef(),
+        entity.getUID(),
+        entity.getScripting().components,
+        args,
+        saved
+    );
+}
+
+entityid_t Entities::spawn(
+    const EntityDef& def,
+    glm::vec3 position,
+    dv::value args,
+    dv::value saved,
+    entityid_t uid
+) {
+    auto entity = create(def, position, uid);
     dv::value componentsMap = nullptr;
     if (saved != nullptr) {
         componentsMap = saved["comps"];
-        loadEntity(saved, get(id).value());
+        loadEntity(saved, entity);
     }
-    body.hitbox.position = tsf.pos;
-    scripting::on_entity_spawn(
-        def, id, scripting.components, args, componentsMap);
-    return id;
+    finishSpawn(entity, args, componentsMap);
+    return entity.getUID();
 }
 
 void Entities::despawn(entityid_t id) {
@@ -251,6 +274,178 @@ void Entities::loadEntity(const dv::value& map, Entity entity) {
     }
 }
 
+namespace {
+    /// @brief Entity state read from chunk entities layer
+    struct SavedEntity {
+        entityid_t uid = 0;
+        std::string def;
+        std::string skeletonName;
+        std::optional<glm::vec3> pos;
+        std::optional<glm::vec3> size;
+        std::optional<glm::mat3> rot;
+        std::optional<glm::vec3> velocity;
+        std::string bodyType;
+        std::optional<bool> crouch;
+        std::optional<float> damping;
+        std::vector<std::pair<std::string, std::string>> textures;
+        std::vector<glm::mat4> pose;
+        dv::value comps = nullptr;
+    };
+}
+
+template <int n>
+static glm::vec<n, float> read_vec(json::BinaryCursor& cursor) {
+    glm::vec<n, float> vec {};
+    cursor.enterList();
+    for (int i = 0; cursor.hasNext(); i++) {
+        if (i < n) {
+            vec[i] = cursor.readNumber();
+        } else {
+            cursor.skip();
+        }
+    }
+    return vec;
+}
+
+template <int n, int m>
+static glm::mat<n, m, float> read_mat(json::BinaryCursor& cursor) {
+    glm::mat<n, m, float> mat(1.0f);
+    cursor.enterList();
+    for (int i = 0; cursor.hasNext(); i++) {
+        if (i < n * m) {
+            mat[i / m][i % m] = cursor.readNumber();
+        } else {
+            cursor.skip();
+        }
+    }
+    return mat;
+}
+
+static void read_skeleton(json::BinaryCursor& cursor, SavedEntity& saved) {
+    if (cursor.peekType() == dv::value_type::string) {
+        saved.skeletonName = cursor.readString();
+        return;
+    }
+    cursor.enterObject();
+    while (cursor.hasNext()) {
+        auto key = cursor.readKey();
+        if (key == "textures") {
+            cursor.enterObject();
+            while (cursor.hasNext()) {
+                std::string slot(cursor.readKey());
+                saved.textures.emplace_back(slot, cursor.readString());
+            }
+        } else if (key == "pose") {
+            cursor.enterList();
+            while (cursor.hasNext()) {
+                saved.pose.push_back(read_mat<4, 4>(cursor));
+            }
+        } else {
+            cursor.skip();
+        }
+    }
+}
+
+static SavedEntity read_entity(json::BinaryCursor& cursor) {
+    SavedEntity saved;
+    cursor.enterObject();
+    while (cursor.hasNext()) {
+        auto key = cursor.readKey();
+        if (key == "uid") {
+            saved.uid = cursor.readInteger();
+        } else if (key == "def") {
+            saved.def = cursor.readString();
+        } else if (key == COMP_SKELETON) {
+            read_skeleton(cursor, saved);
+        } else if (key == "comps") {
+            saved.comps = cursor.readValue();
+        } else if (key == COMP_TRANSFORM) {
+            cursor.enterObject();
+            while (cursor.hasNext()) {
+                auto key = cursor.readKey();
+                if (key == "pos") {
+                    saved.pos = read_vec<3>(cursor);
+                } else if (key == "size") {
+                    saved.size = read_vec<3>(cursor);
+                } else if (key == "rot") {
+                    saved.rot = read_mat<3, 3>(cursor);
+                } else {
+                    cursor.skip();
+                }
+            }
+        } else if (key == COMP_RIGIDBODY) {
+            cursor.enterObject();
+            while (cursor.hasNext()) {
+                auto key = cursor.readKey();
+                if (key == "vel") {
+                    saved.velocity = read_vec<3>(cursor);
+                } else if (key == "type") {
+                    saved.bodyType = cursor.readString();
+                } else if (key == "crouch") {
+                    saved.crouch = cursor.readBoolean();
+                } else if (key == "damping") {
+                    saved.damping = cursor.readNumber();
+                } else {
+                    cursor.skip();
+                }
+            }
+        } else {
+            cursor.skip();
+        }
+    }
+    return saved;
+}
+
+void Entities::loadEntity(json::BinaryCursor& cursor) {
+    size_t start = cursor.tell();
+    try {
+        auto saved = read_entity(cursor);
+        auto& def = level.content.entities.require(saved.def);
+        auto entity = create(def, {}, saved.uid);
+
+        auto& transform = entity.getTransform();
+        auto& body = entity.getRigidbody();
+        auto& skeleton = entity.getSkeleton();
+        if (saved.velocity) {
+            body.hitbox.velocity = *saved.velocity;
+        }
+        BodyTypeMeta.getItem(saved.bodyType, body.hitbox.type);
+        if (saved.crouch) {
+            body.hitbox.crouching = *saved.crouch;
+        }
+        if (saved.damping) {
+            body.hitbox.linearDamping = *saved.damping;
+        }
+        if (saved.pos) {
+            transform.pos = *saved.pos;
+        }
+        if (saved.size) {
+            transform.size = *saved.size;
+        }
+        if (saved.rot) {
+            transform.rot = *saved.rot;
+        }
+        if (!saved.skeletonName.empty() &&
+            saved.skeletonName != skeleton.config->getName()) {
+            skeleton.config = level.content.getSkeleton(saved.skeletonName);
+        }
+        for (auto& [slot, texture] : saved.textures) {
+            skeleton.textures[slot] = std::move(texture);
+        }
+        for (size_t i = 0;
+             i < std::min(skeleton.pose.matrices.size(), saved.pose.size());
+             i++) {
+            skeleton.pose.matrices[i] = saved.pose[i];
+        }
+        finishSpawn(entity, nullptr, saved.comps);
+    } catch (const std::runtime_error& err) {
+        logger.error() << "could not read entity: " << err.what();
+        // continue with the next entity
+        cursor.seek(start);
+        cursor.skip();
+    }
+}
+
 std::optional<Entities::RaycastResult> Entities::rayCast(
     glm::vec3 start, glm::vec3 dir, float maxDistance, entityid_t ignore
 ) {
@@ -294,6 +489,27 @@ void Entities::loadEntities(dv::value root) {
     }
 }
 
+bool Entities::loadEntities(json::BinaryCursor& cursor) {
+    if (cursor.peekType() != dv::value_type::object) {
+        return false;
+    }
+    clean();
+    bool empty = true;
+    cursor.enterObject();
+    while (cursor.hasNext()) {
+        empty = false;
+        if (cursor.readKey() != "data") {
+            cursor.skip();
+            continue;
+        }
+        cursor.enterList();
+        while (cursor.hasNext()) {
+            loadEntity(cursor);
+        }
+    }
+    return !empty;
+}
+
 void Entities::onSave(const Entity& entity) {
     scripting::on_entity_save(entity);
 }
@@ -457,13 +673,23 @@ void Entities::preparePhysics(float delta) {
     }
 }
 
+bool Entities::isSimulated(const glm::vec3& pos) const {
+    return !simulationLimited ||
+           level.chunks->isViewed(
+               floordiv<CHUNK_W>(static_cast<int>(std::floor(pos.x))),
+               floordiv<CHUNK_D>(static_cast<int>(std::floor(pos.z)))
+           );
+}
+
 void Entities::updatePhysics(float delta) {
+    PROFILE_ZONE("Entities::updatePhysics");
     preparePhysics(delta);
 
     auto view = registry.view<EntityId, Transform, Rigidbody>();
     auto physics = level.physics.get();
     for (auto [entity, eid, transform, rigidbody] : view.each()) {
-        if (!rigidbody.enabled || rigidbody.hitbox.type == BodyType::STATIC) {
+        if (!rigidbody.enabled || rigidbody.hitbox.type == BodyType::STATIC ||
+            !isSimulated(transform.pos)) {
             continue;
         }
         auto& hitbox = rigidbody.hitbox;
@@ -488,11 +714,21 @@ void Entities::updatePhysics(float delta) {
 }
 
 void Entities::update(float delta) {
+    PROFILE_ZONE("Entities::update");
     if (updateTickClock.update(delta)) {
+        int parts = updateTickClock.getParts();
+        int part = updateTickClock.getPart();
+        std::vector<entityid_t> suspended;
+        if (simulationLimited) {
+            auto view = registry.view<EntityId, Transform>();
+            for (auto [entity, eid, transform] : view.each()) {
+                if (eid.uid % parts == part && !isSimulated(transform.pos)) {
+                    suspended.push_back(eid.uid);
+                }
+            }
+        }
         scripting::on_entities_update(
-            updateTickClock.getTickRate(),
-            updateTickClock.getParts(),
-            updateTickClock.getPart()
+            updateTickClock.getTickRate(), parts, part, suspended
         );
     }
 }
@@ -14,6 +14,10 @@
 #include <glm/gtx/norm.hpp>
 #include <unordered_map>
 
+namespace json {
+    class BinaryCursor;
+}
+
 struct EntityFuncsSet {
     bool init;
     bool on_despawn;
@@ -185,11 +189,23 @@ class Entities {
     entityid_t nextID = 1;
     util::Clock sensorsTickClock;
     util::Clock updateTickClock;
+    /// @brief Entities outside of active chunks are not simulated
+    bool simulationLimited = false;
+
+    /// @brief Check if entity at the position is simulated
+    bool isSimulated(const glm::vec3& pos) const;
 
     void updateSensors(
         Rigidbody& body, const Transform& tsf, std::vector<Sensor*>& sensors
     );
     void preparePhysics(float delta);
+
+    /// @brief Create entity with default components state
+    Entity create(const EntityDef& def, glm::vec3 position, entityid_t uid);
+    /// @brief Run on_spawn event of the created entity
+    void finishSpawn(
+        const Entity& entity, const dv::value& args, const dv::value& saved
+    );
 public:
     struct RaycastResult {
         entityid_t entity;
@@ -203,6 +219,12 @@ public:
     void updatePhysics(float delta);
     void update(float delta);
 
+    /// @brief Enable skipping physics and scripts updates of entities
+    /// outside of chunks viewers areas (simulation distance)
+    void setSimulationLimited(bool flag) {
+        simulationLimited = flag;
+    }
+
     void renderDebug(
         LineBatch& batch, const Frustum* frustum, const DrawContext& ctx
     );
@@ -245,7 +267,12 @@ public:
     );
 
     void loadEntities(dv::value map);
+    /// @brief Load entities from chunk entities layer data without
+    /// decoding whole data tree
+    /// @return false if there is no entities data
+    bool loadEntities(json::BinaryCursor& cursor);
     void loadEntity(const dv::value& map);
+    void loadEntity(json::BinaryCursor& cursor);
     void loadEntity(const dv::value& map, Entity entity);
     void onSave(const Entity& entity);
     bool hasBlockingInside(AABB aabb);
@@ -5,6 +5,7 @@
 #include "world/Level.hpp"
 #include "world/World.hpp"
 #include "objects/Entities.hpp"
+#include "voxels/GlobalChunks.hpp"
 
 Players::Players(Level& level) : level(level) {}
 
@@ -68,6 +69,7 @@ void Players::resume(int64_t id) {
 
 void Players::remove(int64_t id) {
     players.erase(id);
+    level.chunks->removeViewer(id);
 }
 
 dv::value Players::serialize() const {
@@ -40,6 +40,33 @@ struct ChunksSettings {
     IntegerSetting loadDistance {22, 3, 80};
     /// @brief Buffer zone where chunks are not unloading (chunk is unit)
     IntegerSetting padding {2, 1, 8};
+    /// @brief Max number of chunk prototypes kept by world generator after
+    /// leaving generation area (0 - disabled)
+    IntegerSetting prototypesCache {0, 0, 65536};
+    /// @brief Write prototypes evicted from cache to world folder
+    FlagSetting prototypesSpill {false};
+    /// @brief Number of chunks compression threads (0 - save synchronously)
+    IntegerSetting saveWorkers {2, 0, 16};
+    /// @brief In-memory regions budget in MiB (0 - unlimited)
+    IntegerSetting regionsMemory {256, 0, 8192};
+    /// @brief Append saved chunks to the world journal instead of
+    /// rewriting region files on every save
+    FlagSetting saveJournal {false};
+    /// @brief Save chunks voxels as difference with the world generator
+    /// output
+    FlagSetting saveDeltas {false};
+    /// @brief Lower players load distance when level update takes longer
+    /// than targetTickTime or chunks loading can not keep up
+    FlagSetting adaptiveDistance {false};
+    /// @brief Adaptive load distance lower bound (chunk is unit)
+    IntegerSetting minLoadDistance {6, 3, 80};
+    /// @brief Radius of simulated zone: random ticks, entities physics
+    /// and updates (0 - same as load distance)
+    IntegerSetting simulationDistance {0, 0, 80};
+    /// @brief Level update time target in milliseconds
+    IntegerSetting targetTickTime {40, 1, 1000};
+    /// @brief Number of chunks waiting for loading considered as backlog
+    IntegerSetting maxBacklog {64, 1, 4096};
 };
 
 struct CameraSettings {
@@ -82,6 +109,11 @@ struct DebugSettings {
     FlagSetting generatorTestMode {false};
     /// @brief Write lights cache
     FlagSetting doWriteLights {true};
+    /// @brief Per-pack scripts time allowance per update in milliseconds
+    /// (0 - disabled)
+    NumberSetting scriptsBudget {0.0f, 0.0f, 1000.0f};
+    /// @brief Skip periodic events of packs exceeding scripts budget
+    FlagSetting scriptsThrottle {false};
 };
 
 struct UiSettings {
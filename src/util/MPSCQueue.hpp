@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace util {
+    /// @brief Bounded lock-free multi-producer single-consumer queue
+    /// (Vyukov's bounded queue with single consumer)
+    /// @tparam T value type, must be default-constructible and movable
+    template <typename T>
+    class MPSCQueue {
+        struct Cell {
+            std::atomic<size_t> sequence;
+            T value;
+        };
+        std::unique_ptr<Cell[]> cells;
+        size_t mask;
+        alignas(64) std::atomic<size_t> enqueuePos {0};
+        alignas(64) size_t dequeuePos = 0;
+    public:
+        /// @param capacity max number of values, rounded up to power of two
+        explicit MPSCQueue(size_t capacity) {
+            size_t size = 2;
+            while (size < capacity) {
+                size <<= 1;
+            }
+            cells = std::make_unique<Cell[]>(size);
+            mask = size - 1;
+            for (size_t i = 0; i < size; i++) {
+                cells[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        MPSCQueue(const MPSCQueue&) = delete;
+        MPSCQueue& operator=(const MPSCQueue&) = delete;
+
+        /// @brief Push value (thread-safe)
+        /// @return false if the queue is full (value is not moved)
+        bool tryPush(T&& value) {
+            Cell* cell;
+            size_t pos = enqueuePos.load(std::memory_order_relaxed);
+            while (true) {
+                cell = &cells[pos & mask];
+                size_t sequence = cell->sequence.load(std::memory_order_acquire);
+                auto diff = static_cast<intptr_t>(sequence) -
+                            static_cast<intptr_t>(pos);
+                if (diff == 0) {
+                    if (enqueuePos.compare_exchange_weak(
+                            pos, pos + 1, std::memory_order_relaxed
+                        )) {
+                        break;
+                    }
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    pos = enqueuePos.load(std::memory_order_relaxed);
+                }
+            }
+            cell->value = std::move(value);
+            cell->sequence.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        /// @brief Pop value (consumer thread only)
+        /// @return false if the queue is empty
+        bool tryPop(T& value) {
+            Cell& cell = cells[dequeuePos & mask];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            if (static_cast<intptr_t>(sequence) -
+                    static_cast<intptr_t>(dequeuePos + 1) < 0) {
+                return false;
+            }
+            value = std::move(cell.value);
+            cell.sequence.store(dequeuePos + mask + 1, std::memory_order_release);
+            dequeuePos++;
+            return true;
+        }
+
+        size_t capacity() const {
+            return mask + 1;
+        }
+    };
+}
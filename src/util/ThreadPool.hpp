@@ -38,6 +38,7 @@ namespace util {
         std::queue<T> jobs;
         std::queue<ThreadPoolResult<T, R>> results;
         std::mutex resultsMutex;
+        std::condition_variable resultsCondition;
         std::vector<std::thread> threads;
         std::condition_variable jobsMutexCondition;
         std::mutex jobsMutex;
@@ -48,7 +49,7 @@ namespace util {
         std::atomic<int> busyWorkers = 0;
         std::atomic<uint> jobsDone = 0;
         std::atomic<bool> working = true;
-        bool failed = false;
+        std::atomic<bool> failed = false;
         bool standaloneResults = true;
         bool stopOnFail = true;
 
@@ -82,6 +83,7 @@ namespace util {
                         }
                         busyWorkers--;
                     }
+                    resultsCondition.notify_all();
                     if (!standaloneResults) {
                         std::unique_lock<std::mutex> lock(mutex);
                         variable.wait(lock, [&] {
@@ -99,7 +101,12 @@ namespace util {
                     }
                     logger.error() << "uncaught exception: " << err.what();
                 }
-                jobsDone++;
+                {
+                    // failed jobs produce no results
+                    std::lock_guard<std::mutex> lock(resultsMutex);
+                    jobsDone++;
+                }
+                resultsCondition.notify_all();
             }
         }
     public:
@@ -170,6 +177,7 @@ namespace util {
                     }
                 }
             }
+            resultsCondition.notify_all();
 
             jobsMutexCondition.notify_all();
             for (auto& thread : threads) {
@@ -229,6 +237,19 @@ namespace util {
             }
         }
 
+        /// @brief Block until some results are ready to be consumed with
+        /// update(), a job is finished without result, failed or the pool
+        /// is terminated. Must not be called when no jobs are enqueued or
+        /// being processed
+        void waitForResults() {
+            std::unique_lock<std::mutex> lock(resultsMutex);
+            uint done = jobsDone;
+            resultsCondition.wait(lock, [this, done] {
+                return !results.empty() || !working || failed ||
+                       jobsDone != done;
+            });
+        }
+
         void enqueueJob(T job) {
             {
                 std::lock_guard<std::mutex> lock(jobsMutex);
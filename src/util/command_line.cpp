@@ -2,6 +2,7 @@
 
 #include <iostream>
 
+#include "debug/Logger.hpp"
 #include "io/engine_paths.hpp"
 #include "util/ArgsReader.hpp"
 #include "engine/Engine.hpp"
@@ -27,6 +28,15 @@ static bool perform_keyword(
         std::cout << " --headless - run in headless mode\n";
         std::cout << " --test <path> - test script file\n";
         std::cout << " --script <path> - main script file\n";
+        std::cout << " --profile <path> - write Chrome trace on exit\n";
+        std::cout << " --world <name> - run dedicated server with world\n";
+        std::cout << " --tps <rate> - dedicated server ticks per second\n";
+        std::cout << " --catch-up - run missed ticks instead of skipping\n";
+        std::cout << " --metrics <path> - write tick metrics file\n";
+        std::cout << " --replay <path> - replay recorded session on --world "
+                     "snapshot in headless mode and report tick timings\n";
+        std::cout << " --log-level [module=]<level> - set min log level "
+                     "(debug, info, warning, error)\n";
         std::cout << std::endl;
         return false;
     } else if (keyword == "--version") {
@@ -42,6 +52,43 @@ static bool perform_keyword(
         auto token = reader.next();
         params.testMode = false;
         params.scriptFile = token;
+    } else if (keyword == "--profile") {
+        auto token = reader.next();
+        params.profileFile = token;
+    } else if (keyword == "--world") {
+        params.worldName = reader.next();
+    } else if (keyword == "--tps") {
+        auto token = reader.next();
+        try {
+            params.tickRate = std::stoi(token);
+        } catch (const std::logic_error&) {
+            params.tickRate = 0;
+        }
+        if (params.tickRate <= 0 || params.tickRate > 1000) {
+            throw std::runtime_error("invalid tick rate " + token);
+        }
+    } else if (keyword == "--catch-up") {
+        params.tickCatchUp = true;
+    } else if (keyword == "--log-level") {
+        auto token = reader.next();
+        auto separator = token.find('=');
+        auto level = debug::Logger::parseLevel(
+            separator == std::string::npos ? token : token.substr(separator + 1)
+        );
+        if (!level) {
+            throw std::runtime_error("invalid log level " + token);
+        }
+        if (separator == std::string::npos) {
+            debug::Logger::setLevel(*level);
+        } else {
+            debug::Logger::setModuleLevel(token.substr(0, separator), *level);
+        }
+    } else if (keyword == "--replay") {
+        auto token = reader.next();
+        params.replayFile = token;
+    } else if (keyword == "--metrics") {
+        auto token = reader.next();
+        params.metricsFile = token;
     } else {
         throw std::runtime_error("unknown argument " + keyword);
     }
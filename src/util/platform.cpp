@@ -65,8 +65,28 @@ int platform::get_process_id() {
     return GetCurrentProcessId(); 
 }
 
+bool platform::sync_file(const std::filesystem::path& file) {
+    HANDLE handle = CreateFileW(
+        file.wstring().c_str(),
+        GENERIC_WRITE,
+        FILE_SHARE_READ | FILE_SHARE_WRITE,
+        nullptr,
+        OPEN_EXISTING,
+        // required to open directory handle
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_BACKUP_SEMANTICS,
+        nullptr
+    );
+    if (handle == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    bool success = FlushFileBuffers(handle);
+    CloseHandle(handle);
+    return success;
+}
+
 #else // _WIN32
 
+#include <fcntl.h>
 #include <unistd.h>
 #include "frontend/locale.hpp"
 
@@ -92,6 +112,17 @@ void platform::sleep(size_t millis) {
 int platform::get_process_id() {
     return getpid();
 }
+
+bool platform::sync_file(const std::filesystem::path& file) {
+    // directories may be synced too to make renames durable
+    int fd = open(file.u8string().c_str(), O_RDONLY);
+    if (fd == -1) {
+        return false;
+    }
+    bool success = fsync(fd) == 0;
+    close(fd);
+    return success;
+}
 #endif // _WIN32
 
 void platform::open_folder(const std::filesystem::path& folder) {
@@ -13,4 +13,7 @@ namespace platform {
     /// Makes the current thread sleep for the specified amount of milliseconds.
     void sleep(size_t millis);
     int get_process_id();
+    /// @brief Flush file or directory data to the storage device
+    /// @return false if file could not be synced
+    bool sync_file(const std::filesystem::path& file);
 }
@@ -0,0 +1,155 @@
+#include "ActiveChunks.hpp"
+
+#include <algorithm>
+
+#include "Chunk.hpp"
+
+/// @brief Visit positions inside of the area but outside of the excluded one
+template <typename Func>
+static void for_each_difference(
+    const ChunksViewer& area, const ChunksViewer* exclude, const Func& func
+) {
+    int minX = area.x - area.radius;
+    int maxX = area.x + area.radius;
+    int minZ = area.z - area.radius;
+    int maxZ = area.z + area.radius;
+    // intersection of the areas (empty if there is no excluded area)
+    int innerMinX = minX, innerMaxX = minX;
+    int innerMinZ = minZ, innerMaxZ = minZ;
+    if (exclude) {
+        innerMinX = std::max(minX, exclude->x - exclude->radius);
+        innerMaxX = std::min(maxX, exclude->x + exclude->radius);
+        innerMinZ = std::max(minZ, exclude->z - exclude->radius);
+        innerMaxZ = std::min(maxZ, exclude->z + exclude->radius);
+        if (innerMinX >= innerMaxX || innerMinZ >= innerMaxZ) {
+            innerMinX = innerMaxX = minX;
+            innerMinZ = innerMaxZ = minZ;
+        }
+    }
+    for (int z = minZ; z < maxZ; z++) {
+        if (z < innerMinZ || z >= innerMaxZ) {
+            for (int x = minX; x < maxX; x++) {
+                func(x, z);
+            }
+            continue;
+        }
+        for (int x = minX; x < innerMinX; x++) {
+            func(x, z);
+        }
+        for (int x = innerMaxX; x < maxX; x++) {
+            func(x, z);
+        }
+    }
+}
+
+void ActiveChunks::activate(Entry& entry) {
+    if (entry.index != NOT_ACTIVE) {
+        return;
+    }
+    entry.index = chunks.size();
+    chunks.push_back(entry.chunk);
+}
+
+void ActiveChunks::deactivate(Entry& entry) {
+    size_t index = entry.index;
+    if (index == NOT_ACTIVE) {
+        return;
+    }
+    entry.index = NOT_ACTIVE;
+    // swap with the last one
+    Chunk* last = chunks.back();
+    chunks.pop_back();
+    if (index == chunks.size()) {
+        return;
+    }
+    chunks[index] = last;
+    entries.at({last->x, last->z}).index = index;
+}
+
+void ActiveChunks::update(
+    const ChunksViewer& area, const ChunksViewer* exclude, int delta
+) {
+    auto apply = [this, delta](Entry& entry) {
+        entry.viewers += delta;
+        if (entry.viewers > 0) {
+            activate(entry);
+        } else {
+            deactivate(entry);
+        }
+    };
+    size_t areaSize = static_cast<size_t>(area.radius) * area.radius * 4;
+    if (areaSize > entries.size()) {
+        // area is mostly not loaded yet (new viewer or teleport)
+        for (auto& [pos, entry] : entries) {
+            if (area.contains(pos.x, pos.y) &&
+                !(exclude && exclude->contains(pos.x, pos.y))) {
+                apply(entry);
+            }
+        }
+        return;
+    }
+    for_each_difference(area, exclude, [this, &apply](int x, int z) {
+        const auto& found = entries.find({x, z});
+        if (found != entries.end()) {
+            apply(found->second);
+        }
+    });
+}
+
+void ActiveChunks::add(Chunk* chunk) {
+    auto& entry = entries[{chunk->x, chunk->z}];
+    deactivate(entry);
+    entry.chunk = chunk;
+    entry.viewers = 0;
+    for (const auto& [_, viewer] : viewers) {
+        if (viewer.contains(chunk->x, chunk->z)) {
+            entry.viewers++;
+        }
+    }
+    if (entry.viewers > 0) {
+        activate(entry);
+    }
+}
+
+void ActiveChunks::remove(int x, int z) {
+    const auto& found = entries.find({x, z});
+    if (found == entries.end()) {
+        return;
+    }
+    deactivate(found->second);
+    entries.erase(found);
+}
+
+void ActiveChunks::setViewer(u64id_t id, const ChunksViewer& viewer) {
+    const auto& [found, inserted] = viewers.try_emplace(id, viewer);
+    if (inserted) {
+        update(viewer, nullptr, 1);
+        return;
+    }
+    ChunksViewer previous = found->second;
+    if (previous == viewer) {
+        return;
+    }
+    found->second = viewer;
+    update(previous, &viewer, -1);
+    update(viewer, &previous, 1);
+}
+
+void ActiveChunks::removeViewer(u64id_t id) {
+    const auto& found = viewers.find(id);
+    if (found == viewers.end()) {
+        return;
+    }
+    ChunksViewer previous = found->second;
+    viewers.erase(found);
+    update(previous, nullptr, -1);
+}
+
+bool ActiveChunks::isViewed(int x, int z) const {
+    for (const auto& [_, viewer] : viewers) {
+        if (viewer.contains(x, z)) {
+            return true;
+        }
+    }
+    return false;
+}
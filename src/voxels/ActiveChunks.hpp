@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/glm.hpp>
+#include <glm/gtx/hash.hpp>
+
+#include "typedefs.hpp"
+
+class Chunk;
+
+/// @brief Chunks viewer (player) loading area
+struct ChunksViewer {
+    /// @brief Center chunk coords
+    int x, z;
+    /// @brief Loading radius (in chunks) excluding padding
+    int radius;
+
+    bool contains(int cx, int cz) const {
+        return cx >= x - radius && cx < x + radius && cz >= z - radius &&
+               cz < z + radius;
+    }
+
+    bool operator==(const ChunksViewer& other) const {
+        return x == other.x && z == other.z && radius == other.radius;
+    }
+};
+
+/// @brief Deduplicated list of resident chunks inside of viewers areas.
+///
+/// Each resident chunk keeps number of viewers areas containing it, so
+/// moving a viewer visits only chunks entering or leaving its area.
+class ActiveChunks {
+    static constexpr size_t NOT_ACTIVE = SIZE_MAX;
+
+    struct Entry {
+        Chunk* chunk = nullptr;
+        /// @brief Number of viewers areas containing the chunk
+        int viewers = 0;
+        /// @brief Index in chunks or NOT_ACTIVE
+        size_t index = NOT_ACTIVE;
+    };
+
+    std::unordered_map<u64id_t, ChunksViewer> viewers;
+    std::unordered_map<glm::ivec2, Entry> entries;
+    std::vector<Chunk*> chunks;
+
+    void activate(Entry& entry);
+    void deactivate(Entry& entry);
+
+    /// @brief Add delta to viewers counters of resident chunks inside of
+    /// the area but outside of the excluded one
+    void update(
+        const ChunksViewer& area, const ChunksViewer* exclude, int delta
+    );
+public:
+    /// @brief Register resident chunk (replaces chunk at the same position)
+    void add(Chunk* chunk);
+
+    /// @brief Forget unloaded chunk
+    void remove(int x, int z);
+
+    /// @brief Set or update viewer area
+    /// @param id viewer (player) id
+    void setViewer(u64id_t id, const ChunksViewer& viewer);
+    void removeViewer(u64id_t id);
+
+    /// @brief Check if chunk position is inside of any viewer area
+    bool isViewed(int x, int z) const;
+
+    /// @return resident chunks inside of viewers areas (without duplicates)
+    const std::vector<Chunk*>& get() const {
+        return chunks;
+    }
+};
@@ -37,6 +37,8 @@ public:
         bool loadedLights : 1;
         bool entities : 1;
         bool blocksData : 1;
+        /// @brief Voxels are equal to the world generator output
+        bool generated : 1;
     } flags {};
 
     /// @brief Block inventories map where key is index of block in voxels array
@@ -66,6 +68,7 @@ public:
     inline void setModifiedAndUnsaved() {
         flags.modified = true;
         flags.unsaved = true;
+        flags.generated = false;
     }
 
     /// @brief Encode chunk to bytes array of size CHUNK_DATA_LEN
@@ -34,7 +34,7 @@ std::shared_ptr<Chunk> GlobalChunks::fetch(int x, int z) {
     if (found == chunksMap.end()) {
         return nullptr;
     }
-    return found->second;
+    return found->second.chunk;
 }
 
 static void check_voxels(const ContentIndices& indices, Chunk& chunk) {
@@ -62,7 +62,12 @@ static void check_voxels(const ContentIndices& indices, Chunk& chunk) {
 }
 
 void GlobalChunks::erase(int x, int z) {
-    chunksMap.erase(keyfrom(x, z));
+    const auto& found = chunksMap.find(keyfrom(x, z));
+    if (found == chunksMap.end()) {
+        return;
+    }
+    activeChunks.remove(x, z);
+    chunksMap.erase(found);
 }
 
 static inline auto load_inventories(
@@ -91,29 +96,32 @@ static inline auto load_inventories(
 std::shared_ptr<Chunk> GlobalChunks::create(int x, int z) {
     const auto& found = chunksMap.find(keyfrom(x, z));
     if (found != chunksMap.end()) {
-        return found->second;
+        return found->second.chunk;
     }
 
     auto chunk = std::make_shared<Chunk>(x, z);
-    chunksMap[keyfrom(x, z)] = chunk;
+    chunksMap[keyfrom(x, z)].chunk = chunk;
+    activeChunks.add(chunk.get());
 
     World& world = *level.getWorld();
     auto& regions = world.wfile.get()->getRegions();
 
-    if (auto data = regions.getVoxels(chunk->x, chunk->z)) {
+    if (regions.loadVoxels(*chunk)) {
         const auto& indices = *level.content.getIndices();
 
-        chunk->decode(data.get());
         check_voxels(indices, *chunk);
 
         chunk->setBlockInventories(
             load_inventories(regions, *chunk, indices.blocks)
         );
 
-        auto entitiesData = regions.fetchEntities(chunk->x, chunk->z);
-        if (entitiesData.getType() == dv::value_type::object) {
-            level.entities->loadEntities(std::move(entitiesData));
-            chunk->flags.entities = true;
+        uint32_t entitiesSize;
+        if (auto entitiesData =
+                regions.fetchEntitiesData(chunk->x, chunk->z, entitiesSize)) {
+            json::BinaryCursor cursor(entitiesData, entitiesSize);
+            if (level.entities->loadEntities(cursor)) {
+                chunk->flags.entities = true;
+            }
         }
 
         chunk->flags.loaded = true;
@@ -144,36 +152,49 @@ size_t GlobalChunks::size() const {
 }
 
 void GlobalChunks::incref(Chunk* chunk) {
-    auto key = reinterpret_cast<ptrdiff_t>(chunk);
-    const auto& found = refCounters.find(key);
-    if (found == refCounters.end()) {
-        refCounters[key] = 1;
+    const auto& found = chunksMap.find(keyfrom(chunk->x, chunk->z));
+    if (found == chunksMap.end() || found->second.chunk.get() != chunk) {
+        // not a level chunk
         return;
     }
-    found->second++;
+    found->second.refs++;
 }
 
 void GlobalChunks::decref(Chunk* chunk) {
-    auto key = reinterpret_cast<ptrdiff_t>(chunk);
-    const auto& found = refCounters.find(key);
-    if (found == refCounters.end()) {
-        abort();
+    const auto& found = chunksMap.find(keyfrom(chunk->x, chunk->z));
+    if (found == chunksMap.end()) {
+        // erased while shown
+        return;
     }
-    if (--found->second == 0) {
-        union {
-            int pos[2];
-            long long key;
-        } ekey;
-        ekey.pos[0] = chunk->x;
-        ekey.pos[1] = chunk->z;
-
-        if (onUnload) {
-            onUnload(*chunk);
-        }
-        save(chunk);
-        chunksMap.erase(ekey.key);
-        refCounters.erase(found);
+    auto& entry = found->second;
+    if (entry.chunk.get() != chunk) {
+        return;
+    }
+    if (--entry.refs > 0) {
+        return;
+    }
+    if (onUnload) {
+        onUnload(*chunk);
     }
+    save(chunk);
+    activeChunks.remove(chunk->x, chunk->z);
+    chunksMap.erase(found);
+}
+
+bool GlobalChunks::isViewed(int x, int z) const {
+    return activeChunks.isViewed(x, z);
+}
+
+void GlobalChunks::setViewer(u64id_t id, const ChunksViewer& viewer) {
+    activeChunks.setViewer(id, viewer);
+}
+
+void GlobalChunks::removeViewer(u64id_t id) {
+    activeChunks.removeViewer(id);
+}
+
+const std::vector<Chunk*>& GlobalChunks::getActiveChunks() const {
+    return activeChunks.get();
 }
 
 void GlobalChunks::save(Chunk* chunk) {
@@ -195,13 +216,15 @@ void GlobalChunks::save(Chunk* chunk) {
 }
 
 void GlobalChunks::saveAll() {
-    for (const auto& [_, chunk] : chunksMap) {
-        save(chunk.get());
+    for (const auto& [_, entry] : chunksMap) {
+        save(entry.chunk.get());
     }
 }
 
 void GlobalChunks::putChunk(std::shared_ptr<Chunk> chunk) {
-    chunksMap[keyfrom(chunk->x, chunk->z)] = std::move(chunk);
+    auto& entry = chunksMap[keyfrom(chunk->x, chunk->z)];
+    activeChunks.add(chunk.get());
+    entry.chunk = std::move(chunk);
 }
 
 const AABB* GlobalChunks::isObstacleAt(float x, float y, float z) const {
@@ -2,6 +2,7 @@
 
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/glm.hpp>
@@ -9,12 +10,19 @@
 
 #include "voxel.hpp"
 #include "delegates.hpp"
+#include "typedefs.hpp"
+#include "ActiveChunks.hpp"
 
 class Chunk;
 class Level;
 struct AABB;
 class ContentIndices;
 
+/// @brief Level chunks storage and residency manager.
+///
+/// Chunk stays resident while it is shown in at least one chunks matrix.
+/// Viewers areas are used to keep deduplicated list of active (ticked)
+/// chunks instead of iterating every player matrix (see ActiveChunks).
 class GlobalChunks {
     static inline uint64_t keyfrom(int32_t x, int32_t z) {
         union {
@@ -26,11 +34,17 @@ class GlobalChunks {
         return ekey.key;
     }
 
+    struct ChunkEntry {
+        std::shared_ptr<Chunk> chunk;
+        /// @brief Number of chunks matrices the chunk is shown in
+        int refs = 0;
+    };
+
     Level& level;
     const ContentIndices& indices;
-    std::unordered_map<uint64_t, std::shared_ptr<Chunk>> chunksMap;
+    std::unordered_map<uint64_t, ChunkEntry> chunksMap;
     std::unordered_map<glm::ivec2, std::shared_ptr<Chunk>> pinnedChunks;
-    std::unordered_map<ptrdiff_t, int> refCounters;
+    ActiveChunks activeChunks;
 
     consumer<Chunk&> onUnload;
 public:
@@ -52,6 +66,17 @@ public:
 
     void erase(int x, int z);
 
+    /// @brief Set or update viewer area
+    /// @param id viewer (player) id
+    void setViewer(u64id_t id, const ChunksViewer& viewer);
+    void removeViewer(u64id_t id);
+
+    /// @brief Check if chunk position is inside of any viewer area
+    bool isViewed(int x, int z) const;
+
+    /// @return resident chunks inside of viewers areas (without duplicates)
+    const std::vector<Chunk*>& getActiveChunks() const;
+
     void save(Chunk* chunk);
     void saveAll();
 
@@ -64,7 +89,7 @@ public:
         if (found == chunksMap.end()) {
             return nullptr;
         }
-        return found->second.get();
+        return found->second.chunk.get();
     }
 
     const ContentIndices& getContentIndices() const {
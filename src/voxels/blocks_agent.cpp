@@ -98,6 +98,100 @@ void blocks_agent::set(
     set_block(chunks, x, y, z, id, state);
 }
 
+template <class Storage>
+static inline void fill_blocks(
+    Storage& chunks,
+    const glm::ivec3& min,
+    const glm::ivec3& max,
+    uint32_t id,
+    blockstate state
+) {
+    int y1 = std::max(min.y, 0);
+    int y2 = std::min(max.y, CHUNK_H - 1);
+    if (y1 > y2) {
+        return;
+    }
+    const auto& indices = chunks.getContentIndices();
+    const auto* defs = indices.blocks.getDefs();
+    const auto& newdef = indices.blocks.require(id);
+
+    int cx1 = floordiv<CHUNK_W>(min.x);
+    int cz1 = floordiv<CHUNK_D>(min.z);
+    int cx2 = floordiv<CHUNK_W>(max.x);
+    int cz2 = floordiv<CHUNK_D>(max.z);
+
+    for (int cz = cz1; cz <= cz2; cz++) {
+        for (int cx = cx1; cx <= cx2; cx++) {
+            Chunk* chunk = get_chunk(chunks, cx, cz);
+            if (chunk == nullptr) {
+                continue;
+            }
+            int lx1 = std::max(min.x - cx * CHUNK_W, 0);
+            int lz1 = std::max(min.z - cz * CHUNK_D, 0);
+            int lx2 = std::min(max.x - cx * CHUNK_W, CHUNK_W - 1);
+            int lz2 = std::min(max.z - cz * CHUNK_D, CHUNK_D - 1);
+            for (int y = y1; y <= y2; y++) {
+                for (int lz = lz1; lz <= lz2; lz++) {
+                    for (int lx = lx1; lx <= lx2; lx++) {
+                        voxel& vox = chunk->voxels[vox_index(lx, y, lz)];
+                        const auto& prevdef = *defs[vox.id];
+                        // blocks requiring finalization or initialization
+                        // go through the regular path
+                        if (prevdef.inventorySize != 0 ||
+                            prevdef.rt.extended || prevdef.dataStruct ||
+                            newdef.rt.extended) {
+                            set_block(
+                                chunks,
+                                lx + cx * CHUNK_W,
+                                y,
+                                lz + cz * CHUNK_D,
+                                id,
+                                state
+                            );
+                            continue;
+                        }
+                        vox.id = id;
+                        vox.state = state;
+                    }
+                }
+            }
+            chunk->setModifiedAndUnsaved();
+            chunk->updateHeights();
+        }
+    }
+    // neighbour chunks meshes depend on the area border voxels
+    for (int cz = cz1 - 1; cz <= cz2 + 1; cz++) {
+        for (int cx = cx1 - 1; cx <= cx2 + 1; cx++) {
+            if (cz >= cz1 && cz <= cz2 && cx >= cx1 && cx <= cx2) {
+                continue;
+            }
+            if (Chunk* chunk = get_chunk(chunks, cx, cz)) {
+                chunk->flags.modified = true;
+            }
+        }
+    }
+}
+
+void blocks_agent::fill(
+    Chunks& chunks,
+    const glm::ivec3& min,
+    const glm::ivec3& max,
+    uint32_t id,
+    blockstate state
+) {
+    fill_blocks(chunks, min, max, id, state);
+}
+
+void blocks_agent::fill(
+    GlobalChunks& chunks,
+    const glm::ivec3& min,
+    const glm::ivec3& max,
+    uint32_t id,
+    blockstate state
+) {
+    fill_blocks(chunks, min, max, id, state);
+}
+
 template <class Storage>
 static inline voxel* raycast_blocks(
     const Storage& chunks,
@@ -144,6 +144,38 @@ void set(
     blockstate state
 );
 
+/// @brief Fill area with the block writing voxels directly. Chunks are
+/// marked modified once per chunk instead of once per voxel.
+/// Lighting and neighbour updates are not performed.
+/// @param chunks chunks matrix
+/// @param min area minimum corner (inclusive)
+/// @param max area maximum corner (inclusive)
+/// @param id new block id
+/// @param state new block state
+void fill(
+    Chunks& chunks,
+    const glm::ivec3& min,
+    const glm::ivec3& max,
+    uint32_t id,
+    blockstate state
+);
+
+/// @brief Fill area with the block writing voxels directly. Chunks are
+/// marked modified once per chunk instead of once per voxel.
+/// Lighting and neighbour updates are not performed.
+/// @param chunks chunks storage
+/// @param min area minimum corner (inclusive)
+/// @param max area maximum corner (inclusive)
+/// @param id new block id
+/// @param state new block state
+void fill(
+    GlobalChunks& chunks,
+    const glm::ivec3& min,
+    const glm::ivec3& max,
+    uint32_t id,
+    blockstate state
+);
+
 /// @brief Erase extended block segments
 /// @tparam Storage chunks storage class
 /// @param chunks chunks storage
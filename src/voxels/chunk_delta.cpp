@@ -0,0 +1,86 @@
+#include "chunk_delta.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+#include "content/ContentReport.hpp"
+#include "util/data_io.hpp"
+
+static uint32_t read_count(const ubyte* data, uint32_t size) {
+    if (size < chunk_delta::HEADER_SIZE) {
+        throw std::runtime_error("invalid chunk delta record");
+    }
+    uint32_t count;
+    std::memcpy(&count, data, sizeof(count));
+    count = dataio::le2h(count);
+    if (chunk_delta::HEADER_SIZE + count * chunk_delta::ENTRY_SIZE != size) {
+        throw std::runtime_error("invalid chunk delta record size");
+    }
+    return count;
+}
+
+std::unique_ptr<ubyte[]> chunk_delta::encode_pristine(uint32_t& size) {
+    size = HEADER_SIZE;
+    auto bytes = std::make_unique<ubyte[]>(HEADER_SIZE);
+    std::memset(bytes.get(), 0, HEADER_SIZE);
+    return bytes;
+}
+
+std::unique_ptr<ubyte[]> chunk_delta::encode(
+    const voxel* voxels, const voxel* baseline, uint32_t& size
+) {
+    uint32_t count = 0;
+    for (uint i = 0; i < CHUNK_VOL; i++) {
+        if (voxels[i].id != baseline[i].id ||
+            blockstate2int(voxels[i].state) !=
+                blockstate2int(baseline[i].state)) {
+            if (++count > MAX_ENTRIES) {
+                return nullptr;
+            }
+        }
+    }
+    size = HEADER_SIZE + count * ENTRY_SIZE;
+    auto bytes = std::make_unique<ubyte[]>(size);
+    uint32_t header = dataio::h2le(count);
+    std::memcpy(bytes.get(), &header, sizeof(header));
+
+    auto indices = reinterpret_cast<uint16_t*>(bytes.get() + HEADER_SIZE);
+    auto ids = indices + count;
+    auto states = ids + count;
+    uint32_t entry = 0;
+    for (uint i = 0; i < CHUNK_VOL && entry < count; i++) {
+        blockstate_t state = blockstate2int(voxels[i].state);
+        if (voxels[i].id == baseline[i].id &&
+            state == blockstate2int(baseline[i].state)) {
+            continue;
+        }
+        indices[entry] = dataio::h2le(static_cast<uint16_t>(i));
+        ids[entry] = dataio::h2le(voxels[i].id);
+        states[entry] = dataio::h2le(state);
+        entry++;
+    }
+    return bytes;
+}
+
+void chunk_delta::apply(const ubyte* data, uint32_t size, voxel* voxels) {
+    uint32_t count = read_count(data, size);
+    auto indices = reinterpret_cast<const uint16_t*>(data + HEADER_SIZE);
+    auto ids = indices + count;
+    auto states = ids + count;
+    for (uint32_t i = 0; i < count; i++) {
+        voxel& vox = voxels[dataio::le2h(indices[i])];
+        vox.id = dataio::le2h(ids[i]);
+        vox.state = int2blockstate(dataio::le2h(states[i]));
+    }
+}
+
+void chunk_delta::convert(
+    ubyte* data, uint32_t size, const ContentReport* report
+) {
+    uint32_t count = read_count(data, size);
+    auto ids = reinterpret_cast<uint16_t*>(data + HEADER_SIZE) + count;
+    for (uint32_t i = 0; i < count; i++) {
+        blockid_t id = dataio::le2h(ids[i]);
+        ids[i] = dataio::h2le(report->blocks.getId(id));
+    }
+}
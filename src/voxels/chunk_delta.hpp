@@ -0,0 +1,60 @@
+#pragma once
+
+#include <memory>
+
+#include "typedefs.hpp"
+#include "Chunk.hpp"
+
+class ContentReport;
+
+/// @brief Chunk voxels stored as a difference with the world generator
+/// output (baseline). Record format (little-endian):
+///
+/// ```cpp
+/// uint32_t count;
+/// uint16_t index[count];
+/// uint16_t id[count];
+/// uint16_t states[count];
+/// ```
+///
+/// Record with zero count (pristine marker) means that chunk is equal to
+/// the baseline. Delta records are always smaller than the full chunk data
+/// (CHUNK_DATA_LEN), so the record type is defined by its size.
+namespace chunk_delta {
+    static_assert(CHUNK_VOL <= 65536, "voxel index must fit uint16");
+
+    inline constexpr uint32_t HEADER_SIZE = 4;
+    inline constexpr uint32_t ENTRY_SIZE = 6;
+    /// @brief Max number of changed voxels stored as delta
+    inline constexpr uint32_t MAX_ENTRIES =
+        (CHUNK_DATA_LEN - HEADER_SIZE - 1) / ENTRY_SIZE;
+
+    /// @param size voxels layer record source size
+    inline bool is_delta(uint32_t size) {
+        return size < CHUNK_DATA_LEN;
+    }
+
+    /// @param size voxels layer record source size
+    inline bool is_pristine(uint32_t size) {
+        return size == HEADER_SIZE;
+    }
+
+    /// @brief Create pristine marker
+    std::unique_ptr<ubyte[]> encode_pristine(uint32_t& size);
+
+    /// @brief Create delta record
+    /// @param voxels chunk voxels
+    /// @param baseline generated voxels
+    /// @param size [out] record size
+    /// @return nullptr if too many voxels differ (see MAX_ENTRIES)
+    std::unique_ptr<ubyte[]> encode(
+        const voxel* voxels, const voxel* baseline, uint32_t& size
+    );
+
+    /// @brief Apply delta record to baseline voxels
+    /// @throws std::runtime_error if record is malformed
+    void apply(const ubyte* data, uint32_t size, voxel* voxels);
+
+    /// @brief Replace block ids in delta record (see Chunk::convert)
+    void convert(ubyte* data, uint32_t size, const ContentReport* report);
+}
@@ -0,0 +1,270 @@
+#include "RegionsJournal.hpp"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "coders/byte_utils.hpp"
+#include "debug/Logger.hpp"
+#include "util/platform.hpp"
+
+static debug::Logger logger("regions-journal");
+
+#define JOURNAL_FORMAT_MAGIC ".VOXJRN"
+
+inline constexpr uint JOURNAL_FORMAT_VERSION = 1;
+inline constexpr uint JOURNAL_HEADER_SIZE = 10;
+
+enum JournalRecordType : ubyte {
+    RECORD_CHUNK = 1,
+    RECORD_COMMIT,
+};
+
+/// @brief Chunk record header size excluding type byte
+inline constexpr uint CHUNK_RECORD_SIZE = 21;
+/// @brief Commit record size excluding type byte
+inline constexpr uint COMMIT_RECORD_SIZE = 4;
+
+static uint32_t record_checksum(
+    const ubyte* header, size_t headerSize, const ubyte* data, size_t size
+) {
+    uLong crc = crc32(0L, header, headerSize);
+    if (data) {
+        crc = crc32(crc, data, size);
+    }
+    return static_cast<uint32_t>(crc);
+}
+
+RegionsJournal::RegionsJournal(io::path file) : file(std::move(file)) {
+    reset();
+}
+
+RegionsJournal::~RegionsJournal() = default;
+
+void RegionsJournal::append(
+    RegionLayerIndex layer,
+    int x,
+    int z,
+    const ubyte* data,
+    uint32_t size,
+    uint32_t srcSize
+) {
+    if (data == nullptr) {
+        size = 0;
+        srcSize = 0;
+    }
+    ByteBuilder builder(CHUNK_RECORD_SIZE + 1);
+    builder.put(RECORD_CHUNK);
+    builder.put(static_cast<ubyte>(layer));
+    builder.putInt32(x);
+    builder.putInt32(z);
+    builder.putInt32(size);
+    builder.putInt32(srcSize);
+    // checksum covers record fields and data
+    builder.putInt32(
+        record_checksum(builder.data() + 1, builder.size() - 1, data, size)
+    );
+    std::lock_guard lock(mutex);
+    stream.write(reinterpret_cast<const char*>(builder.data()), builder.size());
+    if (data) {
+        stream.write(reinterpret_cast<const char*>(data), size);
+    }
+    if (!stream.good()) {
+        throw std::runtime_error("could not write " + file.string());
+    }
+    this->size += builder.size() + size;
+    uncommitted++;
+}
+
+void RegionsJournal::commit() {
+    if (writeCommit()) {
+        sync();
+    }
+}
+
+bool RegionsJournal::writeCommit() {
+    if (uncommitted == 0) {
+        return false;
+    }
+    ByteBuilder builder(COMMIT_RECORD_SIZE + 1);
+    builder.put(RECORD_COMMIT);
+    builder.putInt32(uncommitted);
+    {
+        std::lock_guard lock(mutex);
+        stream.write(
+            reinterpret_cast<const char*>(builder.data()), builder.size()
+        );
+        if (!stream.good()) {
+            throw std::runtime_error("could not write " + file.string());
+        }
+    }
+    size += builder.size();
+    uncommitted = 0;
+    return true;
+}
+
+void RegionsJournal::sync() {
+    {
+        std::lock_guard lock(mutex);
+        stream.flush();
+        if (!stream.good()) {
+            throw std::runtime_error("could not write " + file.string());
+        }
+    }
+    // records are appended meanwhile, they are synced by the next commit
+    if (!platform::sync_file(io::resolve(file))) {
+        logger.warning() << "could not sync " << file.string();
+    }
+}
+
+void RegionsJournal::reset() {
+    std::lock_guard lock(mutex);
+    if (stream.is_open()) {
+        stream.close();
+    }
+    stream.open(
+        io::resolve(file), std::ios::out | std::ios::binary | std::ios::trunc
+    );
+    char header[JOURNAL_HEADER_SIZE] = JOURNAL_FORMAT_MAGIC;
+    header[8] = JOURNAL_FORMAT_VERSION;
+    stream.write(header, JOURNAL_HEADER_SIZE);
+    stream.flush();
+    if (!stream.good()) {
+        throw std::runtime_error("could not create " + file.string());
+    }
+    platform::sync_file(io::resolve(file));
+    size = JOURNAL_HEADER_SIZE;
+    uncommitted = 0;
+}
+
+namespace {
+    struct JournalRecord {
+        JournalRecordType type;
+        RegionLayerIndex layer;
+        int x;
+        int z;
+        uint32_t size;
+        uint32_t srcSize;
+        uint32_t count;
+        std::unique_ptr<ubyte[]> data;
+    };
+}
+
+/// @brief Read and validate next record
+/// @return false if end of file reached or record is incomplete or damaged
+static bool read_record(
+    std::istream& stream, size_t fileSize, JournalRecord& record
+) {
+    int type = stream.get();
+    if (type == RECORD_COMMIT) {
+        ubyte bytes[COMMIT_RECORD_SIZE];
+        if (!stream.read(reinterpret_cast<char*>(bytes), COMMIT_RECORD_SIZE)) {
+            return false;
+        }
+        ByteReader reader(bytes, COMMIT_RECORD_SIZE);
+        record.type = RECORD_COMMIT;
+        record.count = reader.getInt32();
+        return true;
+    } else if (type != RECORD_CHUNK) {
+        return false;
+    }
+    ubyte bytes[CHUNK_RECORD_SIZE];
+    if (!stream.read(reinterpret_cast<char*>(bytes), CHUNK_RECORD_SIZE)) {
+        return false;
+    }
+    ByteReader reader(bytes, CHUNK_RECORD_SIZE);
+    record.type = RECORD_CHUNK;
+    uint layer = reader.get();
+    record.x = reader.getInt32();
+    record.z = reader.getInt32();
+    record.size = reader.getInt32();
+    record.srcSize = reader.getInt32();
+    uint32_t checksum = reader.getInt32();
+    if (layer >= REGION_LAYERS_COUNT) {
+        return false;
+    }
+    record.layer = static_cast<RegionLayerIndex>(layer);
+    record.data = nullptr;
+    if (record.size) {
+        size_t position = stream.tellg();
+        if (record.size > fileSize - position) {
+            return false;
+        }
+        record.data = std::make_unique<ubyte[]>(record.size);
+        if (!stream.read(
+                reinterpret_cast<char*>(record.data.get()), record.size
+            )) {
+            return false;
+        }
+    }
+    return checksum == record_checksum(
+                           bytes, CHUNK_RECORD_SIZE - 4,
+                           record.data.get(), record.size
+                       );
+}
+
+static bool read_header(std::istream& stream) {
+    char header[JOURNAL_HEADER_SIZE];
+    if (!stream.read(header, JOURNAL_HEADER_SIZE)) {
+        return false;
+    }
+    if (std::string(header, std::strlen(JOURNAL_FORMAT_MAGIC)) !=
+        JOURNAL_FORMAT_MAGIC) {
+        return false;
+    }
+    return static_cast<uint>(header[8]) <= JOURNAL_FORMAT_VERSION;
+}
+
+size_t RegionsJournal::replay(
+    const io::path& file, const RecordConsumer& consumer
+) {
+    auto path = io::resolve(file);
+    size_t fileSize = io::file_size(file);
+
+    // find end of the last complete batch
+    size_t committedEnd = 0;
+    {
+        std::ifstream stream(path, std::ios::binary);
+        if (!read_header(stream)) {
+            logger.error() << "invalid journal header " << file.string();
+            return 0;
+        }
+        JournalRecord record {};
+        uint32_t count = 0;
+        while (read_record(stream, fileSize, record)) {
+            if (record.type == RECORD_CHUNK) {
+                count++;
+                continue;
+            }
+            if (record.count != count) {
+                break;
+            }
+            committedEnd = stream.tellg();
+            count = 0;
+        }
+        if (std::max<size_t>(committedEnd, JOURNAL_HEADER_SIZE) < fileSize) {
+            logger.warning() << "uncommitted or damaged journal tail ignored";
+        }
+    }
+    size_t records = 0;
+    std::ifstream stream(path, std::ios::binary);
+    read_header(stream);
+    JournalRecord record {};
+    while (static_cast<size_t>(stream.tellg()) < committedEnd &&
+           read_record(stream, fileSize, record)) {
+        if (record.type != RECORD_CHUNK) {
+            continue;
+        }
+        consumer(
+            record.layer,
+            record.x,
+            record.z,
+            std::move(record.data),
+            record.size,
+            record.srcSize
+        );
+        records++;
+    }
+    return records;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include "io/io.hpp"
+#include "typedefs.hpp"
+#include "world_regions_fwd.hpp"
+
+/// @brief Append-only journal of compressed chunks data put to regions.
+/// Records are made durable by commit (single fsync per batch), so region
+/// files may be rewritten rarely (see WorldRegions::checkpoint).
+/// Only records followed by a commit record are replayed, so a crash
+/// during save leaves the last committed state.
+class RegionsJournal {
+    io::path file;
+    std::ofstream stream;
+    /// @brief Guards the stream, so the journal may be synced by another
+    /// thread (see sync)
+    std::mutex mutex;
+    /// @brief Number of records appended since the last commit
+    uint32_t uncommitted = 0;
+    /// @brief Journal file size in bytes
+    size_t size = 0;
+public:
+    using RecordConsumer = std::function<void(
+        RegionLayerIndex layer,
+        int x,
+        int z,
+        std::unique_ptr<ubyte[]> data,
+        uint32_t size,
+        uint32_t srcSize
+    )>;
+
+    /// @brief Create empty journal (existing file is truncated)
+    RegionsJournal(io::path file);
+    ~RegionsJournal();
+
+    /// @brief Append chunk record. Not durable until commit
+    /// @param layer region layer index
+    /// @param x chunk x
+    /// @param z chunk z
+    /// @param data compressed chunk data (nullptr - chunk data deleted)
+    /// @param size compressed data size
+    /// @param srcSize source data size
+    void append(
+        RegionLayerIndex layer,
+        int x,
+        int z,
+        const ubyte* data,
+        uint32_t size,
+        uint32_t srcSize
+    );
+
+    /// @brief Write commit record and flush journal to the storage device
+    void commit();
+
+    /// @brief Write commit record. Not durable until sync
+    /// @return false if there are no records to commit
+    bool writeCommit();
+
+    /// @brief Flush journal to the storage device. May be called from
+    /// another thread while records are appended
+    void sync();
+
+    /// @brief Truncate journal. Must be called only when all committed
+    /// records are durably written to region files
+    void reset();
+
+    size_t getSize() const {
+        return size;
+    }
+
+    uint32_t getUncommitted() const {
+        return uncommitted;
+    }
+
+    /// @brief Read committed records from journal file.
+    /// Uncommitted or damaged tail is ignored
+    /// @return number of records passed to the consumer
+    static size_t replay(const io::path& file, const RecordConsumer& consumer);
+};
@@ -2,7 +2,11 @@
 
 #include <cstring>
 
+#include "debug/Metrics.hpp"
+#include "debug/Profiler.hpp"
 #include "util/data_io.hpp"
+#include "util/platform.hpp"
+#include "RegionsJournal.hpp"
 
 #define REGION_FORMAT_MAGIC ".VOXREG"
 
@@ -13,14 +17,20 @@ static io::path get_region_filename(int x, int z) {
 /// @brief Read missing chunks data (null pointers) from region file
 static void fetch_chunks(WorldRegion* region, int x, int z, regfile* file) {
     auto* chunks = region->getChunks();
-    auto sizes = region->getSizes();
 
     for (size_t i = 0; i < REGION_CHUNKS_COUNT; i++) {
         int chunk_x = (i % REGION_SIZE) + x * REGION_SIZE;
         int chunk_z = (i / REGION_SIZE) + z * REGION_SIZE;
         if (chunks[i] == nullptr) {
-            chunks[i] = RegionsLayer::readChunkData(
-                    chunk_x, chunk_z, sizes[i][0], sizes[i][1], file);
+            uint32_t size, srcSize;
+            auto data = RegionsLayer::readChunkData(
+                chunk_x, chunk_z, size, srcSize, file
+            );
+            if (data) {
+                uint localX = i % REGION_SIZE;
+                uint localZ = i / REGION_SIZE;
+                region->put(localX, localZ, std::move(data), size, srcSize);
+            }
         }
     }
 }
@@ -67,6 +77,15 @@ std::unique_ptr<ubyte[]> regfile::read(int index, uint32_t& size, uint32_t& srcS
     return data;
 }
 
+bool regfile::has(int index) {
+    size_t file_size = file.length();
+    size_t table_offset = file_size - REGION_CHUNKS_COUNT * 4;
+
+    uint32_t buff32;
+    file.seekg(table_offset + index * 4);
+    file.read(reinterpret_cast<char*>(&buff32), 4);
+    return dataio::le2h(buff32) != 0;
+}
 
 void RegionsLayer::closeRegFile(glm::ivec2 coord) {
     openRegFiles.erase(coord);
@@ -82,7 +101,11 @@ regfile_ptr RegionsLayer::useRegFile(glm::ivec2 coord) {
 // Marks regfile as used and unmarks when shared_ptr dies
 regfile_ptr RegionsLayer::getRegFile(glm::ivec2 coord, bool create) {
     {
-        std::lock_guard lock(regFilesMutex);
+        std::unique_lock lock(regFilesMutex);
+        // wait for background write of the region file
+        regFilesCv.wait(lock, [this, coord]() {
+            return pendingWrites.find(coord) == pendingWrites.end();
+        });
         const auto found = openRegFiles.find(coord);
         if (found != openRegFiles.end()) {
             if (found->second->inUse) {
@@ -135,6 +158,7 @@ WorldRegion* RegionsLayer::getRegion(int x, int z) {
     if (found == regions.end()) {
         return nullptr;
     }
+    found->second->touch();
     return found->second.get();
 }
 
@@ -149,21 +173,67 @@ WorldRegion* RegionsLayer::getOrCreateRegion(int x, int z) {
     std::lock_guard lock(mapMutex);
     auto region_ptr = std::make_unique<WorldRegion>();
     auto region = region_ptr.get();
+    region->touch();
+    region->attach(&memoryUsage);
     regions[{x, z}] = std::move(region_ptr);
+    regionsCount++;
     return region;
 }
 
+std::unique_ptr<WorldRegion> RegionsLayer::takeRegion(int x, int z) {
+    std::lock_guard lock(mapMutex);
+    auto found = regions.find({x, z});
+    if (found == regions.end()) {
+        return nullptr;
+    }
+    auto region = std::move(found->second);
+    regions.erase(found);
+    regionsCount--;
+    region->detach();
+    return region;
+}
+
+void RegionsLayer::putChunk(
+    int x,
+    int z,
+    std::unique_ptr<ubyte[]> data,
+    uint32_t size,
+    uint32_t srcSize
+) {
+    if (journal) {
+        journal->append(layer, x, z, data.get(), size, srcSize);
+    }
+    int regionX, regionZ, localX, localZ;
+    calc_reg_coords(x, z, regionX, regionZ, localX, localZ);
+
+    WorldRegion* region = getOrCreateRegion(regionX, regionZ);
+    region->setUnsaved(true);
+    if (data == nullptr) {
+        region->put(localX, localZ, nullptr, 0, 0);
+    } else {
+        region->put(localX, localZ, std::move(data), size, srcSize);
+    }
+}
+
 ubyte* RegionsLayer::getData(int x, int z, uint32_t& size, uint32_t& srcSize) {
+    static auto& hitsCounter = debug::metrics::counter("regions.hits");
+    static auto& missesCounter = debug::metrics::counter("regions.misses");
+
     int regionX, regionZ, localX, localZ;
     calc_reg_coords(x, z, regionX, regionZ, localX, localZ);
 
     WorldRegion* region = getOrCreateRegion(regionX, regionZ);
     ubyte* data = region->getChunkData(localX, localZ);
-    if (data == nullptr) {
+    if (data != nullptr) {
+        hits++;
+        hitsCounter.add();
+    } else {
         auto regfile = getRegFile({regionX, regionZ});
         if (regfile != nullptr) {
             auto dataptr = readChunkData(x, z, size, srcSize, regfile.get());
             if (dataptr) {
+                misses++;
+                missesCounter.add();
                 data = dataptr.get();
                 region->put(localX, localZ, std::move(dataptr), size, srcSize);
             }
@@ -178,22 +248,77 @@ ubyte* RegionsLayer::getData(int x, int z, uint32_t& size, uint32_t& srcSize) {
     return nullptr;
 }
 
-void RegionsLayer::writeRegion(int x, int z, WorldRegion* entry) {
-    io::path filename = folder / get_region_filename(x, z);
+bool RegionsLayer::hasChunk(int x, int z) {
+    int regionX, regionZ, localX, localZ;
+    calc_reg_coords(x, z, regionX, regionZ, localX, localZ);
 
-    glm::ivec2 regcoord(x, z);
-    if (auto regfile = getRegFile(regcoord, false)) {
-        fetch_chunks(entry, x, z, regfile.get());
+    if (auto region = getRegion(regionX, regionZ)) {
+        if (region->getChunkData(localX, localZ)) {
+            return true;
+        }
+    }
+    auto regfile = getRegFile({regionX, regionZ});
+    if (regfile == nullptr) {
+        return false;
+    }
+    return regfile.get()->has(localZ * REGION_SIZE + localX);
+}
 
+void RegionsLayer::beginRegionWrite(glm::ivec2 coord) {
+    std::lock_guard lock(regFilesMutex);
+    const auto found = openRegFiles.find(coord);
+    if (found != openRegFiles.end()) {
+        if (found->second->inUse) {
+            throw std::runtime_error("regfile is currently in use");
+        }
+        closeRegFile(coord);
+    }
+    pendingWrites[coord]++;
+}
+
+void RegionsLayer::endRegionWrite(glm::ivec2 coord) {
+    {
         std::lock_guard lock(regFilesMutex);
-        regfile.reset();
-        closeRegFile(regcoord);
+        const auto found = pendingWrites.find(coord);
+        if (found != pendingWrites.end() && --found->second == 0) {
+            pendingWrites.erase(found);
+        }
     }
+    regFilesCv.notify_all();
+}
+
+void RegionsLayer::holdRegionFile(glm::ivec2 coord) {
+    std::lock_guard lock(regFilesMutex);
+    heldFiles[coord]++;
+}
 
+void RegionsLayer::releaseRegionFile(glm::ivec2 coord) {
+    {
+        std::lock_guard lock(regFilesMutex);
+        const auto found = heldFiles.find(coord);
+        if (found != heldFiles.end() && --found->second == 0) {
+            heldFiles.erase(found);
+        }
+    }
+    heldFilesCv.notify_all();
+}
+
+void RegionsLayer::waitRegionFileRelease(glm::ivec2 coord) {
+    std::unique_lock lock(regFilesMutex);
+    heldFilesCv.wait(lock, [this, coord]() {
+        return heldFiles.find(coord) == heldFiles.end();
+    });
+}
+
+static size_t write_region_data(
+    const std::filesystem::path& filename,
+    WorldRegion* entry,
+    compression::Method compression
+) {
     char header[REGION_HEADER_SIZE] = REGION_FORMAT_MAGIC;
     header[8] = REGION_FORMAT_VERSION;
     header[9] = static_cast<ubyte>(compression); // FIXME
-    std::ofstream file(io::resolve(filename), std::ios::out | std::ios::binary);
+    std::ofstream file(filename, std::ios::out | std::ios::binary);
     file.write(header, REGION_HEADER_SIZE);
 
     size_t offset = REGION_HEADER_SIZE;
@@ -229,11 +354,78 @@ void RegionsLayer::writeRegion(int x, int z, WorldRegion* entry) {
         intbuf = dataio::h2le(offsets[i]);
         file.write(reinterpret_cast<const char*>(&intbuf), 4);
     }
+    file.flush();
+    if (!file.good()) {
+        throw std::runtime_error("could not write " + filename.u8string());
+    }
+    return offset + REGION_CHUNKS_COUNT * 4;
+}
+
+static size_t write_region_file(
+    const io::path& filename,
+    WorldRegion* entry,
+    compression::Method compression,
+    bool durable
+) {
+    // written to a temporary file first, so an interrupted write does not
+    // damage the existing region file
+    auto dstfile = io::resolve(filename);
+    auto tmpfile = dstfile;
+    tmpfile += ".tmp";
+    size_t written = write_region_data(tmpfile, entry, compression);
+    if (durable && !platform::sync_file(tmpfile)) {
+        throw std::runtime_error("could not sync " + tmpfile.u8string());
+    }
+    std::filesystem::rename(tmpfile, dstfile);
+    if (durable) {
+        platform::sync_file(dstfile.parent_path());
+    }
+    return written;
+}
+
+void RegionsLayer::writeRegion(int x, int z, WorldRegion* entry) {
+    waitRegionFileRelease({x, z});
+    writeRegion(
+        x, z, entry, folder / get_region_filename(x, z), durableWrites
+    );
+}
+
+void RegionsLayer::writeRegion(
+    int x, int z, WorldRegion* entry, const io::path& filename, bool durable
+) {
+    PROFILE_ZONE("RegionsLayer::writeRegion");
+    glm::ivec2 regcoord(x, z);
+    if (auto regfile = getRegFile(regcoord, false)) {
+        fetch_chunks(entry, x, z, regfile.get());
+
+        std::lock_guard lock(regFilesMutex);
+        regfile.reset();
+        closeRegFile(regcoord);
+    }
+    write_region_file(filename, entry, compression, durable);
+}
+
+size_t RegionsLayer::writeRegionFile(int x, int z, WorldRegion* entry) {
+    waitRegionFileRelease({x, z});
+    return writeRegionFile(x, z, entry, folder);
+}
+
+size_t RegionsLayer::writeRegionFile(
+    int x, int z, WorldRegion* entry, const io::path& folder
+) {
+    io::path filename = folder / get_region_filename(x, z);
+    if (io::exists(filename)) {
+        // not shared with other threads while the write is pending
+        regfile file(filename);
+        fetch_chunks(entry, x, z, &file);
+    }
+    return write_region_file(filename, entry, compression, durableWrites);
 }
 
 std::unique_ptr<ubyte[]> RegionsLayer::readChunkData(
     int x, int z, uint32_t& size, uint32_t& srcSize, regfile* rfile
 ) {
+    PROFILE_ZONE("RegionsLayer::readChunkData");
     int regionX, regionZ, localX, localZ;
     calc_reg_coords(x, z, regionX, regionZ, localX, localZ);
     int chunkIndex = localZ * REGION_SIZE + localX;
@@ -0,0 +1,510 @@
+#include "RegionsSaver.hpp"
+
+#include <vector>
+
+#include "debug/Logger.hpp"
+#include "RegionsJournal.hpp"
+#include "util/ThreadPool.hpp"
+#include "voxels/chunk_delta.hpp"
+#include "WorldRegions.hpp"
+
+static debug::Logger logger("regions-saver");
+
+void ChunkSaveData::set(
+    RegionLayerIndex layer, std::unique_ptr<ubyte[]> data, size_t size
+) {
+    auto& entry = layers[layer];
+    entry.data = std::move(data);
+    entry.size = size;
+    entry.srcSize = size;
+}
+
+void ChunkSaveData::compress(const RegionsLayer* regionsLayers) {
+    std::unique_ptr<ubyte[]> compressed[REGION_LAYERS_COUNT];
+    size_t sizes[REGION_LAYERS_COUNT] {};
+    for (size_t i = 0; i < REGION_LAYERS_COUNT; i++) {
+        const auto& entry = layers[i];
+        auto method = regionsLayers[i].compression;
+        if (entry.data == nullptr || method == compression::Method::NONE) {
+            continue;
+        }
+        compressed[i] = compression::compress(
+            entry.data.get(), entry.srcSize, sizes[i], method
+        );
+    }
+    for (size_t i = 0; i < REGION_LAYERS_COUNT; i++) {
+        if (compressed[i]) {
+            layers[i].data = std::move(compressed[i]);
+            layers[i].size = sizes[i];
+        }
+    }
+}
+
+class ChunkCompressWorker
+    : public util::Worker<ChunkSaveDataPtr, ChunkSaveDataPtr> {
+    const RegionsLayer* layers;
+    BaselineGenerator baselineGenerator;
+    std::unique_ptr<Chunk> chunk;
+    std::unique_ptr<voxel[]> baseline;
+
+    /// @brief Replace full voxels data with delta record if it's smaller
+    void encodeDelta(ChunkSaveData& data) {
+        auto& entry = data.layers[REGION_LAYER_VOXELS];
+        if (!chunk->decode(entry.data.get())) {
+            return;
+        }
+        baselineGenerator(data.x, data.z, baseline.get());
+        uint32_t size;
+        if (auto delta =
+                chunk_delta::encode(chunk->voxels, baseline.get(), size)) {
+            data.set(REGION_LAYER_VOXELS, std::move(delta), size);
+        }
+    }
+public:
+    ChunkCompressWorker(
+        const RegionsLayer* layers, BaselineGenerator baselineGenerator
+    )
+        : layers(layers), baselineGenerator(std::move(baselineGenerator)) {
+        if (this->baselineGenerator) {
+            chunk = std::make_unique<Chunk>(0, 0);
+            baseline = std::make_unique<voxel[]>(CHUNK_VOL);
+        }
+    }
+
+    ChunkSaveDataPtr operator()(const ChunkSaveDataPtr& data) override {
+        try {
+            if (data->voxelsDelta && baselineGenerator) {
+                encodeDelta(*data);
+            }
+            data->compress(layers);
+        } catch (const std::exception& err) {
+            data->error = err.what();
+        }
+        return data;
+    }
+};
+
+RegionsSaver::RegionsSaver(
+    RegionsLayer* layers,
+    int workers,
+    const BaselineGeneratorFactory& baselineFactory
+)
+    : layers(layers), baselineGenerators(baselineFactory != nullptr) {
+    pool = std::make_unique<
+        util::ThreadPool<ChunkSaveDataPtr, ChunkSaveDataPtr>>(
+        "chunks-saver-pool",
+        [layers, baselineFactory]() {
+            return std::make_shared<ChunkCompressWorker>(
+                layers, baselineFactory ? baselineFactory() : nullptr
+            );
+        },
+        [this](ChunkSaveDataPtr& data) { processResult(data); },
+        workers
+    );
+    writerThread = std::thread(&RegionsSaver::writerLoop, this);
+}
+
+RegionsSaver::~RegionsSaver() {
+    try {
+        flush();
+    } catch (const std::exception& err) {
+        logger.error() << "could not complete saving: " << err.what();
+    }
+    {
+        std::lock_guard lock(writeMutex);
+        stopping = true;
+    }
+    writeCv.notify_all();
+    writerThread.join();
+    pool->terminate();
+}
+
+void RegionsSaver::enqueue(ChunkSaveDataPtr data) {
+    while (pendingIds.size() >= MAX_QUEUED_CHUNKS) {
+        waitForResults();
+    }
+    data->id = nextId++;
+    pendingIds.insert(data->id);
+    pendingChunks[{data->x, data->z}].push_back(data->id);
+    pool->enqueueJob(std::move(data));
+}
+
+void RegionsSaver::processResult(ChunkSaveDataPtr& data) {
+    glm::ivec2 pos(data->x, data->z);
+    auto found = pendingChunks.find(pos);
+    if (found == pendingChunks.end()) {
+        return;
+    }
+    if (found->second.front() != data->id) {
+        // previous save of the chunk is not done yet
+        deferred[data->id] = data;
+        return;
+    }
+    auto& queue = found->second;
+    auto current = data;
+    while (true) {
+        putToRegions(current);
+        pendingIds.erase(current->id);
+        queue.pop_front();
+        if (queue.empty()) {
+            pendingChunks.erase(found);
+            break;
+        }
+        auto next = deferred.find(queue.front());
+        if (next == deferred.end()) {
+            break;
+        }
+        current = std::move(next->second);
+        deferred.erase(next);
+    }
+}
+
+void RegionsSaver::putToRegions(const ChunkSaveDataPtr& data) {
+    glm::ivec2 pos(data->x, data->z);
+    if (!data->error.empty()) {
+        logger.error() << "could not save chunk " << data->x << ", "
+                       << data->z << ": " << data->error;
+        failedChunks[pos] = data;
+        return;
+    }
+    failedChunks.erase(pos);
+    for (size_t i = 0; i < REGION_LAYERS_COUNT; i++) {
+        auto& entry = data->layers[i];
+        if (entry.data == nullptr) {
+            continue;
+        }
+        layers[i].putChunk(
+            data->x, data->z, std::move(entry.data), entry.size, entry.srcSize
+        );
+    }
+    chunksSaved++;
+}
+
+void RegionsSaver::retryFailedChunks() {
+    auto chunks = std::move(failedChunks);
+    failedChunks.clear();
+    for (auto& [_, data] : chunks) {
+        data->error.clear();
+        try {
+            data->compress(layers);
+        } catch (const std::exception& err) {
+            data->error = err.what();
+        }
+        putToRegions(data);
+    }
+}
+
+void RegionsSaver::update() {
+    pool->update();
+    processWriteResults();
+    checkCommitRequest();
+    checkWriteRequest();
+}
+
+void RegionsSaver::waitForResults() {
+    if (!pendingIds.empty()) {
+        pool->waitForResults();
+    }
+    update();
+}
+
+void RegionsSaver::requestWriteAll() {
+    retryFailedChunks();
+    writeRequested = true;
+    writeRequestId = nextId - 1;
+    checkWriteRequest();
+}
+
+void RegionsSaver::requestCommit() {
+    commitRequested = true;
+    commitRequestId = nextId - 1;
+    checkCommitRequest();
+}
+
+void RegionsSaver::checkCommitRequest() {
+    if (!commitRequested) {
+        return;
+    }
+    if (!pendingIds.empty() && *pendingIds.begin() <= commitRequestId) {
+        return;
+    }
+    commitRequested = false;
+    commitJournal();
+}
+
+void RegionsSaver::commitJournal() {
+    auto journal = layers[0].journal;
+    if (journal == nullptr || !journal->writeCommit()) {
+        return;
+    }
+    {
+        std::lock_guard lock(writeMutex);
+        if (journalSync) {
+            return;
+        }
+        journalSync = journal;
+        writesPending++;
+    }
+    writeCv.notify_one();
+}
+
+void RegionsSaver::checkWriteRequest() {
+    if (!writeRequested) {
+        return;
+    }
+    if (!pendingIds.empty() && *pendingIds.begin() <= writeRequestId) {
+        return;
+    }
+    writeRequested = false;
+    for (size_t i = 0; i < REGION_LAYERS_COUNT; i++) {
+        auto& layer = layers[i];
+        const auto& writing = writingVersions[i];
+        std::vector<std::pair<glm::ivec2, std::unique_ptr<WorldRegion>>> copies;
+        {
+            std::lock_guard lock(layer.mapMutex);
+            for (const auto& [pos, region] : layer.regions) {
+                if (region->getChunks() == nullptr || !region->isUnsaved()) {
+                    continue;
+                }
+                // region is marked saved when written (see
+                // processWriteResults), so it's not written twice
+                const auto found = writing.find(pos);
+                if (found != writing.end() &&
+                    found->second == region->getVersion()) {
+                    continue;
+                }
+                copies.emplace_back(pos, region->clone());
+            }
+        }
+        for (auto& [pos, copy] : copies) {
+            uint64_t version = copy->getVersion();
+            enqueueWrite(layer, pos, std::move(copy), version, false);
+        }
+    }
+}
+
+void RegionsSaver::processWriteResults() {
+    std::vector<WriteJob> results;
+    {
+        std::lock_guard lock(writeMutex);
+        results = std::move(writeResults);
+        writeResults.clear();
+    }
+    for (auto& job : results) {
+        auto& layer = *job.layer;
+        auto& writing = writingVersions[layer.layer];
+        const auto found = writing.find(job.pos);
+        if (found != writing.end() && found->second == job.version) {
+            writing.erase(found);
+        }
+        if (job.unload && --unloading[job.pos] == 0) {
+            unloading.erase(job.pos);
+        }
+        if (!job.error.empty()) {
+            // region stays unsaved in memory to be written again
+            writeErrors[layer.layer][job.pos] = std::move(job.error);
+            continue;
+        }
+        writeErrors[layer.layer].erase(job.pos);
+
+        bool changed = true;
+        {
+            std::lock_guard lock(layer.mapMutex);
+            const auto region = layer.regions.find(job.pos);
+            if (region != layer.regions.end() &&
+                region->second->getVersion() == job.version) {
+                region->second->setUnsaved(false);
+                changed = false;
+            }
+        }
+        // region changed after the copy was written is kept in memory
+        if (job.unload && !changed) {
+            layer.takeRegion(job.pos.x, job.pos.y);
+        }
+    }
+}
+
+bool RegionsSaver::hasPendingChunks(int x, int z) const {
+    for (const auto& [pos, _] : pendingChunks) {
+        if (floordiv<REGION_SIZE>(pos.x) == x &&
+            floordiv<REGION_SIZE>(pos.y) == z) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void RegionsSaver::unloadRegion(int x, int z) {
+    while (hasPendingChunks(x, z)) {
+        waitForResults();
+    }
+    // synced by the writer before the region is written
+    commitJournal();
+    for (size_t i = 0; i < REGION_LAYERS_COUNT; i++) {
+        auto& layer = layers[i];
+        std::unique_ptr<WorldRegion> copy;
+        {
+            std::lock_guard lock(layer.mapMutex);
+            const auto found = layer.regions.find({x, z});
+            if (found == layer.regions.end()) {
+                continue;
+            }
+            if (found->second->isUnsaved()) {
+                copy = found->second->clone();
+            }
+        }
+        if (copy == nullptr) {
+            layer.takeRegion(x, z);
+            continue;
+        }
+        // kept in memory until written, so a failed write does not lose it
+        uint64_t version = copy->getVersion();
+        unloading[{x, z}]++;
+        enqueueWrite(layer, {x, z}, std::move(copy), version, true);
+    }
+}
+
+bool RegionsSaver::isUnloading(int x, int z) const {
+    return unloading.find({x, z}) != unloading.end();
+}
+
+void RegionsSaver::waitChunk(int x, int z) {
+    while (pendingChunks.find({x, z}) != pendingChunks.end()) {
+        waitForResults();
+    }
+}
+
+void RegionsSaver::enqueueWrite(
+    RegionsLayer& layer,
+    glm::ivec2 pos,
+    std::unique_ptr<WorldRegion> region,
+    uint64_t version,
+    bool unload
+) {
+    layer.beginRegionWrite(pos);
+    writingVersions[layer.layer][pos] = version;
+    writesPending++;
+    {
+        std::lock_guard lock(writeMutex);
+        writeQueue.push(
+            WriteJob {&layer, pos, std::move(region), version, unload, {}}
+        );
+    }
+    writeCv.notify_one();
+}
+
+void RegionsSaver::writerLoop() {
+    while (true) {
+        WriteJob job;
+        RegionsJournal* journal = nullptr;
+        {
+            std::unique_lock lock(writeMutex);
+            writeCv.wait(lock, [this]() {
+                return !writeQueue.empty() || journalSync || stopping;
+            });
+            if (journalSync) {
+                journal = journalSync;
+                journalSync = nullptr;
+            } else if (writeQueue.empty()) {
+                break;
+            } else {
+                job = std::move(writeQueue.front());
+                writeQueue.pop();
+            }
+        }
+        if (journal) {
+            syncJournal(*journal);
+            continue;
+        }
+        auto& layer = *job.layer;
+        try {
+            io::create_directories(layer.folder);
+            bytesWritten += layer.writeRegionFile(
+                job.pos.x, job.pos.y, job.region.get()
+            );
+            regionsWritten++;
+        } catch (const std::exception& err) {
+            logger.error() << "could not write region " << job.pos.x << "_"
+                           << job.pos.y << " to " << layer.folder.string()
+                           << ": " << err.what();
+            job.error = err.what();
+        }
+        job.region.reset();
+        layer.endRegionWrite(job.pos);
+        {
+            std::lock_guard lock(writeMutex);
+            writeResults.push_back(std::move(job));
+            writesPending--;
+        }
+        writesDone.notify_all();
+    }
+}
+
+void RegionsSaver::syncJournal(RegionsJournal& journal) {
+    std::string error;
+    try {
+        journal.sync();
+    } catch (const std::exception& err) {
+        logger.error() << "could not sync journal: " << err.what();
+        error = err.what();
+    }
+    {
+        std::lock_guard lock(writeMutex);
+        journalError = std::move(error);
+        writesPending--;
+    }
+    writesDone.notify_all();
+}
+
+void RegionsSaver::flush() {
+    retryFailedChunks();
+    update();
+    while (!pendingIds.empty() || writeRequested || commitRequested) {
+        waitForResults();
+    }
+    std::string error;
+    {
+        std::unique_lock lock(writeMutex);
+        writesDone.wait(lock, [this]() { return writesPending == 0; });
+        error = journalError;
+    }
+    processWriteResults();
+    if (!error.empty()) {
+        throw std::runtime_error("could not sync journal: " + error);
+    }
+
+    size_t failedRegions = 0;
+    for (const auto& errors : writeErrors) {
+        failedRegions += errors.size();
+        if (error.empty() && !errors.empty()) {
+            error = errors.begin()->second;
+        }
+    }
+    if (failedChunks.empty() && failedRegions == 0) {
+        return;
+    }
+    if (error.empty()) {
+        error = failedChunks.begin()->second->error;
+    }
+    throw std::runtime_error(
+        "could not save " + std::to_string(failedChunks.size()) +
+        " chunk(s) and write " + std::to_string(failedRegions) +
+        " region(s): " + error
+    );
+}
+
+size_t RegionsSaver::getQueueDepth() const {
+    return pendingIds.size() + writesPending;
+}
+
+uint64_t RegionsSaver::getBytesWritten() const {
+    return bytesWritten;
+}
+
+uint64_t RegionsSaver::getRegionsWritten() const {
+    return regionsWritten;
+}
+
+uint64_t RegionsSaver::getChunksSaved() const {
+    return chunksSaved;
+}
@@ -0,0 +1,231 @@
+#pragma once
+
+#include <set>
+#include <deque>
+#include <queue>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unordered_map>
+#include <condition_variable>
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/glm.hpp>
+#include <glm/gtx/hash.hpp>
+
+#include "typedefs.hpp"
+#include "coders/compression.hpp"
+#include "world_regions_fwd.hpp"
+
+struct RegionsLayer;
+class WorldRegion;
+class RegionsJournal;
+
+namespace util {
+    template <class T, class R>
+    class ThreadPool;
+}
+
+/// @brief Chunk data of all region layers to be put to regions
+struct ChunkSaveData {
+    struct Layer {
+        /// @brief Layer data (nullptr if layer is not written)
+        std::unique_ptr<ubyte[]> data;
+        /// @brief Compressed data size
+        uint32_t size = 0;
+        /// @brief Source data size
+        uint32_t srcSize = 0;
+    };
+    int x;
+    int z;
+    /// @brief Save order number
+    uint64_t id = 0;
+    Layer layers[REGION_LAYERS_COUNT] {};
+    /// @brief Voxels layer holds full chunk data to be replaced with
+    /// delta record by the saver worker
+    bool voxelsDelta = false;
+    /// @brief Error message if compression failed
+    std::string error;
+
+    ChunkSaveData(int x, int z) : x(x), z(z) {}
+
+    /// @brief Set layer source data
+    void set(RegionLayerIndex layer, std::unique_ptr<ubyte[]> data, size_t size);
+
+    /// @brief Compress layers data using layers compression methods.
+    /// Source data is kept if compression fails
+    void compress(const RegionsLayer* layers);
+};
+
+using ChunkSaveDataPtr = std::shared_ptr<ChunkSaveData>;
+
+/// @brief Asynchronous chunks saving pipeline:
+/// 1. chunk data is copied on the main thread (see WorldRegions::put)
+/// 2. voxels delta is calculated and layers data is compressed by worker
+/// threads
+/// 3. compressed data is put to in-memory regions on the main thread
+/// (update) keeping saves order for every chunk
+/// 4. region files are written by a background writer thread
+/// (region copies are written, so in-memory regions stay usable)
+/// 5. write results are handled on the main thread (update): regions are
+/// marked saved or unloaded only when written, failed ones stay unsaved
+/// in memory to be written again
+class RegionsSaver {
+    RegionsLayer* layers;
+    bool baselineGenerators;
+    std::unique_ptr<util::ThreadPool<ChunkSaveDataPtr, ChunkSaveDataPtr>> pool;
+
+    uint64_t nextId = 1;
+    /// @brief Ids of chunks saves not put to regions yet
+    std::set<uint64_t> pendingIds;
+    /// @brief Pending saves ids of every chunk in order
+    std::unordered_map<glm::ivec2, std::deque<uint64_t>> pendingChunks;
+    /// @brief Compressed chunks waiting for previous saves of the same chunk
+    std::unordered_map<uint64_t, ChunkSaveDataPtr> deferred;
+    /// @brief Chunks saves failed to be compressed, compressed again on
+    /// the next write request (a newer save of the chunk replaces them)
+    std::unordered_map<glm::ivec2, ChunkSaveDataPtr> failedChunks;
+
+    /// @brief Write all regions after all saves with id <= writeRequestId
+    bool writeRequested = false;
+    uint64_t writeRequestId = 0;
+
+    /// @brief Commit journal after all saves with id <= commitRequestId
+    bool commitRequested = false;
+    uint64_t commitRequestId = 0;
+
+    struct WriteJob {
+        RegionsLayer* layer;
+        glm::ivec2 pos;
+        std::unique_ptr<WorldRegion> region;
+        /// @brief Version of the region copy (see WorldRegion::getVersion)
+        uint64_t version = 0;
+        /// @brief Remove the region from memory when written
+        bool unload = false;
+        /// @brief Error message if writing failed
+        std::string error;
+    };
+    /// @brief Versions of regions being written per layer
+    std::unordered_map<glm::ivec2, uint64_t> writingVersions[REGION_LAYERS_COUNT];
+    /// @brief Number of unload writes enqueued per region
+    std::unordered_map<glm::ivec2, int> unloading;
+    /// @brief Last write error of regions per layer (removed when written)
+    std::unordered_map<glm::ivec2, std::string> writeErrors[REGION_LAYERS_COUNT];
+
+    std::thread writerThread;
+    std::queue<WriteJob> writeQueue;
+    /// @brief Finished writes to be handled on the main thread
+    std::vector<WriteJob> writeResults;
+    /// @brief Journal to be synced by the writer thread (nullptr if not
+    /// requested). Single sync covers all commits written before
+    RegionsJournal* journalSync = nullptr;
+    /// @brief Last journal sync error (cleared when synced)
+    std::string journalError;
+    std::mutex writeMutex;
+    std::condition_variable writeCv;
+    /// @brief Notified when a region write is finished
+    std::condition_variable writesDone;
+    bool stopping = false;
+
+    std::atomic<size_t> writesPending = 0;
+    std::atomic<uint64_t> bytesWritten = 0;
+    std::atomic<uint64_t> regionsWritten = 0;
+    uint64_t chunksSaved = 0;
+
+    void processResult(ChunkSaveDataPtr& data);
+    void putToRegions(const ChunkSaveDataPtr& data);
+    void retryFailedChunks();
+    void checkWriteRequest();
+    void checkCommitRequest();
+    /// @brief Write journal commit record, sync it in background
+    void commitJournal();
+    void syncJournal(RegionsJournal& journal);
+    /// @brief Mark written regions saved, unload ones requested
+    void processWriteResults();
+    /// @brief Block until some compressed chunks are ready, then put them
+    /// to regions
+    void waitForResults();
+    void enqueueWrite(
+        RegionsLayer& layer,
+        glm::ivec2 pos,
+        std::unique_ptr<WorldRegion> region,
+        uint64_t version,
+        bool unload
+    );
+    void writerLoop();
+public:
+    /// @brief Max number of chunks saves being compressed.
+    /// Limits memory used by chunks data copies
+    static inline constexpr size_t MAX_QUEUED_CHUNKS = 512;
+
+    /// @param layers WorldRegions layers array
+    /// @param workers number of compression threads
+    /// @param baselineFactory creates baseline generator for every worker
+    /// (nullptr - workers do not calculate voxels delta)
+    RegionsSaver(
+        RegionsLayer* layers,
+        int workers,
+        const BaselineGeneratorFactory& baselineFactory = nullptr
+    );
+    ~RegionsSaver();
+
+    /// @return true if workers are able to calculate voxels delta
+    /// (see ChunkSaveData::voxelsDelta)
+    bool hasBaselineGenerator() const {
+        return baselineGenerators;
+    }
+
+    /// @brief Enqueue chunk data compression. Waits for some saves to
+    /// complete if MAX_QUEUED_CHUNKS is reached
+    void enqueue(ChunkSaveDataPtr data);
+
+    /// @brief Put compressed chunks to regions, start requested regions
+    /// writing. Must be called on the main thread
+    void update();
+
+    /// @brief Write all unsaved regions of all layers after all currently
+    /// enqueued chunks are put to regions. Returns without waiting
+    void requestWriteAll();
+
+    /// @brief Commit journal after all currently enqueued chunks are put to
+    /// regions. The journal is synced to the storage device by the writer
+    /// thread. Returns without waiting
+    void requestCommit();
+
+    /// @brief Unload region of all layers writing unsaved ones in background.
+    /// Unsaved regions are kept in memory until written. Journal is
+    /// committed before, so region files keep committed state only.
+    /// Waits for enqueued saves of the region chunks
+    void unloadRegion(int x, int z);
+
+    /// @return true if region is kept in memory until written (see
+    /// unloadRegion)
+    bool isUnloading(int x, int z) const;
+
+    /// @return true if region has chunks saves not put to regions yet
+    bool hasPendingChunks(int x, int z) const;
+
+    /// @brief Wait until enqueued saves of the chunk are put to regions
+    void waitChunk(int x, int z);
+
+    /// @brief Barrier: wait until all enqueued chunks are put to regions
+    /// and all requested region writes are finished
+    /// @throws std::runtime_error if some chunks or regions could not be
+    /// saved (they are kept in memory to be saved again)
+    void flush();
+
+    /// @return number of chunks and regions waiting to be saved/written
+    size_t getQueueDepth() const;
+
+    /// @return number of bytes written to region files
+    uint64_t getBytesWritten() const;
+
+    /// @return number of region files written
+    uint64_t getRegionsWritten() const;
+
+    /// @return number of chunks put to regions
+    uint64_t getChunksSaved() const;
+};
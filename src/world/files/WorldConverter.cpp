@@ -1,34 +1,61 @@
 #include "WorldConverter.hpp"
 
+#include <fstream>
 #include <iostream>
 #include <memory>
+#include <set>
 #include <stdexcept>
 #include <utility>
 
 #include "content/ContentReport.hpp"
 #include "compatibility.hpp"
+#include "content/Content.hpp"
 #include "debug/Logger.hpp"
 #include "io/io.hpp"
 #include "objects/Player.hpp"
+#include "util/platform.hpp"
 #include "util/ThreadPool.hpp"
 #include "voxels/Chunk.hpp"
+#include "voxels/chunk_delta.hpp"
 #include "items/Inventory.hpp"
 #include "voxels/Block.hpp"
+#include "world/World.hpp"
+#include "world/generator/GeneratorDef.hpp"
+#include "world/generator/WorldGenerator.hpp"
 #include "WorldFiles.hpp"
 
 namespace fs = std::filesystem;
 
 static debug::Logger logger("world-converter");
 
+static const char* to_string(ConvertMode mode) {
+    switch (mode) {
+        case ConvertMode::UPGRADE:
+            return "upgrade";
+        case ConvertMode::REINDEX:
+            return "reindex";
+        case ConvertMode::BLOCK_FIELDS:
+            return "block-fields";
+    }
+    return "unknown";
+}
+
+static std::string get_task_key(const ConvertTask& task) {
+    return std::to_string(static_cast<int>(task.type)) + " " +
+           task.file.string();
+}
+
 class ConverterWorker : public util::Worker<ConvertTask, int> {
     std::shared_ptr<WorldConverter> converter;
+    BaselineGenerator baseline;
 public:
     ConverterWorker(std::shared_ptr<WorldConverter> converter)
-        : converter(std::move(converter)) {
+        : converter(std::move(converter)),
+          baseline(this->converter->createBaselineGenerator()) {
     }
 
     int operator()(const ConvertTask& task) override {
-        converter->convert(task);
+        converter->convert(task, baseline);
         return 0;
     }
 };
@@ -99,6 +126,28 @@ void WorldConverter::createConvertTasks() {
         ConvertTaskType::PLAYER, wfile->getPlayerFile(), 0, 0, {}});
 }
 
+void WorldConverter::createBaselineFactory() {
+    auto info = wfile->readWorldInfo();
+    if (!info) {
+        return;
+    }
+    auto def = content->generators.find(info->generator);
+    if (def == nullptr) {
+        logger.warning() << "generator " << info->generator
+                         << " not found - chunks stored as delta can not be "
+                            "converted";
+        return;
+    }
+    uint64_t seed = info->seed;
+    baselineFactory = [def, content = content, seed]() {
+        return WorldGenerator::createStandalone(*def, *content, seed);
+    };
+}
+
+BaselineGenerator WorldConverter::createBaselineGenerator() const {
+    return baselineFactory ? baselineFactory() : nullptr;
+}
+
 void WorldConverter::createBlockFieldsConvertTasks() {
     // blocks data conversion requires correct block indices
     // so it must be done AFTER voxels conversion
@@ -125,7 +174,9 @@ WorldConverter::WorldConverter(
     : wfile(worldFiles),
       report(std::move(reportPtr)),
       content(content),
-      mode(mode)
+      mode(mode),
+      progressFile(worldFiles->getFolder() / PROGRESS_FILE),
+      stagingFolder(worldFiles->getFolder() / STAGING_FOLDER)
 {
     switch (mode) {
         case ConvertMode::UPGRADE:
@@ -138,6 +189,81 @@ WorldConverter::WorldConverter(
             createBlockFieldsConvertTasks();
             break;
     }
+    resume();
+    if (!tasks.empty() && mode == ConvertMode::BLOCK_FIELDS) {
+        // blocks data conversion requires voxels of chunks
+        createBaselineFactory();
+    }
+    tasksTotal = tasks.size() + tasksResumed;
+    startTime = std::chrono::steady_clock::now();
+    lastReportTime = startTime;
+}
+
+void WorldConverter::resume() {
+    auto progressPath = io::resolve(progressFile);
+    // completed tasks are valid only for the same conversion
+    std::string header =
+        std::string(to_string(mode)) + " " + report->getFingerprint();
+    std::set<std::string> completed;
+    if (fs::is_regular_file(progressPath)) {
+        std::ifstream stream(progressPath);
+        std::string line;
+        std::getline(stream, line);
+        std::string progressHeader = line;
+        while (std::getline(stream, line)) {
+            if (!line.empty()) {
+                completed.insert(line);
+            }
+        }
+        stream.close();
+        if (progressHeader != header) {
+            if (!completed.empty()) {
+                // converting again or skipping converted files would
+                // corrupt the world
+                throw std::runtime_error(
+                    "world conversion '" + progressHeader +
+                    "' was interrupted and can not be resumed with "
+                    "changed content ('" + header + "'): restore content "
+                    "packs used before or the world backup"
+                );
+            }
+            logger.warning() << "discarding progress of '" << progressHeader
+                             << "' conversion";
+            fs::remove(progressPath);
+        }
+    }
+    std::queue<ConvertTask> remaining;
+    while (!tasks.empty()) {
+        ConvertTask task = std::move(tasks.front());
+        tasks.pop();
+        if (completed.find(get_task_key(task)) == completed.end()) {
+            remaining.push(std::move(task));
+            continue;
+        }
+        // task is recorded but interrupted before its file was moved
+        auto staged = getStagedFile(task);
+        if (io::is_regular_file(staged)) {
+            fs::rename(io::resolve(staged), io::resolve(task.file));
+        }
+        tasksResumed++;
+    }
+    tasks = std::move(remaining);
+    tasksDone = tasksResumed;
+
+    // output of uncommitted tasks
+    io::remove_all(stagingFolder);
+    io::create_directories(stagingFolder);
+
+    if (!fs::is_regular_file(progressPath)) {
+        std::ofstream stream(progressPath, std::ios::binary);
+        stream << header << '\n';
+        stream.close();
+        platform::sync_file(progressPath);
+    }
+    if (tasksResumed) {
+        logger.info() << "resuming " << to_string(mode) << " conversion: "
+                      << tasksResumed << " tasks already done";
+    }
 }
 
 WorldConverter::~WorldConverter() {
@@ -179,41 +305,116 @@ std::shared_ptr<Task> WorldConverter::startTask(
     return pool;
 }
 
+io::path WorldConverter::getStagedFile(const ConvertTask& task) const {
+    return stagingFolder / (std::to_string(static_cast<int>(task.type)) +
+                            "_" + task.file.parent().name() + "_" +
+                            task.file.name());
+}
+
+void WorldConverter::commit(const ConvertTask& task, bool staged) {
+    {
+        std::lock_guard lock(progressMutex);
+        auto progressPath = io::resolve(progressFile);
+        std::ofstream stream(
+            progressPath, std::ios::binary | std::ios::app
+        );
+        stream << get_task_key(task) << '\n';
+        stream.close();
+        if (!stream || !platform::sync_file(progressPath)) {
+            throw std::runtime_error("could not write conversion progress");
+        }
+    }
+    if (staged) {
+        fs::rename(
+            io::resolve(getStagedFile(task)), io::resolve(task.file)
+        );
+    }
+    reportProgress(++tasksDone);
+}
+
+void WorldConverter::reportProgress(uint done) {
+    auto now = std::chrono::steady_clock::now();
+    std::lock_guard lock(progressMutex);
+    if (done < tasksTotal && now - lastReportTime < REPORT_INTERVAL) {
+        return;
+    }
+    lastReportTime = now;
+    double elapsed = std::chrono::duration<double>(now - startTime).count();
+    double speed = elapsed > 0.0 ? (done - tasksResumed) / elapsed : 0.0;
+
+    auto message = logger.info();
+    message << "converted " << done << "/" << tasksTotal << ", "
+            << static_cast<int>(speed * 10.0) / 10.0 << " regions/s";
+    if (done < tasksTotal && speed > 0.0) {
+        message << ", ETA " << static_cast<int>((tasksTotal - done) / speed)
+                << " s";
+    } else if (done == tasksTotal) {
+        message << " in " << static_cast<int>(elapsed) << " s";
+    }
+}
+
 void WorldConverter::upgradeRegion(
-    const io::path& file, int x, int z, RegionLayerIndex layer
+    const io::path& file,
+    int x,
+    int z,
+    RegionLayerIndex layer,
+    const io::path& staged
 ) const {
     auto path = wfile->getRegions().getRegionFilePath(layer, x, z);
     auto bytes = io::read_bytes_buffer(path);
     auto buffer = compatibility::convert_region_2to3(bytes, layer);
-    io::write_bytes(path, buffer.data(), buffer.size());
+    io::write_bytes(staged, buffer.data(), buffer.size());
+    platform::sync_file(io::resolve(staged));
 }
 
-void WorldConverter::convertVoxels(const io::path& file, int x, int z) const {
+void WorldConverter::convertVoxels(
+    int x, int z, const io::path& staged
+) const {
     logger.info() << "converting voxels region " << x << "_" << z;
-    wfile->getRegions().processRegion(x, z, REGION_LAYER_VOXELS,
-    [=](std::unique_ptr<ubyte[]> data, uint32_t*) {
-        Chunk::convert(data.get(), report.get());
+    auto& regions = wfile->getRegions();
+    regions.processRegion(x, z, REGION_LAYER_VOXELS,
+    [=](std::unique_ptr<ubyte[]> data, uint32_t* size) {
+        if (chunk_delta::is_delta(*size)) {
+            chunk_delta::convert(data.get(), *size, report.get());
+        } else {
+            Chunk::convert(data.get(), report.get());
+        }
         return data;
     });
+    regions.writeRegionTo(REGION_LAYER_VOXELS, x, z, staged);
 }
 
-void WorldConverter::convertInventories(const io::path& file, int x, int z) const {
+void WorldConverter::convertInventories(
+    int x, int z, const io::path& staged
+) const {
     logger.info() << "converting inventories region " << x << "_" << z;
-    wfile->getRegions().processInventories(x, z, [=](Inventory* inventory) {
+    auto& regions = wfile->getRegions();
+    regions.processInventories(x, z, [=](Inventory* inventory) {
         inventory->convert(report.get());
     });
+    regions.writeRegionTo(REGION_LAYER_INVENTORIES, x, z, staged);
 }
 
-void WorldConverter::convertPlayer(const io::path& file) const {
+void WorldConverter::convertPlayer(
+    const io::path& file, const io::path& staged
+) const {
     logger.info() << "converting player " << file.string();
     auto map = io::read_json(file);
     Player::convert(map, report.get());
-    io::write_json(file, map);
+    io::write_json(staged, map);
+    platform::sync_file(io::resolve(staged));
 }
 
-void WorldConverter::convertBlocksData(int x, int z, const ContentReport& report) const {
+void WorldConverter::convertBlocksData(
+    int x,
+    int z,
+    const ContentReport& report,
+    const BaselineGenerator& baseline,
+    const io::path& staged
+) const {
     logger.info() << "converting blocks data";
-    wfile->getRegions().processBlocksData(x, z, 
+    auto& regions = wfile->getRegions();
+    regions.processBlocksData(x, z, 
     [=](BlocksMetadata* heap, std::unique_ptr<ubyte[]> voxelsData) {
         Chunk chunk(0, 0);
         chunk.decode(voxelsData.get());
@@ -236,29 +437,36 @@ void WorldConverter::convertBlocksData(int x, int z, const ContentReport& report
             newStruct.convert(prevStruct, entry.data(), dst, true);
         }
         *heap = std::move(newHeap);
-    });
+    }, baseline);
+    regions.writeRegionTo(REGION_LAYER_BLOCKS_DATA, x, z, staged);
 }
 
-void WorldConverter::convert(const ConvertTask& task) const {
-    if (!io::is_regular_file(task.file)) return;
-
+void WorldConverter::convert(
+    const ConvertTask& task, const BaselineGenerator& baseline
+) {
+    if (!io::is_regular_file(task.file)) {
+        commit(task, false);
+        return;
+    }
+    auto staged = getStagedFile(task);
     switch (task.type) {
         case ConvertTaskType::UPGRADE_REGION:
-            upgradeRegion(task.file, task.x, task.z, task.layer);
+            upgradeRegion(task.file, task.x, task.z, task.layer, staged);
             break;
         case ConvertTaskType::VOXELS:
-            convertVoxels(task.file, task.x, task.z);
+            convertVoxels(task.x, task.z, staged);
             break;
         case ConvertTaskType::INVENTORIES:
-            convertInventories(task.file, task.x, task.z);
+            convertInventories(task.x, task.z, staged);
             break;
         case ConvertTaskType::PLAYER:
-            convertPlayer(task.file);
+            convertPlayer(task.file, staged);
             break;
         case ConvertTaskType::CONVERT_BLOCKS_DATA:
-            convertBlocksData(task.x, task.z, *report);
+            convertBlocksData(task.x, task.z, *report, baseline, staged);
             break;
     }
+    commit(task, io::is_regular_file(staged));
 }
 
 void WorldConverter::convertNext() {
@@ -267,9 +475,11 @@ void WorldConverter::convertNext() {
     }
     ConvertTask task = tasks.front();
     tasks.pop();
-    tasksDone++;
 
-    convert(task);
+    if (baselineGenerator == nullptr) {
+        baselineGenerator = createBaselineGenerator();
+    }
+    convert(task, baselineGenerator);
 }
 
 void WorldConverter::setOnComplete(runnable callback) {
@@ -308,6 +518,10 @@ void WorldConverter::write() {
     }
     wfile->patchIndicesFile(patch);
     wfile->write(nullptr, nullptr);
+
+    // all tasks are committed, conversion can't be resumed anymore
+    io::remove(progressFile);
+    io::remove_all(stagingFolder);
 }
 
 void WorldConverter::waitForEnd() {
@@ -317,7 +531,7 @@ void WorldConverter::waitForEnd() {
 }
 
 uint WorldConverter::getWorkTotal() const {
-    return tasks.size() + tasksDone;
+    return tasksTotal;
 }
 
 uint WorldConverter::getWorkDone() const {
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
 #include <memory>
+#include <mutex>
 #include <queue>
 
 #include "delegates.hpp"
@@ -41,21 +44,66 @@ enum class ConvertMode {
     BLOCK_FIELDS,
 };
 
+/// @brief Converts world files. Every task result is written to a staging
+/// file, recorded in the progress file and moved in place of the source
+/// file, so interrupted conversion is resumed skipping completed tasks
+/// (re-applying indices conversion would corrupt the data). The progress
+/// file stores conversion mode and content report fingerprint, resuming
+/// with another report is refused.
 class WorldConverter : public Task {
     std::shared_ptr<WorldFiles> wfile;
     std::shared_ptr<ContentReport> const report;
     const Content* const content;
     std::queue<ConvertTask> tasks;
     runnable onComplete;
-    uint tasksDone = 0;
+    std::atomic<uint> tasksDone = 0;
+    /// @brief Number of tasks completed before the conversion was resumed
+    uint tasksResumed = 0;
+    uint tasksTotal = 0;
     ConvertMode mode;
+    /// @brief Restores voxels of chunks stored as delta records
+    /// (nullptr if not required or the world generator is not available)
+    BaselineGeneratorFactory baselineFactory;
+    /// @brief Baseline generator used by convertNext (created on demand)
+    BaselineGenerator baselineGenerator;
+
+    io::path progressFile;
+    io::path stagingFolder;
+    std::mutex progressMutex;
+    std::chrono::steady_clock::time_point startTime;
+    std::chrono::steady_clock::time_point lastReportTime;
 
     void upgradeRegion(
-        const io::path& file, int x, int z, RegionLayerIndex layer) const;
-    void convertPlayer(const io::path& file) const;
-    void convertVoxels(const io::path& file, int x, int z) const;
-    void convertInventories(const io::path& file, int x, int z) const;
-    void convertBlocksData(int x, int z, const ContentReport& report) const;
+        const io::path& file,
+        int x,
+        int z,
+        RegionLayerIndex layer,
+        const io::path& staged
+    ) const;
+    void convertPlayer(const io::path& file, const io::path& staged) const;
+    void convertVoxels(int x, int z, const io::path& staged) const;
+    void convertInventories(int x, int z, const io::path& staged) const;
+    void convertBlocksData(
+        int x,
+        int z,
+        const ContentReport& report,
+        const BaselineGenerator& baseline,
+        const io::path& staged
+    ) const;
+
+    io::path getStagedFile(const ConvertTask& task) const;
+
+    /// @brief Skip tasks completed by previous interrupted conversion
+    /// @throws std::runtime_error if the conversion was interrupted with
+    /// another mode or content report
+    void resume();
+
+    /// @brief Record task as completed and move staged file in place
+    /// of the source file
+    /// @param staged false if task produced no output
+    void commit(const ConvertTask& task, bool staged);
+
+    void reportProgress(uint done);
 
     void addRegionsTasks(
         RegionLayerIndex layerid,
@@ -65,7 +113,10 @@ class WorldConverter : public Task {
     void createUpgradeTasks();
     void createConvertTasks();
     void createBlockFieldsConvertTasks();
+    void createBaselineFactory();
 public:
+    /// @throws std::runtime_error if previous interrupted conversion
+    /// can not be resumed (see resume)
     WorldConverter(
         const std::shared_ptr<WorldFiles>& worldFiles,
         const Content* content,
@@ -74,7 +125,18 @@ public:
     );
     ~WorldConverter();
 
-    void convert(const ConvertTask& task) const;
+    static inline const std::string PROGRESS_FILE = "convert.progress";
+    static inline const std::string STAGING_FOLDER = ".convert";
+    static constexpr auto REPORT_INTERVAL = std::chrono::seconds(2);
+
+    /// @brief Run and commit the task. Thread-safe for different tasks
+    /// @param baseline generator used to restore voxels of chunks stored
+    /// as delta records (not shared between threads)
+    void convert(const ConvertTask& task, const BaselineGenerator& baseline);
+
+    /// @return new baseline generator for a conversion thread or nullptr
+    /// if not required. Must be called in the main thread
+    BaselineGenerator createBaselineGenerator() const;
     void convertNext();
     void setOnComplete(runnable callback);
     void write();
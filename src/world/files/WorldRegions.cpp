@@ -1,10 +1,12 @@
 #include "WorldRegions.hpp"
 
+#include <algorithm>
 #include <cstring>
 #include <utility>
 #include <vector>
 
 #include "debug/Logger.hpp"
+#include "debug/Profiler.hpp"
 #include "coders/json.hpp"
 #include "coders/byte_utils.hpp"
 #include "coders/rle.hpp"
@@ -12,11 +14,20 @@
 #include "items/Inventory.hpp"
 #include "maths/voxmaths.hpp"
 #include "util/data_io.hpp"
+#include "voxels/chunk_delta.hpp"
+#include "RegionsJournal.hpp"
+#include "RegionsSaver.hpp"
 
 #define REGION_FORMAT_MAGIC ".VOXREG"
 
 static debug::Logger logger("world-regions");
 
+/// @brief Journal size triggering regions checkpoint on save
+inline constexpr size_t JOURNAL_CHECKPOINT_SIZE = 64 * 1024 * 1024;
+
+/// @brief Part of the memory budget regions are unloaded to when exceeded
+inline constexpr double EVICTION_TARGET = 0.9;
+
 WorldRegion::WorldRegion()
     : chunksData(
           std::make_unique<std::unique_ptr<ubyte[]>[]>(REGION_CHUNKS_COUNT)
@@ -26,13 +37,23 @@ WorldRegion::WorldRegion()
 
 WorldRegion::~WorldRegion() = default;
 
+/// @brief Regions changes counter shared by all layers
+static std::atomic<uint64_t> version_counter = 0;
+
 void WorldRegion::setUnsaved(bool unsaved) {
     this->unsaved = unsaved;
+    if (unsaved) {
+        version = ++version_counter;
+    }
 }
 bool WorldRegion::isUnsaved() const {
     return unsaved;
 }
 
+uint64_t WorldRegion::getVersion() const {
+    return version;
+}
+
 std::unique_ptr<ubyte[]>* WorldRegion::getChunks() const {
     return chunksData.get();
 }
@@ -45,10 +66,69 @@ void WorldRegion::put(
     uint x, uint z, std::unique_ptr<ubyte[]> data, uint32_t size, uint32_t srcSize
 ) {
     size_t chunk_index = z * REGION_SIZE + x;
+    size_t prevSize = dataSize;
+    if (chunksData[chunk_index]) {
+        dataSize -= sizes[chunk_index][0];
+    }
+    if (data) {
+        dataSize += size;
+    }
+    if (memoryCounter) {
+        *memoryCounter += dataSize - prevSize;
+    }
     chunksData[chunk_index] = std::move(data);
     sizes[chunk_index] = glm::u32vec2(size, srcSize);
 }
 
+std::unique_ptr<WorldRegion> WorldRegion::clone() const {
+    auto region = std::make_unique<WorldRegion>();
+    for (size_t i = 0; i < REGION_CHUNKS_COUNT; i++) {
+        const auto& data = chunksData[i];
+        if (data == nullptr) {
+            continue;
+        }
+        auto size = sizes[i];
+        auto copy = std::make_unique<ubyte[]>(size[0]);
+        std::memcpy(copy.get(), data.get(), size[0]);
+        region->chunksData[i] = std::move(copy);
+        region->sizes[i] = size;
+    }
+    region->unsaved = unsaved;
+    region->version = version;
+    region->dataSize = dataSize;
+    return region;
+}
+
+/// @brief Regions access counter shared by all layers
+static std::atomic<uint64_t> access_counter = 0;
+
+void WorldRegion::touch() {
+    lastAccess = ++access_counter;
+}
+
+uint64_t WorldRegion::getLastAccess() const {
+    return lastAccess;
+}
+
+size_t WorldRegion::getMemoryUsage() const {
+    return sizeof(WorldRegion) + dataSize +
+           REGION_CHUNKS_COUNT *
+               (sizeof(std::unique_ptr<ubyte[]>) + sizeof(glm::u32vec2));
+}
+
+void WorldRegion::attach(std::atomic<size_t>* counter) {
+    detach();
+    memoryCounter = counter;
+    *memoryCounter += getMemoryUsage();
+}
+
+void WorldRegion::detach() {
+    if (memoryCounter) {
+        *memoryCounter -= getMemoryUsage();
+        memoryCounter = nullptr;
+    }
+}
+
 ubyte* WorldRegion::getChunkData(uint x, uint z) {
     return chunksData[z * REGION_SIZE + x].get();
 }
@@ -75,9 +155,75 @@ WorldRegions::WorldRegions(const io::path& directory) : directory(directory) {
 
     auto& blocksData = layers[REGION_LAYER_BLOCKS_DATA];
     blocksData.folder = directory / "blocksdata";
+
+    if (!directory.empty() && io::exists(getJournalFile())) {
+        recoverJournal();
+    }
 }
 
-WorldRegions::~WorldRegions() = default;
+WorldRegions::~WorldRegions() {
+    if (journal) {
+        try {
+            checkpoint();
+        } catch (const std::exception& err) {
+            logger.error() << "could not apply journal: " << err.what();
+        }
+    }
+    // saver must complete requested writes before layers are destroyed
+    saver.reset();
+}
+
+io::path WorldRegions::getJournalFile() const {
+    return directory / "regions.journal";
+}
+
+void WorldRegions::recoverJournal() {
+    auto file = getJournalFile();
+    size_t records = RegionsJournal::replay(
+        file,
+        [this](auto layer, int x, int z, auto data, auto size, auto srcSize) {
+            layers[layer].putChunk(x, z, std::move(data), size, srcSize);
+        }
+    );
+    logger.info() << "recovered " << records << " chunks records from "
+                  << file.string();
+    for (auto& layer : layers) {
+        layer.durableWrites = true;
+        io::create_directories(layer.folder);
+        layer.writeAll();
+        layer.durableWrites = false;
+    }
+    io::remove(file);
+}
+
+void WorldRegions::enableJournal() {
+    if (journal) {
+        return;
+    }
+    // changes made before are not journaled
+    writeAll();
+    flush();
+
+    io::create_directories(directory);
+    journal = std::make_unique<RegionsJournal>(getJournalFile());
+    for (auto& layer : layers) {
+        layer.journal = journal.get();
+        layer.durableWrites = true;
+    }
+}
+
+void WorldRegions::checkpoint() {
+    if (saver) {
+        saver->requestWriteAll();
+        saver->flush();
+    } else {
+        for (auto& layer : layers) {
+            io::create_directories(layer.folder);
+            layer.writeAll();
+        }
+    }
+    journal->reset();
+}
 
 void RegionsLayer::writeAll() {
     for (auto& it : regions) {
@@ -87,6 +233,7 @@ void RegionsLayer::writeAll() {
         }
         const auto& key = it.first;
         writeRegion(key[0], key[1], region);
+        region->setUnsaved(false);
     }
 }
 
@@ -97,24 +244,14 @@ void WorldRegions::put(
     std::unique_ptr<ubyte[]> data,
     size_t srcSize
 ) {
+    waitChunk(x, z);
     size_t size = srcSize;
     auto& layer = layers[layerid];
-    int regionX, regionZ, localX, localZ;
-    calc_reg_coords(x, z, regionX, regionZ, localX, localZ);
-
-    WorldRegion* region = layer.getOrCreateRegion(regionX, regionZ);
-    region->setUnsaved(true);
-    
-    if (data == nullptr) {
-        region->put(localX, localZ, nullptr, 0, 0);
-        return;
-    }
-
-    if (layer.compression != compression::Method::NONE) {
+    if (data && layer.compression != compression::Method::NONE) {
         data = compression::compress(
             data.get(), size, size, layer.compression);
     }
-    region->put(localX, localZ, std::move(data), size, srcSize);
+    layer.putChunk(x, z, std::move(data), size, srcSize);
 }
 
 static std::unique_ptr<ubyte[]> write_inventories(
@@ -143,16 +280,17 @@ static ChunkInventoriesMap load_inventories(const ubyte* src, uint32_t size) {
     for (int i = 0; i < count; i++) {
         uint index = reader.getInt32();
         uint size = reader.getInt32();
-        auto map = json::from_binary(reader.pointer(), size);
+        json::BinaryCursor cursor(reader.pointer(), size);
         reader.skip(size);
         auto inv = std::make_shared<Inventory>(0, 0);
-        inv->deserialize(map);
+        inv->deserialize(cursor);
         inventories[index] = std::move(inv);
     }
     return inventories;
 }
 
 void WorldRegions::put(Chunk* chunk, std::vector<ubyte> entitiesData) {
+    PROFILE_ZONE("WorldRegions::put");
     if (generatorTestMode) {
         return;
     }
@@ -164,58 +302,101 @@ void WorldRegions::put(Chunk* chunk, std::vector<ubyte> entitiesData) {
     if (!chunk->flags.unsaved && !lightsUnsaved && !chunk->flags.entities) {
         return;
     }
-
-    int regionX, regionZ, localX, localZ;
-    calc_reg_coords(chunk->x, chunk->z, regionX, regionZ, localX, localZ);
-
-    put(chunk->x,
-        chunk->z,
-        REGION_LAYER_VOXELS,
-        chunk->encode(),
-        CHUNK_DATA_LEN);
+    // encoding is a plain copy of chunk data, so it's done in the calling
+    // thread to take a consistent snapshot
+    auto data = std::make_shared<ChunkSaveData>(chunk->x, chunk->z);
+    if (deltaStorage && !chunk->flags.generated && baselineGenerator &&
+        saver && saver->hasBaselineGenerator()) {
+        // baseline generation is expensive, so delta is calculated
+        // by saver workers
+        data->set(REGION_LAYER_VOXELS, chunk->encode(), CHUNK_DATA_LEN);
+        data->voxelsDelta = true;
+    } else {
+        uint32_t voxelsSize;
+        auto voxels = encodeVoxels(*chunk, voxelsSize);
+        data->set(REGION_LAYER_VOXELS, std::move(voxels), voxelsSize);
+    }
 
     // Writing lights cache
     if (doWriteLights && chunk->flags.lighted) {
-        put(chunk->x,
-            chunk->z,
-            REGION_LAYER_LIGHTS,
-            chunk->lightmap.encode(),
-            LIGHTMAP_DATA_LEN);
+        data->set(
+            REGION_LAYER_LIGHTS, chunk->lightmap.encode(), LIGHTMAP_DATA_LEN
+        );
     }
     // Writing block inventories
     if (!chunk->inventories.empty()) {
         uint datasize;
-        auto data = write_inventories(chunk->inventories, datasize);
-        put(chunk->x,
-            chunk->z,
-            REGION_LAYER_INVENTORIES,
-            std::move(data),
-            datasize);
+        auto bytes = write_inventories(chunk->inventories, datasize);
+        data->set(REGION_LAYER_INVENTORIES, std::move(bytes), datasize);
     }
     // Writing entities
     if (!entitiesData.empty()) {
-        auto data = std::make_unique<ubyte[]>(entitiesData.size());
-        for (size_t i = 0; i < entitiesData.size(); i++) {
-            data[i] = entitiesData[i];
-        }
-        put(chunk->x,
-            chunk->z,
-            REGION_LAYER_ENTITIES,
-            std::move(data),
-            entitiesData.size());
+        auto bytes = std::make_unique<ubyte[]>(entitiesData.size());
+        std::memcpy(bytes.get(), entitiesData.data(), entitiesData.size());
+        data->set(REGION_LAYER_ENTITIES, std::move(bytes), entitiesData.size());
     }
     // Writing blocks data
     if (chunk->flags.blocksData) {
         auto bytes = chunk->blocksMetadata.serialize();
-        put(chunk->x,
-            chunk->z,
-            REGION_LAYER_BLOCKS_DATA,
-            bytes.release(),
-            bytes.size());
+        size_t size = bytes.size();
+        data->set(REGION_LAYER_BLOCKS_DATA, bytes.release(), size);
     }
+    if (saver) {
+        saver->enqueue(std::move(data));
+        return;
+    }
+    data->compress(layers);
+    for (auto& layer : layers) {
+        auto& entry = data->layers[layer.layer];
+        if (entry.data == nullptr) {
+            continue;
+        }
+        layer.putChunk(
+            chunk->x, chunk->z, std::move(entry.data), entry.size, entry.srcSize
+        );
+    }
+}
+
+void WorldRegions::waitChunk(int x, int z) {
+    if (saver) {
+        saver->waitChunk(x, z);
+    }
+}
+
+std::unique_ptr<ubyte[]> WorldRegions::encodeVoxels(
+    const Chunk& chunk, uint32_t& size
+) {
+    if (deltaStorage && chunk.flags.generated) {
+        return chunk_delta::encode_pristine(size);
+    }
+    if (deltaStorage && baselineGenerator) {
+        auto baseline = std::make_unique<voxel[]>(CHUNK_VOL);
+        baselineGenerator(chunk.x, chunk.z, baseline.get());
+        if (auto delta =
+                chunk_delta::encode(chunk.voxels, baseline.get(), size)) {
+            return delta;
+        }
+    }
+    size = CHUNK_DATA_LEN;
+    return chunk.encode();
+}
+
+void WorldRegions::applyDelta(
+    int x, int z, const ubyte* data, uint32_t size, voxel* voxels
+) {
+    if (baselineGenerator == nullptr) {
+        throw std::runtime_error(
+            "chunk (" + std::to_string(x) + ", " + std::to_string(z) +
+            ") is stored as delta and can not be restored without generator"
+        );
+    }
+    baselineGenerator(x, z, voxels);
+    chunk_delta::apply(data, size, voxels);
 }
 
 std::unique_ptr<ubyte[]> WorldRegions::getVoxels(int x, int z) {
+    PROFILE_ZONE("WorldRegions::getVoxels");
+    waitChunk(x, z);
     uint32_t size;
     uint32_t srcSize;
     auto& layer = layers[REGION_LAYER_VOXELS];
@@ -223,11 +404,41 @@ std::unique_ptr<ubyte[]> WorldRegions::getVoxels(int x, int z) {
     if (data == nullptr) {
         return nullptr;
     }
-    assert(srcSize == CHUNK_DATA_LEN);
-    return compression::decompress(data, size, srcSize, layer.compression);
+    auto bytes =
+        compression::decompress(data, size, srcSize, layer.compression);
+    if (!chunk_delta::is_delta(srcSize)) {
+        assert(srcSize == CHUNK_DATA_LEN);
+        return bytes;
+    }
+    auto chunk = std::make_unique<Chunk>(x, z);
+    applyDelta(x, z, bytes.get(), srcSize, chunk->voxels);
+    return chunk->encode();
+}
+
+bool WorldRegions::loadVoxels(Chunk& chunk) {
+    PROFILE_ZONE("WorldRegions::loadVoxels");
+    waitChunk(chunk.x, chunk.z);
+    uint32_t size;
+    uint32_t srcSize;
+    auto& layer = layers[REGION_LAYER_VOXELS];
+    auto* data = layer.getData(chunk.x, chunk.z, size, srcSize);
+    if (data == nullptr) {
+        return false;
+    }
+    auto bytes =
+        compression::decompress(data, size, srcSize, layer.compression);
+    if (!chunk_delta::is_delta(srcSize)) {
+        assert(srcSize == CHUNK_DATA_LEN);
+        chunk.decode(bytes.get());
+        return true;
+    }
+    applyDelta(chunk.x, chunk.z, bytes.get(), srcSize, chunk.voxels);
+    chunk.flags.generated = chunk_delta::is_pristine(srcSize);
+    return true;
 }
 
 std::unique_ptr<light_t[]> WorldRegions::getLights(int x, int z) {
+    waitChunk(x, z);
     uint32_t size;
     uint32_t srcSize;
     auto& layer = layers[REGION_LAYER_LIGHTS];
@@ -243,6 +454,7 @@ std::unique_ptr<light_t[]> WorldRegions::getLights(int x, int z) {
 }
 
 ChunkInventoriesMap WorldRegions::fetchInventories(int x, int z) {
+    waitChunk(x, z);
     uint32_t bytesSize;
     uint32_t srcSize;
     auto bytes = layers[REGION_LAYER_INVENTORIES].getData(x, z, bytesSize, srcSize);
@@ -253,6 +465,7 @@ ChunkInventoriesMap WorldRegions::fetchInventories(int x, int z) {
 }
 
 BlocksMetadata WorldRegions::getBlocksData(int x, int z) {
+    waitChunk(x, z);
     uint32_t bytesSize;
     uint32_t srcSize;
     auto bytes = layers[REGION_LAYER_BLOCKS_DATA].getData(x, z, bytesSize, srcSize);
@@ -275,7 +488,9 @@ void WorldRegions::processInventories(int x, int z, const InventoryProc& func) {
     });
 }
 
-void WorldRegions::processBlocksData(int x, int z, const BlockDataProc& func) {
+void WorldRegions::processBlocksData(
+    int x, int z, const BlockDataProc& func, const BaselineGenerator& baseline
+) {
     auto& voxLayer = layers[REGION_LAYER_VOXELS];
     auto& datLayer = layers[REGION_LAYER_BLOCKS_DATA];
     if (voxLayer.getRegion(x, z) || datLayer.getRegion(x, z)) {
@@ -319,6 +534,20 @@ void WorldRegions::processBlocksData(int x, int z, const BlockDataProc& func) {
             voxData = compression::decompress(
                 voxData.get(), voxLength, voxSrcSize, voxLayer.compression
             );
+            if (chunk_delta::is_delta(voxSrcSize)) {
+                if (baseline == nullptr) {
+                    throw std::runtime_error(
+                        "chunk (" + std::to_string(gx) + ", " +
+                        std::to_string(gz) +
+                        ") is stored as delta and can not be processed "
+                        "without generator"
+                    );
+                }
+                auto chunk = std::make_unique<Chunk>(gx, gz);
+                baseline(gx, gz, chunk->voxels);
+                chunk_delta::apply(voxData.get(), voxSrcSize, chunk->voxels);
+                voxData = chunk->encode();
+            }
 
             BlocksMetadata blocksData;
             blocksData.deserialize(datData.get(), datLength);
@@ -335,21 +564,13 @@ void WorldRegions::processBlocksData(int x, int z, const BlockDataProc& func) {
     }
 }
 
-dv::value WorldRegions::fetchEntities(int x, int z) {
+const ubyte* WorldRegions::fetchEntitiesData(int x, int z, uint32_t& size) {
     if (generatorTestMode) {
         return nullptr;
     }
-    uint32_t bytesSize;
+    waitChunk(x, z);
     uint32_t srcSize;
-    const ubyte* data = layers[REGION_LAYER_ENTITIES].getData(x, z, bytesSize, srcSize);
-    if (data == nullptr) {
-        return nullptr;
-    }
-    auto map = json::from_binary(data, bytesSize);
-    if (map.empty()) {
-        return nullptr;
-    }
-    return map;
+    return layers[REGION_LAYER_ENTITIES].getData(x, z, size, srcSize);
 }
 
 void WorldRegions::processRegion(
@@ -388,6 +609,10 @@ void WorldRegions::processRegion(
     }
 }
 
+RegionsLayer& WorldRegions::getLayer(RegionLayerIndex layerid) {
+    return layers[layerid];
+}
+
 const io::path& WorldRegions::getRegionsFolder(RegionLayerIndex layerid) const {
     return layers[layerid].folder;
 }
@@ -397,17 +622,201 @@ io::path WorldRegions::getRegionFilePath(RegionLayerIndex layerid, int x, int z)
 }
 
 void WorldRegions::writeAll() {
+    if (journal) {
+        if (saver) {
+            // committed when all chunks are put to regions (and journal),
+            // synced by the saver writer thread
+            saver->requestCommit();
+        } else {
+            journal->commit();
+        }
+        if (journal->getSize() >= JOURNAL_CHECKPOINT_SIZE) {
+            checkpoint();
+        }
+        return;
+    }
+    if (saver) {
+        saver->requestWriteAll();
+        return;
+    }
     for (auto& layer : layers) {
         io::create_directories(layer.folder);
         layer.writeAll();
     }
 }
 
+bool WorldRegions::hasChunk(int x, int z) {
+    waitChunk(x, z);
+    return layers[REGION_LAYER_VOXELS].hasChunk(x, z);
+}
+
+void WorldRegions::flushRegion(int x, int z) {
+    if (saver) {
+        saver->unloadRegion(x, z);
+        return;
+    }
+    if (journal) {
+        // region files must not get uncommitted changes
+        journal->commit();
+    }
+    for (auto& layer : layers) {
+        // taken after written, so a failed write does not lose the region
+        auto region = layer.getRegion(x, z);
+        if (region && region->getChunks() && region->isUnsaved()) {
+            io::create_directories(layer.folder);
+            layer.writeRegion(x, z, region);
+            region->setUnsaved(false);
+        }
+        layer.takeRegion(x, z);
+    }
+}
+
+void WorldRegions::startAsyncSaving(int workers) {
+    if (saver == nullptr) {
+        saver = std::make_unique<RegionsSaver>(layers, workers, baselineFactory);
+    }
+}
+
+void WorldRegions::update() {
+    // regions are kept in memory on errors, so they are retried later
+    try {
+        if (saver) {
+            saver->update();
+        }
+        if (memoryBudget) {
+            enforceMemoryBudget();
+        }
+    } catch (const std::exception& err) {
+        logger.error() << "could not write regions: " << err.what();
+    }
+}
+
+bool WorldRegions::writeRegionTo(
+    RegionLayerIndex layerid, int x, int z, const io::path& file
+) {
+    auto& layer = layers[layerid];
+    auto region = layer.takeRegion(x, z);
+    if (region == nullptr) {
+        return false;
+    }
+    layer.writeRegion(x, z, region.get(), file, true);
+    return true;
+}
+
+void WorldRegions::setDeltaStorage(bool flag) {
+    deltaStorage = flag;
+}
+
+void WorldRegions::setBaselineGenerator(
+    BaselineGenerator generator, BaselineGeneratorFactory factory
+) {
+    baselineGenerator = std::move(generator);
+    baselineFactory = std::move(factory);
+}
+
+void WorldRegions::setMemoryBudget(size_t bytes) {
+    memoryBudget = bytes;
+}
+
+size_t WorldRegions::getMemoryUsage() const {
+    size_t total = 0;
+    for (const auto& layer : layers) {
+        total += layer.memoryUsage;
+    }
+    return total;
+}
+
+void WorldRegions::enforceMemoryBudget() {
+    if (getMemoryUsage() <= memoryBudget) {
+        return;
+    }
+    struct RegionUsage {
+        uint64_t lastAccess = 0;
+        size_t memory = 0;
+        bool unsaved = false;
+    };
+    std::unordered_map<glm::ivec2, RegionUsage> usages;
+    for (auto& layer : layers) {
+        std::lock_guard lock(layer.mapMutex);
+        for (const auto& [pos, region] : layer.regions) {
+            auto& usage = usages[pos];
+            usage.lastAccess =
+                std::max(usage.lastAccess, region->getLastAccess());
+            usage.memory += region->getMemoryUsage();
+            usage.unsaved |= region->isUnsaved();
+        }
+    }
+    std::vector<std::pair<glm::ivec2, RegionUsage>> candidates(
+        usages.begin(), usages.end()
+    );
+    std::sort(candidates.begin(), candidates.end(), [](auto& a, auto& b) {
+        return a.second.lastAccess < b.second.lastAccess;
+    });
+    // unload a bit more than required, so regions are not collected
+    // and sorted again on the next update
+    size_t target = memoryBudget * EVICTION_TARGET;
+    size_t memory = getMemoryUsage();
+    if (saver) {
+        // regions being written are unloaded when written
+        for (const auto& [pos, usage] : candidates) {
+            if (saver->isUnloading(pos.x, pos.y)) {
+                memory -= std::min(memory, usage.memory);
+            }
+        }
+    }
+    for (const auto& [pos, usage] : candidates) {
+        if (memory <= target) {
+            break;
+        }
+        // regions with chunks being saved are evicted later
+        if (saver && (saver->hasPendingChunks(pos.x, pos.y) ||
+                      saver->isUnloading(pos.x, pos.y))) {
+            continue;
+        }
+        // region files are written on checkpoints only in journal mode,
+        // so they keep point-in-time state (see checkpoint)
+        if (journal && usage.unsaved) {
+            continue;
+        }
+        flushRegion(pos.x, pos.y);
+        memory -= std::min(memory, usage.memory);
+        evictions++;
+        if (usage.unsaved) {
+            writeBacks++;
+        }
+    }
+}
+
+RegionsCacheStats WorldRegions::getCacheStats() const {
+    RegionsCacheStats stats {};
+    for (const auto& layer : layers) {
+        stats.memoryUsage += layer.memoryUsage;
+        stats.regions += layer.regionsCount;
+        stats.hits += layer.hits;
+        stats.misses += layer.misses;
+    }
+    stats.memoryBudget = memoryBudget;
+    stats.evictions = evictions;
+    stats.writeBacks = writeBacks;
+    return stats;
+}
+
+void WorldRegions::flush() {
+    if (saver) {
+        saver->flush();
+    }
+}
+
+const RegionsSaver* WorldRegions::getSaver() const {
+    return saver.get();
+}
+
 void WorldRegions::deleteRegion(RegionLayerIndex layerid, int x, int z) {
     auto& layer = layers[layerid];
     if (layer.getRegFile({x, z}, false)) {
         throw std::runtime_error("region file is currently in use");
     }
+    layer.waitRegionFileRelease({x, z});
     auto file = layer.getRegionFilePath(x, z);
     if (io::exists(file)) {
         logger.info() << "remove region file " << file.string();
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <condition_variable>
 #include <functional>
 #include <glm/glm.hpp>
@@ -24,6 +25,9 @@ inline constexpr uint REGION_SIZE_BIT = 5;
 inline constexpr uint REGION_SIZE = (1 << (REGION_SIZE_BIT));
 inline constexpr uint REGION_CHUNKS_COUNT = ((REGION_SIZE) * (REGION_SIZE));
 
+class RegionsSaver;
+class RegionsJournal;
+
 class illegal_region_format : public std::runtime_error {
 public:
     illegal_region_format(const std::string& message)
@@ -35,6 +39,14 @@ class WorldRegion {
     std::unique_ptr<std::unique_ptr<ubyte[]>[]> chunksData;
     std::unique_ptr<glm::u32vec2[]> sizes;
     bool unsaved = false;
+    /// @brief Number of the last change (see getVersion)
+    uint64_t version = 0;
+    /// @brief Total size of chunks data
+    size_t dataSize = 0;
+    /// @brief Access order number (see touch)
+    uint64_t lastAccess = 0;
+    /// @brief Layer memory usage counter updated on put (see attach)
+    std::atomic<size_t>* memoryCounter = nullptr;
 public:
     WorldRegion();
     ~WorldRegion();
@@ -46,8 +58,30 @@ public:
     void setUnsaved(bool unsaved);
     bool isUnsaved() const;
 
+    /// @return number of the last change marking region unsaved. Numbers
+    /// are unique for all regions, so a region written in background
+    /// may be checked for changes made since its copy was taken
+    uint64_t getVersion() const;
+
     std::unique_ptr<ubyte[]>* getChunks() const;
     glm::u32vec2* getSizes() const;
+
+    /// @brief Create a deep copy of the region
+    std::unique_ptr<WorldRegion> clone() const;
+
+    /// @brief Mark region as most recently used
+    void touch();
+    uint64_t getLastAccess() const;
+
+    /// @return approximate memory used by the region in bytes
+    size_t getMemoryUsage() const;
+
+    /// @brief Account region memory usage in the counter until detached.
+    /// Chunks data put to the region is accounted too
+    void attach(std::atomic<size_t>* counter);
+
+    /// @brief Subtract region memory usage from the attached counter
+    void detach();
 };
 
 struct regfile {
@@ -59,6 +93,10 @@ struct regfile {
     regfile(const regfile&) = delete;
 
     std::unique_ptr<ubyte[]> read(int index, uint32_t& size, uint32_t& srcSize);
+
+    /// @brief Check if chunk is present in the region file
+    /// @param index chunk index in region
+    bool has(int index);
 };
 
 using RegionsMap = std::unordered_map<glm::ivec2, std::unique_ptr<WorldRegion>>;
@@ -135,6 +173,32 @@ struct RegionsLayer {
     std::mutex regFilesMutex;
     std::condition_variable regFilesCv;
 
+    /// @brief Chunks data journal (nullptr if journal is disabled)
+    RegionsJournal* journal = nullptr;
+
+    /// @brief Sync region files to the storage device when written
+    bool durableWrites = false;
+
+    /// @brief Number of chunks data found in memory by getData
+    std::atomic<uint64_t> hits = 0;
+    /// @brief Number of chunks data read from region files by getData
+    std::atomic<uint64_t> misses = 0;
+
+    /// @brief Memory used by in-memory regions in bytes
+    std::atomic<size_t> memoryUsage = 0;
+    /// @brief Number of in-memory regions
+    std::atomic<size_t> regionsCount = 0;
+
+    /// @brief Number of background writes enqueued per region.
+    /// Region files are not opened until written (guarded by regFilesMutex)
+    std::unordered_map<glm::ivec2, int> pendingWrites;
+
+    /// @brief Number of holds per region file being copied by another
+    /// thread. Held files are not replaced or removed (guarded by
+    /// regFilesMutex)
+    std::unordered_map<glm::ivec2, int> heldFiles;
+    std::condition_variable heldFilesCv;
+
     [[nodiscard]] regfile_ptr getRegFile(glm::ivec2 coord, bool create = true);
     [[nodiscard]] regfile_ptr useRegFile(glm::ivec2 coord);
     regfile_ptr createRegFile(glm::ivec2 coord);
@@ -143,8 +207,26 @@ struct RegionsLayer {
     WorldRegion* getRegion(int x, int z);
     WorldRegion* getOrCreateRegion(int x, int z);
 
+    /// @brief Remove region from memory (is not written)
+    /// @return removed region or nullptr if not loaded
+    std::unique_ptr<WorldRegion> takeRegion(int x, int z);
+
     io::path getRegionFilePath(int x, int z) const;
 
+    /// @brief Put compressed chunk data to region and journal
+    /// @param x chunk x coord
+    /// @param z chunk z coord
+    /// @param data compressed chunk data (nullptr - delete chunk data)
+    /// @param size compressed chunk data length
+    /// @param srcSize source chunk data length
+    void putChunk(
+        int x,
+        int z,
+        std::unique_ptr<ubyte[]> data,
+        uint32_t size,
+        uint32_t srcSize
+    );
+
     /// @brief Get chunk data. Read from file if not loaded yet.
     /// @param x chunk x coord
     /// @param z chunk z coord
@@ -153,14 +235,56 @@ struct RegionsLayer {
     /// @return nullptr if no saved chunk data found
     [[nodiscard]] ubyte* getData(int x, int z, uint32_t& size, uint32_t& srcSize);
 
-    /// @brief Write or rewrite region file
+    /// @brief Check if chunk data is present in memory or in region file
+    /// without reading it
+    /// @param x chunk x coord
+    /// @param z chunk z coord
+    bool hasChunk(int x, int z);
+
+    /// @brief Write or rewrite region file. The file is replaced atomically
     /// @param x region X
     /// @param z region Z
     void writeRegion(int x, int y, WorldRegion* entry);
 
+    /// @brief Write region to the specified file. Chunks missing in the
+    /// entry are read from the region file which is closed then
+    /// @param filename target file (replaced atomically)
+    /// @param durable sync the file to the storage device
+    void writeRegion(
+        int x, int z, WorldRegion* entry, const io::path& filename, bool durable
+    );
+
     /// @brief Write all unsaved regions to files
     void writeAll();
 
+    /// @brief Register background write of the region file.
+    /// Closes the region file if open. Must be called on the main thread
+    void beginRegionWrite(glm::ivec2 coord);
+
+    /// @brief Finish background write of the region file
+    void endRegionWrite(glm::ivec2 coord);
+
+    /// @brief Prevent the region file from being replaced or removed
+    /// until released (the file is being copied by another thread)
+    void holdRegionFile(glm::ivec2 coord);
+
+    /// @brief Release the region file held by holdRegionFile
+    void releaseRegionFile(glm::ivec2 coord);
+
+    /// @brief Wait until the region file is not held
+    void waitRegionFileRelease(glm::ivec2 coord);
+
+    /// @brief Write region file from a background thread (see
+    /// beginRegionWrite). Chunks missing in the entry are read from the
+    /// existing region file
+    /// @return number of bytes written
+    size_t writeRegionFile(int x, int z, WorldRegion* entry);
+
+    /// @brief Write region file to the specified folder (see writeRegionFile)
+    size_t writeRegionFile(
+        int x, int z, WorldRegion* entry, const io::path& folder
+    );
+
     /// @brief Read chunk data from region file
     /// @param x chunk x coord
     /// @param z chunk z coord
@@ -173,11 +297,69 @@ struct RegionsLayer {
     );
 };
 
+struct RegionsCacheStats {
+    /// @brief Memory used by in-memory regions of all layers in bytes
+    size_t memoryUsage = 0;
+    /// @brief Memory budget in bytes (0 - unlimited)
+    size_t memoryBudget = 0;
+    /// @brief Number of in-memory regions of all layers
+    size_t regions = 0;
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    /// @brief Number of regions unloaded to fit the budget
+    uint64_t evictions = 0;
+    /// @brief Number of evicted regions written to files
+    uint64_t writeBacks = 0;
+};
+
 class WorldRegions {
     /// @brief World directory
     io::path directory;
 
     RegionsLayer layers[REGION_LAYERS_COUNT] {};
+
+    /// @brief Asynchronous saving pipeline (nullptr if saving is synchronous)
+    std::unique_ptr<RegionsSaver> saver;
+
+    void waitChunk(int x, int z);
+
+    size_t memoryBudget = 0;
+    uint64_t evictions = 0;
+    uint64_t writeBacks = 0;
+
+    /// @return memory used by in-memory regions of all layers in bytes
+    size_t getMemoryUsage() const;
+
+    /// @brief Unload least recently used regions until memory usage
+    /// fits the budget. Does nothing while the budget is not exceeded
+    void enforceMemoryBudget();
+
+    /// @brief Chunks data journal (nullptr if journal is disabled)
+    std::unique_ptr<RegionsJournal> journal;
+
+    io::path getJournalFile() const;
+
+    /// @brief Apply committed journal records left after crash to
+    /// region files
+    void recoverJournal();
+
+    /// @brief Write all unsaved regions to files durably and truncate
+    /// the journal
+    void checkpoint();
+
+    /// @brief Store chunk voxels as difference with generated baseline
+    bool deltaStorage = false;
+    BaselineGenerator baselineGenerator;
+    /// @brief Creates baseline generators of saver workers
+    BaselineGeneratorFactory baselineFactory;
+
+    /// @brief Encode voxels layer record (full or delta)
+    std::unique_ptr<ubyte[]> encodeVoxels(const Chunk& chunk, uint32_t& size);
+
+    /// @brief Generate baseline and apply delta record to it
+    void applyDelta(
+        int x, int z, const ubyte* data, uint32_t size, voxel* voxels
+    );
 public:
     bool generatorTestMode = false;
     bool doWriteLights = true;
@@ -203,12 +385,17 @@ public:
         size_t size
     );
 
-    /// @brief Get chunk voxels data
+    /// @brief Get chunk voxels data. Delta records are expanded
     /// @param x chunk.x
     /// @param z chunk.z
-    /// @return voxels data buffer or nullptr
+    /// @return voxels data buffer (CHUNK_DATA_LEN) or nullptr
     std::unique_ptr<ubyte[]> getVoxels(int x, int z);
 
+    /// @brief Load saved chunk voxels. Sets chunk generated flag if pristine
+    /// marker is stored
+    /// @return false if no voxels saved
+    bool loadVoxels(Chunk& chunk);
+
     /// @brief Get cached lights for chunk at x,z
     /// @return lights data or nullptr
     std::unique_ptr<light_t[]> getLights(int x, int z);
@@ -217,11 +404,14 @@ public:
 
     BlocksMetadata getBlocksData(int x, int z);
     
-    /// @brief Load saved entities data for chunk
+    /// @brief Get saved entities data (binary json) for chunk without
+    /// decoding it
     /// @param x chunk.x
     /// @param z chunk.z
-    /// @return map with entities list as "data"
-    dv::value fetchEntities(int x, int z);
+    /// @param size output data size
+    /// @return pointer to the region data, valid until the chunk entities
+    /// data is replaced or the region is unloaded; nullptr if no data saved
+    const ubyte* fetchEntitiesData(int x, int z, uint32_t& size);
 
     /// @brief Load, process and save processed region chunks data
     /// @param x region X
@@ -233,20 +423,103 @@ public:
 
     void processInventories(int x, int z, const InventoryProc& func);
 
-    void processBlocksData(int x, int z, const BlockDataProc& func);
+    /// @brief Process blocks data of region chunks with their voxels
+    /// @param baseline generator used to restore voxels of chunks stored
+    /// as delta records (may be used in another thread than the one
+    /// set with setBaselineGenerator)
+    /// @throws std::runtime_error if a chunk is stored as delta record
+    /// and baseline generator is not provided
+    void processBlocksData(
+        int x,
+        int z,
+        const BlockDataProc& func,
+        const BaselineGenerator& baseline = nullptr
+    );
 
     /// @brief Get regions directory by layer index
     /// @param layerid layer index
     /// @return directory path
+    RegionsLayer& getLayer(RegionLayerIndex layerid);
+
     const io::path& getRegionsFolder(RegionLayerIndex layerid) const;
 
     io::path getRegionFilePath(RegionLayerIndex layerid, int x, int z) const;
 
-    /// @brief Write all region layers
+    /// @brief Check if chunk voxels are saved (or put and not written yet)
+    /// @param x chunk.x
+    /// @param z chunk.z
+    bool hasChunk(int x, int z);
+
+    /// @brief Write all region layers. Regions are written in background
+    /// if asynchronous saving is enabled (see flush). If journal is enabled
+    /// only journal is committed (synced in background if saving is
+    /// asynchronous), regions are written when it gets large
     void writeAll();
 
+    /// @brief Enable journaled saving: chunks data put to regions is
+    /// appended to the journal, region files are rewritten rarely.
+    /// Journal left after crash is applied on next WorldRegions creation
+    void enableJournal();
+
+    /// @brief Store voxels of chunks as difference with the world generator
+    /// output: unmodified generated chunks are saved as a pristine marker,
+    /// modified ones as a list of changed voxels. Delta records are always
+    /// readable if baseline generator is set
+    void setDeltaStorage(bool flag);
+
+    /// @brief Set generator used to restore voxels from delta records
+    /// (nullptr - delta records can not be read and are not written)
+    /// @param factory creates generators for asynchronous saving workers,
+    /// so deltas are calculated off the main thread. Must be set before
+    /// startAsyncSaving, otherwise deltas are calculated in put()
+    void setBaselineGenerator(
+        BaselineGenerator generator, BaselineGeneratorFactory factory = nullptr
+    );
+
+    /// @brief Enable asynchronous chunks saving and regions writing
+    /// @param workers number of compression threads
+    void startAsyncSaving(int workers);
+
+    /// @brief Process asynchronous saving results and unload regions
+    /// exceeding memory budget. Must be called on the main thread regularly
+    void update();
+
+    /// @brief Set in-memory regions budget. When exceeded, least recently
+    /// used regions are unloaded on update down to 90% of the budget,
+    /// unsaved ones are written first (only saved ones are unloaded if
+    /// journal is enabled)
+    /// @param bytes budget in bytes (0 - unlimited)
+    void setMemoryBudget(size_t bytes);
+
+    /// @brief Get regions cache counters. Memory usage is tracked on
+    /// regions change, so the call is cheap
+    RegionsCacheStats getCacheStats() const;
+
+    /// @brief Wait until all enqueued chunks saves and regions writes are
+    /// finished (does nothing if saving is synchronous)
+    /// @throws std::runtime_error if some chunks or regions could not be
+    /// saved (see RegionsSaver::flush)
+    void flush();
+
+    /// @return asynchronous saving pipeline or nullptr
+    const RegionsSaver* getSaver() const;
+
+    /// @brief Write region of all layers if unsaved and unload it from memory.
+    /// Journal is committed before
+    /// @param x region X
+    /// @param z region Z
+    void flushRegion(int x, int z);
+
     void deleteRegion(RegionLayerIndex layerid, int x, int z);
 
+    /// @brief Unload in-memory region (processed with processRegion,
+    /// processInventories or processBlocksData) writing it durably to the
+    /// specified file instead of the region file
+    /// @return false if the region is not loaded
+    bool writeRegionTo(
+        RegionLayerIndex layerid, int x, int z, const io::path& file
+    );
+
     /// @brief Extract X and Z from 'X_Z.bin' region file name.
     /// @param name source region file name
     /// @param x parsed X destination
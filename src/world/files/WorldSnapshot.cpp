@@ -0,0 +1,224 @@
+#include "WorldSnapshot.hpp"
+
+#include <map>
+
+#include "debug/Logger.hpp"
+#include "io/devices/ZipFileDevice.hpp"
+#include "WorldFiles.hpp"
+
+static debug::Logger logger("world-snapshot");
+
+namespace fs = std::filesystem;
+
+WorldSnapshot::WorldSnapshot(WorldFiles& wfile, io::path target)
+    : stagingFolder(wfile.getFolder() / STAGING_FOLDER),
+      target(std::move(target)) {
+    if (io::exists(this->target)) {
+        throw std::runtime_error(
+            "snapshot target " + this->target.string() + " already exists"
+        );
+    }
+    try {
+        stage(wfile);
+    } catch (...) {
+        releaseFiles(0);
+        throw;
+    }
+    workTotal = fileCopies.size() + unsavedRegions.size() + 1;
+    thread = std::thread(&WorldSnapshot::run, this);
+}
+
+WorldSnapshot::~WorldSnapshot() {
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+void WorldSnapshot::stage(WorldFiles& wfile) {
+    auto& regions = wfile.getRegions();
+    // wait for in-flight chunks saves and region writes
+    regions.flush();
+
+    auto worldFolder = io::resolve(wfile.getFolder());
+    auto stagingPath = io::resolve(stagingFolder);
+    fs::remove_all(stagingPath);
+    fs::create_directories(stagingPath);
+
+    std::map<fs::path, RegionsLayer*> regionFolders;
+    for (size_t i = 0; i < REGION_LAYERS_COUNT; i++) {
+        auto& layer = regions.getLayer(static_cast<RegionLayerIndex>(i));
+        regionFolders[io::resolve(layer.folder).lexically_normal()] = &layer;
+    }
+    uint linked = 0;
+    auto it = fs::recursive_directory_iterator(worldFolder);
+    for (; it != fs::recursive_directory_iterator(); it++) {
+        const auto& file = it->path();
+        auto relative = file.lexically_relative(worldFolder);
+        auto root = relative.begin()->u8string();
+        // prototypes cache is not a part of the world state
+        if (root == STAGING_FOLDER || root == "prototypes") {
+            it.disable_recursion_pending();
+            continue;
+        }
+        auto dst = stagingPath / relative;
+        if (it->is_directory()) {
+            fs::create_directories(dst);
+            continue;
+        }
+        // journal changes are taken from in-memory regions
+        if (file.extension() == ".tmp" || file.filename() == "regions.journal") {
+            continue;
+        }
+        const auto& found =
+            regionFolders.find(file.parent_path().lexically_normal());
+        int x, z;
+        if (file.extension() == ".bin" && found != regionFolders.end() &&
+            WorldRegions::parseRegionFilename(file.stem().u8string(), x, z)) {
+            std::error_code ec;
+            fs::create_hard_link(file, dst, ec);
+            if (!ec) {
+                linked++;
+                continue;
+            }
+            // copied in background, must not be replaced until then
+            found->second->holdRegionFile({x, z});
+            fileCopies.push_back(FileCopy {file, dst, found->second, {x, z}});
+            continue;
+        }
+        fileCopies.push_back(FileCopy {file, dst, nullptr, {}});
+    }
+    for (size_t i = 0; i < REGION_LAYERS_COUNT; i++) {
+        auto& layer = regions.getLayer(static_cast<RegionLayerIndex>(i));
+        std::lock_guard lock(layer.mapMutex);
+        for (const auto& [pos, region] : layer.regions) {
+            if (region->getChunks() == nullptr || !region->isUnsaved()) {
+                continue;
+            }
+            unsavedRegions.push_back(RegionCopy {&layer, pos, region->clone()});
+        }
+    }
+    logger.info() << "snapshot staged: " << linked << " files linked, "
+                  << fileCopies.size() << " files to copy, "
+                  << unsavedRegions.size() << " unsaved regions";
+}
+
+void WorldSnapshot::copyFiles() {
+    size_t index = 0;
+    try {
+        for (; index < fileCopies.size(); index++) {
+            const auto& copy = fileCopies[index];
+            fs::copy_file(copy.source, copy.destination);
+            if (copy.layer) {
+                copy.layer->releaseRegionFile(copy.pos);
+            }
+            workDone++;
+        }
+    } catch (...) {
+        // release region files left uncopied
+        releaseFiles(index);
+        finishCopies();
+        throw;
+    }
+    finishCopies();
+}
+
+void WorldSnapshot::releaseFiles(size_t from) {
+    for (size_t i = from; i < fileCopies.size(); i++) {
+        const auto& copy = fileCopies[i];
+        if (copy.layer) {
+            copy.layer->releaseRegionFile(copy.pos);
+        }
+    }
+}
+
+void WorldSnapshot::finishCopies() {
+    {
+        std::lock_guard lock(copiesMutex);
+        copiesDone = true;
+    }
+    copiesCv.notify_all();
+}
+
+void WorldSnapshot::run() {
+    try {
+        copyFiles();
+        for (auto& copy : unsavedRegions) {
+            auto folder = stagingFolder / copy.layer->folder.name();
+            io::create_directories(folder);
+            copy.layer->writeRegionFile(
+                copy.pos.x, copy.pos.y, copy.region.get(), folder
+            );
+            copy.region.reset();
+            workDone++;
+        }
+        auto stagingPath = io::resolve(stagingFolder);
+        if (target.extension() == ".zip") {
+            io::write_zip(stagingFolder, target);
+            fs::remove_all(stagingPath);
+        } else {
+            auto targetPath = io::resolve(target);
+            fs::create_directories(targetPath.parent_path());
+            std::error_code ec;
+            fs::rename(stagingPath, targetPath, ec);
+            if (ec) {
+                // target is on another device
+                fs::copy(stagingPath, targetPath, fs::copy_options::recursive);
+                fs::remove_all(stagingPath);
+            }
+        }
+        workDone++;
+    } catch (const std::exception& err) {
+        std::lock_guard lock(errorMutex);
+        error = err.what();
+    }
+    finished = true;
+}
+
+bool WorldSnapshot::isActive() const {
+    return active;
+}
+
+uint WorldSnapshot::getWorkTotal() const {
+    return workTotal;
+}
+
+uint WorldSnapshot::getWorkDone() const {
+    return workDone;
+}
+
+void WorldSnapshot::update() {
+    if (!active || !finished) {
+        return;
+    }
+    if (thread.joinable()) {
+        thread.join();
+    }
+    active = false;
+
+    std::lock_guard lock(errorMutex);
+    if (!error.empty()) {
+        std::error_code ec;
+        fs::remove_all(io::resolve(stagingFolder), ec);
+        throw std::runtime_error("snapshot failed: " + error);
+    }
+    logger.info() << "snapshot written to " << target.string();
+}
+
+void WorldSnapshot::waitForEnd() {
+    if (thread.joinable()) {
+        thread.join();
+    }
+    update();
+}
+
+void WorldSnapshot::waitForCopies() {
+    std::unique_lock lock(copiesMutex);
+    copiesCv.wait(lock, [this]() { return copiesDone; });
+}
+
+void WorldSnapshot::terminate() {
+    if (thread.joinable()) {
+        thread.join();
+    }
+    active = false;
+}
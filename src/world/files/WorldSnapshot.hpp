@@ -0,0 +1,94 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "interfaces/Task.hpp"
+#include "io/io.hpp"
+
+class WorldFiles;
+class WorldRegion;
+struct RegionsLayer;
+
+/// @brief Point-in-time copy of a running world folder.
+///
+/// The world must be saved before the snapshot is created. Creation
+/// (main thread) waits for in-flight region writes, hard-links region files
+/// into a staging folder (region files are replaced on write, never
+/// modified, so links keep the snapshot state) and copies unsaved in-memory
+/// regions. Other files are copied in background: region files that could
+/// not be linked are held from being replaced until copied, world saves
+/// wait for the copying (see waitForCopies). Then unsaved regions are
+/// merged into staged files and the staging folder is moved to the target
+/// directory or archived (target with .zip extension).
+class WorldSnapshot : public Task {
+    /// @brief Unsaved in-memory region copy
+    struct RegionCopy {
+        RegionsLayer* layer;
+        glm::ivec2 pos;
+        std::unique_ptr<WorldRegion> region;
+    };
+    /// @brief File to be copied into the staging folder
+    struct FileCopy {
+        std::filesystem::path source;
+        std::filesystem::path destination;
+        /// @brief Layer of the held region file or nullptr
+        RegionsLayer* layer;
+        glm::ivec2 pos;
+    };
+    io::path stagingFolder;
+    io::path target;
+    std::vector<RegionCopy> unsavedRegions;
+    std::vector<FileCopy> fileCopies;
+
+    std::mutex copiesMutex;
+    std::condition_variable copiesCv;
+    bool copiesDone = false;
+
+    std::thread thread;
+    std::atomic<uint> workDone = 0;
+    uint workTotal = 0;
+    std::atomic<bool> finished = false;
+    bool active = true;
+    std::mutex errorMutex;
+    std::string error;
+
+    void stage(WorldFiles& wfile);
+    void copyFiles();
+    /// @brief Release held region files starting from the index
+    void releaseFiles(size_t from);
+    void finishCopies();
+    void run();
+public:
+    /// @brief Staging folder name inside the world folder
+    static inline const std::string STAGING_FOLDER = ".snapshot";
+
+    /// @param wfile saved world files
+    /// @param target target directory or .zip file (must not exist)
+    WorldSnapshot(WorldFiles& wfile, io::path target);
+    ~WorldSnapshot();
+
+    bool isActive() const override;
+    uint getWorkTotal() const override;
+    uint getWorkDone() const override;
+    /// @brief Check background work completion (rethrows its error)
+    void update() override;
+    void waitForEnd() override;
+    /// @brief Wait until world files are copied into the staging folder.
+    /// Must be called before the world files are written
+    void waitForCopies();
+    /// @brief Wait for background work (it can't be interrupted safely)
+    void terminate() override;
+
+    const io::path& getTarget() const {
+        return target;
+    }
+};
@@ -1,7 +1,11 @@
 #pragma once
 
+#include <functional>
+
 #include "typedefs.hpp"
 
+struct voxel;
+
 enum RegionLayerIndex : uint {
     REGION_LAYER_VOXELS = 0,
     REGION_LAYER_LIGHTS,
@@ -11,3 +15,9 @@ enum RegionLayerIndex : uint {
     
     REGION_LAYERS_COUNT
 };
+
+/// @brief Generate chunk voxels the way the world generator does
+using BaselineGenerator = std::function<void(int x, int z, voxel* dst)>;
+/// @brief Create baseline generator independent from others, so it may
+/// be used in another thread
+using BaselineGeneratorFactory = std::function<BaselineGenerator()>;
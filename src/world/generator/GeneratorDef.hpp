@@ -128,6 +128,10 @@ public:
 
     virtual void initialize(uint64_t seed) = 0;
 
+    /// @brief Create an independent not initialized instance of the script
+    /// to be used in another thread
+    virtual std::unique_ptr<GeneratorScript> clone() const = 0;
+
     /// @brief Generate a heightmap with values in range 0..1
     /// @param offset position of the heightmap in the world
     /// @param size size of the heightmap
@@ -222,6 +226,10 @@ struct GeneratorDef {
     /// structures placement triggered
     uint wideStructsChunksRadius = 3;
 
+    /// @brief Size of the area (in chunks) generated by a single
+    /// generate_heightmap / generate_biome_parameters call
+    uint areaChunks = 1;
+
     /// @brief Indices of biome parameter maps passed to generate_heightmap
     std::vector<uint8_t> heightmapInputs;
 
@@ -0,0 +1,359 @@
+#include "PrototypeCache.hpp"
+
+#include <functional>
+
+#include "coders/byte_utils.hpp"
+#include "content/Content.hpp"
+#include "debug/Logger.hpp"
+#include "io/io.hpp"
+#include "voxels/Block.hpp"
+#include "world/files/WorldRegions.hpp"
+#include "GeneratorDef.hpp"
+#include "WorldGenerator.hpp"
+
+static debug::Logger logger("prototype-cache");
+
+/// @brief Spilled prototype format version. Must be incremented on
+/// serialization changes to invalidate existing spill files
+inline constexpr int PROTOTYPE_FORMAT_VERSION = 1;
+
+/// @brief Number of spilled prototypes kept in memory before writing
+inline constexpr uint SPILL_WRITE_THRESHOLD = REGION_CHUNKS_COUNT;
+
+enum PlacementType : ubyte {
+    PLACEMENT_STRUCTURE = 0,
+    PLACEMENT_LINE,
+};
+
+/// @brief Create spill folder info used to detect generator,
+/// seed or content change
+static dv::value create_info(
+    const GeneratorDef& def, const Content& content, uint64_t seed
+) {
+    std::string key;
+    for (const auto& biome : def.biomes) {
+        key += biome.name + ";";
+    }
+    for (const auto& structure : def.structures) {
+        key += structure->meta.name + ";";
+    }
+    for (const auto& block : content.getIndices()->blocks.getIterable()) {
+        key += block->name + ";";
+    }
+    key += std::to_string(CHUNK_W) + ";" + std::to_string(CHUNK_D) + ";";
+    key += std::to_string(def.biomesBPD) + ";" + std::to_string(def.heightsBPD);
+    key += ";" + std::to_string(def.areaChunks);
+
+    dv::value info = dv::object();
+    info["version"] = PROTOTYPE_FORMAT_VERSION;
+    info["generator"] = def.name;
+    info["seed"] = static_cast<integer_t>(seed);
+    info["content-hash"] =
+        static_cast<integer_t>(std::hash<std::string>()(key));
+    return info;
+}
+
+static bool is_same_info(const dv::value& a, const dv::value& b) {
+    for (const auto& key : {"version", "seed", "content-hash"}) {
+        if (!a.has(key) || a[key].asInteger() != b[key].asInteger()) {
+            return false;
+        }
+    }
+    return a.has("generator") &&
+           a["generator"].asString() == b["generator"].asString();
+}
+
+PrototypeCache::PrototypeCache(
+    const GeneratorDef& def,
+    const Content& content,
+    uint64_t seed,
+    size_t capacity,
+    io::path spillFolder
+)
+    : def(def), capacity(capacity) {
+    if (spillFolder.empty()) {
+        return;
+    }
+    auto info = create_info(def, content, seed);
+    auto infoFile = spillFolder / "info.json";
+    if (io::exists(spillFolder)) {
+        bool valid = false;
+        try {
+            valid = io::is_regular_file(infoFile) &&
+                    is_same_info(io::read_json(infoFile), info);
+        } catch (const std::exception& err) {
+            logger.error() << "could not read " << infoFile.string() << ": "
+                           << err.what();
+        }
+        if (!valid) {
+            logger.info() << "generator or content changed, deleting "
+                          << spillFolder.string();
+            io::remove_all(spillFolder);
+        }
+    }
+    io::create_directories(spillFolder);
+    io::write_json(infoFile, info);
+
+    spill = std::make_unique<RegionsLayer>();
+    spill->folder = std::move(spillFolder);
+    spill->compression = compression::Method::GZIP;
+}
+
+PrototypeCache::~PrototypeCache() {
+    try {
+        flush();
+    } catch (const std::exception& err) {
+        logger.error() << "could not write prototypes: " << err.what();
+    }
+    logger.info() << "hits: " << stats.hits << ", disk hits: "
+                  << stats.diskHits << ", misses: " << stats.misses
+                  << ", spilled: " << stats.spilled;
+}
+
+void PrototypeCache::put(
+    const glm::ivec2& pos, std::unique_ptr<ChunkPrototype> prototype
+) {
+    if (prototype->level < ChunkPrototypeLevel::WIDE_STRUCTS) {
+        return;
+    }
+    if (prototype->level == ChunkPrototypeLevel::BIOMES) {
+        // heightmap inputs are not stored, so biomes will be regenerated
+        prototype->level = ChunkPrototypeLevel::WIDE_STRUCTS;
+    }
+    if (prototype->level < ChunkPrototypeLevel::HEIGHTMAP) {
+        prototype->biomes.reset();
+        prototype->heightmap.reset();
+    }
+    // received placements are restored by neighbour prototypes
+    prototype->placements.clear();
+    prototype->heightmapInputs.clear();
+
+    const auto& found = entries.find(pos);
+    if (found != entries.end()) {
+        order.erase(found->second.orderIt);
+        entries.erase(found);
+    }
+    order.push_front(pos);
+    entries[pos] = Entry {std::move(prototype), order.begin()};
+
+    while (entries.size() > capacity) {
+        const auto& lastPos = order.back();
+        auto& entry = entries.at(lastPos);
+        if (spill) {
+            spillPrototype(lastPos, *entry.prototype);
+        }
+        entries.erase(lastPos);
+        order.pop_back();
+    }
+}
+
+std::unique_ptr<ChunkPrototype> PrototypeCache::pop(const glm::ivec2& pos) {
+    const auto& found = entries.find(pos);
+    if (found != entries.end()) {
+        auto prototype = std::move(found->second.prototype);
+        order.erase(found->second.orderIt);
+        entries.erase(found);
+        stats.hits++;
+        return prototype;
+    }
+    if (spill) {
+        if (auto prototype = readSpilled(pos)) {
+            stats.diskHits++;
+            return prototype;
+        }
+    }
+    stats.misses++;
+    return nullptr;
+}
+
+void PrototypeCache::flush() {
+    if (spill == nullptr) {
+        return;
+    }
+    for (const auto& [pos, entry] : entries) {
+        spillPrototype(pos, *entry.prototype);
+    }
+    writeSpilled();
+}
+
+void PrototypeCache::spillPrototype(
+    const glm::ivec2& pos, const ChunkPrototype& prototype
+) {
+    auto bytes = serialize(prototype);
+    size_t size;
+    auto data = compression::compress(
+        bytes.data(), bytes.size(), size, spill->compression
+    );
+    int regionX, regionZ, localX, localZ;
+    calc_reg_coords(pos.x, pos.y, regionX, regionZ, localX, localZ);
+
+    auto region = spill->getOrCreateRegion(regionX, regionZ);
+    region->put(localX, localZ, std::move(data), size, bytes.size());
+    region->setUnsaved(true);
+    stats.spilled++;
+
+    if (++spillPending >= SPILL_WRITE_THRESHOLD) {
+        writeSpilled();
+    }
+}
+
+void PrototypeCache::writeSpilled() {
+    spill->writeAll();
+    std::lock_guard lock(spill->mapMutex);
+    spill->regions.clear();
+    spillPending = 0;
+}
+
+std::unique_ptr<ChunkPrototype> PrototypeCache::readSpilled(
+    const glm::ivec2& pos
+) {
+    int regionX, regionZ, localX, localZ;
+    calc_reg_coords(pos.x, pos.y, regionX, regionZ, localX, localZ);
+
+    uint32_t size = 0;
+    uint32_t srcSize = 0;
+    const ubyte* data = nullptr;
+    std::unique_ptr<ubyte[]> fileData;
+    if (auto region = spill->getRegion(regionX, regionZ)) {
+        data = region->getChunkData(localX, localZ);
+        auto sizes = region->getChunkDataSize(localX, localZ);
+        size = sizes[0];
+        srcSize = sizes[1];
+    }
+    if (data == nullptr) {
+        auto regfile = spill->getRegFile({regionX, regionZ});
+        if (regfile == nullptr) {
+            return nullptr;
+        }
+        fileData = RegionsLayer::readChunkData(
+            pos.x, pos.y, size, srcSize, regfile.get()
+        );
+        data = fileData.get();
+    }
+    if (data == nullptr) {
+        return nullptr;
+    }
+    try {
+        auto bytes = compression::decompress(
+            data, size, srcSize, spill->compression
+        );
+        return deserialize(bytes.get(), srcSize);
+    } catch (const std::exception& err) {
+        logger.error() << "could not read prototype " << pos.x << ", "
+                       << pos.y << ": " << err.what();
+        return nullptr;
+    }
+}
+
+static void write_placements(
+    ByteBuilder& builder, const std::vector<Placement>& placements
+) {
+    builder.putInt32(placements.size());
+    for (const auto& placement : placements) {
+        builder.putInt32(placement.priority);
+        if (auto sp = std::get_if<StructurePlacement>(&placement.placement)) {
+            builder.put(PLACEMENT_STRUCTURE);
+            builder.putInt32(sp->structure);
+            builder.putInt32(sp->position.x);
+            builder.putInt32(sp->position.y);
+            builder.putInt32(sp->position.z);
+            builder.put(sp->rotation);
+        } else {
+            const auto& line = std::get<LinePlacement>(placement.placement);
+            builder.put(PLACEMENT_LINE);
+            builder.putInt16(line.block);
+            builder.putInt32(line.a.x);
+            builder.putInt32(line.a.y);
+            builder.putInt32(line.a.z);
+            builder.putInt32(line.b.x);
+            builder.putInt32(line.b.y);
+            builder.putInt32(line.b.z);
+            builder.putInt32(line.radius);
+        }
+    }
+}
+
+static glm::ivec3 read_ivec3(ByteReader& reader) {
+    int x = reader.getInt32();
+    int y = reader.getInt32();
+    int z = reader.getInt32();
+    return {x, y, z};
+}
+
+static std::vector<Placement> read_placements(ByteReader& reader) {
+    std::vector<Placement> placements;
+    int count = reader.getInt32();
+    placements.reserve(count);
+    for (int i = 0; i < count; i++) {
+        int priority = reader.getInt32();
+        if (reader.get() == PLACEMENT_STRUCTURE) {
+            int structure = reader.getInt32();
+            auto position = read_ivec3(reader);
+            uint8_t rotation = reader.get();
+            placements.emplace_back(
+                priority, StructurePlacement(structure, position, rotation)
+            );
+        } else {
+            blockid_t block = reader.getInt16();
+            auto a = read_ivec3(reader);
+            auto b = read_ivec3(reader);
+            int radius = reader.getInt32();
+            placements.emplace_back(
+                priority, LinePlacement(block, a, b, radius)
+            );
+        }
+    }
+    return placements;
+}
+
+std::vector<ubyte> PrototypeCache::serialize(
+    const ChunkPrototype& prototype
+) const {
+    ByteBuilder builder;
+    builder.put(static_cast<ubyte>(prototype.level));
+    write_placements(builder, prototype.widePlacements);
+    if (prototype.level >= ChunkPrototypeLevel::HEIGHTMAP) {
+        const Biome* biomesBase = def.biomes.data();
+        for (uint i = 0; i < CHUNK_W * CHUNK_D; i++) {
+            builder.putInt16(prototype.biomes[i] - biomesBase);
+        }
+        const float* heights = prototype.heightmap->getValues();
+        for (uint i = 0; i < CHUNK_W * CHUNK_D; i++) {
+            builder.putFloat32(heights[i]);
+        }
+    }
+    if (prototype.level >= ChunkPrototypeLevel::STRUCTURES) {
+        write_placements(builder, prototype.ownPlacements);
+    }
+    return builder.build();
+}
+
+std::unique_ptr<ChunkPrototype> PrototypeCache::deserialize(
+    const ubyte* src, size_t size
+) const {
+    ByteReader reader(src, size);
+    auto prototype = std::make_unique<ChunkPrototype>();
+    prototype->level = static_cast<ChunkPrototypeLevel>(reader.get());
+    prototype->widePlacements = read_placements(reader);
+    if (prototype->level >= ChunkPrototypeLevel::HEIGHTMAP) {
+        auto biomes = std::make_unique<const Biome*[]>(CHUNK_W * CHUNK_D);
+        for (uint i = 0; i < CHUNK_W * CHUNK_D; i++) {
+            uint16_t index = reader.getInt16();
+            if (index >= def.biomes.size()) {
+                throw std::runtime_error("invalid biome index");
+            }
+            biomes[i] = &def.biomes[index];
+        }
+        std::vector<float> heights(CHUNK_W * CHUNK_D);
+        for (uint i = 0; i < CHUNK_W * CHUNK_D; i++) {
+            heights[i] = reader.getFloat32();
+        }
+        prototype->biomes = std::move(biomes);
+        prototype->heightmap =
+            std::make_shared<Heightmap>(CHUNK_W, CHUNK_D, std::move(heights));
+    }
+    if (prototype->level >= ChunkPrototypeLevel::STRUCTURES) {
+        prototype->ownPlacements = read_placements(reader);
+    }
+    return prototype;
+}
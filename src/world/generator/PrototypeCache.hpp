@@ -0,0 +1,99 @@
+#pragma once
+
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/glm.hpp>
+#include <glm/gtx/hash.hpp>
+
+#include "io/path.hpp"
+#include "typedefs.hpp"
+
+class Content;
+struct GeneratorDef;
+struct ChunkPrototype;
+struct RegionsLayer;
+
+struct PrototypeCacheStats {
+    /// @brief Number of prototypes restored from memory
+    uint64_t hits = 0;
+    /// @brief Number of prototypes restored from spill files
+    uint64_t diskHits = 0;
+    /// @brief Number of prototypes not found in cache
+    uint64_t misses = 0;
+    /// @brief Number of prototypes written to spill files
+    uint64_t spilled = 0;
+};
+
+/// @brief Bounded LRU cache of chunk prototypes that left the world
+/// generator area. Evicted prototypes may be spilled to region files.
+/// Cached prototypes contain results not depending on neighbour chunks only:
+/// biomes, heightmap and placements made by the chunk itself
+/// (see ChunkPrototype::cachedLevel).
+class PrototypeCache {
+    const GeneratorDef& def;
+    /// @brief Max number of prototypes kept in memory
+    size_t capacity;
+    /// @brief Least recently used positions at the back
+    std::list<glm::ivec2> order;
+
+    struct Entry {
+        std::unique_ptr<ChunkPrototype> prototype;
+        std::list<glm::ivec2>::iterator orderIt;
+    };
+    std::unordered_map<glm::ivec2, Entry> entries;
+
+    /// @brief Spill files layer (nullptr if spill is disabled)
+    std::unique_ptr<RegionsLayer> spill;
+    /// @brief Number of spilled prototypes not written to files yet
+    uint spillPending = 0;
+
+    PrototypeCacheStats stats {};
+
+    void spillPrototype(const glm::ivec2& pos, const ChunkPrototype& prototype);
+    std::unique_ptr<ChunkPrototype> readSpilled(const glm::ivec2& pos);
+    void writeSpilled();
+
+    std::vector<ubyte> serialize(const ChunkPrototype& prototype) const;
+    std::unique_ptr<ChunkPrototype> deserialize(
+        const ubyte* src, size_t size
+    ) const;
+public:
+    /// @param def generator definition
+    /// @param content world content (used to validate spill files)
+    /// @param seed world seed (used to validate spill files)
+    /// @param capacity max number of prototypes kept in memory
+    /// @param spillFolder spill files folder (empty path - spill disabled).
+    /// Folder contents are deleted if created for other generator or content
+    PrototypeCache(
+        const GeneratorDef& def,
+        const Content& content,
+        uint64_t seed,
+        size_t capacity,
+        io::path spillFolder = ""
+    );
+    ~PrototypeCache();
+
+    /// @brief Store prototype. Prototype must have at least WIDE_STRUCTS
+    /// level, BIOMES level is stored as WIDE_STRUCTS.
+    void put(const glm::ivec2& pos, std::unique_ptr<ChunkPrototype> prototype);
+
+    /// @brief Take prototype out of cache
+    /// @return nullptr if not found in memory or in spill files
+    std::unique_ptr<ChunkPrototype> pop(const glm::ivec2& pos);
+
+    /// @brief Spill all in-memory prototypes (if spill is enabled)
+    /// and write spill files
+    void flush();
+
+    size_t size() const {
+        return entries.size();
+    }
+
+    const PrototypeCacheStats& getStats() const {
+        return stats;
+    }
+};
@@ -8,6 +8,7 @@
 #include "voxels/Block.hpp"
 #include "voxels/Chunk.hpp"
 #include "GeneratorDef.hpp"
+#include "PrototypeCache.hpp"
 #include "VoxelFragment.hpp"
 #include "util/timeutil.hpp"
 #include "util/listutil.hpp"
@@ -25,13 +26,32 @@ static inline constexpr uint BASIC_PROTOTYPE_LAYERS = 5;
 
 WorldGenerator::WorldGenerator(
     const GeneratorDef& def, const Content& content, uint64_t seed
+)
+    : WorldGenerator(def, content, seed, nullptr) {
+}
+
+WorldGenerator::WorldGenerator(
+    const GeneratorDef& def,
+    const Content& content,
+    uint64_t seed,
+    std::unique_ptr<GeneratorScript> scriptInstance
 )
     : def(def), 
       content(content), 
       seed(seed),
-      surroundMap(0, BASIC_PROTOTYPE_LAYERS + def.wideStructsChunksRadius * 2)
+      ownScript(std::move(scriptInstance)),
+      script(ownScript ? ownScript.get() : def.script.get()),
+      surroundMap(0, BASIC_PROTOTYPE_LAYERS + def.wideStructsChunksRadius * 2),
+      areaChunks(static_cast<int>(std::max(1u, def.areaChunks)))
 {
-    def.script->initialize(seed);
+    script->initialize(seed);
+
+    if (areaChunks > 1 && (CHUNK_W % def.biomesBPD || CHUNK_D % def.biomesBPD ||
+                           CHUNK_W % def.heightsBPD || CHUNK_D % def.heightsBPD)) {
+        logger.warning() << "area generation requires chunk size to be "
+            "divisible by biomes-bpd and heights-bpd, area-chunks is ignored";
+        areaChunks = 1;
+    }
 
     uint levels = BASIC_PROTOTYPE_LAYERS + def.wideStructsChunksRadius * 2;
 
@@ -43,12 +63,23 @@ WorldGenerator::WorldGenerator(
             logger.warning() << "unable to remove non-existing chunk prototype";
             return;
         }
+        if (prototypeCache) {
+            prototypeCache->put({x, z}, std::move(found->second));
+        }
         prototypes.erase({x, z});
     });
     surroundMap.setLevelCallback(1, [this](int const x, int const z) {
         if (prototypes.find({x, z}) != prototypes.end()) {
             return;
         }
+        if (prototypeCache) {
+            if (auto prototype = prototypeCache->pop({x, z})) {
+                prototype->cachedLevel = prototype->level;
+                prototype->level = ChunkPrototypeLevel::VOID;
+                prototypes[{x, z}] = std::move(prototype);
+                return;
+            }
+        }
         prototypes[{x, z}] = generatePrototype(x, z);
     });
     surroundMap.setLevelCallback(def.wideStructsChunksRadius + 1, 
@@ -74,7 +105,27 @@ WorldGenerator::WorldGenerator(
     }
 }
 
-WorldGenerator::~WorldGenerator() {}
+std::function<void(int x, int z, voxel* voxels)>
+WorldGenerator::createStandalone(
+    const GeneratorDef& def, const Content& content, uint64_t seed
+) {
+    auto generator = std::make_shared<WorldGenerator>(
+        def, content, seed, def.script->clone()
+    );
+    return [generator](int x, int z, voxel* voxels) {
+        // minimal area around the chunk
+        generator->update(x, z, 1);
+        generator->generate(voxels, x, z);
+    };
+}
+
+WorldGenerator::~WorldGenerator() {
+    if (prototypeCache) {
+        for (auto& [pos, prototype] : prototypes) {
+            prototypeCache->put(pos, std::move(prototype));
+        }
+    }
+}
 
 ChunkPrototype& WorldGenerator::requirePrototype(int x, int z) {
     const auto& found = prototypes.find({x, z});
@@ -230,10 +281,12 @@ void WorldGenerator::generateStructuresWide(
     if (prototype.level >= ChunkPrototypeLevel::WIDE_STRUCTS) {
         return;
     }
-    auto placements = def.script->placeStructuresWide(
-        {chunkX * CHUNK_W, chunkZ * CHUNK_D}, {CHUNK_W, CHUNK_D}, CHUNK_H
-    );
-    placeStructures(placements, prototype, chunkX, chunkZ);
+    if (prototype.cachedLevel < ChunkPrototypeLevel::WIDE_STRUCTS) {
+        prototype.widePlacements = script->placeStructuresWide(
+            {chunkX * CHUNK_W, chunkZ * CHUNK_D}, {CHUNK_W, CHUNK_D}, CHUNK_H
+        );
+    }
+    placeStructures(prototype.widePlacements, prototype, chunkX, chunkZ);
 
     prototype.level = ChunkPrototypeLevel::WIDE_STRUCTS;
 }
@@ -244,14 +297,23 @@ void WorldGenerator::generateStructures(
     if (prototype.level >= ChunkPrototypeLevel::STRUCTURES) {
         return;
     }
+    if (prototype.cachedLevel < ChunkPrototypeLevel::STRUCTURES) {
+        prototype.ownPlacements = findStructures(prototype, chunkX, chunkZ);
+    }
+    placeStructures(prototype.ownPlacements, prototype, chunkX, chunkZ);
+    prototype.level = ChunkPrototypeLevel::STRUCTURES;
+}
+
+std::vector<Placement> WorldGenerator::findStructures(
+    const ChunkPrototype& prototype, int chunkX, int chunkZ
+) {
     const auto& biomes = prototype.biomes;
     const auto& heightmap = prototype.heightmap;
 
-    auto placements = def.script->placeStructures(
+    auto placements = script->placeStructures(
         {chunkX * CHUNK_W, chunkZ * CHUNK_D}, {CHUNK_W, CHUNK_D},
         heightmap, CHUNK_H
     );
-    placeStructures(placements, prototype, chunkX, chunkZ);
 
     util::PseudoRandom structsRand;
     structsRand.setSeed(chunkX, chunkZ);
@@ -276,19 +338,12 @@ void WorldGenerator::generateStructures(
             glm::ivec3 position {x, height-structure.meta.lowering, z};
             position.x -= fragment.getSize().x / 2;
             position.z -= fragment.getSize().z / 2;
-            placeStructure(
-                StructurePlacement {
-                    structureId,
-                    position,
-                    rotation
-                },
-                1,
-                chunkX, 
-                chunkZ
+            placements.emplace_back(
+                1, StructurePlacement {structureId, position, rotation}
             );
         }
     }
-    prototype.level = ChunkPrototypeLevel::STRUCTURES;
+    return placements;
 }
 
 void WorldGenerator::generateBiomes(
@@ -297,8 +352,32 @@ void WorldGenerator::generateBiomes(
     if (prototype.level >= ChunkPrototypeLevel::BIOMES) {
         return;
     }
+    if (prototype.cachedLevel >= ChunkPrototypeLevel::HEIGHTMAP) {
+        prototype.level = ChunkPrototypeLevel::BIOMES;
+        return;
+    }
+    const auto& biomes = def.biomes;
+
+    if (areaChunks > 1) {
+        auto& area = requireArea(chunkX, chunkZ);
+        int offsetX = (chunkX - floordiv(chunkX, areaChunks) * areaChunks) * CHUNK_W;
+        int offsetZ = (chunkZ - floordiv(chunkZ, areaChunks) * areaChunks) * CHUNK_D;
+
+        auto chunkBiomes = std::make_unique<const Biome*[]>(CHUNK_W*CHUNK_D);
+        for (uint z = 0; z < CHUNK_D; z++) {
+            for (uint x = 0; x < CHUNK_W; x++) {
+                chunkBiomes.get()[z * CHUNK_W + x] = choose_biome(
+                    biomes, area.biomeParams, offsetX + x, offsetZ + z
+                );
+            }
+        }
+        prototype.biomes = std::move(chunkBiomes);
+        prototype.level = ChunkPrototypeLevel::BIOMES;
+        return;
+    }
+
     uint bpd = def.biomesBPD;
-    auto biomeParams = def.script->generateParameterMaps(
+    auto biomeParams = script->generateParameterMaps(
         {floordiv(chunkX * CHUNK_W, bpd), floordiv(chunkZ * CHUNK_D, bpd)},
         {floordiv(CHUNK_W, bpd)+1, floordiv(CHUNK_D, bpd)+1},
         bpd
@@ -319,7 +398,6 @@ void WorldGenerator::generateBiomes(
         );
         map->crop(0, 0, CHUNK_W, CHUNK_D);
     }
-    const auto& biomes = def.biomes;
 
     auto chunkBiomes = std::make_unique<const Biome*[]>(CHUNK_W*CHUNK_D);
     for (uint z = 0; z < CHUNK_D; z++) {
@@ -338,8 +416,38 @@ void WorldGenerator::generateHeightmap(
     if (prototype.level >= ChunkPrototypeLevel::HEIGHTMAP) {
         return;
     }
+    if (prototype.cachedLevel >= ChunkPrototypeLevel::HEIGHTMAP) {
+        prototype.level = ChunkPrototypeLevel::HEIGHTMAP;
+        return;
+    }
+    if (areaChunks > 1) {
+        int areaX = floordiv(chunkX, areaChunks);
+        int areaZ = floordiv(chunkZ, areaChunks);
+        auto& area = requireArea(chunkX, chunkZ);
+        if (area.heightmap == nullptr) {
+            generateAreaHeightmap(area, areaX, areaZ);
+        }
+        const auto& areaMap = *area.heightmap;
+        int offsetX = (chunkX - areaX * areaChunks) * CHUNK_W;
+        int offsetZ = (chunkZ - areaZ * areaChunks) * CHUNK_D;
+
+        std::vector<float> values(CHUNK_W * CHUNK_D);
+        const float* src = areaMap.getValues();
+        for (uint z = 0; z < CHUNK_D; z++) {
+            std::memcpy(
+                values.data() + z * CHUNK_W,
+                src + (offsetZ + z) * areaMap.getWidth() + offsetX,
+                CHUNK_W * sizeof(float)
+            );
+        }
+        prototype.heightmap =
+            std::make_shared<Heightmap>(CHUNK_W, CHUNK_D, std::move(values));
+        prototype.level = ChunkPrototypeLevel::HEIGHTMAP;
+        return;
+    }
+
     uint bpd = def.heightsBPD;
-    prototype.heightmap = def.script->generateHeightmap(
+    prototype.heightmap = script->generateHeightmap(
         {floordiv(chunkX * CHUNK_W, bpd), floordiv(chunkZ * CHUNK_D, bpd)},
         {floordiv(CHUNK_W, bpd)+1, floordiv(CHUNK_D, bpd)+1},
         bpd,
@@ -353,10 +461,87 @@ void WorldGenerator::generateHeightmap(
     prototype.level = ChunkPrototypeLevel::HEIGHTMAP;
 }
 
+GeneratorArea& WorldGenerator::requireArea(int chunkX, int chunkZ) {
+    glm::ivec2 key(floordiv(chunkX, areaChunks), floordiv(chunkZ, areaChunks));
+    const auto& found = areas.find(key);
+    if (found != areas.end()) {
+        return *found->second;
+    }
+    auto area = std::make_unique<GeneratorArea>();
+    generateAreaBiomes(*area, key.x, key.y);
+    auto& ref = *area;
+    areas[key] = std::move(area);
+    return ref;
+}
+
+void WorldGenerator::generateAreaBiomes(
+    GeneratorArea& area, int areaX, int areaZ
+) {
+    uint bpd = def.biomesBPD;
+    int width = CHUNK_W * areaChunks;
+    int depth = CHUNK_D * areaChunks;
+    area.biomeParams = script->generateParameterMaps(
+        {floordiv(areaX * width, bpd), floordiv(areaZ * depth, bpd)},
+        {floordiv(width, bpd)+1, floordiv(depth, bpd)+1},
+        bpd
+    );
+    for (auto index : def.heightmapInputs) {
+        // copy non-scaled maps
+        auto copy = std::make_shared<Heightmap>(*area.biomeParams[index]);
+        copy->resize(
+            floordiv(width, def.heightsBPD) + 1,
+            floordiv(depth, def.heightsBPD) + 1,
+            def.heightsInterpolation
+        );
+        area.heightmapInputs.push_back(std::move(copy));
+    }
+    for (const auto& map : area.biomeParams) {
+        map->resize(width + bpd, depth + bpd, def.biomesInterpolation);
+        map->crop(0, 0, width, depth);
+    }
+}
+
+void WorldGenerator::generateAreaHeightmap(
+    GeneratorArea& area, int areaX, int areaZ
+) {
+    uint bpd = def.heightsBPD;
+    int width = CHUNK_W * areaChunks;
+    int depth = CHUNK_D * areaChunks;
+    area.heightmap = script->generateHeightmap(
+        {floordiv(areaX * width, bpd), floordiv(areaZ * depth, bpd)},
+        {floordiv(width, bpd)+1, floordiv(depth, bpd)+1},
+        bpd,
+        area.heightmapInputs
+    );
+    area.heightmap->clamp();
+    area.heightmap->resize(width + bpd, depth + bpd, def.heightsInterpolation);
+    area.heightmap->crop(0, 0, width, depth);
+    area.heightmapInputs.clear();
+}
+
+void WorldGenerator::cleanupAreas() {
+    const auto& map = surroundMap.getArea();
+    int minX = floordiv(map.getOffsetX(), areaChunks);
+    int minZ = floordiv(map.getOffsetY(), areaChunks);
+    int maxX = floordiv(map.getOffsetX() + map.getWidth() - 1, areaChunks);
+    int maxZ = floordiv(map.getOffsetY() + map.getHeight() - 1, areaChunks);
+    for (auto it = areas.begin(); it != areas.end();) {
+        const auto& pos = it->first;
+        if (pos.x < minX || pos.x > maxX || pos.y < minZ || pos.y > maxZ) {
+            it = areas.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
 void WorldGenerator::update(int centerX, int centerY, int loadDistance) {
     surroundMap.setCenter(centerX, centerY);
     surroundMap.resize(loadDistance);
     surroundMap.setCenter(centerX, centerY);
+    if (areaChunks > 1) {
+        cleanupAreas();
+    }
 }
 
 void WorldGenerator::generatePlants(
@@ -609,6 +794,16 @@ WorldGenDebugInfo WorldGenerator::createDebugInfo() const {
     };
 }
 
+void WorldGenerator::setPrototypeCache(
+    std::unique_ptr<PrototypeCache> cache
+) {
+    prototypeCache = std::move(cache);
+}
+
+const PrototypeCache* WorldGenerator::getPrototypeCache() const {
+    return prototypeCache.get();
+}
+
 uint64_t WorldGenerator::getSeed() const {
     return seed;
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <array>
+#include <functional>
 #include <string>
 #include <memory>
 #include <vector>
@@ -13,6 +14,8 @@
 #include "StructurePlacement.hpp"
 
 class Content;
+class GeneratorScript;
+class PrototypeCache;
 struct GeneratorDef;
 class Heightmap;
 struct Biome;
@@ -33,8 +36,33 @@ struct ChunkPrototype {
 
     std::vector<Placement> placements;
 
+    /// @brief wide structures placements made by this chunk
+    std::vector<Placement> widePlacements;
+
+    /// @brief structures placements made by this chunk (including biome
+    /// structures)
+    std::vector<Placement> ownPlacements;
+
     /// @brief biome parameters maps saved until heightmaps generation
     std::vector<std::shared_ptr<Heightmap>> heightmapInputs {};
+
+    /// @brief level of the prototype restored from PrototypeCache.
+    /// Restored stages use cached results instead of script calls
+    ChunkPrototypeLevel cachedLevel = ChunkPrototypeLevel::VOID;
+};
+
+/// @brief Biome parameter maps and heightmap generated for an area of
+/// NxN chunks by single script calls (see GeneratorDef::areaChunks).
+/// Chunk prototypes maps are sliced from the area maps.
+struct GeneratorArea {
+    /// @brief biome parameter maps scaled to blocks
+    std::vector<std::shared_ptr<Heightmap>> biomeParams;
+
+    /// @brief biome parameter maps passed to generate_heightmap
+    std::vector<std::shared_ptr<Heightmap>> heightmapInputs;
+
+    /// @brief area heightmap scaled to blocks (nullptr until generated)
+    std::shared_ptr<Heightmap> heightmap;
 };
 
 struct WorldGenDebugInfo {
@@ -53,10 +81,20 @@ class WorldGenerator {
     const Content& content;
     /// @param seed world seed
     uint64_t seed;
+    /// @brief Own script instance (if specified on construction)
+    std::unique_ptr<GeneratorScript> ownScript;
+    /// @brief Script used for generation (def.script or ownScript)
+    GeneratorScript* script;
     /// @brief Chunk prototypes main storage
     std::unordered_map<glm::ivec2, std::unique_ptr<ChunkPrototype>> prototypes;
     /// @brief Chunk prototypes loading surround map
     SurroundMap surroundMap;
+    /// @brief Generated areas cache (used if areaChunks > 1)
+    std::unordered_map<glm::ivec2, std::unique_ptr<GeneratorArea>> areas;
+    /// @brief Area size in chunks (1 - per-chunk generation)
+    int areaChunks;
+    /// @brief Cache of prototypes out of the surround map (optional)
+    std::unique_ptr<PrototypeCache> prototypeCache;
 
     /// @brief Generate chunk prototype (see ChunkPrototype)
     /// @param x chunk position X divided by CHUNK_W
@@ -69,10 +107,28 @@ class WorldGenerator {
 
     void generateStructures(ChunkPrototype& prototype, int x, int z);
 
+    /// @brief Get structures placed by the chunk script and biomes
+    std::vector<Placement> findStructures(
+        const ChunkPrototype& prototype, int x, int z
+    );
+
     void generateBiomes(ChunkPrototype& prototype, int x, int z);
 
     void generateHeightmap(ChunkPrototype& prototype, int x, int z);
 
+    /// @brief Get area containing the chunk generating biome parameters
+    /// maps if not generated yet
+    /// @param x chunk position X divided by CHUNK_W
+    /// @param z chunk position Y divided by CHUNK_D
+    GeneratorArea& requireArea(int x, int z);
+
+    void generateAreaBiomes(GeneratorArea& area, int areaX, int areaZ);
+
+    void generateAreaHeightmap(GeneratorArea& area, int areaX, int areaZ);
+
+    /// @brief Remove areas that are out of the surround map
+    void cleanupAreas();
+
     void placeStructure(
         const StructurePlacement& placement, int priority, 
         int chunkX, int chunkZ
@@ -123,6 +179,14 @@ public:
         const Content& content,
         uint64_t seed
     );
+    /// @param script separate script instance to use instead of def.script
+    /// (see GeneratorScript::clone)
+    WorldGenerator(
+        const GeneratorDef& def,
+        const Content& content,
+        uint64_t seed,
+        std::unique_ptr<GeneratorScript> script
+    );
     ~WorldGenerator();
 
     void update(int centerX, int centerY, int loadDistance);
@@ -133,7 +197,20 @@ public:
     /// @param z chunk position Y divided by CHUNK_D
     void generate(voxel* voxels, int x, int z);
 
+    /// @brief Create function generating voxels of any chunk. It owns
+    /// generator with separate script instance, so it may be used in
+    /// another thread. Must be created in the main thread
+    static std::function<void(int x, int z, voxel* voxels)> createStandalone(
+        const GeneratorDef& def, const Content& content, uint64_t seed
+    );
+
     WorldGenDebugInfo createDebugInfo() const;
 
+    /// @brief Set cache keeping prototypes out of the generation area
+    /// to restore them without script calls (nullptr - disable cache)
+    void setPrototypeCache(std::unique_ptr<PrototypeCache> cache);
+
+    const PrototypeCache* getPrototypeCache() const;
+
     uint64_t getSeed() const;
 };
@@ -36,3 +36,107 @@ TEST(BJSON, EncodeDecode) {
         }
     }
 }
+
+TEST(BJSON, Cursor) {
+    auto object = dv::object();
+    object["name"] = "cursor";
+    object["nested"] = dv::object();
+    object["nested"]["list"] = dv::list({1, 2, dv::list({3, 4})});
+    object["nested"]["text"] = "skipped";
+    object["values"] = dv::list({300, 70000, 5000000000LL, 2.5, true});
+    object["data"] = std::make_shared<dv::objects::Bytes>(
+        dv::objects::Bytes({7, 8, 9})
+    );
+    auto bytes = json::to_binary(object, true);
+
+    json::BinaryCursor cursor(bytes.data(), bytes.size());
+    cursor.enterObject();
+    int entries = 0;
+    while (cursor.hasNext()) {
+        auto key = cursor.readKey();
+        entries++;
+        if (key == "name") {
+            EXPECT_EQ(cursor.readString(), "cursor");
+        } else if (key == "values") {
+            EXPECT_EQ(cursor.peekType(), dv::value_type::list);
+            cursor.enterList();
+            EXPECT_EQ(cursor.readInteger(), 300);
+            EXPECT_EQ(cursor.readInteger(), 70000);
+            EXPECT_EQ(cursor.readInteger(), 5000000000LL);
+            EXPECT_DOUBLE_EQ(cursor.readNumber(), 2.5);
+            EXPECT_THROW(cursor.readString(), std::runtime_error);
+            EXPECT_TRUE(cursor.readBoolean());
+            EXPECT_FALSE(cursor.hasNext());
+        } else if (key == "data") {
+            size_t size;
+            const ubyte* data = cursor.readBytes(size);
+            ASSERT_EQ(size, 3);
+            EXPECT_EQ(data[2], 9);
+        } else {
+            cursor.skip();
+        }
+    }
+    EXPECT_EQ(entries, 4);
+}
+
+TEST(BJSON, CursorSkipList) {
+    auto object = dv::object();
+    auto& list = object.list("list");
+    list.add(dv::list({1, 2}));
+    list.add("two");
+    list.object();
+    list.add(3.0);
+    object["after"] = 42;
+    auto bytes = json::to_binary(object);
+
+    json::BinaryCursor cursor(bytes.data(), bytes.size());
+    cursor.enterObject();
+    while (cursor.hasNext()) {
+        if (cursor.readKey() == "after") {
+            EXPECT_EQ(cursor.readValue().asInteger(), 42);
+        } else {
+            cursor.skip();
+        }
+    }
+}
+
+TEST(BJSON, CursorSeek) {
+    auto object = dv::object();
+    auto& list = object.list("data");
+    auto& broken = list.object();
+    broken["pos"] = "not a vector";
+    broken["def"] = "broken";
+    auto& valid = list.object();
+    valid["def"] = "valid";
+    auto bytes = json::to_binary(object);
+
+    json::BinaryCursor cursor(bytes.data(), bytes.size());
+    cursor.enterObject();
+    ASSERT_EQ(cursor.readKey(), "data");
+    cursor.enterList();
+    std::vector<std::string> read;
+    while (cursor.hasNext()) {
+        size_t start = cursor.tell();
+        try {
+            std::string def;
+            cursor.enterObject();
+            while (cursor.hasNext()) {
+                auto key = cursor.readKey();
+                if (key == "pos") {
+                    cursor.enterList();
+                    cursor.skip();
+                } else {
+                    def = cursor.readString();
+                }
+            }
+            read.push_back(def);
+        } catch (const std::runtime_error&) {
+            cursor.seek(start);
+            cursor.skip();
+        }
+    }
+    EXPECT_FALSE(cursor.hasNext());
+    ASSERT_EQ(read.size(), 1);
+    EXPECT_EQ(read[0], "valid");
+    EXPECT_THROW(cursor.seek(bytes.size() + 1), std::runtime_error);
+}
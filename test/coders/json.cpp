@@ -1,8 +1,16 @@
 #include <gtest/gtest.h>
 
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#include "coders/commons.hpp"
 #include "coders/json.hpp"
+#include "coders/scanning.hpp"
 #include "util/stringutil.hpp"
 
+namespace fs = std::filesystem;
+
 TEST(JSON, EncodeDecode) {
     const std::string name = "JSON-encoder";
     const int bytesSize = 20;
@@ -40,3 +48,67 @@ TEST(JSON, EncodeDecode) {
         }
     }
 }
+
+/// @brief Parse with vectorized scanning enabled and disabled
+/// @return stringified result or error description
+static std::string parse_both(const std::string& text, bool vectorized) {
+    bool enabled = scanning::is_enabled();
+    scanning::set_enabled(vectorized);
+    std::string result;
+    try {
+        result = json::stringify(json::parse(text), false);
+    } catch (const parsing_error& err) {
+        result = std::string(err.what()) + " at " + std::to_string(err.pos) +
+                 ":" + std::to_string(err.line) + ":" +
+                 std::to_string(err.linestart);
+    }
+    scanning::set_enabled(enabled);
+    return result;
+}
+
+TEST(JSON, ScanningErrors) {
+    const std::string padding(37, ' ');
+    const std::string texts[] {
+        "{\n" + padding + "\"key\":\n\n" + padding + "\"value" + padding,
+        "{\"long string with escapes \\t\\u0041\\x42\\101 and more text\":"
+        + padding + "\n\n12345678901234567890123_45.0012e+3,\n\"b\": 1\n" +
+        padding + "}",
+        "[\n\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t1, 2,\n" + padding +
+        "\"abcdefghijklmnopqrstuvwxyz\n\"]",
+        "{\"a\": \"abcdefghijklmnopqrstuvwxyz\\q\"}",
+        "[" + padding + "00000000000000000123.0000000000000000001, 1e5, ]",
+    };
+    for (const auto& text : texts) {
+        EXPECT_EQ(parse_both(text, false), parse_both(text, true));
+    }
+}
+
+static fs::path find_res_folder() {
+    for (auto path : {"res", "../res", "../../res"}) {
+        if (fs::is_directory(fs::u8path(path) / "content")) {
+            return fs::u8path(path);
+        }
+    }
+    return {};
+}
+
+TEST(JSON, ResParseScanning) {
+    auto folder = find_res_folder();
+    if (folder.empty()) {
+        GTEST_SKIP() << "res folder not found";
+    }
+    int files = 0;
+    for (const auto& entry : fs::recursive_directory_iterator(folder)) {
+        if (entry.path().extension() != ".json") {
+            continue;
+        }
+        std::ifstream file(entry.path(), std::ios::binary);
+        std::stringstream ss;
+        ss << file.rdbuf();
+        auto text = ss.str();
+        EXPECT_EQ(parse_both(text, false), parse_both(text, true))
+            << entry.path();
+        files++;
+    }
+    EXPECT_GT(files, 0);
+}
@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+
+#include "content/ContentCache.hpp"
+#include "content/ContentPack.hpp"
+#include "graphics/core/Atlas.hpp"
+#include "graphics/core/ImageData.hpp"
+#include "io/devices/StdfsDevice.hpp"
+#include "io/io.hpp"
+
+namespace fs = std::filesystem;
+
+static std::vector<ContentPack> prepare_packs() {
+    auto folder = fs::temp_directory_path() / "voxelengine_cache_test";
+    fs::remove_all(folder);
+    fs::create_directories(folder / "pack" / "blocks");
+    io::set_device("cachetest", std::make_shared<io::StdfsDevice>(folder));
+    io::write_string("cachetest:pack/blocks/stone.json", R"({"a": 1})");
+    io::write_string("cachetest:other.json", R"({"b": [1, 2.5, null]})");
+
+    ContentPack pack {};
+    pack.id = "pack";
+    pack.folder = "cachetest:pack";
+    return {pack};
+}
+
+TEST(ContentCache, Definitions) {
+    auto packs = prepare_packs();
+    io::path cacheFile = "cachetest:content.bjson";
+    {
+        ContentCache cache(cacheFile, packs);
+        EXPECT_EQ(cache.readJson("cachetest:other.json")["b"].size(), 3);
+        cache.putScript("cachetest:pack/scripts/a.lua", std::string("\0\1", 2));
+        cache.save();
+    }
+    // file outside of the packs does not affect the key
+    io::write_string("cachetest:other.json", R"({"b": []})");
+    {
+        ContentCache cache(cacheFile, packs);
+        EXPECT_EQ(cache.getKey(), ContentCache::computeKey(packs));
+        auto value = cache.readJson("cachetest:other.json");
+        ASSERT_EQ(value["b"].size(), 3);
+        EXPECT_EQ(value["b"][2].getType(), dv::value_type::none);
+        auto script = cache.getScript("cachetest:pack/scripts/a.lua");
+        ASSERT_TRUE(script.has_value());
+        EXPECT_EQ(*script, std::string("\0\1", 2));
+    }
+    // any pack file change invalidates the cache
+    io::write_string("cachetest:pack/blocks/stone.json", R"({"a": 22})");
+    {
+        ContentCache cache(cacheFile, packs);
+        EXPECT_EQ(cache.readJson("cachetest:other.json")["b"].size(), 0);
+        EXPECT_FALSE(cache.getScript("cachetest:pack/scripts/a.lua"));
+    }
+}
+
+TEST(ContentCache, Atlas) {
+    auto packs = prepare_packs();
+    io::path cacheFile = "cachetest:content.bjson";
+    {
+        ContentCache cache(cacheFile, packs);
+        EXPECT_EQ(cache.getAtlas("textures/blocks"), nullptr);
+        auto image = std::make_unique<ImageData>(ImageFormat::rgba8888, 2, 2);
+        image->getData()[5] = 42;
+        Atlas atlas(
+            std::move(image), {{"stone", UVRegion(0.0f, 0.5f, 0.5f, 1.0f)}}, false
+        );
+        cache.putAtlas("textures/blocks", atlas);
+        cache.save();
+    }
+    ContentCache cache(cacheFile, packs);
+    auto atlas = cache.getAtlas("textures/blocks");
+    ASSERT_NE(atlas, nullptr);
+    EXPECT_EQ(atlas->getImage()->getWidth(), 2);
+    EXPECT_EQ(atlas->getImage()->getData()[5], 42);
+    ASSERT_TRUE(atlas->has("stone"));
+    EXPECT_FLOAT_EQ(atlas->get("stone").v1, 0.5f);
+    EXPECT_EQ(atlas->getRegions().size(), 1);
+}
@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+
+#include "coders/json.hpp"
+#include "data/dv_document.hpp"
+#include "util/Buffer.hpp"
+
+static bool equals(const dv::value& a, const dv::value& b) {
+    if (a.getType() != b.getType()) {
+        return false;
+    }
+    switch (a.getType()) {
+        case dv::value_type::none:
+            return true;
+        case dv::value_type::number:
+        case dv::value_type::integer:
+            return a.asNumber() == b.asNumber();
+        case dv::value_type::boolean:
+            return a.asBoolean() == b.asBoolean();
+        case dv::value_type::string:
+            return a.asString() == b.asString();
+        case dv::value_type::bytes: {
+            const auto& x = a.asBytes();
+            const auto& y = b.asBytes();
+            return x.size() == y.size() &&
+                   std::equal(x.data(), x.data() + x.size(), y.data());
+        }
+        case dv::value_type::list:
+            for (size_t i = 0; i < a.size(); i++) {
+                if (i >= b.size() || !equals(a[i], b[i])) {
+                    return false;
+                }
+            }
+            return a.size() == b.size();
+        case dv::value_type::object:
+            for (const auto& [key, value] : a.asObject()) {
+                if (!b.has(key) || !equals(value, b[key])) {
+                    return false;
+                }
+            }
+            return a.size() == b.size();
+    }
+    return false;
+}
+
+/// @brief Generate entities layer similar to Entities::serialize output
+static dv::value generate_entities(int count) {
+    auto root = dv::object();
+    auto& list = root.list("data");
+    for (int i = 0; i < count; i++) {
+        auto& entity = list.object();
+        entity["def"] = i % 3 ? "base:drop" : "base:falling_block";
+        entity["uid"] = 1000 + i;
+        auto& transform = entity.object("transform");
+        transform["pos"] = dv::list({i * 0.5, 64.0 + i % 7, -i * 0.25});
+        if (i % 2) {
+            transform["size"] = dv::list({0.25, 0.25, 0.25});
+        }
+        auto& rigidbody = entity.object("rigidbody");
+        rigidbody["vel"] = dv::list({0.0, -9.8 * (i % 5), 0.0});
+        rigidbody["damping"] = 1.5;
+        auto& comps = entity.object("comps");
+        auto& drop = comps.object("base:drop");
+        drop["item"] = i % 3 ? "base:stone.item" : "base:dirt.item";
+        drop["count"] = i % 64 + 1;
+        drop["timer"] = i * 0.01;
+    }
+    return root;
+}
+
+TEST(dv_document, FromBinary) {
+    auto value = generate_entities(50);
+    value["bytes"] = std::make_shared<dv::objects::Bytes>(
+        dv::objects::Bytes({1, 2, 3, 4, 5})
+    );
+    value["flag"] = true;
+    auto bytes = json::to_binary(value);
+    auto doc = json::from_binary_document(bytes.data(), bytes.size());
+    auto root = doc.getRoot();
+
+    ASSERT_TRUE(root.isObject());
+    const auto& list = root["data"];
+    ASSERT_EQ(list.size(), 50);
+    EXPECT_EQ(list[1]["def"].asString(), "base:drop");
+    EXPECT_EQ(list[1]["uid"].asInteger(), 1001);
+    EXPECT_EQ(list[2]["comps"]["base:drop"]["count"].asInteger(), 3);
+    EXPECT_DOUBLE_EQ(list[3]["transform"]["pos"][1].asNumber(), 67.0);
+    EXPECT_FALSE(list[0]["transform"].has("size"));
+    EXPECT_TRUE(list[0]["transform"]["size"].isNone());
+    EXPECT_EQ(root["bytes"].size(), 5);
+    EXPECT_EQ(root["bytes"].asBytes()[4], 5);
+    EXPECT_TRUE(root["flag"].asBoolean());
+    EXPECT_FALSE(root.has("none"));
+    EXPECT_TRUE(root["none"].isNone());
+    EXPECT_TRUE(equals(root.toValue(), value));
+}
+
+TEST(dv_document, Parse) {
+    auto doc = json::parse_document(
+        "[string]",
+        R"({
+            "short": "abcdefgh",
+            "long": "abcdefghijklmnopqrstuvwxyz",
+            "empty": "",
+            "list": [1, 2.5, true, null, {"a": []}],
+            "key": 1,
+            "key": 2,
+            "esc\u0061ped": "a\"b\n"
+        })"
+    );
+    auto root = doc.getRoot();
+    EXPECT_EQ(root.size(), 6);
+    EXPECT_EQ(root["short"].asString(), "abcdefgh");
+    EXPECT_EQ(root["long"].asString(), "abcdefghijklmnopqrstuvwxyz");
+    EXPECT_EQ(root["empty"].asString(), "");
+    EXPECT_EQ(root["key"].asInteger(), 2);
+    EXPECT_EQ(root["escaped"].asString(), "a\"b\n");
+    const auto& list = root["list"];
+    ASSERT_EQ(list.size(), 5);
+    EXPECT_EQ(list[0].asInteger(), 1);
+    EXPECT_DOUBLE_EQ(list[1].asNumber(), 2.5);
+    EXPECT_TRUE(list[2].asBoolean());
+    EXPECT_TRUE(list[3].isNone());
+    EXPECT_TRUE(list[4]["a"].isList());
+    EXPECT_EQ(list[4]["a"].size(), 0);
+    EXPECT_THROW(list[5], std::out_of_range);
+    EXPECT_THROW(root["key"].asString(), std::runtime_error);
+    EXPECT_TRUE(equals(
+        root.toValue(), json::parse(json::stringify(root.toValue(), false))
+    ));
+}
@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#include "debug/Metrics.hpp"
+
+using namespace debug;
+
+TEST(Metrics, CounterThreads) {
+    auto& counter = metrics::counter("test.counter");
+    counter.reset();
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 8; i++) {
+        threads.emplace_back([]() {
+            auto& counter = metrics::counter("test.counter");
+            for (int j = 0; j < 10000; j++) {
+                counter.add();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(counter.get(), 80000);
+
+    metrics::MetricValue value;
+    ASSERT_TRUE(metrics::get("test.counter", value));
+    EXPECT_EQ(value.type, metrics::MetricType::counter);
+    EXPECT_EQ(value.value, 80000);
+    EXPECT_THROW(metrics::gauge("test.counter"), std::runtime_error);
+}
+
+TEST(Metrics, Histogram) {
+    auto& histogram = metrics::histogram("test.histogram", {10, 20, 30, 40});
+    histogram.reset();
+    for (int i = 0; i < 40; i++) {
+        histogram.observe(i + 0.5);
+    }
+    histogram.observe(1000);
+
+    auto snapshot = histogram.snapshot();
+    EXPECT_EQ(snapshot.count, 41);
+    ASSERT_EQ(snapshot.counts.size(), 5);
+    EXPECT_EQ(snapshot.counts[0], 10);
+    EXPECT_EQ(snapshot.counts[3], 10);
+    EXPECT_EQ(snapshot.counts[4], 1);
+    EXPECT_NEAR(snapshot.quantile(0.5), 20.5, 0.01);
+    EXPECT_DOUBLE_EQ(snapshot.quantile(1.0), 40);
+    EXPECT_NEAR(snapshot.mean(), (800.0 + 1000.0) / 41, 1e-9);
+}
+
+TEST(Metrics, Collect) {
+    metrics::gauge("test.collect.b").set(2.5);
+    metrics::counter("test.collect.a").add(3);
+    metrics::gauge("test.collectx").set(1);
+
+    auto values = metrics::collect("test.collect.");
+    ASSERT_EQ(values.size(), 2);
+    EXPECT_EQ(values[0].name, "test.collect.a");
+    EXPECT_EQ(values[0].value, 3);
+    EXPECT_EQ(values[1].name, "test.collect.b");
+    EXPECT_EQ(values[1].value, 2.5);
+
+    metrics::MetricValue value;
+    EXPECT_FALSE(metrics::get("test.missing", value));
+}
+
+TEST(Metrics, ResetPrefix) {
+    auto& own = metrics::counter("test.reset.a");
+    auto& other = metrics::counter("test.resetx");
+    auto& histogram = metrics::histogram("test.reset.b");
+    auto& gauge = metrics::gauge("test.reset.c");
+    own.add(2);
+    other.add(3);
+    histogram.observe(1);
+    gauge.set(4);
+
+    metrics::reset("test.reset.");
+    EXPECT_EQ(own.get(), 0);
+    EXPECT_EQ(histogram.snapshot().count, 0);
+    EXPECT_EQ(gauge.get(), 4);
+    EXPECT_EQ(other.get(), 3);
+}
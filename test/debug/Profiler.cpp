@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <thread>
+
+#include "coders/json.hpp"
+#include "debug/Profiler.hpp"
+
+using namespace debug;
+
+TEST(Profiler, ChromeTrace) {
+    profiler::start();
+    {
+        PROFILE_ZONE("outer");
+        {
+            PROFILE_ZONE("inner");
+        }
+        std::thread([]() { PROFILE_ZONE("worker \"zone\""); }).join();
+    }
+    profiler::begin(profiler::intern("script"));
+    EXPECT_TRUE(profiler::end());
+    EXPECT_FALSE(profiler::end());
+    profiler::stop();
+    {
+        PROFILE_ZONE("ignored");
+    }
+    EXPECT_EQ(profiler::count(), 4);
+
+    auto root = json::parse(profiler::to_chrome_trace());
+    const auto& events = root["traceEvents"];
+    int zones = 0;
+    double outerEnd = 0.0;
+    double innerEnd = 0.0;
+    for (const auto& event : events) {
+        if (event["ph"].asString() != "X") {
+            continue;
+        }
+        zones++;
+        const auto& name = event["name"].asString();
+        double end = event["ts"].asNumber() + event["dur"].asNumber();
+        if (name == "outer") {
+            outerEnd = end;
+        } else if (name == "inner") {
+            innerEnd = end;
+        }
+    }
+    EXPECT_EQ(zones, 4);
+    EXPECT_LE(innerEnd, outerEnd);
+}
+
+TEST(Profiler, ChromeTraceFormat) {
+    using namespace std::chrono_literals;
+
+    profiler::start();
+    auto now = profiler::clock::now();
+    profiler::record("fixed", now + 1ms, now + 3ms);
+    // began before the capture
+    profiler::record("early", now - 1s, now);
+    std::thread([now]() {
+        profiler::record("tab\tquote\"", now, now + 500us);
+    }).join();
+    profiler::stop();
+
+    auto root = json::parse(profiler::to_chrome_trace());
+    EXPECT_EQ(root["displayTimeUnit"].asString(), "ms");
+
+    int threads = 0;
+    std::vector<std::string> names;
+    for (const auto& event : root["traceEvents"]) {
+        EXPECT_EQ(event["pid"].asInteger(), 1);
+        const auto& ph = event["ph"].asString();
+        if (ph == "M") {
+            EXPECT_EQ(event["name"].asString(), "thread_name");
+            threads++;
+            continue;
+        }
+        ASSERT_EQ(ph, "X");
+        const auto& name = event["name"].asString();
+        names.push_back(name);
+        EXPECT_GE(event["ts"].asNumber(), 0.0);
+        if (name == "fixed") {
+            EXPECT_DOUBLE_EQ(event["dur"].asNumber(), 2000.0);
+            EXPECT_GE(event["ts"].asNumber(), 1000.0);
+        } else if (name == "tab\tquote\"") {
+            EXPECT_DOUBLE_EQ(event["dur"].asNumber(), 500.0);
+        }
+    }
+    EXPECT_EQ(threads, 2);
+    ASSERT_EQ(names.size(), 2);
+    EXPECT_NE(std::find(names.begin(), names.end(), "fixed"), names.end());
+    EXPECT_EQ(std::find(names.begin(), names.end(), "early"), names.end());
+}
@@ -0,0 +1,34 @@
+#include "engine/TickMetrics.hpp"
+
+#include <gtest/gtest.h>
+
+TEST(TickMetrics, Percentiles) {
+    TickMetrics metrics(100);
+    metrics.setTargetRate(20);
+    // 200 ticks at 20 TPS, only the last 100 are in the window
+    for (int i = 0; i < 200; i++) {
+        double duration = (i % 100 == 99) ? 0.040 : (i % 10) * 0.001;
+        metrics.record(i * 0.05, duration);
+    }
+    auto stats = metrics.getStats();
+    EXPECT_EQ(stats.samples, 100);
+    EXPECT_NEAR(stats.tps, 20.0, 1e-6);
+    EXPECT_NEAR(stats.tpsP1, 20.0, 1e-6);
+    EXPECT_NEAR(stats.msptMax, 40.0, 1e-6);
+    EXPECT_NEAR(stats.msptP50, 4.0, 1e-6);
+    EXPECT_NEAR(stats.msptP95, 9.0, 1e-6);
+    EXPECT_EQ(metrics.getTicks(), 200);
+}
+
+TEST(TickMetrics, Text) {
+    TickMetrics metrics(10);
+    metrics.record(0.0, 0.01);
+    metrics.record(0.1, 0.01);
+    metrics.addSkipped(3);
+    metrics.addOverload();
+    auto text = metrics.toText();
+    EXPECT_NE(text.find("voxelcore_tps 10\n"), std::string::npos);
+    EXPECT_NE(text.find("voxelcore_mspt_count 2\n"), std::string::npos);
+    EXPECT_NE(text.find("voxelcore_ticks_skipped_total 3\n"), std::string::npos);
+    EXPECT_NE(text.find("voxelcore_overloads_total 1\n"), std::string::npos);
+}
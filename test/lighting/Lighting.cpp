@@ -0,0 +1,179 @@
+#include <gtest/gtest.h>
+
+#include "content/Content.hpp"
+#include "content/ContentBuilder.hpp"
+#include "core_defs.hpp"
+#include "items/ItemDef.hpp"
+#include "lighting/Lighting.hpp"
+#include "objects/rigging.hpp"
+#include "voxels/Block.hpp"
+#include "voxels/Chunk.hpp"
+#include "voxels/Chunks.hpp"
+#include "voxels/blocks_agent.hpp"
+
+static constexpr int CHUNKS_SIZE = 4;
+static constexpr int GROUND_HEIGHT = 32;
+
+static std::unique_ptr<Content> create_content() {
+    ContentBuilder builder;
+    {
+        Block& block = builder.blocks.create(CORE_AIR);
+        block.replaceable = true;
+        block.lightPassing = true;
+        block.skyLightPassing = true;
+        block.obstacle = false;
+        block.model = BlockModel::none;
+        block.pickingItem = CORE_EMPTY;
+    }
+    builder.items.create(CORE_EMPTY);
+    {
+        Block& block = builder.blocks.create("test:stone");
+        block.pickingItem = CORE_EMPTY;
+    }
+    {
+        Block& block = builder.blocks.create("test:lamp");
+        block.pickingItem = CORE_EMPTY;
+        block.emission[0] = 15;
+        block.emission[1] = 9;
+        block.emission[2] = 4;
+    }
+    return builder.build();
+}
+
+/// @brief Flat ground with a lamp above it, lights calculated
+static std::unique_ptr<Chunks> create_chunks(const Content& content) {
+    const auto& indices = *content.getIndices();
+    blockid_t stone = content.blocks.require("test:stone").rt.id;
+    blockid_t lamp = content.blocks.require("test:lamp").rt.id;
+    int offset = -CHUNKS_SIZE / 2;
+
+    auto chunks = std::make_unique<Chunks>(
+        CHUNKS_SIZE, CHUNKS_SIZE, 0, 0, nullptr, indices
+    );
+    chunks->setCenter(0, 0);
+    for (int z = 0; z < CHUNKS_SIZE; z++) {
+        for (int x = 0; x < CHUNKS_SIZE; x++) {
+            auto chunk = std::make_shared<Chunk>(offset + x, offset + z);
+            for (int y = 0; y < GROUND_HEIGHT; y++) {
+                for (int lz = 0; lz < CHUNK_D; lz++) {
+                    for (int lx = 0; lx < CHUNK_W; lx++) {
+                        chunk->voxels[vox_index(lx, y, lz)].id = stone;
+                    }
+                }
+            }
+            chunk->updateHeights();
+            Lighting::prebuildSkyLight(*chunk, indices);
+            chunk->flags.loaded = true;
+            chunk->flags.ready = true;
+            chunks->putChunk(chunk);
+        }
+    }
+    Lighting lighting(content, *chunks);
+    for (int z = 0; z < CHUNKS_SIZE; z++) {
+        for (int x = 0; x < CHUNKS_SIZE; x++) {
+            lighting.buildSkyLight(offset + x, offset + z);
+            lighting.onChunkLoaded(offset + x, offset + z, true);
+        }
+    }
+    blocks_agent::set(*chunks, 7, GROUND_HEIGHT + 6, 0, lamp, {});
+    lighting.onBlockSet(7, GROUND_HEIGHT + 6, 0, lamp);
+    return chunks;
+}
+
+/// @brief Same area edit performed through per-block and area paths
+struct FillTest {
+    std::unique_ptr<Content> content = create_content();
+    std::unique_ptr<Chunks> perBlock = create_chunks(*content);
+    std::unique_ptr<Chunks> area = create_chunks(*content);
+    Lighting perBlockLighting {*content, *perBlock};
+    Lighting areaLighting {*content, *area};
+
+    void fill(const glm::ivec3& min, const glm::ivec3& max, blockid_t id) {
+        for (int y = min.y; y <= max.y; y++) {
+            for (int z = min.z; z <= max.z; z++) {
+                for (int x = min.x; x <= max.x; x++) {
+                    blocks_agent::set(*perBlock, x, y, z, id, {});
+                    perBlockLighting.onBlockSet(x, y, z, id);
+                }
+            }
+        }
+        blocks_agent::fill(*area, min, max, id, {});
+        areaLighting.onAreaSet(min.x, min.y, min.z, max.x, max.y, max.z);
+    }
+
+    void compare() {
+        const auto& expected = perBlock->getChunks();
+        const auto& actual = area->getChunks();
+        ASSERT_EQ(expected.size(), actual.size());
+        for (size_t i = 0; i < expected.size(); i++) {
+            const auto& a = expected[i]->lightmap;
+            const auto& b = actual[i]->lightmap;
+            for (uint index = 0; index < CHUNK_VOL; index++) {
+                if (a.map[index] == b.map[index]) {
+                    continue;
+                }
+                for (int channel = 0; channel < 4; channel++) {
+                    ASSERT_EQ(
+                        Lightmap::extract(a.map[index], channel),
+                        Lightmap::extract(b.map[index], channel)
+                    ) << "chunk " << expected[i]->x << ", " << expected[i]->z
+                      << " voxel " << index << " channel " << "RGBS"[channel];
+                }
+            }
+        }
+    }
+
+    blockid_t require(const std::string& name) const {
+        return content->blocks.require(name).rt.id;
+    }
+};
+
+TEST(Lighting, AreaSetCutsSkyLight) {
+    FillTest test;
+    // opaque roof over the lamp crossing chunk borders
+    test.fill(
+        {-10, GROUND_HEIGHT + 10, -9}, {12, GROUND_HEIGHT + 11, 8},
+        test.require("test:stone")
+    );
+    test.compare();
+    // hole in the roof
+    test.fill(
+        {-4, GROUND_HEIGHT + 10, -3}, {5, GROUND_HEIGHT + 11, 4}, BLOCK_AIR
+    );
+    test.compare();
+}
+
+TEST(Lighting, AreaSetEmitters) {
+    FillTest test;
+    test.fill(
+        {-6, GROUND_HEIGHT, -5}, {-1, GROUND_HEIGHT + 2, 3},
+        test.require("test:lamp")
+    );
+    test.compare();
+    // emitters replaced with opaque blocks
+    test.fill(
+        {-6, GROUND_HEIGHT, -5}, {-3, GROUND_HEIGHT + 2, 3},
+        test.require("test:stone")
+    );
+    test.compare();
+}
+
+TEST(Lighting, AreaSetBordersLight) {
+    FillTest test;
+    // box next to the lamp
+    test.fill(
+        {-5, GROUND_HEIGHT, -6}, {6, GROUND_HEIGHT + 8, 6},
+        test.require("test:stone")
+    );
+    test.compare();
+    // cleared box is lighted back from its borders
+    test.fill(
+        {-4, GROUND_HEIGHT, -5}, {5, GROUND_HEIGHT + 7, 5}, BLOCK_AIR
+    );
+    test.compare();
+    // ground dug under the open sky
+    test.fill(
+        {-12, GROUND_HEIGHT - 6, 9}, {-2, GROUND_HEIGHT - 1, 14}, BLOCK_AIR
+    );
+    test.compare();
+}
@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+
+#include <set>
+#include <utility>
+
+#include "logic/ChunksScheduler.hpp"
+
+using ChunksSet = std::set<std::pair<int, int>>;
+
+static int load_all(ChunksScheduler& scheduler, ChunksSet& loaded) {
+    auto isLoaded = [&loaded](int x, int z) {
+        return loaded.find({x, z}) != loaded.end();
+    };
+    int x, z;
+    int count = 0;
+    while (scheduler.nextMissing(isLoaded, x, z)) {
+        loaded.insert({x, z});
+        count++;
+    }
+    return count;
+}
+
+TEST(ChunksScheduler, NearestFirst) {
+    ChunksScheduler scheduler;
+    EXPECT_TRUE(scheduler.setArea(10, -5, 8));
+
+    ChunksSet loaded;
+    auto isLoaded = [&loaded](int x, int z) {
+        return loaded.find({x, z}) != loaded.end();
+    };
+    int x, z;
+    int prevDistance = 0;
+    while (scheduler.nextMissing(isLoaded, x, z)) {
+        int distance = (x - 10) * (x - 10) + (z + 5) * (z + 5);
+        EXPECT_GE(distance, prevDistance);
+        EXPECT_LT(distance, 8 * 8);
+        prevDistance = distance;
+        loaded.insert({x, z});
+    }
+    EXPECT_TRUE(loaded.count({10, -5}));
+    EXPECT_EQ(scheduler.getLoadedCount(), loaded.size());
+}
+
+TEST(ChunksScheduler, Shift) {
+    const int radius = 16;
+    ChunksScheduler scheduler;
+    scheduler.setArea(0, 0, radius);
+    ChunksSet loaded;
+    size_t total = load_all(scheduler, loaded);
+
+    EXPECT_FALSE(scheduler.setArea(2, 1, radius));
+    // inner part of the circle is kept
+    EXPECT_GT(scheduler.getLoadedCount(), 0);
+    EXPECT_LT(scheduler.getLoadedCount(), total);
+
+    load_all(scheduler, loaded);
+    for (int z = -radius; z < radius; z++) {
+        for (int x = -radius; x < radius; x++) {
+            if (x * x + z * z < radius * radius) {
+                EXPECT_TRUE(loaded.count({x + 2, z + 1}));
+            }
+        }
+    }
+    EXPECT_EQ(scheduler.getLoadedCount(), total);
+
+    // jump farther than radius
+    scheduler.setArea(100, 100, radius);
+    EXPECT_EQ(scheduler.getLoadedCount(), 0);
+}
+
+TEST(ChunksScheduler, LightsCandidates) {
+    ChunksScheduler scheduler;
+    scheduler.setArea(0, 0, 4);
+    scheduler.onChunkLoaded(3, 0);
+
+    ChunksSet candidates;
+    int x, z;
+    while (scheduler.nextLightsCandidate(x, z)) {
+        candidates.insert({x, z});
+    }
+    // x = 4 is outside of the loading square
+    EXPECT_EQ(candidates.size(), 6);
+    EXPECT_TRUE(candidates.count({2, -1}));
+    EXPECT_FALSE(candidates.count({4, 0}));
+}
+
+TEST(ChunksScheduler, RequestLights) {
+    ChunksScheduler scheduler;
+    scheduler.setArea(0, 0, 4);
+    ChunksSet loaded;
+    load_all(scheduler, loaded);
+    EXPECT_EQ(scheduler.getPendingCount(), 0);
+
+    // lights of a loaded chunk are reset
+    scheduler.requestLights(1, 2);
+    EXPECT_EQ(scheduler.getPendingCount(), 1);
+    int x, z;
+    EXPECT_TRUE(scheduler.nextLightsCandidate(x, z));
+    EXPECT_EQ(x, 1);
+    EXPECT_EQ(z, 2);
+    EXPECT_FALSE(scheduler.nextLightsCandidate(x, z));
+}
@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+
+#include "logic/LoadDistanceController.hpp"
+
+static const LoadDistanceLimits LIMITS {6, 20, 40.0f, 64};
+
+/// @brief Feed samples until smoothed tick time settles
+static void set_tick_time(LoadDistanceController& controller, float ms) {
+    for (int i = 0; i < 200; i++) {
+        controller.addTickTime(ms);
+    }
+}
+
+/// @brief Update the player for the given time with 0.05s steps
+static int simulate(
+    LoadDistanceController& controller, float seconds, int backlog
+) {
+    int distance = 0;
+    for (int i = 0; i < static_cast<int>(seconds * 20); i++) {
+        distance = controller.update(1, 0.05f, backlog, LIMITS);
+    }
+    return distance;
+}
+
+TEST(LoadDistanceController, StartsFromMaximum) {
+    LoadDistanceController controller;
+    EXPECT_EQ(controller.getDistance(1), 0);
+    EXPECT_EQ(controller.update(1, 0.05f, 0, LIMITS), LIMITS.maxDistance);
+    EXPECT_EQ(controller.getDistance(1), LIMITS.maxDistance);
+}
+
+TEST(LoadDistanceController, LowersWhenOverloaded) {
+    LoadDistanceController controller;
+    set_tick_time(controller, 80.0f);
+    EXPECT_EQ(simulate(controller, 3.5f, 0), LIMITS.maxDistance - 3);
+    EXPECT_EQ(simulate(controller, 60.0f, 0), LIMITS.minDistance);
+}
+
+TEST(LoadDistanceController, RaisesWhenIdle) {
+    LoadDistanceController controller;
+    set_tick_time(controller, 80.0f);
+    simulate(controller, 5.5f, 0);
+    EXPECT_EQ(controller.getDistance(1), LIMITS.maxDistance - 5);
+
+    // between raise threshold and target: steady
+    set_tick_time(controller, 30.0f);
+    EXPECT_EQ(simulate(controller, 20.0f, 0), LIMITS.maxDistance - 5);
+
+    set_tick_time(controller, 5.0f);
+    // backlog between raise threshold and limit: steady
+    EXPECT_EQ(simulate(controller, 20.0f, 40), LIMITS.maxDistance - 5);
+    EXPECT_EQ(simulate(controller, 10.5f, 0), LIMITS.maxDistance - 3);
+    EXPECT_EQ(simulate(controller, 60.0f, 0), LIMITS.maxDistance);
+}
+
+TEST(LoadDistanceController, RaisesWhileMoving) {
+    LoadDistanceController controller;
+    set_tick_time(controller, 80.0f);
+    simulate(controller, 5.5f, 0);
+    set_tick_time(controller, 5.0f);
+
+    // moving player: new chunks appear at the area edge and get loaded
+    int distance = 0;
+    for (int i = 0; i < 20 * 60; i++) {
+        distance = controller.update(1, 0.05f, 30 - i % 13, LIMITS);
+    }
+    EXPECT_EQ(distance, LIMITS.maxDistance);
+}
+
+TEST(LoadDistanceController, Backlog) {
+    LoadDistanceController controller;
+    set_tick_time(controller, 5.0f);
+
+    // growing backlog
+    int distance = 0;
+    for (int i = 0; i < 30; i++) {
+        distance = controller.update(1, 0.05f, 100 + i, LIMITS);
+    }
+    EXPECT_EQ(distance, LIMITS.maxDistance - 1);
+
+    // backlog is being drained
+    for (int i = 0; i < 40; i++) {
+        distance = controller.update(1, 0.05f, 110 - i, LIMITS);
+    }
+    EXPECT_EQ(distance, LIMITS.maxDistance - 1);
+}
+
+TEST(LoadDistanceController, Limits) {
+    LoadDistanceController controller;
+    set_tick_time(controller, 5.0f);
+    simulate(controller, 1.0f, 0);
+
+    LoadDistanceLimits limits = LIMITS;
+    limits.maxDistance = 10;
+    EXPECT_EQ(controller.update(1, 0.05f, 0, limits), 10);
+
+    limits.minDistance = 30;
+    EXPECT_EQ(controller.update(1, 0.05f, 0, limits), 10);
+
+    controller.reset();
+    EXPECT_EQ(controller.getDistance(1), 0);
+}
+
+TEST(LoadDistanceController, RemovePlayer) {
+    LoadDistanceController controller;
+    controller.update(1, 0.05f, 0, LIMITS);
+    controller.update(2, 0.05f, 0, LIMITS);
+    controller.removePlayer(1);
+    EXPECT_EQ(controller.getDistance(1), 0);
+    EXPECT_EQ(controller.getDistance(2), LIMITS.maxDistance);
+}
@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+#include "items/ItemDef.hpp"
+#include "logic/SessionRecorder.hpp"
+#include "logic/SessionReplayer.hpp"
+#include "voxels/Block.hpp"
+
+using namespace session;
+
+static std::vector<ubyte> to_bytes(const std::stringbuf& buffer) {
+    auto string = buffer.str();
+    return std::vector<ubyte>(string.begin(), string.end());
+}
+
+TEST(SessionRecorder, RoundTrip) {
+    Block stone("base:stone");
+    ItemDef pickaxe("base:pickaxe");
+    PlayerState state {{1.5f, 80.0f, -3.0f}, {90.0f, 0.0f, 0.0f}, 2, 0};
+    PlayerState flying = state;
+    flying.flags = PLAYER_FLIGHT | PLAYER_NOCLIP;
+
+    std::stringbuf buffer;
+    {
+        SessionRecorder recorder(
+            std::make_unique<std::ostream>(&buffer), "export:snapshot.zip"
+        );
+        recorder.beginTick(0.05f);
+        recorder.onPlayerState(0, state);
+        recorder.onPlayerState(1, state);
+        recorder.onBlockPlaced(nullptr, stone, {}, {10, 64, -20});
+        recorder.onItemUseOnBlock(
+            nullptr, pickaxe, {10, 64, -20}, {0, 1, 0}
+        );
+
+        recorder.beginTick(0.04f);
+        // unchanged state is not written again
+        recorder.onPlayerState(0, state);
+        recorder.onPlayerState(1, flying);
+        recorder.onEntityAttacked(nullptr, 42);
+        EXPECT_EQ(recorder.getTicks(), 2);
+    }
+
+    SessionReplayer replayer(to_bytes(buffer));
+    EXPECT_EQ(replayer.getSnapshot(), "export:snapshot.zip");
+
+    float delta;
+    int64_t id;
+    PlayerState readState;
+    Interaction record;
+
+    ASSERT_TRUE(replayer.nextTick(delta));
+    EXPECT_FLOAT_EQ(delta, 0.05f);
+    ASSERT_TRUE(replayer.nextPlayerState(id, readState));
+    EXPECT_EQ(id, 0);
+    EXPECT_EQ(readState, state);
+    ASSERT_TRUE(replayer.nextPlayerState(id, readState));
+    EXPECT_EQ(id, 1);
+    EXPECT_FALSE(replayer.nextPlayerState(id, readState));
+
+    ASSERT_TRUE(replayer.nextInteraction(record));
+    EXPECT_EQ(record.type, RecordType::blockPlace);
+    EXPECT_EQ(record.player, -1);
+    EXPECT_EQ(record.pos, glm::ivec3(10, 64, -20));
+    EXPECT_EQ(record.name, "base:stone");
+    ASSERT_TRUE(replayer.nextInteraction(record));
+    EXPECT_EQ(record.type, RecordType::itemUseOnBlock);
+    EXPECT_EQ(record.normal, glm::ivec3(0, 1, 0));
+    EXPECT_EQ(record.name, "base:pickaxe");
+    EXPECT_FALSE(replayer.nextInteraction(record));
+
+    ASSERT_TRUE(replayer.nextTick(delta));
+    EXPECT_FLOAT_EQ(delta, 0.04f);
+    ASSERT_TRUE(replayer.nextPlayerState(id, readState));
+    EXPECT_EQ(id, 1);
+    EXPECT_EQ(readState, flying);
+    EXPECT_FALSE(replayer.nextPlayerState(id, readState));
+    ASSERT_TRUE(replayer.nextInteraction(record));
+    EXPECT_EQ(record.type, RecordType::entityAttacked);
+    EXPECT_EQ(record.entity, 42);
+
+    // end record
+    EXPECT_FALSE(replayer.nextInteraction(record));
+    EXPECT_FALSE(replayer.nextTick(delta));
+    EXPECT_EQ(replayer.getTick(), 2);
+}
+
+TEST(SessionRecorder, InvalidRecording) {
+    std::vector<ubyte> data {'V', 'C', 'R', 'E', 'C', 0, 1};
+    EXPECT_THROW(SessionReplayer replayer(data), std::runtime_error);
+}
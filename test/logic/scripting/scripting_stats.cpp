@@ -0,0 +1,74 @@
+#include "logic/scripting/scripting_stats.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+
+using namespace scripting;
+
+TEST(ScriptingStats, Attribution) {
+    stats::reset();
+    stats::add("base:stone.blockstick", 0.002);
+    stats::add("base:.worldtick", 0.001);
+    stats::add("mod:drop.on_update", 0.004);
+    auto report = stats::report(10);
+    EXPECT_NE(report.find("base: 3.00 ms"), std::string::npos);
+    EXPECT_NE(report.find("blockstick: 2.00 ms"), std::string::npos);
+    EXPECT_NE(report.find("worldtick: 1.00 ms"), std::string::npos);
+    // packs sorted by total time
+    EXPECT_LT(report.find("mod:"), report.find("base:"));
+    stats::reset();
+}
+
+TEST(ScriptingStats, Throttling) {
+    stats::reset();
+    stats::on_tick(1.0, true);
+    stats::add("base:.worldtick", 0.005);
+    stats::add("mod:.worldtick", 0.0005);
+    stats::on_tick(1.0, true);
+    EXPECT_TRUE(stats::is_throttled("base"));
+    EXPECT_FALSE(stats::is_throttled("mod"));
+    stats::on_tick(1.0, true);
+    EXPECT_FALSE(stats::is_throttled("base"));
+
+    stats::add("base:.worldtick", 0.005);
+    stats::on_tick(1.0, false);
+    EXPECT_FALSE(stats::is_throttled("base"));
+
+    stats::on_tick(0.0, false);
+    EXPECT_FALSE(stats::is_enabled());
+    stats::reset();
+}
+
+/// @return pack time in milliseconds from the report
+static double pack_time(const std::string& report, const std::string& pack) {
+    size_t pos = report.find("\n  " + pack + ": ");
+    if (pos == std::string::npos) {
+        return -1.0;
+    }
+    return std::stod(report.substr(pos + pack.length() + 5));
+}
+
+TEST(ScriptingStats, NestedEvents) {
+    stats::reset();
+    stats::set_enabled(true);
+    {
+        stats::Scope outer("base:stone.blockstick");
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        {
+            stats::Scope inner("mod:drop.on_broken");
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+    }
+    stats::set_enabled(false);
+    auto report = stats::report(10);
+    double base = pack_time(report, "base");
+    double mod = pack_time(report, "mod");
+    EXPECT_GE(base, 5.0);
+    // nested event time is not accounted twice
+    EXPECT_LT(base, 20.0);
+    EXPECT_GE(mod, 20.0);
+    EXPECT_LT(report.find("mod:"), report.find("base:"));
+    stats::reset();
+}
@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include "maths/simd.hpp"
+
+static constexpr float TOLERANCE = 1e-5f;
+
+static void fill_points(std::vector<float>& xs, std::vector<float>& ys) {
+    for (size_t i = 0; i < xs.size(); i++) {
+        xs[i] = static_cast<float>(i % 256) * 1.37f - 170.0f;
+        ys[i] = static_cast<float>(i / 256) * 0.91f - 30.0f;
+    }
+}
+
+static void compare_noise(fnl_state& state) {
+    // not divisible by vector width to cover the scalar tail
+    const size_t count = 256 * 64 + 5;
+    std::vector<float> xs(count);
+    std::vector<float> ys(count);
+    std::vector<float> expected(count);
+    std::vector<float> actual(count);
+    fill_points(xs, ys);
+
+    bool enabled = simd::is_enabled();
+    simd::set_enabled(false);
+    simd::noise2d(state, xs.data(), ys.data(), expected.data(), count);
+    simd::set_enabled(enabled);
+    simd::noise2d(state, xs.data(), ys.data(), actual.data(), count);
+
+    for (size_t i = 0; i < count; i++) {
+        EXPECT_NEAR(expected[i], actual[i], TOLERANCE) << "at " << i;
+    }
+}
+
+TEST(simd, OpenSimplex2) {
+    fnl_state state = fnlCreateState();
+    state.noise_type = FNL_NOISE_OPENSIMPLEX2;
+    state.seed = 42;
+    state.frequency = 0.05f;
+    compare_noise(state);
+}
+
+TEST(simd, Cellular) {
+    fnl_state state = fnlCreateState();
+    state.noise_type = FNL_NOISE_CELLULAR;
+    state.seed = -7;
+    for (int func = FNL_CELLULAR_DISTANCE_EUCLIDEAN;
+         func <= FNL_CELLULAR_DISTANCE_HYBRID;
+         func++) {
+        for (int ret = FNL_CELLULAR_RETURN_VALUE_CELLVALUE;
+             ret <= FNL_CELLULAR_RETURN_VALUE_DISTANCE2DIV;
+             ret++) {
+            state.cellular_distance_func =
+                static_cast<fnl_cellular_distance_func>(func);
+            state.cellular_return_type =
+                static_cast<fnl_cellular_return_type>(ret);
+            compare_noise(state);
+        }
+    }
+}
+
+TEST(simd, BinaryOps) {
+    const size_t count = 1027;
+    std::vector<float> src(count);
+    std::vector<float> base(count);
+    for (size_t i = 0; i < count; i++) {
+        base[i] = std::sin(i * 0.1f) * 10.0f;
+        src[i] = std::cos(i * 0.3f) * 5.0f;
+    }
+    bool enabled = simd::is_enabled();
+    for (auto op : {
+             simd::BinaryOp::ADD,
+             simd::BinaryOp::SUB,
+             simd::BinaryOp::MUL,
+             simd::BinaryOp::MIN,
+             simd::BinaryOp::MAX,
+         }) {
+        auto expected = base;
+        auto actual = base;
+        simd::set_enabled(false);
+        simd::binop(op, expected.data(), src.data(), count);
+        simd::binop(op, expected.data(), 0.5f, count);
+        simd::set_enabled(enabled);
+        simd::binop(op, actual.data(), src.data(), count);
+        simd::binop(op, actual.data(), 0.5f, count);
+        for (size_t i = 0; i < count; i++) {
+            EXPECT_NEAR(expected[i], actual[i], TOLERANCE);
+        }
+    }
+    {
+        auto expected = base;
+        auto actual = base;
+        simd::set_enabled(false);
+        simd::abs(expected.data(), count);
+        simd::mix(expected.data(), src.data(), 0.0f, nullptr, 0.3f, count);
+        simd::mix(expected.data(), nullptr, 2.0f, src.data(), 0.0f, count);
+        simd::set_enabled(enabled);
+        simd::abs(actual.data(), count);
+        simd::mix(actual.data(), src.data(), 0.0f, nullptr, 0.3f, count);
+        simd::mix(actual.data(), nullptr, 2.0f, src.data(), 0.0f, count);
+        for (size_t i = 0; i < count; i++) {
+            EXPECT_NEAR(expected[i], actual[i], TOLERANCE);
+        }
+    }
+}
@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#include "util/MPSCQueue.hpp"
+
+using namespace util;
+
+TEST(MPSCQueue, Bounded) {
+    MPSCQueue<int> queue(3);
+    EXPECT_EQ(queue.capacity(), 4);
+    for (int i = 0; i < 4; i++) {
+        EXPECT_TRUE(queue.tryPush(int(i)));
+    }
+    EXPECT_FALSE(queue.tryPush(4));
+    int value;
+    EXPECT_TRUE(queue.tryPop(value));
+    EXPECT_EQ(value, 0);
+    EXPECT_TRUE(queue.tryPush(4));
+    for (int i = 1; i <= 4; i++) {
+        EXPECT_TRUE(queue.tryPop(value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_FALSE(queue.tryPop(value));
+}
+
+TEST(MPSCQueue, MultipleProducers) {
+    constexpr int producersCount = 4;
+    constexpr int valuesCount = 10000;
+    MPSCQueue<int> queue(64);
+    std::vector<std::thread> producers;
+    for (int p = 0; p < producersCount; p++) {
+        producers.emplace_back([&queue, p]() {
+            for (int i = 0; i < valuesCount; i++) {
+                while (!queue.tryPush(p * valuesCount + i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    // values of each producer must arrive in order
+    std::vector<int> last(producersCount, -1);
+    int received = 0;
+    int value;
+    while (received < producersCount * valuesCount) {
+        if (!queue.tryPop(value)) {
+            std::this_thread::yield();
+            continue;
+        }
+        int producer = value / valuesCount;
+        EXPECT_GT(value % valuesCount, last[producer]);
+        last[producer] = value % valuesCount;
+        received++;
+    }
+    for (auto& thread : producers) {
+        thread.join();
+    }
+}
@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "voxels/ActiveChunks.hpp"
+#include "voxels/Chunk.hpp"
+
+/// @brief Resident chunks in square area with the given radius around 0,0
+static std::vector<std::unique_ptr<Chunk>> create_chunks(
+    ActiveChunks& active, int radius
+) {
+    std::vector<std::unique_ptr<Chunk>> chunks;
+    for (int z = -radius; z < radius; z++) {
+        for (int x = -radius; x < radius; x++) {
+            chunks.push_back(std::make_unique<Chunk>(x, z));
+            active.add(chunks.back().get());
+        }
+    }
+    return chunks;
+}
+
+/// @brief Check active chunks are exactly resident chunks inside of the
+/// viewers areas
+static void check_active(
+    const ActiveChunks& active,
+    const std::vector<std::unique_ptr<Chunk>>& chunks,
+    const std::vector<ChunksViewer>& viewers
+) {
+    std::vector<Chunk*> expected;
+    for (const auto& chunk : chunks) {
+        for (const auto& viewer : viewers) {
+            if (viewer.contains(chunk->x, chunk->z)) {
+                expected.push_back(chunk.get());
+                break;
+            }
+        }
+    }
+    auto actual = active.get();
+    std::sort(expected.begin(), expected.end());
+    std::sort(actual.begin(), actual.end());
+    EXPECT_EQ(actual, expected);
+}
+
+TEST(ActiveChunks, MovingViewers) {
+    ActiveChunks active;
+    auto chunks = create_chunks(active, 16);
+    EXPECT_TRUE(active.get().empty());
+
+    ChunksViewer first {0, 0, 4};
+    ChunksViewer second {3, 2, 3};
+    active.setViewer(1, first);
+    active.setViewer(2, second);
+    check_active(active, chunks, {first, second});
+
+    // walking, teleport and radius change
+    for (const auto& viewer : std::vector<ChunksViewer> {
+             {1, 0, 4}, {2, -1, 4}, {2, -1, 6}, {-12, 10, 5}, {-11, 10, 2}}) {
+        first = viewer;
+        active.setViewer(1, first);
+        check_active(active, chunks, {first, second});
+    }
+    EXPECT_TRUE(active.isViewed(-12, 11));
+    EXPECT_FALSE(active.isViewed(-14, 11));
+
+    active.removeViewer(2);
+    check_active(active, chunks, {first});
+    active.removeViewer(1);
+    EXPECT_TRUE(active.get().empty());
+}
+
+TEST(ActiveChunks, ResidentChunks) {
+    ActiveChunks active;
+    ChunksViewer viewer {0, 0, 2};
+    active.setViewer(1, viewer);
+
+    auto chunks = create_chunks(active, 4);
+    check_active(active, chunks, {viewer});
+
+    // unloaded chunk is not active anymore
+    active.remove(0, 0);
+    chunks.erase(std::find_if(chunks.begin(), chunks.end(), [](auto& chunk) {
+        return chunk->x == 0 && chunk->z == 0;
+    }));
+    check_active(active, chunks, {viewer});
+
+    // chunk replaced at the same position
+    chunks.push_back(std::make_unique<Chunk>(-1, 1));
+    active.add(chunks.back().get());
+    chunks.erase(std::find_if(chunks.begin(), chunks.end(), [](auto& chunk) {
+        return chunk->x == -1 && chunk->z == 1;
+    }));
+    check_active(active, chunks, {viewer});
+    EXPECT_EQ(active.get().size(), 15);
+
+    viewer = {1, 1, 2};
+    active.setViewer(1, viewer);
+    check_active(active, chunks, {viewer});
+}
@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "voxels/chunk_delta.hpp"
+
+static std::vector<voxel> generate_baseline() {
+    std::vector<voxel> voxels(CHUNK_VOL);
+    for (uint i = 0; i < CHUNK_VOL; i++) {
+        voxels[i].id = i / (CHUNK_W * CHUNK_D) < 64 ? 2 : 0;
+    }
+    return voxels;
+}
+
+TEST(chunk_delta, EncodeApply) {
+    auto baseline = generate_baseline();
+    auto voxels = baseline;
+    voxels[0].id = 5;
+    voxels[1000].state.rotation = 3;
+    voxels[CHUNK_VOL - 1].id = 7;
+    voxels[CHUNK_VOL - 1].state.userbits = 0x55;
+
+    uint32_t size;
+    auto delta = chunk_delta::encode(voxels.data(), baseline.data(), size);
+    ASSERT_NE(delta, nullptr);
+    EXPECT_EQ(size, chunk_delta::HEADER_SIZE + 3 * chunk_delta::ENTRY_SIZE);
+    EXPECT_TRUE(chunk_delta::is_delta(size));
+    EXPECT_FALSE(chunk_delta::is_pristine(size));
+
+    auto restored = generate_baseline();
+    chunk_delta::apply(delta.get(), size, restored.data());
+    for (uint i = 0; i < CHUNK_VOL; i++) {
+        EXPECT_EQ(restored[i].id, voxels[i].id);
+        EXPECT_EQ(
+            blockstate2int(restored[i].state), blockstate2int(voxels[i].state)
+        );
+    }
+    EXPECT_THROW(
+        chunk_delta::apply(delta.get(), size - 1, restored.data()),
+        std::runtime_error
+    );
+}
+
+TEST(chunk_delta, Pristine) {
+    auto baseline = generate_baseline();
+    uint32_t size;
+    auto delta = chunk_delta::encode(baseline.data(), baseline.data(), size);
+    ASSERT_NE(delta, nullptr);
+    EXPECT_TRUE(chunk_delta::is_pristine(size));
+
+    auto marker = chunk_delta::encode_pristine(size);
+    EXPECT_TRUE(chunk_delta::is_pristine(size));
+    auto restored = generate_baseline();
+    chunk_delta::apply(marker.get(), size, restored.data());
+    EXPECT_EQ(restored[0].id, baseline[0].id);
+}
+
+TEST(chunk_delta, TooManyChanges) {
+    auto baseline = generate_baseline();
+    auto voxels = baseline;
+    for (uint i = 0; i <= chunk_delta::MAX_ENTRIES; i++) {
+        voxels[i].id = 9;
+    }
+    uint32_t size;
+    EXPECT_EQ(chunk_delta::encode(voxels.data(), baseline.data(), size), nullptr);
+    EXPECT_FALSE(chunk_delta::is_delta(CHUNK_DATA_LEN));
+}
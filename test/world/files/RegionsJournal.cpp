@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include "io/io.hpp"
+#include "io/devices/StdfsDevice.hpp"
+#include "world/files/RegionsJournal.hpp"
+
+namespace fs = std::filesystem;
+
+struct ReplayedRecord {
+    RegionLayerIndex layer;
+    int x;
+    int z;
+    std::vector<ubyte> data;
+    uint32_t srcSize;
+};
+
+static std::vector<ReplayedRecord> replay(const io::path& file) {
+    std::vector<ReplayedRecord> records;
+    RegionsJournal::replay(
+        file,
+        [&records](auto layer, int x, int z, auto data, auto size, auto srcSize) {
+            std::vector<ubyte> bytes(data.get(), data.get() + size);
+            records.push_back({layer, x, z, std::move(bytes), srcSize});
+        }
+    );
+    return records;
+}
+
+static io::path prepare_folder() {
+    auto folder = fs::temp_directory_path() / "voxelengine_journal_test";
+    fs::create_directories(folder);
+    io::set_device("journal", std::make_shared<io::StdfsDevice>(folder));
+    return "journal:regions.journal";
+}
+
+TEST(RegionsJournal, ReplayCommitted) {
+    auto file = prepare_folder();
+    ubyte first[] {1, 2, 3, 4};
+    ubyte second[] {5, 6, 7};
+    {
+        RegionsJournal journal(file);
+        journal.append(REGION_LAYER_VOXELS, 3, -7, first, 4, 16);
+        journal.append(REGION_LAYER_LIGHTS, -1, 2, second, 3, 8);
+        journal.commit();
+        journal.append(REGION_LAYER_ENTITIES, 0, 0, nullptr, 0, 0);
+        journal.commit();
+        EXPECT_EQ(journal.getUncommitted(), 0);
+    }
+    auto records = replay(file);
+    ASSERT_EQ(records.size(), 3);
+    EXPECT_EQ(records[0].layer, REGION_LAYER_VOXELS);
+    EXPECT_EQ(records[0].x, 3);
+    EXPECT_EQ(records[0].z, -7);
+    EXPECT_EQ(records[0].data, std::vector<ubyte>(first, first + 4));
+    EXPECT_EQ(records[0].srcSize, 16);
+    EXPECT_EQ(records[1].layer, REGION_LAYER_LIGHTS);
+    EXPECT_EQ(records[1].data, std::vector<ubyte>(second, second + 3));
+    EXPECT_EQ(records[2].layer, REGION_LAYER_ENTITIES);
+    EXPECT_TRUE(records[2].data.empty());
+}
+
+TEST(RegionsJournal, IgnoreUncommittedTail) {
+    auto file = prepare_folder();
+    ubyte data[] {1, 2, 3, 4};
+    {
+        RegionsJournal journal(file);
+        journal.append(REGION_LAYER_VOXELS, 0, 0, data, 4, 4);
+        journal.commit();
+        journal.append(REGION_LAYER_VOXELS, 1, 0, data, 4, 4);
+    }
+    EXPECT_EQ(replay(file).size(), 1);
+}
+
+TEST(RegionsJournal, IgnoreDamagedRecord) {
+    auto file = prepare_folder();
+    ubyte data[] {1, 2, 3, 4};
+    {
+        RegionsJournal journal(file);
+        journal.append(REGION_LAYER_VOXELS, 0, 0, data, 4, 4);
+        journal.commit();
+        journal.append(REGION_LAYER_VOXELS, 1, 0, data, 4, 4);
+        journal.commit();
+    }
+    auto bytes = io::read_bytes(file);
+    // damage chunk data of the second record
+    bytes[bytes.size() - 6] ^= 0xFF;
+    io::write_bytes(file, bytes.data(), bytes.size());
+
+    EXPECT_EQ(replay(file).size(), 1);
+}
+
+TEST(RegionsJournal, Reset) {
+    auto file = prepare_folder();
+    ubyte data[] {1, 2, 3, 4};
+    RegionsJournal journal(file);
+    journal.append(REGION_LAYER_VOXELS, 0, 0, data, 4, 4);
+    journal.commit();
+    journal.reset();
+    EXPECT_TRUE(replay(file).empty());
+}
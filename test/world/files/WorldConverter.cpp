@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+
+#include "content/Content.hpp"
+#include "content/ContentBuilder.hpp"
+#include "content/ContentReport.hpp"
+#include "core_defs.hpp"
+#include "io/io.hpp"
+#include "io/devices/StdfsDevice.hpp"
+#include "items/ItemDef.hpp"
+#include "objects/rigging.hpp"
+#include "voxels/Block.hpp"
+#include "voxels/Chunk.hpp"
+#include "world/files/WorldConverter.hpp"
+#include "world/files/WorldFiles.hpp"
+
+namespace fs = std::filesystem;
+
+static io::path prepare_folder() {
+    auto folder = fs::temp_directory_path() / "voxelengine_converter_test";
+    fs::remove_all(folder);
+    fs::create_directories(folder);
+    io::set_device("convtest", std::make_shared<io::StdfsDevice>(folder));
+    return "convtest:";
+}
+
+static std::unique_ptr<Content> create_content() {
+    ContentBuilder builder;
+    builder.blocks.create(CORE_AIR).pickingItem = CORE_EMPTY;
+    builder.items.create(CORE_EMPTY);
+    for (const auto& name : {"test:a", "test:b"}) {
+        builder.blocks.create(name).pickingItem = CORE_EMPTY;
+    }
+    return builder.build();
+}
+
+/// @brief Report of world saved with test:a and test:b swapped
+static std::shared_ptr<ContentReport> create_report(const Content& content) {
+    auto report = std::make_shared<ContentReport>(
+        content.getIndices(), 3, 1, REGION_FORMAT_VERSION
+    );
+    report->blocks.set(1, "test:b", 2);
+    report->blocks.set(2, "test:a", 1);
+    report->buildIssues();
+    return report;
+}
+
+/// @brief Chunks in two regions
+static const int CHUNKS[][2] {{0, 0}, {REGION_SIZE, 0}};
+
+static void write_chunks(WorldFiles& wfile) {
+    auto& regions = wfile.getRegions();
+    for (const auto& [x, z] : CHUNKS) {
+        Chunk chunk(x, z);
+        chunk.voxels[0].id = 1;
+        chunk.voxels[1].id = 2;
+        chunk.flags.lighted = true;
+        chunk.flags.unsaved = true;
+        regions.put(&chunk, {});
+    }
+    regions.writeAll();
+}
+
+TEST(WorldConverter, ResumeAfterInterrupt) {
+    auto folder = prepare_folder();
+    auto content = create_content();
+    auto report = create_report(*content);
+    {
+        auto wfile = std::make_shared<WorldFiles>(folder);
+        write_chunks(*wfile);
+    }
+    {
+        auto wfile = std::make_shared<WorldFiles>(folder);
+        WorldConverter converter(
+            wfile, content.get(), report, ConvertMode::REINDEX
+        );
+        // two voxels regions and player
+        EXPECT_EQ(converter.getWorkTotal(), 3);
+        converter.convertNext();
+        EXPECT_EQ(converter.getWorkDone(), 1);
+        // interrupted
+    }
+    {
+        auto wfile = std::make_shared<WorldFiles>(folder);
+        WorldConverter converter(
+            wfile, content.get(), report, ConvertMode::REINDEX
+        );
+        EXPECT_EQ(converter.getWorkTotal(), 3);
+        EXPECT_EQ(converter.getWorkDone(), 1);
+        converter.waitForEnd();
+        EXPECT_EQ(converter.getWorkDone(), 3);
+    }
+    // every region is converted once
+    WorldFiles wfile(folder);
+    for (const auto& [x, z] : CHUNKS) {
+        Chunk chunk(x, z);
+        ASSERT_TRUE(wfile.getRegions().loadVoxels(chunk));
+        EXPECT_EQ(chunk.voxels[0].id, 2);
+        EXPECT_EQ(chunk.voxels[1].id, 1);
+    }
+}
+
+TEST(WorldConverter, RefuseResumeWithAnotherReport) {
+    auto folder = prepare_folder();
+    auto content = create_content();
+    {
+        auto wfile = std::make_shared<WorldFiles>(folder);
+        write_chunks(*wfile);
+    }
+    {
+        auto wfile = std::make_shared<WorldFiles>(folder);
+        WorldConverter converter(
+            wfile, content.get(), create_report(*content), ConvertMode::REINDEX
+        );
+        converter.convertNext();
+    }
+    auto report = create_report(*content);
+    report->blocks.set(2, "test:c", BLOCK_VOID);
+
+    auto wfile = std::make_shared<WorldFiles>(folder);
+    EXPECT_THROW(
+        WorldConverter(wfile, content.get(), report, ConvertMode::REINDEX),
+        std::runtime_error
+    );
+    // the same report is accepted
+    WorldConverter converter(
+        wfile, content.get(), create_report(*content), ConvertMode::REINDEX
+    );
+    EXPECT_EQ(converter.getWorkDone(), 1);
+}
@@ -0,0 +1,217 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+
+#include "io/io.hpp"
+#include "io/devices/StdfsDevice.hpp"
+#include "voxels/Chunk.hpp"
+#include "voxels/chunk_delta.hpp"
+#include "world/files/RegionsJournal.hpp"
+#include "world/files/RegionsSaver.hpp"
+#include "world/files/WorldRegions.hpp"
+
+namespace fs = std::filesystem;
+
+static io::path prepare_folder() {
+    auto folder = fs::temp_directory_path() / "voxelengine_regions_test";
+    fs::remove_all(folder);
+    fs::create_directories(folder);
+    io::set_device("regionstest", std::make_shared<io::StdfsDevice>(folder));
+    return "regionstest:";
+}
+
+static void generate_baseline(int, int, voxel* voxels) {
+    for (uint i = 0; i < CHUNK_VOL; i++) {
+        voxels[i].id = i < CHUNK_VOL / 2 ? 1 : 0;
+        voxels[i].state = {};
+    }
+}
+
+TEST(WorldRegions, SaverCalculatesDelta) {
+    WorldRegions regions(prepare_folder());
+    regions.setDeltaStorage(true);
+    regions.setBaselineGenerator(generate_baseline, []() -> BaselineGenerator {
+        return generate_baseline;
+    });
+    regions.startAsyncSaving(2);
+    ASSERT_TRUE(regions.getSaver()->hasBaselineGenerator());
+
+    Chunk chunk(3, -2);
+    generate_baseline(chunk.x, chunk.z, chunk.voxels);
+    chunk.voxels[100].id = 5;
+    chunk.flags.lighted = true;
+    chunk.flags.unsaved = true;
+    regions.put(&chunk, {});
+    regions.flush();
+
+    uint32_t size;
+    uint32_t srcSize;
+    auto& layer = regions.getLayer(REGION_LAYER_VOXELS);
+    ASSERT_NE(layer.getData(3, -2, size, srcSize), nullptr);
+    EXPECT_TRUE(chunk_delta::is_delta(srcSize));
+    EXPECT_FALSE(chunk_delta::is_pristine(srcSize));
+
+    Chunk loaded(3, -2);
+    ASSERT_TRUE(regions.loadVoxels(loaded));
+    EXPECT_EQ(loaded.voxels[100].id, 5);
+    EXPECT_EQ(loaded.voxels[101].id, 1);
+    EXPECT_EQ(loaded.voxels[CHUNK_VOL - 1].id, 0);
+}
+
+static void put_data(WorldRegions& regions, int x, int z, size_t size) {
+    regions.put(
+        x, z, REGION_LAYER_ENTITIES, std::make_unique<ubyte[]>(size), size
+    );
+}
+
+TEST(WorldRegions, CacheStats) {
+    WorldRegions regions(prepare_folder());
+    auto& layer = regions.getLayer(REGION_LAYER_ENTITIES);
+    put_data(regions, 0, 0, 1000);
+    put_data(regions, 1, 0, 500);
+    put_data(regions, REGION_SIZE, 0, 2000);
+
+    size_t regionUsage = WorldRegion().getMemoryUsage();
+    auto stats = regions.getCacheStats();
+    EXPECT_EQ(stats.regions, 2);
+    EXPECT_EQ(stats.memoryUsage, regionUsage * 2 + 3500);
+    EXPECT_EQ(layer.getRegion(0, 0)->getMemoryUsage(), regionUsage + 1500);
+
+    // chunk data replaced
+    put_data(regions, 0, 0, 100);
+    EXPECT_EQ(regions.getCacheStats().memoryUsage, regionUsage * 2 + 2600);
+
+    regions.flushRegion(0, 0);
+    stats = regions.getCacheStats();
+    EXPECT_EQ(stats.regions, 1);
+    EXPECT_EQ(stats.memoryUsage, regionUsage + 2000);
+    EXPECT_TRUE(io::exists(layer.getRegionFilePath(0, 0)));
+
+    // reading from the region file is accounted too
+    uint32_t size;
+    uint32_t srcSize;
+    ASSERT_NE(layer.getData(1, 0, size, srcSize), nullptr);
+    EXPECT_EQ(size, 500);
+    stats = regions.getCacheStats();
+    EXPECT_EQ(stats.regions, 2);
+    EXPECT_EQ(stats.memoryUsage, regionUsage * 2 + 2500);
+    EXPECT_EQ(stats.misses, 1);
+}
+
+TEST(WorldRegions, MemoryBudget) {
+    WorldRegions regions(prepare_folder());
+    auto& layer = regions.getLayer(REGION_LAYER_ENTITIES);
+    for (int i = 0; i < 4; i++) {
+        put_data(regions, i * REGION_SIZE, 0, 1000);
+    }
+    // region 0 is the most recently used one
+    layer.getRegion(0, 0);
+
+    size_t regionUsage = WorldRegion().getMemoryUsage() + 1000;
+    regions.setMemoryBudget(regionUsage * 5 / 2);
+    regions.update();
+
+    auto stats = regions.getCacheStats();
+    EXPECT_EQ(stats.regions, 2);
+    EXPECT_EQ(stats.memoryUsage, regionUsage * 2);
+    EXPECT_EQ(stats.evictions, 2);
+    EXPECT_EQ(stats.writeBacks, 2);
+    EXPECT_NE(layer.getRegion(0, 0), nullptr);
+    EXPECT_NE(layer.getRegion(3, 0), nullptr);
+    EXPECT_TRUE(io::exists(layer.getRegionFilePath(1, 0)));
+    EXPECT_TRUE(io::exists(layer.getRegionFilePath(2, 0)));
+
+    // budget is not exceeded
+    regions.update();
+    EXPECT_EQ(regions.getCacheStats().evictions, 2);
+}
+
+TEST(WorldRegions, FailedWriteBack) {
+    WorldRegions regions(prepare_folder());
+    auto& layer = regions.getLayer(REGION_LAYER_ENTITIES);
+    put_data(regions, 0, 0, 1000);
+    put_data(regions, REGION_SIZE, 0, 1000);
+    // regions folder can not be created
+    io::write_string(layer.folder, "");
+
+    regions.setMemoryBudget(1);
+    EXPECT_NO_THROW(regions.update());
+    EXPECT_EQ(regions.getCacheStats().regions, 2);
+    EXPECT_TRUE(layer.getRegion(0, 0)->isUnsaved());
+
+    io::remove(layer.folder);
+    regions.update();
+    EXPECT_EQ(regions.getCacheStats().regions, 0);
+    EXPECT_TRUE(io::exists(layer.getRegionFilePath(0, 0)));
+    EXPECT_TRUE(io::exists(layer.getRegionFilePath(1, 0)));
+}
+
+TEST(WorldRegions, SaverFailedWrite) {
+    WorldRegions regions(prepare_folder());
+    regions.startAsyncSaving(1);
+    auto& layer = regions.getLayer(REGION_LAYER_ENTITIES);
+    put_data(regions, 0, 0, 1000);
+    put_data(regions, REGION_SIZE, 0, 1000);
+    io::write_string(layer.folder, "");
+
+    regions.writeAll();
+    EXPECT_THROW(regions.flush(), std::runtime_error);
+    EXPECT_TRUE(layer.getRegion(0, 0)->isUnsaved());
+
+    // evicted regions are kept until written
+    regions.setMemoryBudget(1);
+    regions.update();
+    EXPECT_THROW(regions.flush(), std::runtime_error);
+    EXPECT_EQ(regions.getCacheStats().regions, 2);
+    EXPECT_TRUE(layer.getRegion(1, 0)->isUnsaved());
+
+    io::remove(layer.folder);
+    regions.update();
+    regions.flush();
+    EXPECT_EQ(regions.getCacheStats().regions, 0);
+    EXPECT_TRUE(io::exists(layer.getRegionFilePath(0, 0)));
+    EXPECT_TRUE(io::exists(layer.getRegionFilePath(1, 0)));
+}
+
+TEST(WorldRegions, JournalKeepsUnsavedRegions) {
+    WorldRegions regions(prepare_folder());
+    regions.startAsyncSaving(1);
+    regions.enableJournal();
+    auto& layer = regions.getLayer(REGION_LAYER_ENTITIES);
+    put_data(regions, 0, 0, 1000);
+
+    // region files are written on checkpoints only
+    regions.setMemoryBudget(1);
+    regions.update();
+    EXPECT_EQ(regions.getCacheStats().regions, 1);
+    EXPECT_FALSE(io::exists(layer.getRegionFilePath(0, 0)));
+
+    regions.writeAll();
+    regions.flush();
+    size_t records = RegionsJournal::replay(
+        "regionstest:regions.journal", [](auto&&...) {}
+    );
+    EXPECT_EQ(records, 1);
+}
+
+TEST(WorldRegions, HeldRegionFile) {
+    WorldRegions regions(prepare_folder());
+    auto& layer = regions.getLayer(REGION_LAYER_ENTITIES);
+    io::create_directories(layer.folder);
+    put_data(regions, 0, 0, 100);
+
+    layer.holdRegionFile({0, 0});
+    std::atomic<bool> written = false;
+    std::thread writer([&]() {
+        layer.writeRegion(0, 0, layer.getRegion(0, 0));
+        written = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_FALSE(written);
+    EXPECT_FALSE(io::exists(layer.getRegionFilePath(0, 0)));
+
+    layer.releaseRegionFile({0, 0});
+    writer.join();
+    EXPECT_TRUE(io::exists(layer.getRegionFilePath(0, 0)));
+}